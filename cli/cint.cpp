@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Sep 16 13:53:47 PDT 2013
 // Last Modified: Thu Sep 19 16:10:27 PDT 2013
+// Last Modified: Sat Oct 17 20:14:50 PDT 2026 search suspensions in one pass
 // Filename:      ...museinfo/examples/all/cint.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/cint.cpp
 // Syntax:        C++; museinfo
@@ -274,7 +275,7 @@ int       retroQ       = 0;      // used with --retro option
 int       idQ          = 0;      // used with --id option
 vector<string> Ids;              // used with --id option
 string    NoteMarker;            // used with -N option
-PerlRegularExpression SearchString;
+MultiPatternMatcher SearchString;
 string Spacer;
 
 
@@ -510,8 +511,6 @@ int  printCombinationsSuspensions(vector<vector<NoteNode> >& notes,
 		HumdrumFile& infile, vector<int>& ktracks, vector<int>& reverselookup,
 		int n, vector<vector<string> >& retrospective) {
 
-	char sbuffer[24096] = {0};
-
 	int oldcountQ = countQ;
 	countQ = 1;             // mostly used to suppress intermediate output
 
@@ -522,49 +521,46 @@ int  printCombinationsSuspensions(vector<vector<NoteNode> >& notes,
 	// Suspensions with length-2 modules
 	n = 2;                        // -n 2
 	xoptionQ   = 1;               // -x
-	strcpy(sbuffer, "");
-
-	strcat(sbuffer, "^7xs 1 6sx -2 8xx$"); 	strcat(sbuffer, "|");
-	strcat(sbuffer, "^2sx -2 3xs 2 1xx$"); 	strcat(sbuffer, "|");
-	strcat(sbuffer, "^7xs 1 6sx 2 6xx$"); 	strcat(sbuffer, "|");
-	strcat(sbuffer, "^11xs 1 10sx -5 15xx$"); 	strcat(sbuffer, "|");
-	strcat(sbuffer, "^4xs 1 3sx -5 8xx$"); 	strcat(sbuffer, "|");
-	strcat(sbuffer, "^2sx -2 3xs 2 3xx$");	strcat(sbuffer, "|");
+	SearchString.clear();
+
+	SearchString.addPattern("^7xs 1 6sx -2 8xx$");
+	SearchString.addPattern("^2sx -2 3xs 2 1xx$");
+	SearchString.addPattern("^7xs 1 6sx 2 6xx$");
+	SearchString.addPattern("^11xs 1 10sx -5 15xx$");
+	SearchString.addPattern("^4xs 1 3sx -5 8xx$");
+	SearchString.addPattern("^2sx -2 3xs 2 3xx$");
 	// "9xs 1 8sx -2 10xx" archetype: Jos1405 m10 A&B
-	strcat(sbuffer, "^9xs 1 8sx -2 10xx$");	strcat(sbuffer, "|");
+	SearchString.addPattern("^9xs 1 8sx -2 10xx$");
 	// "4xs 1 3sx 5xx" archetype: Jos1713 m87-88 A&B
-	strcat(sbuffer, "^4xs 1 3sx -2 5xx$");	strcat(sbuffer, "|");
+	SearchString.addPattern("^4xs 1 3sx -2 5xx$");
 	// "11xs 1 10sx 4 8xx" archetype: Jos1402 m23-24 S&B
-	strcat(sbuffer, "^11xs 1 10sx 4 8xx$");
+	SearchString.addPattern("^11xs 1 10sx 4 8xx$");
 
-	SearchString.initializeSearchAndStudy(sbuffer);
 	countsum += printCombinations(notes, infile, ktracks, reverselookup, n,
 						   retrospective);
 
 	// Suspensions with length-3 modules /////////////////////////////////
 	n = 3;                        // -n 2
 	xoptionQ   = 1;               // -x
-	strcpy(sbuffer, "");
+	SearchString.clear();
 
 	// "7xs 1 6sx 1 5sx 1 6sx" archetype: Jos2721 m27-78 S&T
-	strcat(sbuffer, "^7xs 1 6sx 1 5sx 1 6sx$");	strcat(sbuffer, "|");
+	SearchString.addPattern("^7xs 1 6sx 1 5sx 1 6sx$");
 	// "7xs 1 6sx 1 6sx -2 8xx" archetype: Rue2018 m38-88 S&T
-	strcat(sbuffer, "^7xs 1 6sx 1 6sx -2 8xx$");	strcat(sbuffer, "|");
+	SearchString.addPattern("^7xs 1 6sx 1 6sx -2 8xx$");
 	// "11xs 1 10sx 1 10sx -5 15xx" archetype: Rue2018 m38-88 S&B
-	strcat(sbuffer, "^11xs 1 10sx 1 10sx -5 15xx$");
+	SearchString.addPattern("^11xs 1 10sx 1 10sx -5 15xx$");
 
-	SearchString.initializeSearchAndStudy(sbuffer);
 	countsum += printCombinations(notes, infile, ktracks, reverselookup, n,
 						   retrospective);
 
 	// Suspensions with length-5 modules /////////////////////////////////
 	n = 5;                        // -n 2
 	xoptionQ   = 1;               // -x
-	strcpy(sbuffer, "");
+	SearchString.clear();
 	// "8xs 1 7sx 1 7sx 1 6sx 1 6sx 1 5sx -1 8xx" archetype: Duf3015a m94 S&T
-	strcat(sbuffer, "^8xs 1 7sx 1 7sx 1 6sx 1 5sx -2 8xx$");
+	SearchString.addPattern("^8xs 1 7sx 1 7sx 1 6sx 1 5sx -2 8xx$");
 
-	SearchString.initializeSearchAndStudy(sbuffer);
 	countsum += printCombinations(notes, infile, ktracks, reverselookup, n,
 						   retrospective);
 
@@ -771,7 +767,7 @@ int printCombinationModulePrepare(ostream& out, const string& filename,
 					newstring += tstring[i];
 				}
 			}
-			match = SearchString.search(newstring);
+			match = SearchString.search(newstring) > 0;
 			if (match) {
 				count++;
 				if (locationQ) {
@@ -2878,7 +2874,11 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	}
 
 	if (searchQ) {
-		SearchString.initializeSearchAndStudy(opts.getString("search").c_str());
+		SearchString.clear();
+		if (SearchString.addPattern(opts.getString("search")) < 0) {
+			cerr << SearchString.getError() << endl;
+			exit(1);
+		}
 	}
 
 }
@@ -8,6 +8,9 @@
 // Last Modified: Wed Sep 14 10:40:48 PDT 2011 Added -F option
 // Last Modified: Sat Apr  6 01:16:22 PDT 2013 Enabled multiple segment input
 // Filename:      ...sig/examples/all/hgrep.cpp
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 Added --threads option
+// Last Modified: Sat Oct 17 20:14:50 PDT 2026 Search --and strings in one pass
+// Last Modified: Sat Oct 17 23:37:59 PDT 2026 Fixed -T --and hang
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/hgrep.cpp
 // Syntax:        C++; museinfo
 //
@@ -32,22 +35,19 @@ using namespace std;
 void      checkOptions        (Options& opts, int argc, char** argv);
 void      example             (void);
 void      usage               (const string& command);
-void      doSearch            (const string& searchstring, HumdrumFile& infile,
-                               const string& filename);
+void      doSearch            (HumdrumFile& infile, const string& filename);
 void      printPreInfo        (const string& filename, HumdrumFile& infile,
                                double measure, int line, int spine = -1);
 char*     searchAndReplace    (char* buffer, const string& searchstring,
                                const string& replacestring,
                                const string& datastring);
 void      displayFraction     (double fraction);
-void      fillAndSearches     (vector<regex_t>& relist,
+void      fillAndSearches     (MultiPatternMatcher& matcher,
                                vector<string>& exlist,
                                const string& string);
-int       tokenSearch         (int& column, HumdrumFile& infile, int line,
-                               regex_t& re);
-int       singleTokenSearch   (int& column, HumdrumFile& infile, int line,
-                               regex_t& re, const string& exstring);
-void      destroyAndSearches  (vector<regex_t>& relist);
+int       tokenSearch         (int& column, HumdrumFile& infile, int line);
+int       isSearchToken       (HumdrumFile& infile, int line, int field,
+                               const string& exstring);
 double    getBeatOfNextData   (HumdrumFile& infile, int line);
 void      printDitto          (HumdrumFile& infile, int line);
 void      markKernNotes       (HumdrumFile& infile, int line);
@@ -78,8 +78,8 @@ int         datastopQ       = 0;     // used with -D option
 int         markQ           = 0;     // used with --mark option
 string      exinterps       = "";    // used with -x option
 char        separator[1024] = {0};   // used with --sep option
-vector<regex_t> Andlist;              // used with --and option
-vector<string> Andexinterp;     // used with --and option
+MultiPatternMatcher Matcher;         // search string and --and strings
+vector<string> Andexinterp;          // used with --and option
 int         MarkerCount     = 0;
 int         MarkerMatchCount= 0;
 
@@ -98,13 +98,17 @@ int main(int argc, char** argv) {
 	checkOptions(options, argc, argv);
 	HumdrumStream streamer(options);
 	HumdrumFile infile;
+	if (options.getInteger("threads") > 1) {
+		streamer.setThreadCount(options.getInteger("threads"));
+		if (absbeatQ || beatQ || measureQ || fracQ) {
+			streamer.setRhythmAnalysis("4");
+		}
+	}
 
 	while (streamer.read(infile)) {
 		analyzeFile(infile);
 	}
 
-	destroyAndSearches(Andlist);
-
 	return 0;
 }
 
@@ -121,7 +125,7 @@ void analyzeFile(HumdrumFile& infile) {
 		infile.analyzeRhythm("4");
 	}
 
-	doSearch(searchstring.c_str(), infile, infile.getFilename());
+	doSearch(infile, infile.getFilename());
 	if (markQ) {
 		cout << infile;
 		if (MarkerCount) {
@@ -139,32 +143,17 @@ void analyzeFile(HumdrumFile& infile) {
 
 //////////////////////////////
 //
-// doSearch --
+// doSearch -- The search string is the first pattern in Matcher, and
+//    the --and strings are the following patterns.
 //
 
-void doSearch(const string& searchstring, HumdrumFile& infile,
-		const string& filename) {
-	regex_t re;
-	int flags = 0;
+void doSearch(HumdrumFile& infile, const string& filename) {
 	double measure = 1;
 	if (infile.getPickupDur() != 0.0) {
 		measure = 0;
 	}
 
-	if (!basicQ) {
-		flags = flags | REG_EXTENDED;
-	}
-	if (ignorecaseQ) {
-		flags = flags | REG_ICASE;
-	}
 	int status;
-	status = regcomp(&re, searchstring.c_str(), flags);
-	if (status != 0) {
-		char errstring[1024] = {0};
-		regerror(status, &re, errstring, 1000);
-		cerr << errstring << endl;
-		exit(1);
-	}
 	int i;
 	int matchcount = 0;
 
@@ -216,7 +205,7 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 				continue;
 			}
 			int column = -1;
-			status = tokenSearch(column, infile, i, re);
+			status = tokenSearch(column, infile, i);
 			// status == 0 means a match was found
 			// status != 0 means a match was not found
 			if (markQ && !status) {
@@ -250,29 +239,29 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 
 		} else { // search entire line as a single unit
 			if (tokenizeQ) {
-				status = 0;
-				for (int ii=0; ii<infile[i].getFieldCount(); ii++) {
-					status = tokenSearch(ii, infile, i, re);
-					if (markQ && !status) {
-						markKernNotes(infile, i);
-						continue;
-					}
-					if (status == 0) {
-						break;
-					}
+				// tokenSearch() checks every token on the line (and sets
+				// column to -1 for --and searches, so it must not be the
+				// index of a loop over the fields).
+				int column = -1;
+				status = tokenSearch(column, infile, i);
+				if (markQ && !status) {
+					markKernNotes(infile, i);
+					continue;
 				}
 			} else {
-				status = regexec(&re, infile[i].getLine(), 0, NULL, 0);
+				Matcher.search(infile[i].getLine());
+				status = !Matcher.isMatch(0);
 				if (markQ && !status) {
 					markKernNotes(infile, i);
 					continue;
 				}
 			}
-			if (Andlist.size() > 0) {
-				for (int aa=0; aa<(int)Andlist.size(); aa++) {
-					int newstatus = regexec(&Andlist[aa], infile[i].getLine(),
-							0, NULL, 0);
-					if (newstatus != 0) {
+			if (Matcher.getPatternCount() > 1) {
+				if (tokenizeQ) {
+					Matcher.search(infile[i].getLine());
+				}
+				for (int aa=1; aa<Matcher.getPatternCount(); aa++) {
+					if (!Matcher.isMatch(aa)) {
 						status = 1;
 					}
 				}
@@ -303,7 +292,6 @@ void doSearch(const string& searchstring, HumdrumFile& infile,
 		}
 	}
 
-	regfree(&re);
 	if (nomatchfilesQ && matchcount == 0) {
 		cout << filename << endl;
 	}
@@ -384,41 +372,30 @@ void printDitto(HumdrumFile& infile, int line) {
 
 //////////////////////////////
 //
-// singleTokenSearch -- used in tokenSearch, but only doing one search
-//   on a line at a time.  Returns 0 if a match was found, otherwise
-//   returns 1 (or a non-zero) if no match.
+// isSearchToken -- returns true if the token is in a spine which should
+//   be searched for a pattern which is limited to the given exclusive
+//   interpretations (or all exclusive interpretations if empty).
 //
 
-int singleTokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re,
+int isSearchToken(HumdrumFile& infile, int line, int field,
 		const string& exstring) {
-	int status;
-	for (int j=0; j<infile[line].getFieldCount(); j++) {
-		if (exstring.size() == 0) {
-			// don't filter out based on exclusive interpretation types
-		} else if (exstring.find(infile[line].getExInterp(j)) == std::string::npos) {
-			continue;
-		}
+	if (exstring.size() == 0) {
+		// don't filter out based on exclusive interpretation types
+	} else if (exstring.find(infile[line].getExInterp(field)) == std::string::npos) {
+		return 0;
+	}
 
-		if ((infile[line].getSpineInfo(j).find('b') != std::string::npos) ||
-				(infile[line].getSpineInfo(j).find("((") != std::string::npos)) {
-			if (primaryQ) {
-				continue;
-			}
-		} else {
-			if (nonprimaryQ) {
-				continue;
-			}
+	if ((infile[line].getSpineInfo(field).find('b') != std::string::npos) ||
+			(infile[line].getSpineInfo(field).find("((") != std::string::npos)) {
+		if (primaryQ) {
+			return 0;
 		}
-
-		status = regexec(&re, infile[line][j], 0, NULL, 0);
-		if (status == 0) {
-//cout << "AND MATCH FOUND IN TOKEN: " << infile[line][j] << endl;
-//cout << "USING REGEX " << (int)(&re) << endl;
-			return status;
+	} else {
+		if (nonprimaryQ) {
+			return 0;
 		}
 	}
-
-	return 1; // no match was found on the line
+	return 1;
 }
 
 
@@ -426,43 +403,58 @@ int singleTokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re,
 //////////////////////////////
 //
 // tokenSearch -- returns 0 if a match was found, otherwise returns 1
-//      if no match was found.
+//      if no match was found.  The search string and all --and strings
+//      are checked in a single pass over each token.
 //
 //
 
-int tokenSearch(int& column, HumdrumFile& infile, int line, regex_t& re) {
-	int matchfound = 0;
+int tokenSearch(int& column, HumdrumFile& infile, int line) {
+	int count = Matcher.getPatternCount();
+	vector<string> exstrings(count);
+	vector<int> found(count, 0);
+	vector<int> active(count);
+	int i, j;
 
-	if (kernQ) {
-		matchfound = singleTokenSearch(column, infile, line, re, "**kern");
-	} else {
-		matchfound = singleTokenSearch(column, infile, line, re, exinterps.c_str());
+	exstrings[0] = kernQ ? "**kern" : exinterps;
+	for (i=1; i<count; i++) {
+		if (kernQ && Andexinterp[i-1].empty()) {
+			exstrings[i] = "**kern";
+		} else {
+			exstrings[i] = Andexinterp[i-1];
+		}
 	}
 
-	if (matchfound != 0) {
-		return matchfound;
+	int activeQ;
+	for (j=0; j<infile[line].getFieldCount(); j++) {
+		activeQ = 0;
+		for (i=0; i<count; i++) {
+			active[i] = !found[i] && isSearchToken(infile, line, j, exstrings[i]);
+			activeQ |= active[i];
+		}
+		if (!activeQ) {
+			continue;
+		}
+		Matcher.search(infile[line][j]);
+		for (i=0; i<count; i++) {
+			if (active[i] && Matcher.isMatch(i)) {
+				found[i] = 1;
+			}
+		}
 	}
 
-	if (Andlist.size() == 0) {
-		return matchfound;
+	if (!found[0]) {
+		return 1;
+	}
+	if (count == 1) {
+		return 0;
 	}
 
-//cout << "CHECKING AND DATA" << endl;
-	for (int i=0; i<(int)Andlist.size(); i++) {
-		if (kernQ && Andexinterp[i].empty()) {
-			matchfound = singleTokenSearch(column, infile, line,
-					Andlist[i], "**kern");
-		} else {
-			matchfound = singleTokenSearch(column, infile, line,
-					Andlist[i], Andexinterp[i]);
-		}
-		if (matchfound != 0) {
-			column = -1;  // don't identify spine for anded searches
+	column = -1;  // don't identify spine for anded searches
+	for (i=1; i<count; i++) {
+		if (!found[i]) {
 			return 1;
 		}
 	}
-
-	column = -1;  // don't identify spine for anded searches
 	return 0; // all matches were satisfied
 }
 
@@ -635,6 +627,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("i|ignore-case=b", "ignore case in matches");
 	opts.define("n|line-number=b", "display line number of match");
 	opts.define("v|invert-match=b", "invert the matching criteria");
+	opts.define("threads=i:1",      "number of threads for parsing files");
 
 	opts.define("author=b",  "author of program");
 	opts.define("version=b", "compilation info");
@@ -702,10 +695,16 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 		nomatchfilesQ = 0;
 	}
 
-	Andlist.resize(0);
+	Matcher.clear();
+	Matcher.setSyntax(basicQ ? MPM_SYNTAX_BASIC : MPM_SYNTAX_EXTENDED);
+	Matcher.setIgnoreCase(ignorecaseQ);
+	if (Matcher.addPattern(searchstring) < 0) {
+		cerr << Matcher.getError() << endl;
+		exit(1);
+	}
 	Andexinterp.resize(0);
 	if (opts.getBoolean("and")) {
-		fillAndSearches(Andlist, Andexinterp, opts.getString("and").c_str());
+		fillAndSearches(Matcher, Andexinterp, opts.getString("and").c_str());
 	}
 }
 
@@ -716,7 +715,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 // fillAndSearches -- exinterp strings are sticky.
 //
 
-void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
+void fillAndSearches(MultiPatternMatcher& matcher, vector<string>& exlist,
 		const string& astring) {
 	char* buffer;
 	int bufsize = (int)astring.size() * 2 + 128;
@@ -724,20 +723,9 @@ void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
 	for (int i=0; i<bufsize; i++) {
 		buffer[i] = '\0';
 	}
-	relist.reserve(100);
-	relist.resize(0);
 
 	char exbuff[1024] = {0};
 
-	int status;
-	int compflags = 0;
-	if (!basicQ) {
-		compflags = compflags | REG_EXTENDED;
-	}
-	if (ignorecaseQ) {
-		compflags = compflags | REG_ICASE;
-	}
-
 	searchAndReplace(buffer, "[\\]n", "\n", astring);
 	char* ptr = strtok(buffer, "\n");
 	while (ptr != NULL) {
@@ -747,13 +735,8 @@ void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
 			ptr = strtok(NULL, "\n");
 			continue;
 		}
-		relist.resize(relist.size()+1);
-//cout << "SEARCH STRING ADDED: " << ptr << endl;
-//cout << "ADDRESS IS " << (int)(&(relist[relist.size()-1])) << endl;
-		status = regcomp(&(relist[(int)relist.size()-1]), ptr, compflags);
-		if (status !=0) {
-			regerror(status, &(relist[(int)relist.size()-1]), buffer, 1024);
-			cerr << buffer << endl;
+		if (matcher.addPattern(ptr) < 0) {
+			cerr << matcher.getError() << endl;
 			exit(1);
 		}
 		exlist.push_back(exbuff);
@@ -764,20 +747,6 @@ void fillAndSearches(vector<regex_t>& relist, vector<string>& exlist,
 
 
 
-//////////////////////////////
-//
-// destroyAndSearches --
-//
-
-void destroyAndSearches(vector<regex_t>& relist) {
-	for (int i=0; i<(int)relist.size(); i++) {
-		regfree(&(relist[i]));
-	}
-	relist.resize(0);
-}
-
-
-
 //////////////////////////////
 //
 // example --
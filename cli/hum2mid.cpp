@@ -33,6 +33,9 @@
 // Last Modified: Wed Dec 11 22:24:36 PST 2013 Added !!midi-transpose:
 // Last Modified: Wed Mar 30 23:12:38 PDT 2016 Added embedded options
 // Last Modified: Mon May 23 21:42:33 PDT 2016 Reversed track numbers
+// Last Modified: Sat Oct 17 22:09:46 PDT 2026 Added --fast
+// Last Modified: Sat Oct 17 23:37:09 PDT 2026 --fast falls back for other options
+// Last Modified: Sun Oct 18 01:05:40 PDT 2026 --fast description
 // Filename:      ...sig/examples/all/hum2mid.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/hum2mid.cpp
 // Syntax:        C++; museinfo
@@ -159,6 +162,8 @@ int     metQ             =   0;    // used with --met option
 int     met2Q            =   0;    // used with --met2 option
 int     tassoQ           =   0;    // used with --tasso option
 int     infoQ            =   0;    // used with --info option
+int     fastQ            =   0;    // used with --fast option
+string  fastconflict;              // used with --fast option
 int     timbresQ         =   0;    // used with --timbres option
 vector<string> TimbreName;         // used with --timbres option
 vector<int> TimbreValue;           // used with --timbres option
@@ -251,6 +256,8 @@ void     checkForBend          (smf::MidiFile& outfile, int notetick, int channe
 void     storeTimbres          (vector<string>& name, vector<int>& value,
                                 vector<int>& volumes, const string& string);
 void     autoPan               (smf::MidiFile& outfile, HumdrumFile& infile);
+void     convertFast           (HumdrumFile& infile);
+string   getFastConflict       (Options& opts);
 
 vector<int> tracknamed;      // for storing boolean if track is named
 vector<int> trackchannel;    // channel of each track
@@ -305,6 +312,14 @@ int main(int argc, char* argv[]) {
 
 		checkEmbeddedOptions(infile, argc, argv);
 
+		if (fastQ && fastconflict.empty()) {
+			convertFast(infile);
+			continue;
+		} else if (fastQ) {
+			cerr << "Warning: --fast cannot be used with the --" << fastconflict
+			     << " option, so it is ignored." << endl;
+		}
+
 		// analyze the input file according to command-line options
 		infile.analyzeRhythm("4", debugQ);
 
@@ -441,6 +456,86 @@ int main(int argc, char* argv[]) {
 
 
 
+//////////////////////////////
+//
+// convertFast -- Convert the file with the HumdrumToMidi library class,
+//     which writes the MIDI data directly in time order.  For the options
+//     which it handles (type 0 files, comments, text, instruments,
+//     padding, channel, fixed volume and transposition) it stores the
+//     same events at the same times as storeMidiData(), in the same
+//     tracks.  The order of note-ons (or of note-offs) at the same time
+//     in a track, such as the notes of a chord, can differ, since
+//     sortTracks() does not compare them with each other, and their order
+//     after it depends on qsort().  If any other conversion option is
+//     given (see getFastConflict()), the regular conversion is used.
+//
+
+void convertFast(HumdrumFile& infile) {
+	HumdrumToMidi converter;
+	converter.setTicksPerQuarterNote(tpq);
+	converter.setComments(storeCommentQ);
+	converter.setText(storeTextQ);
+	converter.setInstruments(instrumentQ);
+	converter.setPadding(padQ);
+	converter.setType0(options.getBoolean("type0"));
+	converter.setTranspose(MidiTranspose);
+	if (fixedChannel >= 0) {
+		converter.setChannel(fixedChannel);
+	}
+	if (fixedvolumeQ) {
+		converter.setFixedVelocity(defaultvolume);
+	}
+
+	infile.analyzeRhythm("4", debugQ);
+	converter.convert(infile);
+
+	if (stdoutQ) {
+		converter.write(cout);
+	} else if ((outlocation == "") || infoQ) {
+		stringstream midistream;
+		converter.write(midistream);
+		smf::MidiFile outfile;
+		outfile.read(midistream);
+		cout << outfile;
+	} else {
+		converter.write(outlocation.c_str());
+	}
+}
+
+
+
+//////////////////////////////
+//
+// getFastConflict -- Returns the name of the first option given which
+//     convertFast() does not handle, or an empty string if all of the
+//     options can be used with --fast.
+//
+
+string getFastConflict(Options& opts) {
+	const char* unsupported[] = {
+		"nodynamics", "showdynamics", "comment", "plus", "time",
+		"time-in-seconds", "dyn", "tempo-scaling", "tempo-spine",
+		"forceinstrument", "min", "rhythmic-scaling", "shorten", "plain",
+		"tasso", "humanvolume", "metricvolume", "sforzando", "no-rest",
+		"fill-pickup", "perfviz", "mark", "bend", "temperament", "monotune",
+		"timbres", "autopan", NULL
+	};
+	for (int i=0; unsupported[i] != NULL; i++) {
+		if (opts.getBoolean(unsupported[i])) {
+			return unsupported[i];
+		}
+	}
+	if (opts.getBoolean("met") && !opts.getBoolean("no-met")) {
+		return "met";
+	}
+	if (opts.getBoolean("met2") && !opts.getBoolean("no-met2")) {
+		return "met2";
+	}
+	return "";
+}
+
+
+
 //////////////////////////////
 //
 // checkEmbeddedOptions --
@@ -1025,6 +1120,7 @@ void defineOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("monotune=s:", "Turn on pitch-bend tuning for monophonic tracks");
 	opts.define("timbres=s",      "Timbral assignments by instrument name");
 	opts.define("autopan=b",      "Pan tracks from left to right");
+	opts.define("fast=b",         "Convert with HumdrumToMidi if only -0CIPTcv/--transpose used");
 
 	opts.define("author=b",  "author of program");
 	opts.define("version=b", "compilation info");
@@ -1164,6 +1260,8 @@ void processOptions(Options& opts, int argc, char* argv[]) {
 	autopanQ      =  opts.getBoolean("autopan");
 	bendQ         =  opts.getBoolean("bend");
 	infoQ         =  opts.getBoolean("info");
+	fastQ         =  opts.getBoolean("fast");
+	fastconflict  =  getFastConflict(opts);
 	rhysc         = opts.getDouble("rhythmic-scaling");
 	if (bendQ) {
 		bendamt    =  opts.getDouble("bend");
@@ -0,0 +1,152 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:41:20 PDT 2026
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026
+// Filename:      ...sig/examples/all/humcache.cpp
+// Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/humcache.cpp
+// Syntax:        C++; museinfo
+//
+// Description:   Write binary .humc caches for Humdrum files, so that
+//                programs reading the files with HumdrumStream can load
+//                them without parsing and analyzing the text again.
+//
+
+#include <iostream>
+#include <string>
+
+#include "humdrum.h"
+
+using namespace std;
+
+
+// function declarations
+void      checkOptions       (Options& opts, int argc, char* argv[]);
+void      example            (void);
+void      usage              (const string& command);
+
+// global variables
+Options   options;            // database for command-line arguments
+int       removeQ  = 0;       // used with -d option
+int       verboseQ = 0;       // used with -v option
+int       rhythmQ  = 1;       // used with -R option
+string    base     = "4";     // used with -r option
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[]) {
+	checkOptions(options, argc, argv);
+	int status = 0;
+	string cachename;
+
+	for (int i=1; i<=options.getArgCount(); i++) {
+		cachename = HumdrumCache::getCacheName(options.getArg(i));
+		if (removeQ) {
+			if ((unlink(cachename.c_str()) == 0) && verboseQ) {
+				cout << "Removed " << cachename << endl;
+			}
+			continue;
+		}
+		if (HumdrumStream::writeCache(options.getArg(i),
+				rhythmQ ? base.c_str() : NULL)) {
+			if (verboseQ) {
+				cout << "Wrote " << cachename << endl;
+			}
+		} else {
+			cerr << "Warning: could not cache " << options.getArg(i) << endl;
+			status = 1;
+		}
+	}
+
+	return status;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// checkOptions -- validate and process command-line options.
+//
+
+void checkOptions(Options& opts, int argc, char* argv[]) {
+	opts.define("r|rhythm=s:4", "rhythm analysis base stored in the cache");
+	opts.define("R|no-rhythm=b", "do not store a rhythm analysis");
+	opts.define("d|delete=b", "remove caches instead of writing them");
+	opts.define("v|verbose=b", "list the caches which are written");
+
+	opts.define("debug=b");                // determine bad input line num
+	opts.define("author=b");               // author of program
+	opts.define("version=b");              // compilation info
+	opts.define("example=b");              // example usages
+	opts.define("h|help=b");               // short description
+	opts.process(argc, argv);
+
+	// handle basic options:
+	if (opts.getBoolean("author")) {
+		cout << "Written by Craig Stuart Sapp, "
+			  << "craig@ccrma.stanford.edu, October 2026" << endl;
+		exit(0);
+	} else if (opts.getBoolean("version")) {
+		cout << argv[0] << ", version: 18 October 2026" << endl;
+		cout << "compiled: " << __DATE__ << endl;
+		cout << MUSEINFO_VERSION << endl;
+		exit(0);
+	} else if (opts.getBoolean("help")) {
+		usage(opts.getCommand());
+		exit(0);
+	} else if (opts.getBoolean("example")) {
+		example();
+		exit(0);
+	}
+
+	base     = opts.getString("rhythm");
+	rhythmQ  = !opts.getBoolean("no-rhythm");
+	removeQ  = opts.getBoolean("delete");
+	verboseQ = opts.getBoolean("verbose");
+}
+
+
+
+//////////////////////////////
+//
+// example -- example usage of the humcache program
+//
+
+void example(void) {
+	cout <<
+	"                                                                         \n"
+	"# cache all files in a directory before running several programs on them:\n"
+	"     humcache *.krn                                                      \n"
+	"                                                                         \n"
+	<< endl;
+}
+
+
+
+//////////////////////////////
+//
+// usage -- gives the usage statement for the humcache program
+//
+
+void usage(const string& command) {
+	cout <<
+	"                                                                         \n"
+	"Writes binary caches (input filename + .humc) of Humdrum files.  Programs\n"
+	"use a cache instead of the original file when the cache is newer than    \n"
+	"the file.                                                                \n"
+	"                                                                         \n"
+	"Usage: " << command << " [-r base | -R] [-d] input1 [input2 ...]\n"
+	"                                                                         \n"
+	"Options:                                                                 \n"
+	"   -r base = rhythm analysis base to store in the cache (default 4)      \n"
+	"   -R      = do not store a rhythm analysis                              \n"
+	"   -d      = delete the caches of the input files                        \n"
+	"   -v      = list the caches which are written                           \n"
+	"   --options = list of all options, aliases and default values           \n"
+	"                                                                         \n"
+	<< endl;
+}
+
+
+
@@ -9,6 +9,7 @@
 // Last Modified: Thu Mar 24 04:22:03 PDT 2011 Fixes for 64-bit compiling.
 // Last Modified: Wed Mar  6 20:35:15 PST 2013 SetKey() was missing?
 // Last Modified: Wed Mar  6 20:35:15 PST 2013 Various changes.
+// Last Modified: Sat Oct 17 22:16:50 PDT 2026 Play with HumdrumPlayer.
 // Filename:      ...sig/doc/examples/all/hplay/hplay.cpp
 // Syntax:        C++
 //
@@ -24,7 +25,7 @@
 #include "synthImprov.h"
 #include "HumdrumFile.h"
 #include "HumdrumStream.h"
-#include "Convert.h"
+#include "HumdrumPlayer.h"
 
 using namespace std;
 
@@ -43,40 +44,40 @@ using namespace std;
 #define COLOR_MARKS          8
 #define COLOR_COMMENT        9
 
-double tempo = 120.0;     // current metronome tempo
-SigTimer timer;           // for playing the humdrum file
-EventBuffer eventBuffer;  // for storing note offs when playing notes
+// sends the MIDI messages of the player to the synthesizer:
+class SynthSink : public HumdrumPlayerSink {
+	public:
+		virtual void send(const unsigned char* data, int size, double time) {
+			if (size == 3) {
+				synth.rawsend(data[0], data[1], data[2]);
+			} else if (size == 2) {
+				synth.rawsend(data[0], data[1]);
+			}
+		}
+};
+
+HumdrumPlayer player;     // plays the notes of the file in a separate thread
+SynthSink synthsink;      // MIDI output for the player
 
 HumdrumStream streamer;   // for inputting multiple Humdrum files/segments
 HumdrumFile data;         // humdrum file to play
-int linenum       = 0;    // for keeping track of current line in file
-double tempoScale = 1.0;  // for global adjustment of tempo
-int velocity      = 64;   // default velocity to play MIDI notes
+int linenum       = 0;    // next line of the file to display
 int echoTextQ     = 1;    // boolean for displaying input file
 int fileNumber    = 1;    // current file number being played
-int pauseQ        = 0;    // pause or unpause the music.
 int colorQ        = 0;    // colorize the display
 int hideQ         = 0;    // hide/show non-kern spines
 int noteonlyQ     = 0;    // hide/show stems and beaming in **kern spines
 int colormode     = 'b';  // w = white background; b = black background
 int tabsize       = 12;   // used with 't' and 'T' real-time commands
-int transpose     = 0;    // used with 'l' and 'L' real-time commands
 vector<int> trackmute;     // used to mute/unmute tracks
 vector<int> markers;       // storage for markers created with space bar
 int markerindex   =  0;   // place to store first marker
 
-int mine          = 30;   // used with the -m option
-int shortenQ      =  0;   // used with the -s option
-int shortenamount = 30;   // used with the -s option
-
 // non-synthImprov function declarations:
 
 void     checkOptions            (void);
 void     inputNewFile            (void);
-void     playdata                (HumdrumFile& data, int& linenum,
-                                  SigTimer& timer);
 void     printInputLine          (HumdrumFile& infile, int line);
-void     processNotes            (HumdrumRecord& record);
 int      getMeasureLine          (HumdrumFile& data, int number);
 ostream& colormessage            (ostream& out, int messagetype, int mode,
                                   int status);
@@ -131,12 +132,9 @@ void description(void) {
 //
 
 void initialization(void) {
+	player.setSink(&synthsink);
 	checkOptions();
-	timer.setPeriod(500);
-	timer.reset();
 	eventIdler.setPeriod(0);
-	eventBuffer.setPollPeriod(10);
-	eventBuffer.setPort(synth.getOutputPort());
 	if (colorQ) {
 		colormessage(cout, COLOR_INIT, colormode, colorQ);
 		colormessage(cout, COLOR_CLEAR_SCREEN, colormode, colorQ);
@@ -162,7 +160,7 @@ void initialization(void) {
 //
 
 void finishup(void) {
-	eventBuffer.off();
+	player.stop();
 	printAllMarkers(cout, markers, data);
 	std::fill(markers.begin(), markers.end(), 0);
 	colormessage(cout, COLOR_RESET, colormode, colorQ);
@@ -174,22 +172,23 @@ void finishup(void) {
 //////////////////////////////
 //
 // mainloopalgorithms -- This function is called continuously while
-//    the programming is running.  It checks to determine whether another
-//    line of the Humdrum file is ready to be played.
+//    the programming is running.  The notes are played by the player
+//    thread, so this function displays the lines which the player has
+//    reached, and loads the next file when the current one is finished.
 //
 
 void mainloopalgorithms(void) {
-	eventBuffer.checkPoll();
-	if (pauseQ) {
-		return;
-	}
-	if (timer.expired()) {
-		playdata(data, linenum, timer);
-		if (linenum >= data.getNumLines()) {
-			printAllMarkers(cout, markers, data);
-			std::fill(markers.begin(), markers.end(), 0);
-			inputNewFile();
+	int line = player.getLine();
+	while (linenum <= line) {
+		if (echoTextQ) {
+			printInputLine(data, linenum);
 		}
+		linenum++;
+	}
+	if (player.isFinished()) {
+		printAllMarkers(cout, markers, data);
+		std::fill(markers.begin(), markers.end(), 0);
+		inputNewFile();
 	}
 }
 
@@ -257,20 +256,23 @@ void keyboardchar(int key) {
 	// case 'k': break;
 		case 'l':               // transpose up specified number of semitones
 			if (number < 100) {
-				transpose = number;
-				cout << "!! Transposing " << transpose << " steps up" << endl;
+				player.setTranspose(number);
+				cout << "!! Transposing " << number << " steps up" << endl;
 			}
 			break;
 		case 'L':               // transpose down specified number of semitones
 			if (number < 100) {
-				transpose = -number;
-				cout << "!! Transposing " << -transpose << " steps down" << endl;
+				player.setTranspose(-number);
+				cout << "!! Transposing " << number << " steps down" << endl;
 			}
 			break;
 		case 'm':               // mute or unmute all tracks
 			if (number == 0) {
 				std::fill(trackmute.begin(), trackmute.end(), 
 						!trackmute[(int)trackmute.size()-1]);
+				for (int i=1; i<=data.getMaxTracks(); i++) {
+					player.setMute(i, trackmute[i]);
+				}
 				if (trackmute[0]) {
 					cout << "!! All spines are muted" << endl;
 				} else {
@@ -279,6 +281,7 @@ void keyboardchar(int key) {
 			} else {
 				int tracknum = getKernTrack(number, data);
 				trackmute[tracknum] = !trackmute[tracknum];
+				player.setMute(tracknum, trackmute[tracknum]);
 				if (trackmute[tracknum]) {
 					cout << "!! **kern spine " << number << " is muted" << endl;
 				} else {
@@ -301,17 +304,16 @@ void keyboardchar(int key) {
 		case 'o':               // set the tempo to a particular value
 			if (number > 20 && number < 601) {
 				cout << "!! TEMPO SET TO " << number << endl;
-				tempo = number;
-				tempoScale = 1.0;
+				player.setTempo(number);
 			} else if (number == 0) {
-				cout << "!! Current tempo: " << tempo * tempoScale << endl;
+				cout << "!! Current tempo: " << player.getTempo() << endl;
 			}
 			break;
 		case 'p':               // toggle music pausing
-			eventBuffer.off();
-			timer.reset();
-			pauseQ = !pauseQ;
-			if (pauseQ) {
+			if (player.isPaused()) {
+				player.resume();
+			} else {
+				player.pause();
 				cout << "!! Paused" << endl;
 			}
 			break;
@@ -327,20 +329,18 @@ void keyboardchar(int key) {
 			if (number == 0) {
 				linenum = markers[0];
 				cout << "!! Going to line " << linenum << endl;
-				eventBuffer.off();
-				timer.reset();
+				player.seek(linenum);
 			} else if (number < (int)markers.size()) {
 				linenum = markers[number];
 				cout << "!! Going to line " << linenum << endl;
-				eventBuffer.off();
-				timer.reset();
+				player.seek(linenum);
 			}
 			break;
 		case 'R':               // Print a list of all markers
 			printAllMarkers(cout, markers, data);
 			break;
 		case 's':    // silence notes
-			eventBuffer.off();
+			player.silence();
 			break;
 		case 't':    // increase tab size
 			tabsize++;
@@ -380,20 +380,20 @@ void keyboardchar(int key) {
 			printMarkLocation(data, linenum == 0 ? 0 : linenum-1, markerindex);
 			break;
 		case ',':    // slow down tempo
-			tempoScale *= 0.97;
-			cout << "!! TEMPO SET TO " << (int)(tempo * tempoScale) << endl;
+			player.setTempoScale(player.getTempoScale() * 0.97);
+			cout << "!! TEMPO SET TO " << (int)player.getTempo() << endl;
 			break;
 		case '<':
-			tempoScale *= 0.93;
-			cout << "!! TEMPO SET TO " << (int)(tempo * tempoScale) << endl;
+			player.setTempoScale(player.getTempoScale() * 0.93);
+			cout << "!! TEMPO SET TO " << (int)player.getTempo() << endl;
 			break;
 		case '.':    // speed up tempo
-			tempoScale *= 1.03;
-			cout << "!! TEMPO SET TO " << (int)(tempo * tempoScale) << endl;
+			player.setTempoScale(player.getTempoScale() * 1.03);
+			cout << "!! TEMPO SET TO " << (int)player.getTempo() << endl;
 			break;
 		case '>':
-			tempoScale *= 1.07;
-			cout << "!! TEMPO SET TO " << (int)(tempo * tempoScale) << endl;
+			player.setTempoScale(player.getTempoScale() * 1.07);
+			cout << "!! TEMPO SET TO " << (int)player.getTempo() << endl;
 			break;
 		case '=':
 			{
@@ -408,8 +408,7 @@ void keyboardchar(int key) {
 						  << " =" << number
 						  << endl;
 					linenum = newline;
-					eventBuffer.off();
-					timer.reset();
+					player.seek(linenum);
 				}
 			}
 			break;
@@ -419,8 +418,7 @@ void keyboardchar(int key) {
 				cout << "!! back " << number << " measure"
 		 << (number==1? "":"s") << endl;
 				linenum = newline;
-				eventBuffer.off();
-				timer.reset();
+				player.seek(linenum);
 			}
 			break;
 		case ')':
@@ -429,33 +427,28 @@ void keyboardchar(int key) {
 				cout << "!! forward " << number << " measure"
 					  << (number==1? "":"s") << endl;
 				linenum = newline;
-				eventBuffer.off();
-				timer.reset();
+				player.seek(linenum);
 			}
 			break;
 		case '+':    // louder
-			velocity++;
-			if (velocity > 127) {
-				velocity = 127;
-			}
-			cout << "!! velocity = " << velocity << endl;
+			player.setVelocity(player.getVelocity() + 1);
+			cout << "!! velocity = " << player.getVelocity() << endl;
 			break;
 
 		case '_':    // sofer
-			velocity--;
-			if (velocity < 1) {
-				velocity = 1;
-			}
-			cout << "!! velocity = " << velocity << endl;
+			player.setVelocity(player.getVelocity() - 1);
+			cout << "!! velocity = " << player.getVelocity() << endl;
 			break;
 
 		case '^':    // go to the start of the file
 			linenum = 0;
+			player.seek(linenum);
 			cout << "!! Going to start of file" << endl;
 			break;
 
 		case '$':    // go to the end of the file
 			linenum = data.getNumLines() - 1;
+			player.seek(linenum);
 			cout << "!! Going to end of file" << endl;
 			break;
 	}
@@ -731,9 +724,9 @@ void checkOptions(void) {
 	options.define("s|shorten=i:30",  "shortening millisecond value for note durations");
 	options.process();
 
-	velocity = options.getInteger("velocity");
-	tempoScale = options.getDouble("tempo-scale");
-	tempo = options.getDouble("tempo");
+	player.setVelocity(options.getInteger("velocity"));
+	player.setTempoScale(options.getDouble("tempo-scale"));
+	player.setDefaultTempo(options.getDouble("tempo"));
 	if (options.getBoolean("quiet")) {
 		echoTextQ = 0;
 	}
@@ -747,12 +740,9 @@ void checkOptions(void) {
 	options.getArgList(list);
 	streamer.setFileList(list);
 
-	mine = options.getInteger("min");
-	if (mine < 0) {
-		mine = 0;
-	}
-	shortenQ = !options.getBoolean("shorten");
-	shortenamount = options.getInteger("shorten");
+	player.setMinimumDuration(options.getInteger("min"));
+	int shortenQ = !options.getBoolean("shorten");
+	player.setShorten(shortenQ ? options.getInteger("shorten") : 0);
 
 	colorQ = !options.getBoolean("color");
 	colormode = options.getString("color").c_str()[0];
@@ -777,58 +767,20 @@ void inputNewFile(void) {
 	}
 
 	data.analyzeRhythm("4");
+	player.load(data);
 
+	// the pause between files is the delay before the first note, so
+	// the keyboard is still read during the pause:
 	if (fileNumber > 1) {
-		millisleep((float)(1000 * options.getDouble("pause")));
+		player.play(options.getDouble("pause"));
+	} else {
+		player.play();
 	}
 	fileNumber++;
 }
 
 
 
-//////////////////////////////
-//
-// playdata -- play the next line of the humdrum file, update the
-//     line number and the time for the next events to be read
-//     from the file.
-//
-
-void playdata(HumdrumFile& data, int& linenum, SigTimer& timer) {
-	double duration = 0;     // duration of the current line;
-
-	if (data.getNumLines() == 0) {
-		// ignore empty files.
-		return;
-	}
-
-	int type = data[linenum].getType();
-
-	while (linenum < data.getNumLines() && duration == 0.0) {
-		duration = data[linenum].getDuration();
-
-		if (type == E_humrec_data) {
-			processNotes(data[linenum]);
-		} else if (type == E_humrec_interpretation) {
-			if (strncmp(data[linenum][0], "*MM", 3) == 0) {
-				tempo = atoi(&data[linenum][0][3]);
-			}
-		}
-		if (echoTextQ) {
-			printInputLine(data, linenum);
-		}
-		if (duration > 0.0) {
-			timer.setPeriod(60000 / tempo / tempoScale * duration);
-			timer.reset();
-		}
-		linenum++;
-		if (linenum < data.getNumLines()) {
-			type = data[linenum].getType();
-		}
-	}
-}
-
-
-
 //////////////////////////////
 //
 // printInputLine -- print the current line of the file,
@@ -1026,95 +978,6 @@ int getKernNoteOnlyLen(char* buffer, const char* ptr) {
 
 
 
-//////////////////////////////
-//
-// processNotes -- play all kern notes in the current record and
-//    return the shortest note duration.  Don't play notes
-//    if they are in a track which is muted.
-//
-
-void processNotes(HumdrumRecord& record) {
-	NoteEvent note;
-	int pitch = 0;
-	double duration = 0.0;
-	int staccatoQ = 0;
-	int accentQ = 0;
-	int sforzandoQ = 0;
-	int i, j;
-	int notecount = 0;
-	char buffer[128] = {0};
-	for (i=0; i<record.getFieldCount(); i++) {
-		if ((record.getPrimaryTrack(i) < (int)trackmute.size())
-				&& trackmute[record.getPrimaryTrack(i)]) {
-			continue;
-		}
-		if (record.getExInterpNum(i) == E_KERN_EXINT) {
-			notecount = record.getTokenCount(i);
-			if (strcmp(record[i], ".") == 0) {
-				continue;
-			}
-			for (j=0; j<notecount; j++) {
-				record.getToken(buffer, i, j);
-				if (strchr(buffer, '[')) {
-					// total tied note durations
-					duration = data.getTiedDuration(linenum, i, j);
-				} else {
-					duration = Convert::kernToDuration(buffer);
-				}
-				pitch = Convert::kernToMidiNoteNumber(buffer);
-				// skip rests
-				if (pitch < 0) {
-					continue;
-				}
-				pitch += transpose;
-				// don't play note which is transposed too extremely
-				if (pitch < 0)   { continue; }
-				if (pitch > 127) { continue; }
-
-				// skip tied notes
-				if (strchr(buffer, '_') || strchr(buffer, ']')) {
-					continue;
-				}
-
-				accentQ    = strchr(buffer, '^')  == NULL? 0 : 1;
-				sforzandoQ = strchr(buffer, 'z')  == NULL? 0 : 1;
-				staccatoQ  = strchr(buffer, '\'') == NULL? 0 : 1;
-				note.setChannel(0);
-				note.setKey(pitch);
-				note.setOnTime(t_time);
-				duration = duration * 60000 / tempo / tempoScale;
-				if (shortenQ) {
-					duration -= shortenamount;
-					if (duration < mine) {
-						duration = mine;
-					}
-				}
-				note.setDur((int)duration);
-				if (staccatoQ) {
-					note.setDur((int)(0.5 * note.getDur()));
-				}
-				note.setKey(pitch);
-				if (accentQ) {
-					velocity *= 1.3;
-				}
-				if (sforzandoQ) {
-					velocity *= 1.5;
-				}
-				if (velocity > 127) {
-					velocity = 127;
-				}
-				note.setVelocity(velocity);
-
-				note.activate();
-				note.action(eventBuffer);
-				eventBuffer.insert(note);
-			}
-		}
-	}
-}
-
-
-
 //////////////////////////////
 //
 // colormessage --
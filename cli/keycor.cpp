@@ -7,6 +7,8 @@
 // Last Modified: Mon Sep 10 15:43:07 PDT 2012 Added enharmonic key labeling
 // Last Modified: Thu Apr 18 13:40:06 PDT 2013 Enabled multiple segment input
 // Last Modified: Sun Apr 21 21:52:30 PDT 2013 Added -e option
+// Last Modified: Sat Oct 17 19:04:14 PDT 2026 Use HumdrumFile::getNoteTable()
+// Last Modified: Sat Oct 17 19:12:08 PDT 2026 Use KeyFinder for --continuous
 // Filename:      ...sig/examples/all/keycordl.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/keycor.cpp
 // Syntax:        C++; museinfo
@@ -45,20 +47,12 @@ void   equalizeData             (double* data, int asize, double summation);
 void   analyzeContinuously      (HumdrumFile& infile, int windowsize,
                                  double stepsize, double* majorKey,
                                  double* minorKey);
-void   loadHistograms           (Array<Array<double> >& histograms,
-                                 HumdrumFile& infile, int segments);
-void   addToHistogramDouble     (Array<Array<double> >& histogram, int pc, 
-                                 double start, double dur, double tdur, 
-				 int segments);
-void   createHistogram          (Array<double>& pitchhist, int start, 
-                                 int count, Array<Array<double> >& segments);
 void   identifyKeyDouble        (Array<double>& histogram, 
                                  Array<double>& correlations,
-                                 double* majorKey, double* minorKey);
+                                 KeyFinder& finder);
 void   printBestKey             (int keynumber);
-double pearsonCorrelation       (int size, double* x, double* y);
 void   printCorrelation         (double value, int style);
-void   printHistogramTotals     (Array<Array<double> >& segments);
+void   printHistogramTotals     (KeyFinder& finder);
 double getConfidence            (Array<double>& cors, int best);
 void   getLocations             (Array<double>& measures, HumdrumFile& infile, 
                                  int segments);
@@ -327,7 +321,6 @@ int main(int argc, char* argv[]) {
 void analyzeContinuously(HumdrumFile& infile, int windowsize,
       double stepsize, double* majorKey, double* minorKey) {
 
-   Array<Array<double> > segments;
    infile.analyzeRhythm("4");
    int segmentCount = int(infile.getTotalDuration() / stepsize + 0.5);
 
@@ -336,21 +329,16 @@ void analyzeContinuously(HumdrumFile& infile, int windowsize,
       return;
    }
 
-   segments.setSize(segmentCount);
-   segments.allowGrowth(0);
-   int i;
-   for (i=0; i<segments.getSize(); i++) {
-      segments[i].setSize(12);
-      segments[i].allowGrowth(0);
-      segments[i].setAll(0);
-   }
-	    
-   loadHistograms(segments, infile, segmentCount);
+   KeyFinder finder(majorKey, minorKey);
+   finder.loadSegments(infile.getNoteTable(), infile.getTotalDuration(),
+         segmentCount);
 
    if (debugQ) {
-      printHistogramTotals(segments);
+      printHistogramTotals(finder);
    }
 
+   int i;
+
    Array<Array<double> > pitchhist; 
    Array<Array<double> > correlations;
 
@@ -366,8 +354,8 @@ void analyzeContinuously(HumdrumFile& infile, int windowsize,
    }
 
    for (i=0; i<segmentCount - windowsize; i++) {
-      createHistogram(pitchhist[i], i, windowsize, segments);
-      identifyKeyDouble(pitchhist[i], correlations[i], majorKey, minorKey);
+      finder.getHistogram(pitchhist[i].getBase(), i, windowsize);
+      identifyKeyDouble(pitchhist[i], correlations[i], finder);
    }
 
 
@@ -490,16 +478,10 @@ double getConfidence(Array<double>& cors, int best) {
 // printHistogramTotals --
 //
 
-void printHistogramTotals(Array<Array<double> >& segments) {
+void printHistogramTotals(KeyFinder& finder) {
    Array<double> sums(12);
    sums.allowGrowth(0);
-   sums.setAll(0);
-   int i, j;
-   for (i=0; i<segments.getSize(); i++) {
-      for (j=0; j<12; j++) {
-         sums[j] += segments[i][j];
-      }
-   }
+   finder.getHistogram(sums.getBase(), 0, finder.getSegmentCount());
 
    cout << "!! C  = " << sums[0]  << endl;
    cout << "!! C# = " << sums[1]  << endl;
@@ -549,43 +531,6 @@ void printCorrelation(double value, int style) {
 
 
 
-//////////////////////////////
-//
-// pearsonCorrelation --
-//
-
-double pearsonCorrelation(int size, double* x, double* y) {
-
-   double sumx  = 0.0;
-   double sumy  = 0.0;
-   double sumco = 0.0;
-   double meanx = x[0];
-   double meany = y[0];
-   double sweep;
-   double deltax;
-   double deltay;
-
-   int i;
-   for (i=2; i<=size; i++) {
-      sweep = (i-1.0) / i;
-      deltax = x[i-1] - meanx;
-      deltay = y[i-1] - meany;
-      sumx  += deltax * deltax * sweep;
-      sumy  += deltay * deltay * sweep;
-      sumco += deltax * deltay * sweep;
-      meanx += deltax / i;
-      meany += deltay / i;
-   }
-
-   double popsdx = sqrt(sumx / size);
-   double popsdy = sqrt(sumy / size);
-   double covxy  = sumco / size;
-
-   return covxy / (popsdx * popsdy);
-}
-
-
-
 //////////////////////////////
 //
 // printBestKey --
@@ -625,161 +570,32 @@ void printBestKey(int keynumber) {
 
 
 
-//////////////////////////////
-//
-// createHistogram --
-//
-
-void createHistogram(Array<double>& pitchhist, int start, int count, 
-   Array<Array<double> >& segments) {
-
-   pitchhist.setAll(0);
-   int i, j;
-   for (i=0; i<count; i++) {
-      for (j=0; j<12; j++) {
-         pitchhist[j] += segments[i+start][j];
-      }
-   }
-}
-
-
-
 ////////////////////////////////////////
 //
 // identifyKeyDouble --
 //
 
 void identifyKeyDouble(Array<double>& histogram, Array<double>& correlations,
-   double* majorKey, double* minorKey) {
+   KeyFinder& finder) {
    int i;
 
-   double h[24];
-   for (i=0; i<12; i++) {
-      h[i] = histogram[i];
-      h[i+12] = h[i];
-   }
-
    double testsum = 0.0;
    for (i=0; i<12; i++) {
-      testsum += h[i];
-      correlations[i]    = pearsonCorrelation(12, majorKey, h+i);
-      correlations[i+12] = pearsonCorrelation(12, minorKey, h+i);
+      testsum += histogram[i];
    }
 
+   int besti = finder.correlate(correlations.getBase(), histogram.getBase());
+
    if (testsum == 0.0) {
       histogram[12] = 24;  // empty histogram, so going to display black
       return;
    }
 
-   // find max value
-   int besti = 0;
-   double bestsum = correlations[0];
-   for (i=1; i<24; i++) {
-      if (correlations[i] > bestsum) {
-         besti = i;
-         bestsum = correlations[i];
-      }
-   }
-
    histogram[12] = besti;
 }
 
 
 
-//////////////////////////////
-//
-// loadHistograms --
-//
-
-void loadHistograms(Array<Array<double> >& histograms,
-   HumdrumFile& infile, int segments) {
-
-   infile.analyzeRhythm("4");
-   double totalduration = infile.getTotalDuration();
-
-   double duration;
-   int i;
-   int j;
-   int k;
-   char buffer[10000] = {0};
-   int pitch;
-   double start;
-   int tokencount;
-   for (i=0; i<infile.getNumLines(); i++) {
-      if (infile[i].getType() !=  E_humrec_data) {
-         continue;
-      }
-      start = infile[i].getAbsBeat();
-      for (j=0; j<infile[i].getFieldCount(); j++) {
-         if (strcmp(infile[i].getExInterp(j), "**kern") != 0) {
-            continue;
-         }
-         if (strcmp(infile[i][j], ".") == 0) {
-            continue; // ignore null tokens
-         }
-         tokencount = infile[i].getTokenCount(j);
-         for (k=0; k<tokencount; k++) {
-            infile[i].getToken(buffer, j, k);
-            if (strcmp(buffer, ".") == 0) {
-               continue;  // ignore illegal inline null tokens
-            }
-            pitch = Convert::kernToMidiNoteNumber(buffer);
-            if (pitch < 0) {
-               continue;  // ignore rests or strange objects
-            }
-            pitch = pitch % 12;  // convert to chromatic pitch-class
-            duration = Convert::kernToDuration(buffer);
-            if (duration <= 0.0) {
-               continue;   // ignore grace notes and strange objects
-            }
-            
-            addToHistogramDouble(histograms, pitch,
-                  start, duration, totalduration, segments);
-         }
-      }
-   }
-}
-
-
-
-//////////////////////////////
-//
-// addToHistogramDouble -- fill the histogram in the right spots.
-//
-
-void addToHistogramDouble(Array<Array<double> >& histogram, int pc, 
-      double start, double dur, double tdur, int segments) {
-
-   pc = pc % 12;
-
-   double startseg = start / tdur * segments;
-   double startfrac = startseg - (int)startseg;
-
-   double segdur = dur / tdur * segments;
-
-   if (segdur <= 1.0 - startfrac) {
-      histogram[(int)startseg][pc] += segdur;
-      return;
-   } else if (1.0 - startfrac > 0.0) {
-      histogram[(int)startseg][pc] += (1.0 - startfrac);
-      segdur -= (1.0 - startfrac);
-   }
-
-   int i = (int)(startseg + 1);
-   while (segdur > 0.0 && i < histogram.getSize()) {
-      if (segdur < 1.0) {
-         histogram[i][pc] += segdur;
-         segdur = 0.0;
-      } else {
-         histogram[i][pc] += 1.0;
-         segdur -= 1.0;
-      }
-      i++;
-   }
-}
-
-
-
 //////////////////////////////
 //
 // printAnalysis -- 
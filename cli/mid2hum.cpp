@@ -3,6 +3,7 @@
 // Creation Date: Fri Mar  5 22:49:55 PST 2004
 // Last Modified: Sat Mar  6 11:28:05 PST 2004
 // Last Modified: Thu Jan  6 03:41:05 PST 2011 (fixed array out-of-bounds err)
+// Last Modified: Sat Oct 17 22:24:23 PDT 2026 (read with MidiFileReader)
 // Filename:      ...sig/examples/all/mid2hum.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/mid2hum.cpp
 // Syntax:        C++; museinfo
@@ -50,6 +51,7 @@
 #include <vector>
 
 #include "MidiFile.h"
+#include "MidiFileReader.h"
 #include "Options.h"
 #include "Convert.h"
 #include "HumdrumFile.h"
@@ -102,18 +104,18 @@ double  timesigtop = 4.0;    // used to print barlines
 double  timesigbottom = 4.0; // used to print barlines
 
 // function declarations:
-void      convertToHumdrum  (smf::MidiFile& midifile);
+void      convertToHumdrum  (MidiFileReader& midifile);
 void      getMidiData       (vector<vector<MidiInfo> >& mididata,
-                             smf::MidiFile& midifile);
+                             MidiFileReader& midifile);
 void      storenote         (MidiInfo& info, vector<vector<MidiInfo> >& mididata,
                              int i, int currtick);
 void      printKernData     (vector<vector<MidiInfo> >& mididata,
-                             smf::MidiFile& midifile, vector<MetaInfo>& metadata);
+                             MidiFileReader& midifile, vector<MetaInfo>& metadata);
 void      identifyChords    (vector<vector<MidiInfo> >& mididata);
 void      correctdurations  (vector<vector<MidiInfo> >& mididata, int tpq);
 int       MidiInfoCompare   (const void* a, const void* b);
 void      printRestCorrection (ostream& out, int restcorr, int tqp);
-void      processMetaMessage(smf::MidiFile& midifile, int track, int event,
+void      processMetaMessage(const MidiFileEvent& event,
                              vector<MetaInfo>& metadata);
 void      printMetaData     (ostream& out, vector<MetaInfo>& metadata,
                              int metaindex);
@@ -128,7 +130,17 @@ void      usage             (const char* command);
 
 int main(int argc, char* argv[]) {
 	checkOptions(options, argc, argv);
-	smf::MidiFile midifile(options.getArg(1));
+	MidiFileReader midifile;
+	if (!midifile.open(options.getArg(1))) {
+		// not a Standard MIDI File (such as binasc data), so read it with
+		// the midifile library and convert it to a Standard MIDI File.
+		smf::MidiFile smffile(options.getArg(1));
+		if (smffile.status()) {
+			stringstream binary;
+			smffile.write(binary);
+			midifile.read(binary);
+		}
+	}
 	convertToHumdrum(midifile);
 
 	return 0;
@@ -142,11 +154,11 @@ int main(int argc, char* argv[]) {
 // convertToHumdrum -- convert a MIDI file into Humdrum format.
 //
 
-void convertToHumdrum(smf::MidiFile& midifile) {
+void convertToHumdrum(MidiFileReader& midifile) {
 	int ticksperquarter = midifile.getTicksPerQuarterNote();
 	cout << "!! Converted from MIDI with mid2hum" << endl;
 	cout << "!! Ticks Per Quarter Note = " << ticksperquarter << endl;
-	cout << "!! Track count: " << midifile.getNumTracks() << endl;
+	cout << "!! Track count: " << midifile.getTrackCount() << endl;
 	vector<vector<MidiInfo> > mididata;
 	getMidiData(mididata, midifile);
 }
@@ -178,8 +190,8 @@ void storenote(MidiInfo& info, vector<vector<MidiInfo> >& mididata,
 // getMidiData --
 //
 
-void getMidiData(vector<vector<MidiInfo> >& mididata, smf::MidiFile& midifile) {
-	mididata.resize(midifile.getNumTracks());
+void getMidiData(vector<vector<MidiInfo> >& mididata, MidiFileReader& midifile) {
+	mididata.resize(midifile.getTrackCount());
 	for  (int i=0; i<(int)mididata.size(); i++) {
 		mididata[i].reserve(10000);
 		mididata[i].resize(0);
@@ -189,38 +201,37 @@ void getMidiData(vector<vector<MidiInfo> >& mididata, smf::MidiFile& midifile) {
 	metadata.reserve(1000);
 	metadata.resize(0);
 
-	vector<vector<MidiInfo> > notestates(midifile.getNumTracks());
+	vector<vector<MidiInfo> > notestates(midifile.getTrackCount());
 	for (int i=0; i<(int)notestates.size(); i++) {
 		notestates[i].resize(128);
 	}
 
 	// extract a list of notes in the MIDI file along with their durations
+	// (the events are decoded directly from the file, one at a time)
 	int k;
-	for (int i=0; i<midifile.getNumTracks(); i++) {
-		for (int j=0; j<midifile.getNumEvents(i); j++) {
-			if (((midifile.getEvent(i, j)[0] & 0xf0) == 0x90) &&
-				 (midifile.getEvent(i, j)[2] > 0) ) {
+	MidiFileEvent event;
+	for (int i=0; i<midifile.getTrackCount(); i++) {
+		midifile.rewind(i);
+		for (int j=0; midifile.next(event); j++) {
+			if (((event[0] & 0xf0) == 0x90) && (event[2] > 0) ) {
 				// a note-on message. Store the state
-				k = midifile.getEvent(i, j)[1];
+				k = event[1];
 				if (notestates[i][k].state == 1) {
-					storenote(notestates[i][k], mididata, i,
-							midifile.getEvent(i, j).tick);
+					storenote(notestates[i][k], mididata, i, event.tick);
 				}
 				notestates[i][k].track = i;
 				notestates[i][k].key = k;
 				notestates[i][k].state = 1;
 				notestates[i][k].index = j;
-				notestates[i][k].starttick = midifile.getEvent(i, j).tick;
+				notestates[i][k].starttick = event.tick;
 				notestates[i][k].tickdur = -1;
-			} else if (((midifile.getEvent(i, j)[0] & 0xf0) == 0x80) ||
-				 (((midifile.getEvent(i, j)[0] & 0xf0) == 0x90) &&
-				 (midifile.getEvent(i, j)[2] == 0)) ) {
+			} else if (((event[0] & 0xf0) == 0x80) ||
+				 (((event[0] & 0xf0) == 0x90) && (event[2] == 0)) ) {
 				// a note-off message.  Print the previous stored note-on message
-				k = midifile.getEvent(i, j)[1];
-				storenote(notestates[i][k], mididata, i,
-						midifile.getEvent(i, j).tick);
+				k = event[1];
+				storenote(notestates[i][k], mididata, i, event.tick);
 			} else {
-				processMetaMessage(midifile, i, j, metadata);
+				processMetaMessage(event, metadata);
 			}
 		}
 	}
@@ -231,7 +242,7 @@ void getMidiData(vector<vector<MidiInfo> >& mididata, smf::MidiFile& midifile) {
 		cout << "Track " << i << endl;
 		for (j=0; j<(int)mididata[i].size(); j++) {
 			cout << "\tNote: pitch = "
-				  << (int)midifile.getEvent(i, mididata[i][j].index)[1]
+				  << mididata[i][j].key
 				  << "\tduration = "
 				  << (double)mididata[i][j].tickdur/midifile.getTicksPerQuarterNote()
 				  << endl;
@@ -256,11 +267,11 @@ void getMidiData(vector<vector<MidiInfo> >& mididata, smf::MidiFile& midifile) {
 // processMetaMessage --
 //
 
-void processMetaMessage(smf::MidiFile& midifile, int track, int event,
+void processMetaMessage(const MidiFileEvent& event,
 		vector<MetaInfo>& metadata) {
 	MetaInfo tempmeta;
-	tempmeta.type = midifile.getEvent(track, event)[1];
-	tempmeta.starttick = midifile.getEvent(track, event).tick;
+	tempmeta.type = event[1];
+	tempmeta.starttick = event.tick;
 	int tempo = 0;
 	int d;  // counter into data field of meta message
 	switch (tempmeta.type) {
@@ -277,16 +288,16 @@ void processMetaMessage(smf::MidiFile& midifile, int track, int event,
 		case 0x05:   // lyric
 			break;
 		case 0x06:   // marker
-			tempmeta.tsize = (unsigned char)midifile.getEvent(track, event)[2];
+			tempmeta.tsize = (unsigned char)event[2];
 			for (d=0; d<tempmeta.tsize; d++) {
-				tempmeta.text[d] = midifile.getEvent(track, event)[3+d];
+				tempmeta.text[d] = event[3+d];
 			}
 			tempmeta.text[tempmeta.tsize] = '\0';
 			break;
 		case 0x07:   // cue point
-			tempmeta.tsize = (unsigned char)midifile.getEvent(track, event)[2];
+			tempmeta.tsize = (unsigned char)event[2];
 			for (d=0; d<tempmeta.tsize; d++) {
-				tempmeta.text[d] = midifile.getEvent(track, event)[3+d];
+				tempmeta.text[d] = event[3+d];
 			}
 			tempmeta.text[tempmeta.tsize] = '\0';
 			break;
@@ -300,19 +311,19 @@ void processMetaMessage(smf::MidiFile& midifile, int track, int event,
 		case 0x7F:   // sequencer-specific meta event
 			break;
 		case 0x51:   // tempo marking
-			tempo = midifile.getEvent(track, event)[3];
-			tempo = (tempo << 8) | midifile.getEvent(track, event)[4];
-			tempo = (tempo << 8) | midifile.getEvent(track, event)[5];
+			tempo = event[3];
+			tempo = (tempo << 8) | event[4];
+			tempo = (tempo << 8) | event[5];
 			tempmeta.tempo = (int)(60.0/tempo*1000000.0 + 0.5);
 			break;
 		case 0x58:   // time signature
-			tempmeta.numerator   = midifile.getEvent(track, event)[3];
+			tempmeta.numerator   = event[3];
 			tempmeta.denominator = (int)pow(2.0,
-					midifile.getEvent(track, event)[4]);
+					event[4]);
 			break;
 		case 0x59:   // key signature
-			tempmeta.keysig = midifile.getEvent(track, event)[3];
-			tempmeta.mode   = midifile.getEvent(track, event)[4];
+			tempmeta.keysig = event[3];
+			tempmeta.mode   = event[4];
 	}
 
 	metadata.push_back(tempmeta);
@@ -431,7 +442,7 @@ int MidiInfoCompare(const void* a, const void* b) {
 // printKernData --
 //
 
-void printKernData(vector<vector<MidiInfo> >& mididata, smf::MidiFile& midifile,
+void printKernData(vector<vector<MidiInfo> >& mididata, MidiFileReader& midifile,
 		vector<MetaInfo>& metadata) {
 	vector<int> kerntrack(mididata.size());
 	for (int i=0; i<(int)mididata.size(); i++) {
@@ -7,6 +7,9 @@
 // Last Modified: Sun May  1 10:32:02 PDT 2011 secondary key display
 // Last Modified: Wed Nov  9 17:34:49 PST 2011 fixed some irritating problems
 // Last Modified: Sun Oct 21 15:33:59 PDT 2012 added -k option
+// Last Modified: Sat Oct 17 19:15:33 PDT 2026 contiguous triangle, --threads
+// Last Modified: Sat Oct 17 22:24:23 PDT 2026 read MIDI with MidiFileReader
+// Last Modified: Sat Oct 17 23:44:05 PDT 2026 added --progressive previews
 //
 // Filename:      ...sig/examples/all/mkeyscape.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/mkeyscape.cpp
@@ -22,48 +25,121 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <string>
+#include <thread>
+#include <atomic>
+#include <utility>
 
 #include "humdrum.h"
 #include "MidiFile.h"
 
 #define HISTTYPE double
 
+#define CELLSIZE   14  /* 12 pitch classes, best key, second-best key */
+#define CELLSTRIDE 16  /* storage for each cell: two 64-byte cache lines */
+
 #define UNKNOWNFILE 0
 #define HUMDRUMFILE 1
 #define MIDIFILE    2
 
+
+//////////////////////////////
+//
+// KeyscapeRow -- one row of the keyscape triangle.  Each cell contains
+//    CELLSIZE values: indexes 0-11 are the pitch-class histogram for the
+//    cell, index 12 is for the best key result, and index 13 is for the
+//    second-best key result.
+//
+
+class KeyscapeRow {
+	public:
+		KeyscapeRow(HISTTYPE* rowdata, int cellcount) :
+				data(rowdata), count(cellcount) { }
+		HISTTYPE* operator[](int index) const {
+				return data + (size_t)index * CELLSTRIDE; }
+		int size(void) const { return count; }
+
+	protected:
+		HISTTYPE* data;
+		int       count;
+};
+
+
+//////////////////////////////
+//
+// KeyscapeTriangle -- All cells of the keyscape stored in one block
+//    of memory: row i has i+1 cells, with the top row (index 0) being the
+//    analysis of the entire piece, and the bottom row containing the
+//    histograms of the individual segments.  The block starts on a
+//    cache-line boundary, and cells are padded to a multiple of the cache
+//    line size so that threads working on different rows do not write
+//    to the same cache lines.
+//
+
+class KeyscapeTriangle {
+	public:
+		KeyscapeTriangle(void) : rows(0), base(NULL) { }
+		void resize(int rowcount) {
+				rows = rowcount;
+				size_t cells = (size_t)rows * (rows + 1) / 2;
+				storage.assign(cells * CELLSTRIDE + 8, 0);
+				base = storage.data();
+				while (((size_t)base & 63) != 0) {
+					base++;
+				}
+		}
+		int size(void) const { return rows; }
+		KeyscapeRow operator[](int index) const {
+				return KeyscapeRow(base + (size_t)index * (index + 1) / 2 *
+						CELLSTRIDE, index + 1); }
+
+	protected:
+		int              rows;
+		vector<HISTTYPE> storage;
+		HISTTYPE*        base;      // first cell of the triangle
+};
+
+
 // function declarations:
 void     checkOptions           (Options& opts, int argc, char** argv);
 void     example                (void);
 void     usage                  (const char* command);
 double   loadHistogramFromHumdrumFile
-                                (vector<vector<HISTTYPE> >& histogram,
+                                (KeyscapeRow histogram,
                                  HumdrumFile& infile,
                                  const char* filename, int segments);
 double   loadHistogramFromMidiFile
-                                (vector<vector<HISTTYPE> >& histogram,
+                                (KeyscapeRow histogram,
                                  const char* filename, int segments);
-void     printBaseHistogram     (vector<vector<HISTTYPE> >& histogram);
+void     printBaseHistogram     (KeyscapeRow histogram);
 void     printBaseHistogramHumdrumStyle
-                                (vector<vector<HISTTYPE> >& histogram,
+                                (KeyscapeRow histogram,
                                  double width);
-void     printNormalizedHistogram(vector<vector<HISTTYPE> >& histogram);
+void     printNormalizedHistogram(KeyscapeRow histogram);
 void     addToHistogramInteger  (vector<vector<int> >& histogram, int pc,
                                  double start, double dur, double tdur,
                                  int segments);
-void     addToHistogramDouble   (vector<vector<double> >& histogram, int pc,
+void     addToHistogramDouble   (KeyscapeRow histogram, int pc,
                                  double start, double dur, double tdur,
                                  int segments);
-void     fillAllHistograms      (vector<vector<vector<HISTTYPE> > >& histograms);
-void     printBest              (vector<vector<vector<HISTTYPE> > >& histogram);
-void     calculateBestKeys      (vector<vector<vector<HISTTYPE> > >& histograms);
-void     identifyKey            (vector<HISTTYPE>& histogram);
-void     displayRawAnalysis     (vector<vector<vector<HISTTYPE> > >& histogram);
-void     displayAnalysisHistogram(vector<vector<vector<HISTTYPE> > >& histograms);
-void     identifyKeyDouble      (vector<HISTTYPE>& histogram);
-void     printPPM               (vector<vector<vector<HISTTYPE> > >& histograms,
+void     fillAllHistograms      (KeyscapeTriangle& histograms);
+void     printBest              (KeyscapeTriangle& histogram);
+void     calculateBestKeys      (KeyscapeTriangle& histograms,
+                                 HumdrumFile& infile);
+void     calculateRows          (KeyscapeTriangle* histograms,
+                                 vector<int>* rowlist, int stop,
+                                 std::atomic<int>* nextblock);
+void     writePreview           (KeyscapeTriangle& histograms,
+                                 HumdrumFile& infile, int pass);
+void     fillCoarseRows         (KeyscapeTriangle& histograms,
+                                 vector<char>& calculated);
+void     identifyKey            (HISTTYPE* histogram);
+void     displayRawAnalysis     (KeyscapeTriangle& histogram);
+void     displayAnalysisHistogram(KeyscapeTriangle& histograms);
+void     identifyKeyDouble      (HISTTYPE* histogram);
+void     printPPM               (KeyscapeTriangle& histograms,
                                  HumdrumFile& infile);
 double   pearsonCorrelation     (int size, double* x, double* y);
 void     setFilterOptions       (vector<int>& channelfilter,
@@ -84,21 +160,21 @@ void     processWeights         (const char* filename, vector<HISTTYPE>& major,
                                  vector<HISTTYPE>& minor);
 void     printColorMap          (vector<const char*>& colorindex);
 void     printWeights           (vector<HISTTYPE>& maj, vector<HISTTYPE>& min);
-void     printKeyAnalysisCorr   (vector<vector<vector<HISTTYPE> > >& histograms,
+void     printKeyAnalysisCorr   (KeyscapeTriangle& histograms,
                                  int level);
-void     printKeyCorrelations   (vector<HISTTYPE>& histogram);
+void     printKeyCorrelations   (HISTTYPE* histogram);
 void     changeColorMapping     (vector<const char*>& ci, const char* type);
 void     fillColorMapping_castel(vector<const char*>& ci);
 void     fillColorMapping_newton(vector<const char*>& ci);
-void     doBlankAnalysis        (vector<vector<vector<HISTTYPE> > >& histograms);
+void     doBlankAnalysis        (KeyscapeTriangle& histograms);
 void     recurseMarkMask        (vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& hist,
+                                 KeyscapeTriangle& hist,
                                  int starti, int startj, int mcounter);
-void     doFillBlanks           (vector<vector<vector<HISTTYPE> > >& histograms,
+void     doFillBlanks           (KeyscapeTriangle& histograms,
                                  vector<vector<int> >& mask);
 void     fillBoundedArea        (double target, int regionid, int line,
                                  int col, vector<vector<int> >& mask,
-                                 vector<vector<vector<double> > >& histograms);
+                                 KeyscapeTriangle& histograms);
 int      isBounded              (int target, int line, int col,
                                  vector<string>& tm,
                                  vector<vector<int> >& mask);
@@ -108,16 +184,16 @@ void     printNumbers           (HumdrumFile& infile, int numberheight,
                                  int numberwidth);
 double   getMeasureSize         (HumdrumFile& infile, int width);
 void     doTrim                 (vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& histograms);
+                                 KeyscapeTriangle& histograms);
 void     trimRegion             (int start, int end, vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& histograms,
+                                 KeyscapeTriangle& histograms,
                                  int color);
 void     doRegionID             (vector<vector<int> >& mask,
-                                 vector<vector<vector<HISTTYPE> > >& histograms);
-void     fillSurroundedBlanks   (vector<vector<vector<HISTTYPE> > >& histograms,
+                                 KeyscapeTriangle& histograms);
+void     fillSurroundedBlanks   (KeyscapeTriangle& histograms,
                                  vector<vector<int> >& mask,
                                  vector<int> blanksonrow);
-void     trimEdges              (vector<vector<vector<HISTTYPE> > >& histograms);
+void     trimEdges              (KeyscapeTriangle& histograms);
 int      hasdigit               (const char* strang);
 
 // User interface variables:
@@ -140,6 +216,9 @@ int       averageQ     = 0;     // used with --average option
 int       maxQ         = 0;     // used with --max option
 int       secondQ      = 0;     // used with --second option
 int       keyQ         = 0;     // used with -k option
+int       threadcount  = 1;     // used with --threads option
+int       coarse       = 1;     // used with --coarse option
+string    progressive;          // used with --progressive option
 
 vector<int> channelfilter;       // used with -x option
 vector<const char*> colorindex;  // used with -c option
@@ -239,16 +318,8 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 	// process the command-line options
 	checkOptions(options, argc, argv);
 
-	vector<vector<vector<HISTTYPE> > > histograms;
+	KeyscapeTriangle histograms;
 	histograms.resize(segments);
-	for (int i=0; i<segments; i++) {
-		histograms[i].resize(i+1);
-		for (int j=0; j<i+1; j++) {
-			histograms[i][j].resize(14);   // index 12 is for best key result
-									              // index 13 for second best key result
-			std::fill(histograms[i][j].begin(), histograms[i][j].end(), 0);
-		}
-	}
 
 	HumdrumFile infile;
 	double totalduration = 0;
@@ -299,7 +370,7 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 	//identifyKey(histograms[0][0]);
 	//exit(0);
 
-	calculateBestKeys(histograms);
+	calculateBestKeys(histograms, infile);
 
 	if (blankQ) {
 		doBlankAnalysis(histograms);
@@ -328,7 +399,7 @@ fillWeightsWithBellmanBudge(majorweights, minorweights);
 // doBlankAnalysis -- remove non-plausible key analysis regions.
 //
 
-void doBlankAnalysis(vector<vector<vector<HISTTYPE> > >& histograms) {
+void doBlankAnalysis(KeyscapeTriangle& histograms) {
 
 	vector<vector<int> > mask;
 	doRegionID(mask, histograms);
@@ -355,7 +426,7 @@ void doBlankAnalysis(vector<vector<vector<HISTTYPE> > >& histograms) {
 //
 
 void doRegionID(vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& histograms) {
+		KeyscapeTriangle& histograms) {
 
 	mask.resize(histograms.size());
 	int mcounter = 1;
@@ -406,7 +477,7 @@ void doRegionID(vector<vector<int> >& mask,
 // doFillBlanks --
 //
 
-void doFillBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
+void doFillBlanks(KeyscapeTriangle& histograms,
 		vector<vector<int> >& mask) {
 
 	int blankcount;
@@ -602,7 +673,7 @@ void doFillBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
 // fillSurroundedBlanks --
 //
 
-void fillSurroundedBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
+void fillSurroundedBlanks(KeyscapeTriangle& histograms,
 		vector<vector<int> >& mask, vector<int> blanksonrow) {
 
 	// Examine blank spots to see if they are completely
@@ -654,7 +725,7 @@ void fillSurroundedBlanks(vector<vector<vector<HISTTYPE> > >& histograms,
 //
 
 void doTrim(vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& histograms) {
+		KeyscapeTriangle& histograms) {
 
 	int i, j;
 	int bottom = (int)mask.size()-1;
@@ -684,7 +755,7 @@ void doTrim(vector<vector<int> >& mask,
 //   which touch the leading and trailing edge of the plot.
 //
 
-void trimEdges(vector<vector<vector<HISTTYPE> > >& histograms) {
+void trimEdges(KeyscapeTriangle& histograms) {
 	int i, j;
 	int target = int(histograms[0][0][12]+0.1);
 	int state = -1;
@@ -701,7 +772,7 @@ void trimEdges(vector<vector<vector<HISTTYPE> > >& histograms) {
 	}
 
 	state = -1;
-	vector<vector<vector<HISTTYPE> > >& h = histograms;
+	KeyscapeTriangle& h = histograms;
 
 	for (i=0; i<(int)histograms.size()-limiter; i++) {
 		if ((state < 0) && ((int)histograms[i][h[i].size()-1][12] != target)) {
@@ -793,7 +864,7 @@ void trimEdges(vector<vector<vector<HISTTYPE> > >& histograms) {
 //
 
 void trimRegion(int start, int end, vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& histograms, int color) {
+		KeyscapeTriangle& histograms, int color) {
 	double trimratio = 1.1;
 
 //color = 24;
@@ -936,7 +1007,7 @@ int isValidCell(int line, int col, vector<vector<int> >& mask) {
 //
 
 void fillBoundedArea(double target, int regionid, int line, int col,
-		vector<vector<int> >& mask, vector<vector<vector<double> > >& histograms) {
+		vector<vector<int> >& mask, KeyscapeTriangle& histograms) {
 	if ((line < 0) || (line > (int)mask.size()-1)) {
 		return;  // out of bounds.
 	}
@@ -966,66 +1037,67 @@ void fillBoundedArea(double target, int regionid, int line, int col,
 //
 
 void recurseMarkMask(vector<vector<int> >& mask,
-		vector<vector<vector<HISTTYPE> > >& hist, int starti, int startj,
+		KeyscapeTriangle& hist, int starti, int startj,
 		int mcounter) {
-	// check above
-	if (starti > 0) {
-		// check above-right
-		if (startj < (int)hist[starti-1].size()) {
-			if (hist[starti][startj][12] == hist[starti-1][startj][12]) {
-				if (mask[starti-1][startj] == 0) {
-					mask[starti-1][startj] = mcounter;
-					recurseMarkMask(mask, hist, starti-1, startj, mcounter);
+	// Cells to visit are kept on a list rather than on the call stack,
+	// since regions in large plots can contain millions of cells.
+	vector<pair<int, int> > pending;
+	pending.push_back(make_pair(starti, startj));
+	HISTTYPE key;
+	int i, j;
+	while (!pending.empty()) {
+		i = pending.back().first;
+		j = pending.back().second;
+		pending.pop_back();
+		key = hist[i][j][12];
+
+		// check above
+		if (i > 0) {
+			// check above-right
+			if (j < (int)hist[i-1].size()) {
+				if ((key == hist[i-1][j][12]) && (mask[i-1][j] == 0)) {
+					mask[i-1][j] = mcounter;
+					pending.push_back(make_pair(i-1, j));
 				}
 			}
-		}
 
-		// check above-left
-		if (startj-1 >= 0) {
-			if (hist[starti][startj][12] == hist[starti-1][startj-1][12]) {
-				if (mask[starti-1][startj-1] == 0) {
-					mask[starti-1][startj-1] = mcounter;
-					recurseMarkMask(mask, hist, starti-1, startj-1, mcounter);
+			// check above-left
+			if (j-1 >= 0) {
+				if ((key == hist[i-1][j-1][12]) && (mask[i-1][j-1] == 0)) {
+					mask[i-1][j-1] = mcounter;
+					pending.push_back(make_pair(i-1, j-1));
 				}
 			}
 		}
-	}
 
-	// check left
-	if (startj > 0) {
-		if (hist[starti][startj][12] == hist[starti][startj-1][12]) {
-			if (mask[starti][startj-1] == 0) {
-				mask[starti][startj-1] = mcounter;
-				recurseMarkMask(mask, hist, starti, startj-1, mcounter);
+		// check left
+		if (j > 0) {
+			if ((key == hist[i][j-1][12]) && (mask[i][j-1] == 0)) {
+				mask[i][j-1] = mcounter;
+				pending.push_back(make_pair(i, j-1));
 			}
 		}
-	}
-	// check right
-	if (startj < (int)hist[starti].size()-1) {
-		if (hist[starti][startj][12] == hist[starti][startj+1][12]) {
-			if (mask[starti][startj+1] == 0) {
-				mask[starti][startj+1] = mcounter;
-				recurseMarkMask(mask, hist, starti, startj+1, mcounter);
+		// check right
+		if (j < (int)hist[i].size()-1) {
+			if ((key == hist[i][j+1][12]) && (mask[i][j+1] == 0)) {
+				mask[i][j+1] = mcounter;
+				pending.push_back(make_pair(i, j+1));
 			}
 		}
-	}
 
-	// check below
-	if (starti < (int)mask.size()-1) {  // don't check bottom row
-		// check below-left
-		if (hist[starti][startj][12] == hist[starti+1][startj][12]) {
-			if (mask[starti+1][startj] == 0) {
-				mask[starti+1][startj] = mcounter;
-				recurseMarkMask(mask, hist, starti+1, startj, mcounter);
+		// check below
+		if (i < (int)mask.size()-1) {  // don't check bottom row
+			// check below-left
+			if ((key == hist[i+1][j][12]) && (mask[i+1][j] == 0)) {
+				mask[i+1][j] = mcounter;
+				pending.push_back(make_pair(i+1, j));
 			}
-		}
 
-		// check below-right
-		if (startj < (int)hist[starti].size()) {
-			if (hist[starti][startj][12] == hist[starti+1][startj+1][12]) {
-				if (mask[starti+1][startj+1] == 0) {
-					mask[starti+1][startj+1] = mcounter;
-					recurseMarkMask(mask, hist, starti+1, startj+1, mcounter);
+			// check below-right
+			if (j < (int)hist[i].size()) {
+				if ((key == hist[i+1][j+1][12]) && (mask[i+1][j+1] == 0)) {
+					mask[i+1][j+1] = mcounter;
+					pending.push_back(make_pair(i+1, j+1));
 				}
 			}
 		}
@@ -1040,7 +1112,7 @@ void recurseMarkMask(vector<vector<int> >& mask,
 //   level of analysis.
 //
 
-void printKeyAnalysisCorr(vector<vector<vector<HISTTYPE> > >& histograms,
+void printKeyAnalysisCorr(KeyscapeTriangle& histograms,
 		int level) {
 	int i;
 
@@ -1112,7 +1184,7 @@ void printKeyAnalysisCorr(vector<vector<vector<HISTTYPE> > >& histograms,
 // printKeyCorrelations --
 //
 
-void printKeyCorrelations(vector<HISTTYPE>& histogram) {
+void printKeyCorrelations(HISTTYPE* histogram) {
 	int i;
 
 	double h[24];
@@ -1244,7 +1316,7 @@ void printColorMap(vector<const char*>& ci) {
 // printPPM --
 //
 
-void printPPM(vector<vector<vector<HISTTYPE> > >& histograms,
+void printPPM(KeyscapeTriangle& histograms,
 		HumdrumFile& infile) {
 
 	if (keyQ) {
@@ -1577,25 +1649,190 @@ void printLegend(int legendheight, int legendwidth) {
 
 //////////////////////////////
 //
-// calculateBestKeys --
+// calculateBestKeys -- With --progressive, a preview image is written
+//   after each pass through the rows except for the last one, with the
+//   rows which have not been analyzed yet filled in from the nearest
+//   analyzed row (previews do not include the -b, -f and --trim
+//   processing).
 //
 
-void calculateBestKeys(vector<vector<vector<HISTTYPE> > >& histograms) {
-	for (int i=0; i<(int)histograms.size(); i++) {
-		for (int j=0; j<(int)histograms[i].size(); j++) {
-			 identifyKeyDouble(histograms[i][j]);
+void calculateBestKeys(KeyscapeTriangle& histograms, HumdrumFile& infile) {
+	int rows = (int)histograms.size();
+	if (rows <= 0) {
+		return;
+	}
+
+	// Order the rows progressively: first the bottom and top rows, then
+	// every 2^n-th row from the top, halving the spacing until reaching
+	// the --coarse spacing.  Rows which are skipped are filled in from
+	// the nearest analyzed row afterwards.
+	vector<int> rowlist;
+	vector<int> passend;   // end of each pass in rowlist
+	vector<char> calculated(rows, 0);
+	rowlist.reserve(rows);
+	rowlist.push_back(rows-1);
+	calculated[rows-1] = 1;
+	int stride = 1;
+	while (stride < rows) {
+		stride *= 2;
+	}
+	int i;
+	while (stride >= 1) {
+		if (stride < coarse) {
+			stride = coarse;
+		}
+		for (i=0; i<rows; i+=stride) {
+			if (!calculated[i]) {
+				calculated[i] = 1;
+				rowlist.push_back(i);
+			}
 		}
+		passend.push_back((int)rowlist.size());
+		if (stride == coarse) {
+			break;
+		}
+		stride /= 2;
+	}
+
+	int previewQ = !progressive.empty() && !keyQ && !rawQ && !khistQ;
+	if (!previewQ) {
+		// analyze all rows in one pass
+		passend.assign(1, (int)rowlist.size());
+	}
+
+	int count = threadcount;
+	if (count > rows) {
+		count = rows;
+	}
+	vector<char> done(rows, 0);
+	int start = 0;
+	int p;
+	for (p=0; p<(int)passend.size(); p++) {
+		std::atomic<int> nextblock(start);
+		if (count <= 1) {
+			calculateRows(&histograms, &rowlist, passend[p], &nextblock);
+		} else {
+			vector<std::thread> workers;
+			for (i=0; i<count; i++) {
+				workers.push_back(std::thread(calculateRows, &histograms,
+						&rowlist, passend[p], &nextblock));
+			}
+			for (i=0; i<(int)workers.size(); i++) {
+				workers[i].join();
+			}
+		}
+		for (i=start; i<passend[p]; i++) {
+			done[rowlist[i]] = 1;
+		}
+		start = passend[p];
+		if (previewQ && (p < (int)passend.size() - 1)) {
+			fillCoarseRows(histograms, done);
+			writePreview(histograms, infile, p+1);
+		}
+	}
+
+	if ((int)rowlist.size() < rows) {
+		fillCoarseRows(histograms, calculated);
 	}
 }
 
 
 
+//////////////////////////////
+//
+// calculateRows -- Identify the keys for each cell in the rows of the
+//   row list.  Threads take blocks of rows from the list (in order)
+//   until all rows before index stop have been analyzed.  Each cell is
+//   only read and written by the thread which analyzes its row.
+//
+
+#define ROWBLOCK 8
+
+void calculateRows(KeyscapeTriangle* histograms, vector<int>* rowlist,
+		int stop, std::atomic<int>* nextblock) {
+	KeyscapeTriangle& h = *histograms;
+	int start;
+	int i, j;
+	while ((start = nextblock->fetch_add(ROWBLOCK)) < stop) {
+		for (i=start; (i<start+ROWBLOCK) && (i<stop); i++) {
+			KeyscapeRow row = h[(*rowlist)[i]];
+			for (j=0; j<row.size(); j++) {
+				identifyKeyDouble(row[j]);
+			}
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// fillCoarseRows -- Copy the key results of rows which were not analyzed
+//   (when using the --coarse option) from the nearest analyzed row below,
+//   using the cell whose analysis window has the same center.
+//
+
+void fillCoarseRows(KeyscapeTriangle& histograms, vector<char>& calculated) {
+	int rows = (int)histograms.size();
+	int i, j;
+	int source;
+	int sourcej;
+	double center;
+	for (i=0; i<rows; i++) {
+		if (calculated[i]) {
+			continue;
+		}
+		source = i + 1;
+		while ((source < rows-1) && !calculated[source]) {
+			source++;
+		}
+		KeyscapeRow row    = histograms[i];
+		KeyscapeRow srcrow = histograms[source];
+		for (j=0; j<row.size(); j++) {
+			// cell (i,j) covers segments j to j+rows-1-i
+			center  = j + (rows - 1 - i) / 2.0;
+			sourcej = int(center - (rows - 1 - source) / 2.0 + 0.5);
+			if (sourcej < 0) {
+				sourcej = 0;
+			} else if (sourcej >= srcrow.size()) {
+				sourcej = srcrow.size() - 1;
+			}
+			row[j][12] = srcrow[sourcej][12];
+			row[j][13] = srcrow[sourcej][13];
+		}
+	}
+}
+
+
+
+//////////////////////////////
+//
+// writePreview -- Write the keyscape as it is after a pass of the
+//   progressive analysis to the file <prefix>-<pass>.ppm.
+//
+
+void writePreview(KeyscapeTriangle& histograms, HumdrumFile& infile,
+		int pass) {
+	string filename = progressive + "-" + to_string(pass) + ".ppm";
+	ofstream outfile(filename.c_str());
+	if (!outfile.is_open()) {
+		cerr << "Error: cannot write preview " << filename << endl;
+		exit(1);
+	}
+	streambuf* coutbuffer = cout.rdbuf(outfile.rdbuf());
+	printPPM(histograms, infile);
+	cout.flush();
+	cout.rdbuf(coutbuffer);
+}
+
+
+
 ////////////////////////////////////////
 //
 // identifyKeyDouble --
 //
 
-void identifyKeyDouble(vector<HISTTYPE>& histogram) {
+void identifyKeyDouble(HISTTYPE* histogram) {
 	int i;
 
 	double h[24];
@@ -1716,7 +1953,7 @@ void identifyKeyDouble(vector<HISTTYPE>& histogram) {
 // identifyKey --
 //
 
-void identifyKey(vector<HISTTYPE>& histogram) {
+void identifyKey(HISTTYPE* histogram) {
 	int i;
 
 	int h[24];
@@ -1787,7 +2024,7 @@ void identifyKey(vector<HISTTYPE>& histogram) {
 // fillAllHistograms --
 //
 
-void fillAllHistograms(vector<vector<vector<HISTTYPE> > >& histograms) {
+void fillAllHistograms(KeyscapeTriangle& histograms) {
 	int size = (int)histograms.size();
 	int i, j, k;
 	for (i=size-2; i>=0; i--) {
@@ -1807,7 +2044,7 @@ void fillAllHistograms(vector<vector<vector<HISTTYPE> > >& histograms) {
 // displayAnalysisHistogram --
 //
 
-void displayAnalysisHistogram(vector<vector<vector<HISTTYPE> > >& histograms) {
+void displayAnalysisHistogram(KeyscapeTriangle& histograms) {
 	int i, j;
 	int key = 0;
 	int size = (int)histograms.size();
@@ -1894,7 +2131,7 @@ int ranksort(const void* A, const void* B) {
 // displayRawAnalysis --
 //
 
-void displayRawAnalysis(vector<vector<vector<HISTTYPE> > >& histogram) {
+void displayRawAnalysis(KeyscapeTriangle& histogram) {
 	int i, j;
 	int key;
 	for (i=0; i<(int)histogram.size(); i++) {
@@ -1922,7 +2159,7 @@ void displayRawAnalysis(vector<vector<vector<HISTTYPE> > >& histogram) {
 // printBaseHistogramHumdrumStyle --
 //
 
-void printBaseHistogramHumdrumStyle(vector<vector<HISTTYPE> >& histogram,
+void printBaseHistogramHumdrumStyle(KeyscapeRow histogram,
 		double totalduration) {
 	int i;
 	int j;
@@ -1935,7 +2172,7 @@ void printBaseHistogramHumdrumStyle(vector<vector<HISTTYPE> >& histogram,
 	cout << "!\t!C\t!C#\t!D\t!D#\t!E\t!F\t!F#\t!G\t!G#\t!A\t!A#\t!B\n";
 	for (i=0; i<(int)histogram.size(); i++) {
 		cout << i << ':';
-		for (j=0; j<(int)histogram[i].size()-1; j++) {
+		for (j=0; j<CELLSIZE-1; j++) {
 			// subtracting one from limit becuase last item
 			// is storage for key analysis
 			cout << '\t' << histogram[i][j];
@@ -1950,12 +2187,12 @@ void printBaseHistogramHumdrumStyle(vector<vector<HISTTYPE> >& histogram,
 // printBaseHistogram --
 //
 
-void printBaseHistogram(vector<vector<HISTTYPE> >& histogram) {
+void printBaseHistogram(KeyscapeRow histogram) {
 	int i;
 	int j;
 	for (i=0; i<(int)histogram.size(); i++) {
 		cout << i << ':';
-		for (j=0; j<(int)histogram[i].size(); j++) {
+		for (j=0; j<CELLSIZE; j++) {
 			cout << '\t' << histogram[i][j];
 		}
 		cout << '\n';
@@ -1969,17 +2206,17 @@ void printBaseHistogram(vector<vector<HISTTYPE> >& histogram) {
 // printNormalizedHistogram --
 //
 
-void printNormalizedHistogram(vector<vector<HISTTYPE> >& histogram) {
+void printNormalizedHistogram(KeyscapeRow histogram) {
 	int i;
 	int j;
 	double sum = 0;
 	for (i=0; i<(int)histogram.size(); i++) {
 		cout << i << ':';
 		sum = 0;
-		for (j=0; j<(int)histogram[i].size(); j++) {
+		for (j=0; j<CELLSIZE; j++) {
 			sum += histogram[i][j];
 		}
-		for (j=0; j<(int)histogram[i].size(); j++) {
+		for (j=0; j<CELLSIZE; j++) {
 			cout << '\t' << (double)histogram[i][j] / sum;
 		}
 		cout << '\n';
@@ -1993,7 +2230,7 @@ void printNormalizedHistogram(vector<vector<HISTTYPE> >& histogram) {
 // printBest --
 //
 
-void printBest(vector<vector<vector<HISTTYPE> > >& histogram) {
+void printBest(KeyscapeTriangle& histogram) {
 	int i;
 	int j;
 	for (i=0; i<(int)histogram.size(); i++) {
@@ -2012,7 +2249,7 @@ void printBest(vector<vector<vector<HISTTYPE> > >& histogram) {
 // loadHistogramFromHumdrumFile --
 //
 
-double loadHistogramFromHumdrumFile(vector<vector<HISTTYPE> >& histograms,
+double loadHistogramFromHumdrumFile(KeyscapeRow histograms,
 	HumdrumFile& infile, const char* filename, int segments) {
 
 	if (strcmp(filename, "") == 0) {
@@ -2075,7 +2312,7 @@ double loadHistogramFromHumdrumFile(vector<vector<HISTTYPE> >& histograms,
 // addToHistogramDouble -- fill the histogram in the right spots.
 //
 
-void addToHistogramDouble(vector<vector<double> >& histogram, int pc,
+void addToHistogramDouble(KeyscapeRow histogram, int pc,
 		double start, double dur, double tdur, int segments) {
 
 	pc = (pc + transpose + 144) % 12;
@@ -2151,45 +2388,65 @@ void addToHistogramInteger(vector<vector<int> >& histogram, int pc,
 // loadHistogramFromMidiFile --
 //
 
-double loadHistogramFromMidiFile(vector<vector<HISTTYPE> >& histogram,
+double loadHistogramFromMidiFile(KeyscapeRow histogram,
 	const char* filename, int segments) {
 
-	smf::MidiFile midifile(filename);
-	midifile.absoluteTicks();
-	midifile.joinTracks();
+	MidiFileReader midifile(filename);
+	if (!midifile.isValid()) {
+		// not a Standard MIDI File (such as binasc data), so read it with
+		// the midifile library and convert it to a Standard MIDI File.
+		smf::MidiFile smffile(filename);
+		if (smffile.status()) {
+			stringstream binary;
+			smffile.write(binary);
+			midifile.read(binary);
+		}
+	}
 
 	vector<int> ontimes(128*16, -1);
 	vector<int> onvelocities(128*16, 0);
 
-	int command = 0;
-	int totalduration = midifile.getEvent(0,midifile.getNumEvents(0)-1).tick;
-	// using the last item as the total duration is not so great because
+	// Using the last event as the total duration is not so great because
 	// some MIDI files have some junk messages long after the music
-	// has stopped (2_ase.mid is an example), so search backwards
-	// through the midifile for the last note-on or note-off message.
-	for (int i=midifile.getNumEvents(0)-1; i>=0; i--) {
-		command = midifile.getEvent(0,i)[0] & 0xf0;
-		if (command == 0x90 || command == 0x80) {
-			totalduration = midifile.getEvent(0, i).tick;
-			break;
+	// has stopped (2_ase.mid is an example), so use the time of the last
+	// note-on or note-off message.  The order of the events does not
+	// matter here, so the tracks are scanned one at a time.
+	MidiFileEvent event;
+	int command = 0;
+	int totalduration = 0;
+	int lastnote = -1;
+	for (int i=0; i<midifile.getTrackCount(); i++) {
+		midifile.rewind(i);
+		while (midifile.next(event)) {
+			if (event.tick > totalduration) {
+				totalduration = event.tick;
+			}
+			command = event[0] & 0xf0;
+			if ((command == 0x90 || command == 0x80) && (event.tick > lastnote)) {
+				lastnote = event.tick;
+			}
 		}
 	}
+	if (lastnote >= 0) {
+		totalduration = lastnote;
+	}
 
 	int key;
 	int channel;
 	int duration;
 	int ontime;
-	for (int i=0; i<midifile.getNumEvents(0); i++) {
-		command = midifile.getEvent(0,i)[0] & 0xf0;
-		channel = midifile.getEvent(0,i)[0] & 0x0f;
+	midifile.rewind();   // all tracks in time order
+	while (midifile.next(event)) {
+		command = event[0] & 0xf0;
+		channel = event[0] & 0x0f;
 		if (channelfilter[channel] == 0) {
 			// ignore events on this channel
 			continue;
 		}
-		if (command == 0x90 && midifile.getEvent(0,i)[2] != 0) {
+		if (command == 0x90 && event[2] != 0) {
 			// store note-on velocity and time.
-			key = midifile.getEvent(0,i)[1];
-			ontime = midifile.getEvent(0,i).tick;
+			key = event[1];
+			ontime = event.tick;
 			if (ontimes[key * channel] > -1) {
 				// the previous note was not turned off, to turn
 				// it off now and store that note in the histogram
@@ -2203,8 +2460,8 @@ double loadHistogramFromMidiFile(vector<vector<HISTTYPE> >& histogram,
 			}
 		} else if (command == 0x90 || command == 0x80) {
 			// process a note-off command
-			key = midifile.getEvent(0,i)[1];
-			ontime = midifile.getEvent(0,i).tick;
+			key = event[1];
+			ontime = event.tick;
 			if (ontimes[key * channel] > -1) {
 				// process the note which has been waiting
 				duration = ontime - ontimes[key * channel];
@@ -2287,6 +2544,9 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("w|weights=s", "arbitrary set of pitch weights");
 	opts.define("W|printweights=b", "display weights which will be used");
 	opts.define("k|key=b", "display top-level key anaysis");
+	opts.define("threads=i:1", "number of threads for key analysis");
+	opts.define("coarse=i:1", "analyze every n-th row (fill in the rest)");
+	opts.define("progressive=s", "write preview images to <s>-N.ppm");
 
 	opts.define("aa|aarden=b",        "load Aarden-Essen weights");
 	opts.define("bb|bellman|budge=b", "load Bellman-Budge weights");
@@ -2327,6 +2587,19 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    maxQ      =  opts.getBoolean("max");
 	secondQ   =  opts.getBoolean("second");
 	keyQ      =  opts.getBoolean("key");
+	threadcount = opts.getInteger("threads");
+	if (threadcount < 1) {
+		threadcount = 1;
+	}
+	coarse    =  opts.getInteger("coarse");
+	if (coarse < 1) {
+		coarse = 1;
+	}
+	if (opts.getBoolean("progressive")) {
+		progressive = opts.getString("progressive");
+	} else {
+		progressive.clear();
+	}
 
 	trimQ     =  opts.getBoolean("trim");
 	segments  =  opts.getInteger("segments");
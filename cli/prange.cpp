@@ -4,6 +4,7 @@
 // Last Modified: Thu Feb  9 07:34:18 PST 2012 SCORE display output by voice.
 // Last Modified: Sat Mar 30 13:14:05 PDT 2013 Allow segmented input.
 // Last Modified: Sat Mar 30 13:14:05 PDT 2013 Allow combined mass sections.
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 Added --threads option.
 // Filename:      ...sig/examples/all/range.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/range.cpp
 // Syntax:        C++; museinfo
@@ -115,6 +116,9 @@ int main(int argc, char* argv[]) {
    checkOptions(options, argc, argv);
    HumdrumStream streamer(options);
    HumdrumFile infile;
+   if (options.getInteger("threads") > 1) {
+      streamer.setThreadCount(options.getInteger("threads"));
+   }
 
    // figure out the number of input files to process
    // int numinputs = options.getArgCount();
@@ -1633,6 +1637,7 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    opts.define("D|diatonic=b",      
          "diatonic counts ignore chormatic alteration");
    opts.define("no-define=b", "Do not use defines in output SCORE data");
+   opts.define("threads=i:1", "number of threads for parsing input files");
 
    opts.define("debug=b",       "trace input parsing");   
    opts.define("author=b",      "author of the program");   
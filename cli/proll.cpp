@@ -10,6 +10,7 @@
 // Last Modified: Mon Feb  2 00:13:08 PST 2015 Fixed due to new comp. restr.
 // Last Modified: Tue Aug 29 13:59:05 PDT 2017 Added physical time to JSON output
 // Last Modified: Wed Oct 23 14:38:21 PDT 2019 Convert to STL
+// Last Modified: Sat Oct 17 23:39:50 PDT 2026 JSON notes from HumdrumFile::getNoteTable()
 // Filename:      ...sig/examples/all/proll.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/proll.cpp
 // Syntax:        C++; museinfo
@@ -155,7 +156,7 @@ void createJsonProll(HumdrumFile& infile) {
 	int b40;
 	RationalNumber duration;
 	int track;
-	int tcount;
+	int n;
 
 	vector<string> partnames(ktracks.size());
 
@@ -169,55 +170,38 @@ void createJsonProll(HumdrumFile& infile) {
 	vector<double> realtimes;
 	calculateRealTimesFromTempos(realtimes, infile, tempos);
 
-	for (i=0; i<infile.getNumLines(); i++) {
-		if (!infile[i].isData()) {
+	// notes which continue a tie are skipped, and the first note of a tie
+	// is given the duration of all of the tied notes:
+	const HumdrumNoteTable& notes = infile.getNoteTable();
+	for (n=0; n<notes.getSize(); n++) {
+		if (!notes.isAttack(n)) {
 			continue;
 		}
-		for (j=0; j<infile[i].getFieldCount(); j++) {
-			if (!infile[i].isExInterp(j, "**kern")) {
-				continue;
-			}
-			if (strcmp(infile[i][j], ".") == 0) {
-				continue;
-			}
-			tcount = infile[i].getTokenCount(j);
-			track = infile[i].getPrimaryTrack(j);
-			for (k=0; k<tcount; k++) {
-				infile[i].getToken(buffer, j, k);
-				if (strchr(buffer, 'r') != NULL) {
-					continue;
-				}
-				if (strchr(buffer, ']') != NULL) {
-					continue;
-				}
-				if (strchr(buffer, '_') != NULL) {
-					continue;
-				}
-				if (strcmp(buffer, ".") == 0) {
-					continue;
-				}
-				b40 = Convert::kernToBase40(buffer);
-				duration = infile.getTiedDurationR(i, j, k);
-				if (noteinit[rktracks[track]] == 0) {
-					noteinit[rktracks[track]] = 1;
-					pi(staves[rktracks[track]], 4);
-					staves[rktracks[track]] << "{\n";
-				} else {
-					pi(staves[rktracks[track]], 4);
-					staves[rktracks[track]] << "},\n";
-					pi(staves[rktracks[track]], 4);
-					staves[rktracks[track]] << "{\n";
-				}
-				printJsonNote(staves[rktracks[track]], b40, duration, buffer, 
-						infile, i, j, k, tempos, realtimes);
+		i = notes.line[n];
+		j = notes.field[n];
+		k = notes.subtoken[n];
+		track = notes.track[n];
+		b40 = notes.base40[n];
+		duration = notes.tiedduration[n].getRationalNumber();
+		infile[i].getToken(buffer, j, k);
+		if (noteinit[rktracks[track]] == 0) {
+			noteinit[rktracks[track]] = 1;
+			pi(staves[rktracks[track]], 4);
+			staves[rktracks[track]] << "{\n";
+		} else {
+			pi(staves[rktracks[track]], 4);
+			staves[rktracks[track]] << "},\n";
+			pi(staves[rktracks[track]], 4);
+			staves[rktracks[track]] << "{\n";
+		}
+		printJsonNote(staves[rktracks[track]], b40, duration, buffer, 
+				infile, i, j, k, tempos, realtimes);
 
-				if (b40 > partmax[rktracks[track]]) {
-					partmax[rktracks[track]] = b40;
-				}
-				if (b40 < partmin[rktracks[track]]) {
-					partmin[rktracks[track]] = b40;
-				}
-			}
+		if (b40 > partmax[rktracks[track]]) {
+			partmax[rktracks[track]] = b40;
+		}
+		if (b40 < partmin[rktracks[track]]) {
+			partmin[rktracks[track]] = b40;
 		}
 	}
 
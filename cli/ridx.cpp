@@ -4,6 +4,7 @@
 // Last Modified: Mon Nov 23 05:24:18 PST 2009
 // Last Modified: Thu Dec 22 11:50:31 PST 2011 Added -V and -k options
 // Last Modified: Mon Apr  1 00:28:01 PDT 2013 Enabled multiple segment input
+// Last Modified: Sat Oct 17 19:51:51 PDT 2026 Read input one line at a time
 // Filename:      ...sig/examples/all/ridx.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/ridx.cpp
 // Syntax:        C++; museinfo
@@ -25,7 +26,10 @@
 void      checkOptions          (Options& opts, int argc, char** argv);
 void      example               (void);
 void      usage                 (const char* command);
-void      processFile           (HumdrumFile& infile, int setcount);
+void      processFile           (HumdrumLineReader& reader, int labelQ,
+                                 const string& filename);
+void      processRecord         (HumdrumRecord& record,
+                                 PerlRegularExpression& pre);
 
 
 // User interface variables:
@@ -52,24 +56,24 @@ int       option_V = 0;   // used with -V option
 int main(int argc, char** argv) {
    // process the command-line options
    checkOptions(options, argc, argv);
-   HumdrumFileSet infiles;
-   // infile.setAllocation(1123123);   // allow for very large inputs up to 
-   //                                  // million lines.
+   HumdrumLineReader reader;
    int numinputs = options.getArgumentCount();
 
    int i;
    if (numinputs < 1) {
-      infiles.read(cin);
+      reader.open(cin);
+      processFile(reader, 0, "");
    } else {
       for (i=0; i<numinputs; i++) {
-         infiles.readAppend(options.getArg(i+1));
+         if (!reader.open(options.getArg(i+1))) {
+            cerr << "Error: could not open file: " << options.getArg(i+1)
+                 << endl;
+            exit(1);
+         }
+         processFile(reader, numinputs > 1, options.getArg(i+1));
       }
    }
 
-   for (i=0; i<infiles.getCount(); i++) {
-      processFile(infiles[i], infiles.getCount());
-   }
-
    return 0;
 }
 
@@ -78,137 +82,155 @@ int main(int argc, char** argv) {
 
 //////////////////////////////
 //
-// processFile --
+// processFile -- Filter the input one line at a time, so that the
+//     output starts before the input has been read completely.  If
+//     labelQ is true, segment labels are printed for every segment
+//     (multiple input files); otherwise they are printed once the input
+//     is known to contain more than one segment or when the segment
+//     has been named by a !!!!SEGMENT: marker.
 //
 
-void processFile(HumdrumFile& infile, int setcount) {
-   int i;
+void processFile(HumdrumLineReader& reader, int labelQ,
+      const string& filename) {
    PerlRegularExpression pre;
+   HumdrumRecord record;
+   const char* basename = strrchr(filename.c_str(), '/');
+   basename = basename == NULL ? filename.c_str() : basename + 1;
+
+   while (reader.read(record)) {
+      // if bibliographic/reference records are not suppressed
+      // print the !!!!SEGMENT: marker if present.
+      if (reader.isSegmentStart() && !option_G && (labelQ ||
+            (reader.getSegmentIndex() > 0) ||
+            (reader.getFilename() != basename))) {
+         reader.printNonemptySegmentLabel(cout);
+      }
+      processRecord(record, pre);
+   }
+}
 
-   int revQ = option_V;
 
-   // if bibliographic/reference records are not suppressed
-   // print the !!!!SEGMENT: marker if present.
-   if ((setcount > 1) && (!option_G)) {
-      infile.printNonemptySegmentLabel(cout);
-   }
 
-   for (i=0; i<infile.getNumLines(); i++) {
+//////////////////////////////
+//
+// processRecord --
+//
 
-      if (option_D && (infile[i].isMeasure() || infile[i].isData())) {
-         // remove data lines if -D is specified
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
-      }
-      if (option_d) {
-         // remove null data lines if -d is specified
-         if (option_k && infile[i].isData() && 
-               infile[i].equalFieldsQ("**kern", ".")) {
-            // remove if only all **kern spines are null.
-            if (revQ) {
-               cout << infile[i] << "\n";
-            }
-            continue;
-         } else if (!option_k && infile[i].isData() && 
-               infile[i].equalDataQ(".")) {
-            // remove null data lines if all spines are null.
-            if (revQ) {
-               cout << infile[i] << "\n";
-            }
-            continue;
-         }
+void processRecord(HumdrumRecord& record, PerlRegularExpression& pre) {
+   int revQ = option_V;
+
+   if (option_D && (record.isMeasure() || record.isData())) {
+      // remove data lines if -D is specified
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_G && (infile[i].isGlobalComment() || 
-            infile[i].isBibliographic())) {
-         // remove global comments if -G is specified
+      return;
+   }
+   if (option_d) {
+      // remove null data lines if -d is specified
+      if (option_k && record.isData() && 
+            record.equalFieldsQ("**kern", ".")) {
+         // remove if only all **kern spines are null.
          if (revQ) {
-            cout << infile[i] << "\n";
+            cout << record << "\n";
          }
-         continue;
-      }
-      if (option_g && pre.search(infile[i][0], "^!!+\\s*$", "")) {
-         // remove empty global comments if -g is specified
+         return;
+      } else if (!option_k && record.isData() && 
+            record.equalDataQ(".")) {
+         // remove null data lines if all spines are null.
          if (revQ) {
-            cout << infile[i] << "\n";
+            cout << record << "\n";
          }
-         continue;
+         return;
       }
-      if (option_I && infile[i].isInterpretation()) {
-         // remove all interpretation records
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+   }
+   if (option_G && (record.isGlobalComment() || 
+         record.isBibliographic())) {
+      // remove global comments if -G is specified
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_i && infile[i].isInterpretation() && 
-            infile[i].equalDataQ("*")) {
-         // remove null interpretation records
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_g && pre.search(record[0], "^!!+\\s*$", "")) {
+      // remove empty global comments if -g is specified
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_L && infile[i].isLocalComment()) {
-         // remove all local comments
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_I && record.isInterpretation()) {
+      // remove all interpretation records
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_l && infile[i].isLocalComment() && 
-            infile[i].equalDataQ("!")) {
-         // remove null local comments
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_i && record.isInterpretation() && 
+         record.equalDataQ("*")) {
+      // remove null interpretation records
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_T && infile[i].isTandem()) {
-         // remove tandem (non-manipulator) interpretations
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_L && record.isLocalComment()) {
+      // remove all local comments
+      if (revQ) {
+         cout << record << "\n";
+      }
+      return;
+   }
+   if (option_l && record.isLocalComment() && 
+         record.equalDataQ("!")) {
+      // remove null local comments
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_U) {
-         // remove unnecessary (duplicate exclusive) interpretations
-         // HumdrumFile class does not allow duplicate ex. interps.
-         // continue;
+      return;
+   }
+   if (option_T && record.isTandem()) {
+      // remove tandem (non-manipulator) interpretations
+      if (revQ) {
+         cout << record << "\n";
       }
+      return;
+   }
+   if (option_U) {
+      // remove unnecessary (duplicate exclusive) interpretations
+      // HumdrumFile class does not allow duplicate ex. interps.
+      // return;
+   }
 
-      // non-classical options:
+   // non-classical options:
 
-      if (option_M && infile[i].isMeasure()) {
-         // remove all measure lines
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
-      }
-      if (option_C && infile[i].isComment()) {
-         // remove all comments (local & global)
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+   if (option_M && record.isMeasure()) {
+      // remove all measure lines
+      if (revQ) {
+         cout << record << "\n";
       }
-      if (option_c && (infile[i].isLocalComment() || 
-            infile[i].isGlobalComment())) {
-         // remove all comments (local & global)
-         if (revQ) {
-            cout << infile[i] << "\n";
-         }
-         continue;
+      return;
+   }
+   if (option_C && record.isComment()) {
+      // remove all comments (local & global)
+      if (revQ) {
+         cout << record << "\n";
       }
-
-      // got past all test, so print the current line:
-      if (!revQ) {
-         cout << infile[i] << "\n";
+      return;
+   }
+   if (option_c && (record.isLocalComment() || 
+         record.isGlobalComment())) {
+      // remove all comments (local & global)
+      if (revQ) {
+         cout << record << "\n";
       }
+      return;
    }
 
+   // got past all test, so print the current line:
+   if (!revQ) {
+      cout << record << "\n";
+   }
 }
 
 
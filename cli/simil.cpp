@@ -4,12 +4,14 @@
 //                   Waterloo, Ontario.
 // Creation Date: Tue Nov 17 14:35:26 PST 2009
 // Last Modified: Tue Dec  8 20:06:25 PST 2009
+// Last Modified: Sat Oct 17 20:33:32 PDT 2026 use EditDistance, --template
 // Filename:      ...sig/examples/all/simil.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/simil.cpp
 // Syntax:        C++; museinfo
 //
 // Description:   Measure Damerau-Levenshtein edit distance between a Humdrum
-//                source file and template file.
+//                source file and template file.  With --template, the
+//                template is compared to any number of source files.
 //
 
 #include "humdrum.h"
@@ -54,17 +56,13 @@ void      printResults          (Array<double>& results,
 void      printResultsSubString (Array<Array<double> >& results, 
                                  Array<Array<char> >& sourcedata, 
                                  Array<Array<char> >& templatedata);
-double    dlv                   (Array<Array<char> >& s1, int offset1, 
-                                 Array<Array<char> >& s2, int offset2);
 void      doDamerauLevenshteinAnalysis(Array<Array<char> >& sourcedata, 
                                  Array<Array<char> >& templatedata);
-double    dlvcharstar           (char** set1, int len1, char** set2, int len2);
-double    dlvstring             (Array<Array<char> >& set1, int offset1, 
-                                 Array<Array<char> >& set2, int offset2,
-                                 int temlen);
-double    dlvint                (int *s1, int len1, int *s2, int len2);
-double    dlv                   (Array<Array<char> >& set1, int offset1, 
-                                 Array<Array<char> >& set2, int offset2);
+void      doCorpusAnalysis      (Array<Array<char> >& templatedata);
+void      getSymbols            (vector<int>& symbols, 
+                                 Array<Array<char> >& tokens);
+int       getWindowCount        (int sourcesize, int templatesize);
+double    getDistanceLimit      (int templatesize);
 int       getMinIndex           (Array<double>& list);
 void      printSubStringInfo    (Array<double>& list, double target);
 void      printWeights          (void);
@@ -87,6 +85,9 @@ int         prependQ  = 0;   // used with -p option (not implemented)
 int         sequenceQ = 0;   // used with -s option
 int         spacesQ   = 1;   // used with -S option
 double      threshold = 0.0; // used with -t option
+int         corpusQ   = 0;   // used with --template option
+int         threadcount = 1; // used with --threads option
+EditDistance Distance;       // edit distance calculations
 
 double      weight_R1 = 1.0; // --R1: deleting a repeated element of S1
 double      weight_R2 = 1.0; // --R2: deleting a repeated element of S2
@@ -108,6 +109,16 @@ int main(int argc, char** argv) {
    Array<Array<char> > sourcedata;
    Array<int> datalines;
 
+   if (corpusQ) {
+      readTemplateContents(templatedata, 
+            options.getString("template").c_str());
+      doCorpusAnalysis(templatedata);
+      if (pweightQ) {
+         printWeights();
+      }
+      return 0;
+   }
+
    if ((options.getArgCount() < 1) || (options.getArgCount() > 2)) {
       usage(options.getCommand().c_str());
       exit(1);
@@ -372,6 +383,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    options.define("s|sequence=b",      "print search sequences");
    options.define("S|no-spaces=b",     "print search sequences without spaces");
    options.define("t|threshold=d:0.0", "similarity threshold for output");
+   options.define("T|template=s",      "compare template to all input files");
+   options.define("threads=i:1",       "number of threads with --template");
 
    options.define("R1|r1=d:1.0", "scr for deleting a repeated element of S1");
    options.define("R2|r2=d:1.0", "scr for deleting a repeated element of S2");
@@ -423,6 +436,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    sequenceQ =  options.getBoolean("sequence");
    spacesQ   = !options.getBoolean("no-spaces");
    threshold =  options.getDouble("threshold");
+   corpusQ   =  options.getBoolean("template");
+   threadcount = options.getInteger("threads");
 
    if (options.getBoolean("weight-file")) {
       readEditWeights(options.getString("weight-file").c_str());
@@ -436,6 +451,10 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
    if (options.getBoolean("S1")) { weight_S1 = options.getDouble("S1"); }
    if (options.getBoolean("S2")) { weight_S2 = options.getDouble("S2"); }
    if (options.getBoolean("S3")) { weight_S3 = options.getDouble("S3"); }
+
+   Distance.setWeights(weight_R1, weight_R2, weight_D1, weight_D2,
+         weight_S0, weight_S1, weight_S2, weight_S3);
+   Distance.setThreadCount(threadcount);
 }
 
 
@@ -520,9 +539,14 @@ void unusual_thing(Array<Array<double> >& results,
       results[i].setSize(subcount);
    }
 
+   vector<int> source;
+   vector<int> pattern;
+   getSymbols(source, sourcedata);
+   getSymbols(pattern, templatedata);
+
    for (i=0; i<len; i++) {
       for (j=0; j<subcount; j++) {
-         results[i][j] = dlvstring(sourcedata, i, templatedata, j, sublen);
+         results[i][j] = Distance.getDistance(source, i, pattern, j, sublen);
       }
    }
 }
@@ -703,14 +727,14 @@ void printResults(Array<double>& results, Array<Array<char> >& sourcedata,
 void printSequence(Array<Array<char> >& sourcedata, int index, int size, 
       int flag) {
    int i;
-   if (size <= 0) {
+   if ((size <= 0) || (index >= sourcedata.getSize())) {
       cout << ".";
       return;
    }
 
    cout << sourcedata[index].getBase();
 
-   for (i=index+1; i<index+size; i++) {
+   for (i=index+1; (i<index+size) && (i<sourcedata.getSize()); i++) {
       if (flag) {
          cout << ' ';
       }
@@ -728,326 +752,172 @@ void printSequence(Array<Array<char> >& sourcedata, int index, int size,
 void usual_thing(Array<double>& results, Array<Array<char> >& sourcedata, 
       Array<Array<char> >& templatedata) {
 
-   int len = (int)fabs(sourcedata.getSize() - templatedata.getSize() + 1);
+   int len = getWindowCount(sourcedata.getSize(), templatedata.getSize());
+   if (len < 0) {
+      cerr << "Error in offset values: " << -1 << ", " 
+           << templatedata.getSize() << endl;
+      exit(1);
+   }
 
    results.setSize(0);
    if (len <= 0) {
       return;
    }
-   results.setSize(len);
-   results.setAll(0.0);
 
+   vector<int> source;
+   vector<int> pattern;
+   vector<double> distances;
+   getSymbols(source, sourcedata);
+   getSymbols(pattern, templatedata);
+   Distance.scoreWindows(distances, source, pattern, len,
+         getDistanceLimit(templatedata.getSize()));
+
+   results.setSize(len);
    for (int i=0; i<len; i++) {
-      results[i] = dlv(sourcedata, i, templatedata, 0);
+      results[i] = distances[i];
    }
 }
 
 
-//////////////////////////////
-//
-// printWeights --
-//
-
-void printWeights(void) {
-   cout << "!! weight_R1: " << weight_R1 << "\n";
-   cout << "!! weight_R2: " << weight_R2 << "\n";
-   cout << "!! weight_D1: " << weight_D1 << "\n";
-   cout << "!! weight_D2: " << weight_D2 << "\n";
-   cout << "!! weight_S0: " << weight_S0 << "\n";
-   cout << "!! weight_S1: " << weight_S1 << "\n";
-   cout << "!! weight_S2: " << weight_S2 << "\n";
-   cout << "!! weight_S3: " << weight_S3 << endl;
-}
-
-
 
 //////////////////////////////
 //
-// dlv -- Compute the Damerau-Levenshtein distance of two arrays of 
-//      integers,  subject to specified weights.           
-//      
-//      dlv         = DLV raw value from Array<char> using dlvcharstar.
-//      dlvstring   = DLV raw value from Array<char> data.
-//      dlvcharstar = DLV raw value from char* data.
-//      dlvint      = DLV raw value from int data. (original function)
+// doCorpusAnalysis -- Compare the template to each input file (or
+//     standard input).  The files are read first, and then the sources
+//     are scored in parallel when --threads is given.
 //
 
-double dlv(Array<Array<char> >& set1, int offset1, 
-      Array<Array<char> >& set2, int offset2) {
-
-   Array<char*> list1;
-   Array<char*> list2;
-   if (offset1 < 0) { offset1 = 0; }
-   if (offset2 < 0) { offset2 = 0; }
-   
-   int size1 = set1.getSize() - offset1;
-   int size2 = set2.getSize() - offset2;
-
-   if ((size1 < 0) || (size2 < 0)) {
-      cerr << "Error in offset values: " << size1 << ", " << size2 << endl;
-      exit(1);
-   }
-
-   list1.setSize(size1);
-   list2.setSize(size2);
-
+void doCorpusAnalysis(Array<Array<char> >& templatedata) {
+   int filecount = options.getArgCount();
+   int count = filecount < 1 ? 1 : filecount;
+   vector<Array<Array<char> > > sources(count);
+   vector<string> filenames(count);
+   HumdrumFile infile;
+   int spine;
    int i;
-   for (i=0; i<size1; i++) {
-      list1[i] = set1[i+offset1].getBase();
-   }
-   for (i=0; i<size2; i++) {
-      list2[i] = set2[i+offset2].getBase();
-   }
-
-   return dlvcharstar(list1.getBase(), size1, list2.getBase(), size2);
-}
-
-
-
-double dlvstring(Array<Array<char> >& set1, int offset1, 
-      Array<Array<char> >& set2, int offset2, int temlen = -1) {
-
-   int len1 = set1.getSize() - offset1;
-   int len2 = set2.getSize() - offset2;
-
-   if (temlen == -1) {
-      // tem len is the length of the substring to consider
-      temlen = set2.getSize();
-   }
-
-   int len = len1;   // the length of the sequences to compare
-
-   if (len1 > len2) {
-      len = len2;
-   } 
-
-   if (temlen < len) {
-      len = temlen;
-   }
-
-   double cost, val, m;
-   int i, j;
-   int mindex;
-   int s1index, s2index;
-   int n = 0;
-
-   if (len+1 > n)  {
-      n   = len + 1;
-   }
-
-   double min[n];
-   int rep1;
-   int rep2;
-
-   mindex = 0;
-   s1index = offset1;
-   m = 0.0;
-   min[mindex] = 0.0;
-
-   for (i=0; i<len; i++, s1index++)  {
-      m = min[mindex++];
-      if ((s1index>0) && 
-          (strcmp(set1[s1index].getBase(), set1[s1index-1].getBase()) == 0)) {
-         m += weight_R1;
+   for (i=0; i<count; i++) {
+      Array<int> datalines;
+      if (filecount < 1) {
+         infile.read(cin);
       } else {
-         m += weight_D1;
+         filenames[i] = options.getArg(i+1);
+         infile.read(filenames[i].c_str());
       }
-      min[mindex] = m;
+      spine = chooseSpine(interp, infile);
+      fillSourceData(sources[i], datalines, infile, spine, nullQ);
    }
-   
-   s2index = offset2;
-   for (j=0; j<len; j++, s2index++)  {
-      rep2 = (s2index>0 && (strcmp(set2[s2index].getBase(), 
-				   set2[s2index-1].getBase()) == 0));
-      mindex = 0;
-      cost = min[mindex];
-      m = cost + (rep2 ? weight_R2 : weight_D2);
-   
-      min[mindex++] = m;
-   
-      s1index = offset1;
-      for (i=0; i<len; i++, s1index++)  {
-         rep1 = (s1index>0) && 
-             (strcmp(set1[s1index].getBase(), 
-                     set1[s1index-1].getBase()) == 0);
-	       
-         m += rep1 ? weight_R1 : weight_D1;
-   
-         if (strcmp(set1[s1index].getBase(),set2[s2index].getBase()) == 0) {
-            val = cost;
-         } else  {
-            if (rep1) {
-               val = cost + (rep2? weight_S3:weight_S1);
-            } else { 
-               val = cost + (rep2? weight_S2:weight_S0);
-            }
-         }
-         if (val < m) {
-            m = val;
-         }
-   
-	 cost = min[mindex];
-         val = cost + (rep2 ? weight_R2 : weight_D2);
-         if (val < m) {
-            m = val;
+
+   if (xlen > 0) {
+      for (i=0; i<count; i++) {
+         if (count > 1) {
+            cout << "!!!!SEGMENT: " << filenames[i] << endl;
          }
-   
-	 min[mindex++] = m;
+         doDamerauLevenshteinAnalysis(sources[i], templatedata);
       }
+      return;
    }
 
-   return (double)m;
-}
-
-
-
-double dlvint(int *s1, int len1, int *s2, int len2) {
-   float cost, val, m;
-   int i, j;
-   float *mptr;
-   int *s1ptr, *s2ptr;
-   int n = 0;
-   float *min = NULL;
-
-   if (len1+1 > n)  {
-      min = new float[len1+1];
-      n   = len1 + 1;
+   vector<int> pattern;
+   vector<vector<int> > corpus(count);
+   vector<int> counts(count);
+   getSymbols(pattern, templatedata);
+   for (i=0; i<count; i++) {
+      getSymbols(corpus[i], sources[i]);
+      counts[i] = getWindowCount(sources[i].getSize(), 
+            templatedata.getSize());
+      if (counts[i] < 0) {
+         cerr << "Error: template is too long for " << filenames[i] << endl;
+      }
    }
 
-   mptr = min;
-
-   s1ptr = s1;
-   m = *mptr = 0.0;
+   vector<vector<double> > distances;
+   Distance.scoreCorpus(distances, corpus, pattern, counts,
+         getDistanceLimit(templatedata.getSize()));
 
-   for (i=len1; --i>=0; s1ptr++)  {
-      m = *mptr++;
-      if (s1ptr>s1 && *s1ptr==*(s1ptr-1)) {
-         m += weight_R1;
-      } else {
-         m += weight_D1;
+   Array<double> results;
+   for (i=0; i<count; i++) {
+      if (counts[i] < 0) {
+         continue;
       }
-   
-      *mptr = m;
+      if (count > 1) {
+         cout << "!!!!SEGMENT: " << filenames[i] << endl;
       }
-   
-      s2ptr = s2;
-      for (j=len2; --j>=0; s2ptr++)  {
-      char rep2 = (s2ptr>s2 && *s2ptr==*(s2ptr-1));
-   
-      mptr = min;
-      m = (cost = *mptr) + (rep2? weight_R2:weight_D2);
-   
-      *mptr++ = m;
-   
-      s1ptr = s1;
-      for (i=len1; --i>=0; s1ptr++)  {
-         char rep1 = (s1ptr>s1 && *s1ptr==*(s1ptr-1));
-   
-         m += (rep1? weight_R1:weight_D1);
-   
-         if (*s1ptr==*s2ptr)
-         val = cost;
-         else  {
-         if (rep1)
-            val = cost + (rep2? weight_S3:weight_S1);
-         else
-            val = cost + (rep2? weight_S2:weight_S0);
-         }
-         if (val < m) { m = val; }
-   
-         val = (cost = *mptr) + (rep2? weight_R2:weight_D2);
-         if (val < m) m = val;
-   
-         *mptr++ = m;
+      results.setSize((int)distances[i].size());
+      for (int j=0; j<results.getSize(); j++) {
+         results[j] = distances[i][j];
       }
+      printResults(results, sources[i], templatedata);
    }
-
-   delete [] min;
-   return (double)m;
 }
 
 
 
-double dlvcharstar(char** set1, int len1, char** set2, int len2) {
+//////////////////////////////
+//
+// getWindowCount -- Return the number of starting positions in the
+//     source at which the template is compared, or -1 if the comparisons
+//     would start past the end of the source.
+//
+
+int getWindowCount(int sourcesize, int templatesize) {
+   int len = (int)fabs(sourcesize - templatesize + 1);
+   if (len > sourcesize + 1) {
+      return -1;
+   }
+   return len;
+}
 
-   int len = len1;   // the length of the sequences to compare
 
-   if (len1 > len2) {
-      len = len2;
-   } 
 
-   double cost, val, m;
-   int i, j;
-   int mindex;
-   int s1index, s2index;
-   int n = 0;
+//////////////////////////////
+//
+// getDistanceLimit -- Return the largest edit distance which will be
+//     printed with the -t option, or -1 if all distances are printed.
+//     Larger distances do not have to be calculated exactly.
+//
 
-   if (len+1 > n)  {
-      n   = len + 1;
+double getDistanceLimit(int templatesize) {
+   if ((threshold <= 0.0) || (templatesize <= 0)) {
+      return -1.0;
    }
+   if (threshold >= 1.0) {
+      // only exact matches are printed
+      return 0.0;
+   }
+   double limit = -templatesize * log(threshold);
+   // allow for rounding in normalize1() when comparing to the threshold
+   return limit * (1.0 + 1e-9) + 1e-9;
+}
 
-   double min[n];
-   int rep1;
-   int rep2;
 
-   mindex = 0;
-   s1index = 0;
-   m = 0.0;
-   min[mindex] = 0.0;
 
-   for (i=0; i<len; i++, s1index++)  {
-      m = min[mindex++];
-      if ((s1index>0) && 
-          (strcmp(set1[s1index], set1[s1index-1]) == 0)) {
-         m += weight_R1;
-      } else {
-         m += weight_D1;
-      }
-      min[mindex] = m;
-   }
-   
-   s2index = 0;
-   for (j=0; j<len; j++, s2index++)  {
-      rep2 = (s2index>0 && (strcmp(set2[s2index], 
-				   set2[s2index-1]) == 0));
-      mindex = 0;
-      cost = min[mindex];
-      m = cost + (rep2 ? weight_R2 : weight_D2);
-   
-      min[mindex++] = m;
-   
-      s1index = 0;
-      for (i=0; i<len; i++, s1index++)  {
-         rep1 = (s1index>0) && 
-             (strcmp(set1[s1index], 
-                     set1[s1index-1]) == 0);
-	       
-         m += rep1 ? weight_R1 : weight_D1;
-   
-         if (strcmp(set1[s1index],set2[s2index]) == 0) {
-            val = cost;
-         } else  {
-            if (rep1) {
-               val = cost + (rep2? weight_S3:weight_S1);
-            } else { 
-               val = cost + (rep2? weight_S2:weight_S0);
-            }
-         }
-         if (val < m) {
-            m = val;
-         }
-   
-	 cost = min[mindex];
-         val = cost + (rep2 ? weight_R2 : weight_D2);
-         if (val < m) {
-            m = val;
-         }
-   
-	 min[mindex++] = m;
-      }
+//////////////////////////////
+//
+// getSymbols -- Convert tokens into symbol numbers for EditDistance.
+//
+
+void getSymbols(vector<int>& symbols, Array<Array<char> >& tokens) {
+   symbols.resize(tokens.getSize());
+   for (int i=0; i<tokens.getSize(); i++) {
+      symbols[i] = Distance.getSymbol(tokens[i].getBase());
    }
+}
+
+
+//////////////////////////////
+//
+// printWeights --
+//
 
-   return (double)m;
+void printWeights(void) {
+   cout << "!! weight_R1: " << weight_R1 << "\n";
+   cout << "!! weight_R2: " << weight_R2 << "\n";
+   cout << "!! weight_D1: " << weight_D1 << "\n";
+   cout << "!! weight_D2: " << weight_D2 << "\n";
+   cout << "!! weight_S0: " << weight_S0 << "\n";
+   cout << "!! weight_S1: " << weight_S1 << "\n";
+   cout << "!! weight_S2: " << weight_S2 << "\n";
+   cout << "!! weight_S3: " << weight_S3 << endl;
 }
 
 
@@ -19,6 +19,9 @@
 // Last Midified: Mon Nov  7 10:40:00 PST 2011 added + == # for pitch search
 // Last Midified: Mon Nov 12 17:09:30 PST 2012 added note offsets
 // Last Midified: Thu Nov 14 02:31:24 WET 2019 convert to STL
+// Last Modified: Sat Oct 17 18:26:56 PDT 2026 use .tix n-gram index files
+// Last Modified: Sat Oct 17 20:14:50 PDT 2026 use MultiPatternMatcher
+// Last Modified: Sat Oct 17 20:24:34 PDT 2026 JIT compile the search
 // Filename:      ...museinfo/examples/all/themax.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/themax.cpp
 // Syntax:        C++; museinfo
@@ -88,11 +91,15 @@
 
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
+#include "NgramIndex.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -124,9 +131,16 @@ void      appendToSearchString   (string& ss, const string& string,
                                   char marker, int anchor);
 void      showCleanedParameters  (void);
 int       searchForMatches       (const string& filename, string& ss,
-                                  PerlRegularExpression& re, int mcount);
+                                  MultiPatternMatcher& matcher, int mcount);
 int       searchForMatches       (istream& inputfile, string& ss,
-                                  PerlRegularExpression& re, int mcount);
+                                  MultiPatternMatcher& matcher, int mcount);
+int       searchCandidates       (istream& inputfile, NgramIndex& index,
+                                  vector<int>& lines,
+                                  MultiPatternMatcher& matcher, int mcount);
+int       searchLine             (string& line, MultiPatternMatcher& matcher,
+                                  PerlRegularExpression& noteoffsettest,
+                                  int& counter, int& mcount);
+int       getIndexCandidates     (vector<int>& lines, NgramIndex& index);
 void      prepareInterval        (string& data);
 int       checkLink              (string& line, int offset);
 void      getSimpleLocationINT   (vector<int>& positions, string& line,
@@ -221,6 +235,9 @@ string      kernstring   = "";      // used with -k option
 int         limitQ       = 0;       // used with --limit option
 int         limitval     = 0;       // used with --limit option
 string      filetag;                // used with -f option
+int         indexQ       = 1;       // used with --no-index option
+int         jitQ         = 1;       // used with --no-jit option
+vector<pair<char, string> > featurequery; // cleaned queries for .tix search
 int         TOTALCOUNT   = 0;       // used for --total option, hack for some problem where count is
                                     //    returning file count instead of match count.
 
@@ -459,14 +476,21 @@ int main(int argc, char** argv) {
 		exit(0);
 	}
 
-	pre.initializeSearchAndStudy(ss.c_str());
+	// The search is run on every line of index files which can be many
+	// megabytes long, so compiling it to machine code is worthwhile.
+	MultiPatternMatcher matcher;
+	matcher.setJit(jitQ);
+	if (matcher.addPattern(ss) < 0) {
+		cerr << matcher.getError() << endl;
+		exit(1);
+	}
 	int totalcount = 0;
 	if (options.getArgCount() == 0) {
 		// standard input
-		totalcount += searchForMatches(cin, ss, pre, totalcount);
+		totalcount += searchForMatches(cin, ss, matcher, totalcount);
 	} else {
 		for (int i=1; i<=options.getArgCount(); i++) {
-			totalcount += searchForMatches(options.getArgument(i), ss, pre, totalcount);
+			totalcount += searchForMatches(options.getArgument(i), ss, matcher, totalcount);
 			if (limitQ && (totalcount >= limitval)) {
 				break;
 			}
@@ -493,7 +517,7 @@ int main(int argc, char** argv) {
 //
 
 int searchForMatches(const string& filename, string& ss,
-		PerlRegularExpression& pre, int mcount) {
+		MultiPatternMatcher& matcher, int mcount) {
 
 	ifstream inputfile;
 	inputfile.open(filename);
@@ -501,86 +525,201 @@ int searchForMatches(const string& filename, string& ss,
 		return 0;
 	}
 
-	int count = searchForMatches(inputfile, ss, pre, mcount);
+	// If tindex --tix created an n-gram index for this file, only the
+	// lines which contain the literal parts of the query need to be
+	// searched.  Inverted searches and -B need to check every line.
+	if (indexQ && !notQ && boundaryQ) {
+		inputfile.seekg(0, ios::end);
+		long filesize = (long)inputfile.tellg();
+		inputfile.seekg(0, ios::beg);
+		NgramIndex index;
+		vector<int> lines;
+		if (index.read(filename + ".tix", filesize) &&
+				getIndexCandidates(lines, index)) {
+			if (verboseQ) {
+				cerr << "Searching " << lines.size() << " of "
+				     << index.getLineCount() << " lines in "
+				     << filename << endl;
+			}
+			int count = searchCandidates(inputfile, index, lines, matcher, mcount);
+			inputfile.close();
+			return count;
+		}
+	}
+
+	int count = searchForMatches(inputfile, ss, matcher, mcount);
 	inputfile.close();
 	return count;
 }
 
 
 
+//////////////////////////////
+//
+// searchCandidates -- search only the given lines of an index file.
+//     The line list must be sorted.
+//
+
+int searchCandidates(istream& inputfile, NgramIndex& index,
+		vector<int>& lines, MultiPatternMatcher& matcher, int mcount) {
+
+	PerlRegularExpression noteoffsettest;
+	noteoffsettest.initializeSearchAndStudy("[^\\t]+;(\\d+)\\t");
+	string line;
+	int counter = 0;
+	long position = 0;
+	for (int i=0; i<(int)lines.size(); i++) {
+		long offset = index.getLineOffset(lines[i]);
+		if (offset != position) {
+			inputfile.clear();
+			inputfile.seekg(offset, ios::beg);
+		}
+		getline(inputfile, line);
+		position = index.getLineOffset(lines[i]+1);
+		if (searchLine(line, matcher, noteoffsettest, counter, mcount)) {
+			break;
+		}
+	}
+	return counter;
+}
+
+
+
 //////////////////////////////
 //
 // searchForMatches -- Should be merged with above function.
 //
 
 int searchForMatches(istream& inputfile, string& ss,
-		PerlRegularExpression& pre, int mcount) {
+		MultiPatternMatcher& matcher, int mcount) {
 
-	PerlRegularExpression blanktest;
-	PerlRegularExpression messagetest;
 	PerlRegularExpression noteoffsettest;
 	noteoffsettest.initializeSearchAndStudy("[^\\t]+;(\\d+)\\t");
 	string line;
-	int offset = 1;
-	int state;
-	int i;
 	int counter = 0;
 	while (!inputfile.eof()) {
 		getline(inputfile, line);
-		if (!boundaryQ) {
-			removeBoundaryCharacters(line);
-		}
-		if (blanktest.search(line, "^\\s*$", "")) {
-			continue;
-		}
-		if (line[0] == '#') {
-			if (!quietQ) {
-				// Echo control messages in the index file.
-				cout << line << "\n";
-			}
-			continue;
+		if (searchLine(line, matcher, noteoffsettest, counter, mcount)) {
+			break;
 		}
-		state = pre.search(line);
-		if (!state) {
-			continue;
+	}
+	return counter;
+}
+
+
+
+//////////////////////////////
+//
+// searchLine -- check a line from an index file for a match, and print
+//    any match.  Returns true if the match limit has been reached.
+//
+
+int searchLine(string& line, MultiPatternMatcher& matcher,
+		PerlRegularExpression& noteoffsettest, int& counter, int& mcount) {
+	PerlRegularExpression blanktest;
+	int offset = 1;
+	int state;
+	int i;
+
+	if (!boundaryQ) {
+		removeBoundaryCharacters(line);
+	}
+	if (blanktest.search(line, "^\\s*$", "")) {
+		return 0;
+	}
+	if (line[0] == '#') {
+		if (!quietQ) {
+			// Echo control messages in the index file.
+			cout << line << "\n";
 		}
-		if (noteoffsettest.search(line)) {
-			offset = atoi(noteoffsettest.getSubmatch(1));
-		} else {
-			offset = 1;
+		return 0;
+	}
+	state = matcher.search(line);
+	if (!state) {
+		return 0;
+	}
+	if (noteoffsettest.search(line)) {
+		offset = atoi(noteoffsettest.getSubmatch(1));
+	} else {
+		offset = 1;
+	}
+	if (state && (!unlinkQ) && (!anchoredQ) && (featureCount > 1)) {
+		state = checkLink(line, offset);
+	} else if (state && (countQ || locationQ || location2Q)) {
+		counter += checkLink(line, offset);
+		mcount++;
+		return 0;
+	}
+	if ((state && !notQ) || (notQ && !state)) {
+		counter++;
+		mcount++;
+		if (verboseQ) {
+			cout << "Matches in <STDIN>" << endl;
 		}
-		if (state && (!unlinkQ) && (!anchoredQ) && (featureCount > 1)) {
-			state = checkLink(line, offset);
-		} else if (state && (countQ || locationQ || location2Q)) {
-			counter += checkLink(line, offset);
-			mcount++;
-			continue;
+		if (totalQ) {
+			return 0;
 		}
-		if ((state && !notQ) || (notQ && !state)) {
-			counter++;
-			mcount++;
-			if (verboseQ) {
-				cout << "Matches in <STDIN>" << endl;
+		if (shortQ && (!countQ && !locationQ && !location2Q)) {
+			i = 0;
+			while ((i < (int)line.size()) && (line[i] != '\t')) {
+				cout << line[i];
+				i++;
 			}
-			if (totalQ) {
+			cout << "\n";
+		} else if (!countQ && !locationQ && !location2Q) {
+			cout << line << "\n";
+		}
+	}
+	if (limitQ && (mcount >= limitval)) {
+		return 1;
+	}
+	return 0;
+}
+
+
+
+//////////////////////////////
+//
+// getIndexCandidates -- use an n-gram index to find the lines which
+//    contain all of the literal text in the feature queries.  Control
+//    lines are included so that they are echoed as in a full search.
+//    Returns false if none of the queries can be searched for in the
+//    index, in which case every line needs to be searched.
+//
+
+int getIndexCandidates(vector<int>& lines, NgramIndex& index) {
+	vector<string> literals;
+	vector<int> found;
+	int usedQ = 0;
+	lines.clear();
+	for (int i=0; i<(int)featurequery.size(); i++) {
+		MultiPatternMatcher::getRegexLiterals(literals, featurequery[i].second);
+		for (int j=0; j<(int)literals.size(); j++) {
+			if (index.searchLiteral(found, featurequery[i].first,
+					literals[j]) < 0) {
 				continue;
 			}
-			if (shortQ && (!countQ && !locationQ && !location2Q)) {
-				i = 0;
-				while ((i < (int)line.size()) && (line[i] != '\t')) {
-					cout << line[i];
-					i++;
-				}
-				cout << "\n";
-			} else if (!countQ && !locationQ && !location2Q) {
-				cout << line << "\n";
+			if (!usedQ) {
+				lines.swap(found);
+				usedQ = 1;
+			} else {
+				NgramIndex::intersect(lines, found);
 			}
 		}
-		if (limitQ && (mcount >= limitval)) {
-			break;
-		}
 	}
-	return counter;
+	if (!usedQ) {
+		return 0;
+	}
+
+	if (!quietQ) {
+		vector<int> controls;
+		vector<int> merged;
+		index.getControlLines(controls);
+		merge(lines.begin(), lines.end(), controls.begin(), controls.end(),
+				back_inserter(merged));
+		lines.swap(merged);
+	}
+	return 1;
 }
 
 
@@ -1893,6 +2032,7 @@ void appendToSearchString(string& ss, const string& astring, char marker, int an
 			ss += '\\';
 	}
 	ss += marker;
+	featurequery.push_back(make_pair(marker, astring));
 
 	// add [^\t]* if not anchored:
 	//
@@ -1985,6 +2125,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("unlink=b",           "unlink search features");
 	opts.define("smart=b",            "do a smart search");
 	opts.define("Q|no-messages=b",    "do not echo control messages from input data");
+	opts.define("no-index=b",         "do not use .tix n-gram index files");
+	opts.define("no-jit=b",           "do not JIT compile the search");
 
 	opts.define("author=b",           "author of program");
 	opts.define("version=b",          "compilation info");
@@ -2027,6 +2169,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	regexQ                 =  opts.getBoolean("regex");
 	boundaryQ              = !opts.getBoolean("no-boundary");
 	smartQ                 =  opts.getBoolean("smart");
+	indexQ                 = !opts.getBoolean("no-index");
+	jitQ                   = !opts.getBoolean("no-jit");
 	majorQ                 =  opts.getBoolean("major");
 	minorQ                 =  opts.getBoolean("minor");
 	tonicQ                 =  opts.getBoolean("tonic");
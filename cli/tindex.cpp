@@ -21,6 +21,10 @@
 // Last Modified: Thu May 24 12:28:08 PDT 2012 added -u and -I options
 // Last Modified: Mon Nov 12 13:56:29 PST 2012 added !noff: processing
 // Last Modified: Sun Apr  7 00:38:49 PDT 2013 Enabled multiple segment input
+// Last Modified: Sat Oct 17 18:26:56 PDT 2026 added --tix n-gram index output
+// Last Modified: Sat Oct 17 20:48:28 PDT 2026 single-pass features, --threads
+// Last Modified: Sat Oct 17 23:41:43 PDT 2026 added IndexWriter
+// Last Modified: Sat Oct 17 23:42:17 PDT 2026 fixed -B and --istn option strings
 // Filename:      ...museinfo/examples/all/tindex.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/tindex.cpp
 // Syntax:        C++; museinfo
@@ -50,6 +54,15 @@
 //  '    = metric level
 //  =    = metric position
 //
+// Each file is scanned once to build a table of the notes in every
+// voice (track and layer).  The pitch, duration and metric sequences of
+// a voice are then extracted together from its note list, and the
+// features of each sequence are generated in one pass over it.  The
+// index lines for a file are collected in a string, and an IndexWriter
+// writes the strings of all files to standard output in 1 MB blocks.
+// With --threads, files are indexed in parallel, and their strings are
+// written in the same order as when using one thread.
+//
 // Todo: When a medial or final tie does not match to
 // an opening tie, that tied note should be indexed.
 // This case occurs at multiple repeat endings in scores.
@@ -62,9 +75,16 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "humdrum.h"
 #include "PerlRegularExpression.h"
+#include "NgramIndex.h"
 
 using namespace std;
 
@@ -87,6 +107,13 @@ using namespace std;
 
 #define RESTDUR -1000
 
+// number of files for each thread which can be indexed ahead of
+// the file being written:
+#define FILES_AHEAD_PER_THREAD 16
+
+// size of the output blocks written by IndexWriter:
+#define INDEX_WRITER_SIZE (1 << 20)
+
 
 class ISTN {
 	protected:
@@ -142,56 +169,114 @@ class ISTN {
 };
 
 
+
+// IndexWriter -- collects the index records of files in one buffer
+// which is written to standard output in large blocks (and when the
+// writer is flushed or destroyed).
+class IndexWriter {
+	public:
+		IndexWriter(void) { buffer.reserve(INDEX_WRITER_SIZE); }
+		~IndexWriter() { flush(); }
+
+		void write(const string& text) {
+			buffer += text;
+			if (buffer.size() >= INDEX_WRITER_SIZE) {
+				flush();
+			}
+		}
+
+		void flush(void) {
+			if (!buffer.empty()) {
+				cout.write(buffer.data(), buffer.size());
+				buffer.clear();
+			}
+		}
+
+	protected:
+		string buffer;
+};
+
+
+
+// VoiceNote -- location of a non-null token in a voice.  breakQ is
+// true if the voice did not continue from the previous data line, in
+// which case a segmentation marker is placed before the note.
+class VoiceNote {
+	public:
+		int line;
+		int field;
+		int breakQ;
+};
+
+
+// IndexFile -- analyses of a file which are shared by the index
+// records of all of its voices.
+class IndexFile {
+	public:
+		int    mode;              // key mode (0 = major, 1 = minor)
+		int    tonic;             // key tonic in base-40 (-1 = unknown)
+		char   longchar;          // RDF marker for long durations
+		string meter;             // meter description
+		string bibs;              // sorted bibliographic records
+		vector<int> metlev;       // metric level of each line
+		vector<vector<vector<VoiceNote> > > voices; // notes by track, layer
+};
+
+
 // function declarations:
 void      checkOptions           (Options& opts, int argc, char** argv);
 void      example                (void);
 void      usage                  (const char* command);
-void      createIndex            (HumdrumFile& infile, const string& xfilename);
-void      createIndexEnding      (HumdrumFile& infile, int track, int layer);
-void      extractPitchSequence   (vector<int>& pitches, HumdrumFile& infile,
-                                  int track, int layer);
-void      extractDurationSequence(vector<double>& durations, HumdrumFile& infile,
-                                  int track, int layer);
-void      extractMetricSequence  (vector<double>& metriclevels,
+void      createIndex            (ostream& out, HumdrumFile& infile,
+                                  const string& xfilename);
+void      createIndexEnding      (ostream& out, HumdrumFile& infile,
+                                  IndexFile& info, int track, int layer);
+void      prepareIndexFile       (IndexFile& info, HumdrumFile& infile);
+void      buildNoteTable         (vector<vector<vector<VoiceNote> > >& voices,
+                                  HumdrumFile& infile);
+void      extractNoteSequences   (vector<int>& pitches,
+                                  vector<double>& durations,
+                                  vector<double>& metriclevels,
                                   vector<RationalNumber>& metricpositions,
-                                  HumdrumFile& infile, int track, int layer);
+                                  HumdrumFile& infile, IndexFile& info,
+                                  vector<VoiceNote>& notes);
 void      getKey                 (HumdrumFile& infile, int& mode, int& tonic);
-void      printKey               (int mode, int tonic);
-void      printMeter             (HumdrumFile& infile);
-int       getMaxLayer            (HumdrumFile& infile, int track);
-
-// pitch sequence printing:
-void      printPitch             (vector<int>& pitches);
-void      printGrossContour      (vector<int>& pitches);
-void      printRefinedContour    (vector<int>& pitches);
-void      print12toneInterval    (vector<int>& pitches);
-void      print12tonePitch       (vector<int>& pitches);
-void      printScaleDegree       (vector<int>& pitches, int tonic);
-void      printMusicalInterval   (vector<int>& pitches);
-
-// rhythm sequence printing:
-void      printGrossContourRhythm (vector<double>& durations);
-void      printRefinedContourRhythm(vector<double>& durations);
-void      printMetricLevel        (vector<double>& levels);
-void      printMetricRefinedContour     (vector<double>& levels);
-void      printMetricGrossContour (vector<double>& levels);
-void      printBeatLevel          (vector<double>& levels);
-void      printDuration           (vector<double>& levels);
-void      printMetricPosition     (vector<RationalNumber>& positions);
+void      printKey               (ostream& out, int mode, int tonic);
+void      printMeter             (ostream& out, HumdrumFile& infile);
+
+// feature printing:
+void      printPitchFeatures     (ostream& out, vector<int>& pitches,
+                                  int tonic);
+void      printRhythmFeatures    (ostream& out, vector<double>& durations,
+                                  vector<double>& levels,
+                                  vector<RationalNumber>& positions);
+void      appendMusicalInterval  (string& output, int interval);
+void      appendDuration         (string& output, double duration);
+int       hasFermata             (const char* token);
 
 void      extractFeatureSet      (const char* features);
 int       is_directory           (const char* path);
 int       is_file                (const char* path);
-void      processArgument        (const char* path);
+int       is_index_file          (const char* path);
+void      getFileList            (vector<string>& filelist, const char* path);
+void      indexFile              (string& output, const string& path);
+void      indexFiles             (vector<string>& filelist);
+void      indexFilesWorker       (vector<string>& filelist,
+                                  vector<string>& outputs,
+                                  vector<char>& readyQ, int& next,
+                                  int& written, mutex& lock,
+                                  condition_variable& ready);
 void      fillIstnDatabase       (vector<ISTN>& istndatabase,
                                   const char* istnfile);
 string    getIstn                (const string& filename);
 int       bibsort                (const void* a, const void* b);
 void      processBibRecords      (ostream& out, HumdrumFile &infile,
                                   const char* bibfilter);
-void      printInstrument        (HumdrumFile& infile, int track);
+void      printInstrument        (ostream& out, HumdrumFile& infile,
+                                  int track);
 char      identifyLongMarker     (HumdrumFile& infile);
-void      printSpineNoteInfo(HumdrumFile& infile, int track, int subtrack);
+void      printSpineNoteInfo     (ostream& out, HumdrumFile& infile,
+                                  int track, int subtrack);
 char*     getOriginalFileName    (char* buffer, HumdrumFile& infile,
                                   const string& filename);
 
@@ -219,14 +304,16 @@ int         istnQ    = 0;      // used with --istn option
 int         bibQ     = 0;      // used with -b option
 int         fileQ    = 0;      // used with --file option
 string      Filename = "";     // used with --file option
-char        FileBuffer[1024] = {0}; // used with !!original-filename:
 int         instrumentQ = 0;   // used with -i option
 int         dirprefixQ = 0;    // used with -d option
 string dirprefix;         // used with -d option
 int         allQ       = 0;    // used with --all option
+int         tixQ       = 0;    // used with --tix option
+string      tixfile;           // used with --tix option
+int         threadcount = 1;   // used with --threads option
 
-const char* bibfilter = "";    // used with -B option
-const char* istnfile= "";      // used with --istn option
+string      bibfilter;         // used with -B option
+string      istnfile;          // used with --istn option
 vector<ISTN> istndatabase;      // used with --istn option
 
 #define PSTATESIZE 128
@@ -258,6 +345,25 @@ int main(int argc, char** argv) {
 	int numinputs = options.getArgCount();
 	HumdrumFileSet infiles;
 
+	// With --tix, everything printed to standard output is also added
+	// to a binary n-gram index which themax can use to find candidate
+	// lines without searching the entire text index.
+	const char markers[] = {
+		P_PITCH_CLASS_MARKER, P_DIATONIC_INTERVAL_MARKER,
+		P_SCALE_DEGREE_MARKER, P_12TONE_INTERVAL_MARKER,
+		P_PITCH_REFINED_CONTOUR_MARKER, P_GROSS_CONTOUR_MARKER,
+		P_12TONE_PITCH_CLASS_MARKER, R_DURATION_GROSS_CONTOUR_MARKER,
+		R_DURATION_REFINED_CONTOUR_MARKER, R_DURATION_MARKER,
+		R_BEAT_LEVEL_MARKER, R_METRIC_POSITION_MARKER,
+		R_METRIC_LEVEL_MARKER, R_METRIC_GROSS_CONTOUR_MARKER,
+		R_METRIC_REFINED_CONTOUR_MARKER, '\0' };
+	NgramIndex ngramindex(markers);
+	streambuf* coutbuffer = cout.rdbuf();
+	NgramIndexBuffer tixbuffer(coutbuffer, ngramindex);
+	if (tixQ) {
+		cout.rdbuf(&tixbuffer);
+	}
+
 	// use --verbose to print default settings.
 	if (!quietQ) {
 		if (!graceQ) {
@@ -291,15 +397,30 @@ int main(int argc, char** argv) {
 	}
 
 
-	for (int i=0; i<numinputs || i==0; i++) {
+	if (numinputs < 1) {
 		// if no command-line arguments read data file from standard input
-		if (numinputs < 1) {
-			infiles.read(cin);
-			for (int j=0; j<infiles.getCount(); j++) {
-				createIndex(infiles[j], infiles[j].getFilename());
-			}
-		} else {
-			processArgument(options.getArg(i+1).c_str());
+		infiles.read(cin);
+		IndexWriter writer;
+		stringstream output;
+		for (int j=0; j<infiles.getCount(); j++) {
+			output.str("");
+			createIndex(output, infiles[j], infiles[j].getFilename());
+			writer.write(output.str());
+		}
+	} else {
+		vector<string> filelist;
+		for (int i=0; i<numinputs; i++) {
+			getFileList(filelist, options.getArg(i+1).c_str());
+		}
+		indexFiles(filelist);
+	}
+
+	if (tixQ) {
+		cout.flush();
+		cout.rdbuf(coutbuffer);
+		if (!ngramindex.write(tixfile)) {
+			cerr << "Error: cannot write n-gram index " << tixfile << endl;
+			exit(1);
 		}
 	}
 
@@ -308,50 +429,21 @@ int main(int argc, char** argv) {
 
 
 //////////////////////////////////////////////////////////////////////////
-
-
 //////////////////////////////
 //
-// processArgument -- check if the argument is a file or a directory.
-//    if a directory, then process all files/subdirectories in it.
+// getFileList -- check if the argument is a file or a directory.
+//    if a directory, then add all files/subdirectories in it to
+//    the list of files to index.
 //
 
-void processArgument(const char* path) {
-	HumdrumFileSet infiles;
+void getFileList(vector<string>& filelist, const char* path) {
 	DIR* dir = NULL;
-	char* fullname;
 	struct dirent* entry;
-	int namelen = 0;
-	int valid = 0;
-	string filename;
+	string fullname;
 
 	if (is_file(path)) {
-		namelen = strlen(path);
-		valid = 0;
-		if (allQ) {
-			valid = 1;
-		} else {
-			if (strcmp(&(path[namelen-4]), ".thm") == 0) {
-				valid = 1;
-			} else if (strcmp(&(path[namelen-4]), ".krn") == 0) {
-				valid = 1;
-			} else if (strcmp(&(path[namelen-4]), ".THM") == 0) {
-				valid = 1;
-			} else if (strcmp(&(path[namelen-4]), ".KRN") == 0) {
-				valid = 1;
-			}
-		}
-		if (!valid) {
-			return;
-		}
-		infiles.read(path);
-		int i;
-		for (i=0; i<infiles.getCount(); i++) {
-			filename = infiles[i].getFilename();
-			if (filename.empty()) {
-				filename = path;
-			}
-			createIndex(infiles[i], filename);
+		if (is_index_file(path)) {
+			filelist.push_back(path);
 		}
 	} else if (is_directory(path)) {
 		dir = opendir(path);
@@ -364,12 +456,10 @@ void processArgument(const char* path) {
 				entry = readdir(dir);
 				continue;
 			}
-
-			fullname = new char[strlen(path) + 1 + strlen(entry->d_name) + 1];
-			strcpy(fullname, path);
-			strcat(fullname, "/");
-			strcat(fullname, entry->d_name);
-			processArgument(fullname);
+			fullname = path;
+			fullname += "/";
+			fullname += entry->d_name;
+			getFileList(filelist, fullname.c_str());
 			entry = readdir(dir);
 		}
 	}
@@ -381,6 +471,157 @@ void processArgument(const char* path) {
 }
 
 
+
+//////////////////////////////
+//
+// is_index_file -- returns true if the file has an extension which
+//    should be indexed (any extension with the -A option).
+//
+
+int is_index_file(const char* path) {
+	if (allQ) {
+		return 1;
+	}
+	int namelen = strlen(path);
+	if (namelen < 4) {
+		return 0;
+	}
+	const char* extension = &(path[namelen-4]);
+	if (strcmp(extension, ".thm") == 0) {
+		return 1;
+	} else if (strcmp(extension, ".krn") == 0) {
+		return 1;
+	} else if (strcmp(extension, ".THM") == 0) {
+		return 1;
+	} else if (strcmp(extension, ".KRN") == 0) {
+		return 1;
+	}
+	return 0;
+}
+
+
+
+//////////////////////////////
+//
+// indexFiles -- create the index records for a list of files and
+//    print them to standard output in the order of the list.  With
+//    --threads, the files are indexed by a pool of threads, and the
+//    main thread prints the records of each file once they are ready.
+//    Threads only start files which are a limited number of files
+//    ahead of the file being printed.  The records are printed through
+//    an IndexWriter.
+//
+
+void indexFiles(vector<string>& filelist) {
+	int i;
+	int count = (int)filelist.size();
+	int tcount = threadcount;
+	if (tcount > count) {
+		tcount = count;
+	}
+
+	IndexWriter writer;
+	string output;
+	if (tcount <= 1) {
+		for (i=0; i<count; i++) {
+			indexFile(output, filelist[i]);
+			writer.write(output);
+		}
+		return;
+	}
+
+	vector<string> outputs(count);
+	vector<char> readyQ(count, 0);
+	int next = 0;
+	int written = 0;
+	mutex lock;
+	condition_variable ready;
+
+	vector<thread> workers;
+	for (i=0; i<tcount; i++) {
+		workers.push_back(thread(indexFilesWorker, ref(filelist), ref(outputs),
+				ref(readyQ), ref(next), ref(written), ref(lock), ref(ready)));
+	}
+
+	for (i=0; i<count; i++) {
+		unique_lock<mutex> guard(lock);
+		while (!readyQ[i]) {
+			ready.wait(guard);
+		}
+		output.swap(outputs[i]);
+		string().swap(outputs[i]);
+		written = i + 1;
+		guard.unlock();
+		ready.notify_all();
+		writer.write(output);
+	}
+
+	for (i=0; i<(int)workers.size(); i++) {
+		workers[i].join();
+	}
+}
+
+
+
+//////////////////////////////
+//
+// indexFilesWorker -- thread function for indexFiles() which indexes
+//    the next file in the list until all files have been indexed.
+//
+
+void indexFilesWorker(vector<string>& filelist, vector<string>& outputs,
+		vector<char>& readyQ, int& next, int& written, mutex& lock,
+		condition_variable& ready) {
+	int index;
+	int count = (int)filelist.size();
+	int ahead = threadcount * FILES_AHEAD_PER_THREAD;
+	string output;
+	while (1) {
+		unique_lock<mutex> guard(lock);
+		while ((next < count) && (next >= written + ahead)) {
+			ready.wait(guard);
+		}
+		if (next >= count) {
+			return;
+		}
+		index = next++;
+		guard.unlock();
+
+		indexFile(output, filelist[index]);
+
+		guard.lock();
+		outputs[index].swap(output);
+		readyQ[index] = 1;
+		guard.unlock();
+		ready.notify_all();
+	}
+}
+
+
+
+//////////////////////////////
+//
+// indexFile -- create the index records for all segments in a file.
+//
+
+void indexFile(string& output, const string& path) {
+	HumdrumFileSet infiles;
+	infiles.read(path.c_str());
+	stringstream out;
+	string filename;
+	int i;
+	for (i=0; i<infiles.getCount(); i++) {
+		filename = infiles[i].getFilename();
+		if (filename.empty()) {
+			filename = path;
+		}
+		createIndex(out, infiles[i], filename);
+	}
+	output = out.str();
+}
+
+
+
 //////////////////////////////
 //
 // is_file -- returns true if the string is a file.
@@ -437,16 +678,17 @@ string getIstn(const string& filename) {
 // is: [Zz] { # : % } j J M
 //
 
-void createIndex(HumdrumFile& infile, const string& xfilename) {
+void createIndex(ostream& out, HumdrumFile& infile, const string& xfilename) {
 	int i;
 	int maxtracks = infile.getMaxTracks();
 	string filename = xfilename;
+	char filebuffer[1024] = {0};
 
 	if (fileQ) {
 		// used to spoof filename for standard input
 		filename = Filename;
 	} else {
-		filename = getOriginalFileName(FileBuffer, infile, filename);
+		filename = getOriginalFileName(filebuffer, infile, filename);
 	}
 
 	PerlRegularExpression pre;
@@ -465,26 +707,29 @@ void createIndex(HumdrumFile& infile, const string& xfilename) {
 
 	pre.sar(printname, ":", "&colon;", "g");
 
+	IndexFile info;
+	prepareIndexFile(info, infile);
+
 	if (polyQ) {
 		for (i=1; i<=maxtracks; i++) {
 			if (infile.getTrackExInterp(i) != "**kern") {
 				continue;
 			}
 			if (istnQ) {
-				cout << getIstn(filename);
+				out << getIstn(filename);
 			} else {
-				cout << printname;
+				out << printname;
 			}
-			cout << ":";
+			out << ":";
 			if (instrumentQ) {
-				printInstrument(infile, i);
+				printInstrument(out, infile, i);
 			}
-			// cout << ":" << i;
-			cout << ":";
-			printSpineNoteInfo(infile, i, 1);
+			// out << ":" << i;
+			out << ":";
+			printSpineNoteInfo(out, infile, i, 1);
 			if (infile.getTrackExInterp(i) == "**kern") {
-				createIndexEnding(infile, i, 1);
-				cout << "\n";
+				createIndexEnding(out, infile, info, i, 1);
+				out << "\n";
 			}
 		}
 	} else if (poly2Q) {
@@ -493,54 +738,54 @@ void createIndex(HumdrumFile& infile, const string& xfilename) {
 				continue;
 			}
 			if (istnQ) {
-				cout << getIstn(filename);
+				out << getIstn(filename);
 			} else {
-				cout << printname;
+				out << printname;
 			}
 
 			// print voice label
-			cout << ":";
+			out << ":";
 			if (instrumentQ) {
-				printInstrument(infile, i);
+				printInstrument(out, infile, i);
 			}
 
 			// print spine, subspine and note offset values
-			// cout << ":" << i;
-			cout << ":";
-			printSpineNoteInfo(infile, i, 1);
+			// out << ":" << i;
+			out << ":";
+			printSpineNoteInfo(out, infile, i, 1);
 
-			createIndexEnding(infile, i, 1);
-			cout << "\n";
-			int maxlayer = getMaxLayer(infile, i);
+			createIndexEnding(out, infile, info, i, 1);
+			out << "\n";
+			int maxlayer = (int)info.voices[i].size();
 			int j;
 			for (j=2; j<=maxlayer; j++) {
 				if (istnQ) {
-					cout << getIstn(filename);
+					out << getIstn(filename);
 				} else {
-					cout << printname;
+					out << printname;
 				}
-				cout << ":";
+				out << ":";
 				if (instrumentQ) {
-					printInstrument(infile, i);
+					printInstrument(out, infile, i);
 				}
-				//cout << ":" << i << "." << j;
-				cout << ":";
-				printSpineNoteInfo(infile, i, j);
+				//out << ":" << i << "." << j;
+				out << ":";
+				printSpineNoteInfo(out, infile, i, j);
 
-				createIndexEnding(infile, i, j);
-				cout << "\n";
+				createIndexEnding(out, infile, info, i, j);
+				out << "\n";
 			}
 		}
 	} else if (monoQ) {
 		if (istnQ) {
-			cout << getIstn(filename);
+			out << getIstn(filename);
 		} else {
-			cout << printname;
+			out << printname;
 		}
 		for (i=1; i<=maxtracks; i++) {
 			if (infile.getTrackExInterp(i) == "**kern") {
-				createIndexEnding(infile, i, 1);
-				cout << "\n";
+				createIndexEnding(out, infile, info, i, 1);
+				out << "\n";
 				break;
    }
 		}
@@ -590,7 +835,8 @@ char* getOriginalFileName(char* buffer, HumdrumFile& infile,
 //    Would mean for that track/subtrack, the note offset value is 23.
 //
 
-void printSpineNoteInfo(HumdrumFile& infile, int track, int subtrack) {
+void printSpineNoteInfo(ostream& out, HumdrumFile& infile, int track,
+		int subtrack) {
 	int i, j;
 	int t, st;
 
@@ -628,49 +874,20 @@ void printSpineNoteInfo(HumdrumFile& infile, int track, int subtrack) {
 
 	// print the track number
 	if (newt >= 0) {
-		cout << newt;
+		out << newt;
 	} else {
-		cout << track;
+		out << track;
 	}
 
 	if (newst > 1) {
-		cout << newt;
+		out << newt;
 	} else if (subtrack > 1) {
-		cout << "." << subtrack;
+		out << "." << subtrack;
 	}
 
 	if (newoffset > 0) {
-		cout << ';' << newoffset;
-	}
-}
-
-
-
-//////////////////////////////
-//
-// getMaxLayer -- return the maximum number of subspines for the
-// given spine on any line.
-//
-
-int getMaxLayer(HumdrumFile& infile, int track) {
-	int i, j;
-	int maxlayer = 0;
-	int linelayer = 0;
-	for (i=0; i<infile.getNumLines(); i++) {
-		if (!infile[i].isData()) {
-			continue;
-		}
-		linelayer = 0;
-		for (j=0; j<infile[i].getFieldCount(); j++) {
-			if (infile[i].getPrimaryTrack(j) == track) {
-				linelayer++;
-			}
-		}
-		if (linelayer > maxlayer) {
-			maxlayer = linelayer;
-		}
+		out << ';' << newoffset;
 	}
-	return maxlayer;
 }
 
 
@@ -682,7 +899,7 @@ int getMaxLayer(HumdrumFile& infile, int track) {
 //    int that track.
 //
 
-void printInstrument(HumdrumFile& infile, int track) {
+void printInstrument(ostream& out, HumdrumFile& infile, int track) {
 	PerlRegularExpression pre;
 	int i, j;
 	for (i=0; i<infile.getNumLines(); i++) {
@@ -699,7 +916,7 @@ void printInstrument(HumdrumFile& infile, int track) {
 			if (pre.search(infile[i][j], "^\\*I\"(.*)$", "")) {
 				string iname = pre.getSubmatch(1);
 				pre.sar(iname, ":", "", "g");
-				cout << iname;
+				out << iname;
 				return;
 			}
 		}
@@ -714,149 +931,135 @@ void printInstrument(HumdrumFile& infile, int track) {
 // createIndexEnding -- The classical fixed order for the thema command
 // is: [Zz] { # : % } j J M
 //
-// Returns the maximum number of layers occuring at any point in the file.
-//
 
-void createIndexEnding(HumdrumFile& infile, int track, int layer) {
+void createIndexEnding(ostream& out, HumdrumFile& infile, IndexFile& info,
+		int track, int layer) {
 	vector<int>    pitches;
 	vector<double> durations;
 	vector<double> metriclevels;
 	vector<RationalNumber> metricpositions;
-	extractPitchSequence(pitches, infile, track, layer);
-
-	int mode = 0;
-	int tonic = 2;
-	getKey(infile, mode, tonic);
-
-	if (extraQ) {
-		cout << '\t';	printKey(mode, tonic);
-	}
-
-	if (pstate[p12toneInterval]) {
-		cout << '\t';	print12toneInterval(pitches);
-	}
+	vector<VoiceNote> nonotes;
 
-	if (pstate[pRefinedContour]) {
-		cout << '\t';	printRefinedContour(pitches);
+	vector<VoiceNote>* notes = &nonotes;
+	if (layer <= (int)info.voices[track].size()) {
+		notes = &info.voices[track][layer-1];
 	}
+	extractNoteSequences(pitches, durations, metriclevels, metricpositions,
+			infile, info, *notes);
 
-	if (pstate[pGrossContour]) {
-		cout << '\t';	printGrossContour(pitches);
-	}
-
-	if (pstate[pScaleDegree]) {
-		cout << '\t';	printScaleDegree(pitches, tonic);
-	}
-
-	if (pstate[pMusicalInterval]) {
-		cout << '\t';	printMusicalInterval(pitches);
+	if (debugQ) {
+		out << "PITCHES: ";
+		for (int i=0; i<(int)pitches.size(); i++) {
+			out << pitches[i] << " ";
+		}
+		out << "\n";
 	}
 
-	if (pstate[p12tonePitch]) {
-		cout << '\t';	print12tonePitch(pitches);
+	if (extraQ) {
+		out << '\t';	printKey(out, info.mode, info.tonic);
 	}
 
-	if (pstate[pPitch]) {
-		cout << '\t';	printPitch(pitches);
-	}
+	printPitchFeatures(out, pitches, info.tonic);
 
 	if (extraQ) {
-		cout << '\t';	printMeter(infile);
+		out << '\t' << info.meter;
 	}
 
-	if (rhythmQ) {
-		extractDurationSequence(durations, infile, track, layer);
-		extractMetricSequence(metriclevels, metricpositions, infile, track, layer);
-	}
+	printRhythmFeatures(out, durations, metriclevels, metricpositions);
 
-	if (pstate[pDurationGrossContour]) {
-		cout << '\t';	printGrossContourRhythm(durations);
+	if (bibQ) {
+		out << info.bibs;
 	}
+}
 
-	if (pstate[pDurationRefinedContour]) {
-		cout << '\t';	printRefinedContourRhythm(durations);
-	}
 
-	if (pstate[pDuration]) {
-		cout << '\t';	printDuration(durations);
-	}
 
-	if (pstate[pBeat]) {
-		cout << '\t';	printBeatLevel(metriclevels);
-	}
+//////////////////////////////
+//
+// prepareIndexFile -- do the analyses of a file which are needed by
+//    the index records of all of its voices.
+//
 
-	if (pstate[pMetricLevel]) {
-		cout << '\t';	printMetricLevel(metriclevels);
-	}
+void prepareIndexFile(IndexFile& info, HumdrumFile& infile) {
+	getKey(infile, info.mode, info.tonic);
 
-	if (pstate[pMetricRefinedContour]) {
-		cout << '\t';	printMetricRefinedContour(metriclevels);
+	info.meter.clear();
+	if (extraQ) {
+		stringstream meter;
+		printMeter(meter, infile);
+		info.meter = meter.str();
 	}
 
-	if (pstate[pMetricGrossContour]) {
-		cout << '\t';	printMetricGrossContour(metriclevels);
+	info.bibs.clear();
+	if (bibQ) {
+		stringstream bibs;
+		processBibRecords(bibs, infile, bibfilter.c_str());
+		info.bibs = bibs.str();
 	}
 
-	if (pstate[pMetricPosition]) {
-		cout << '\t';	printMetricPosition(metricpositions);
+	info.longchar = 0;
+	info.metlev.clear();
+	if (rhythmQ) {
+		info.longchar = identifyLongMarker(infile);
+		infile.analyzeMetricLevel(info.metlev);
+		infile.analyzeRhythm();  // should already be done
 	}
 
-	if (bibQ) {
-		processBibRecords(cout, infile, bibfilter);
-	}
+	buildNoteTable(info.voices, infile);
 }
 
 
 
 //////////////////////////////
 //
-// processBibRecords -- print bibliographic records sorted into
-//    alphabetical order
+// buildNoteTable -- make a list of the non-null tokens in each layer
+//     of each track with one pass through the file.  voices[track][layer-1]
+//     is the list for a layer.  The number of layers for a track is the
+//     maximum number of subspines for the track on any data line.
 //
 
-void processBibRecords(ostream& out, HumdrumFile &infile,
-		const char* bibfilter) {
-
-	vector<HumdrumRecord*> bibs;
-	bibs.reserve(infile.getNumLines());
-	int i, j;
-	PerlRegularExpression pre;
+void buildNoteTable(vector<vector<vector<VoiceNote> > >& voices,
+		HumdrumFile& infile) {
+	int maxtracks = infile.getMaxTracks();
+	voices.clear();
+	voices.resize(maxtracks+1);
 
-	vector<string> bfilt;
-	bfilt.reserve(100);
-	if (strcmp(bibfilter, "") != 0) {
-		PerlRegularExpression::getTokens(bfilt, "[:,\\s]+", bibfilter);
-	}
+	// number of fields for each track on the current/last data line:
+	vector<int> layercounts(maxtracks+1, 0);
+	vector<int> lastlayercounts(maxtracks+1, 0);
 
-	int valid;
-	char buffer[1024] = {0};
+	VoiceNote note;
+	int i, j;
+	int track;
+	int layer;
 	for (i=0; i<infile.getNumLines(); i++) {
-		if (infile[i].isBibliographic()) {
-			if (bfilt.size() > 0) {
-				valid = 0;
-				infile[i].getBibKey(buffer, 1000);
-				for (j=0; j<(int)bfilt.size(); j++) {
-					if (pre.search(buffer, bfilt[j].c_str(), "")) {
-						valid = 1;
-						break;
-					}
-				}
-				if (valid == 0) {
-					continue;
-				}
+		if (infile[i].getType() != E_humrec_data) {
+			continue;
+		}
+		fill(layercounts.begin(), layercounts.end(), 0);
+		for (j=0; j<infile[i].getFieldCount(); j++) {
+			track = infile[i].getPrimaryTrack(j);
+			if ((track < 1) || (track > maxtracks)) {
+				continue;
 			}
-			bibs.push_back(&infile[i]);
+			layer = ++layercounts[track];
+			if ((int)voices[track].size() < layer) {
+				voices[track].resize(layer);
+			}
+			if (strcmp(infile[i][j], ".") == 0) {
+				// ignore null tokens
+				continue;
+			}
+			note.line   = i;
+			note.field  = j;
+			// insert segmentation marker into the data since this layer
+			// does not continue directly from the last occurance of the
+			// layer.
+			note.breakQ = (lastlayercounts[track] != 0) &&
+			              (lastlayercounts[track] < layer);
+			voices[track][layer-1].push_back(note);
 		}
-	}
-
-	qsort(bibs.data(), bibs.size(), sizeof(void*), bibsort);
-
-	string record;
-	for (i=0; i<(int)bibs.size(); i++) {
-		record = (*(bibs[i]))[0];
-		pre.sar(record, "\\t", " ", "g");
-		pre.sar(record, "\\s\\s+", " ", "g");
-		out << '\t' << record;
+		lastlayercounts.swap(layercounts);
 	}
 }
 
@@ -864,230 +1067,350 @@ void processBibRecords(ostream& out, HumdrumFile &infile,
 
 //////////////////////////////
 //
-// bibsort -- for sorting the tracks
-//
-
-int bibsort(const void* a, const void* b) {
-	HumdrumRecord& abib = **((HumdrumRecord**)a);
-	HumdrumRecord& bbib = **((HumdrumRecord**)b);
-	return strcmp(abib[0], bbib[0]);
-}
-
-
-
-//////////////////////////////
+// extractNoteSequences -- extract the pitch, duration and metric
+//     sequences of a voice in one pass through its notes.  Durations
+//     and metric information are only extracted for rhythm features.
 //
-// printGrossContourRhythm --
+// restrictions:
+//   (1) **kern data expected is track being searched
+//   (2) chords will be ignored, only first note in chord will be processed.
 //
 
-void printGrossContourRhythm(vector<double>& durations) {
-	int i;
-	cout << R_DURATION_GROSS_CONTOUR_MARKER;
-	for (i=1; i<(int)durations.size(); i++) {
-		if (durations[i-1] < 0.0) {
-			cout << "R";
-			continue;
-		}
-		if (durations[i] < 0.0) {
-			// ignore rest, will be printed in next loop.
-			continue;
-		}
-		if (durations[i] - durations[i-1] > 0) {
-			cout << '>';
-		} else if (durations[i] - durations[i-1] < 0) {
-			cout << '<';
-		} else {
-			// what is this line?
-			cout << R_METRIC_POSITION_MARKER;
-		}
+void extractNoteSequences(vector<int>& pitches, vector<double>& durations,
+		vector<double>& metriclevels, vector<RationalNumber>& metricpositions,
+		HumdrumFile& infile, IndexFile& info, vector<VoiceNote>& notes) {
+	pitches.resize(0);
+	durations.resize(0);
+	metriclevels.resize(0);
+	metricpositions.resize(0);
+	pitches.reserve(notes.size() + 1);
+	if (rhythmQ) {
+		durations.reserve(notes.size() + 1);
+		metriclevels.reserve(notes.size() + 1);
+		metricpositions.reserve(notes.size() + 1);
 	}
-}
 
+	int pitchesQ  = 1;        // still extracting pitches (-l option)
+	int durationsQ = rhythmQ; // still extracting durations (-l option)
+	int metricQ   = rhythmQ;  // extracting metric information
 
+	int durpitch = 0;  // last duration entry: note = 0, rest marker < 0
+	int metpitch = 0;  // last metric entry: note = 0, rest marker < 0
+	RationalNumber bignegative(-1000000,1);
+	double level = -1000000.0;
 
-//////////////////////////////
-//
-// printRefinedContourRhythm --
-//
-
-void printRefinedContourRhythm(vector<double>& durations) {
+	char notebuf[1024] = {0};
+	int subtokens;
+	int pitch;
+	double dur;
+	int line;
+	int field;
 	int i;
-	cout << R_DURATION_REFINED_CONTOUR_MARKER;
-	double value;
-	for (i=1; i<(int)durations.size(); i++) {
-		if (durations[i-1] < 0.0) {
-			cout << "R";
-			continue;
-		}
-		if (durations[i] < 0.0) {
-			// ignore rest, will be printed in next loop.
-			continue;
-		}
-		if (durations[i-1] == 0.0) {
-			if (durations[i] == 0.0) {
-				cout << "=";
+
+	for (i=0; i<(int)notes.size(); i++) {
+		line = notes[i].line;
+		field = notes[i].field;
+		HumdrumRecord& record = infile[line];
+		const char* token = record[field];
+
+		if (pitchesQ) {
+			if (notes[i].breakQ && (pitches.size() > 0) &&
+					(pitches.back() >= 0)) {
+				// only append segmentation marker if a segmentation marker
+				// is not present in the pitch sequence already.
+				pitches.push_back(-1);
+			}
+
+			subtokens = record.getTokenCount(field);
+			if (subtokens == 1) {
+				strcpy(notebuf, token);
+			} else if (endQ) {
+				record.getToken(notebuf, field, subtokens-1, 1000);
 			} else {
-				cout << "]";
+				record.getToken(notebuf, field, 0, 1000);
 			}
-		} else {
-			value = durations[i]/durations[i-1];
-			if (value > 2.0)       { cout << "]"; }
-			else if (value > 1.0)  { cout << ">"; }
-			else if (value == 1.0) { cout << "="; }
-			else if (value >= 0.5) { cout << "<"; }
-			else if (value < 0.5)  { cout << "["; }
-			else                   { cout << "X"; }
-		}
-	}
-}
 
-/* Old definition (a ratio between adjacent notes)
-
-void printRefinedContourRhythm(vector<double>& durations) {
-	int i;
-	cout << "^";
-	double value;
-	int ivalue;
-	for (i=1; i<(int)durations.size(); i++) {
-		if (durations[i-1] != 0.0) {
-			value = durations[i]/durations[i-1];
-			ivalue = (int)(value * 1000.0 + 0.5);
-		} else {
-			ivalue = 100000;
-		}
-		cout << ivalue << " ";
-	}
-}
-
-*/
-
-
-//////////////////////////////
-//
-// printDuration -- [2011/04/02] change code for Longa from 00 to L.
-//     and Breve from 0 to B so that grace notes do not interact with
-//     breve duration.
-//
-
-void printDuration(vector<double>& durations) {
-	int i;
-	int j;
-	int k;
-	int len;
-	char buffer[128] = {0};
-	cout << R_DURATION_MARKER;
-	stringstream temps;
-	int count;
-	for (i=0; i<(int)durations.size(); i++) {
-		if (durations[i] < 0) {
-			temps << "R ";
-			continue;
+			if ((!graceQ) && (strpbrk(notebuf, "qQ") != NULL)) {
+				// don't count grace notes if not wanted
+			} else if (strchr(notebuf, '_') != NULL) {
+				// ignore continuing ties
+			} else if (strchr(notebuf, ']') != NULL) {
+				// ignore ending ties
+			} else if (strchr(notebuf, 'r') != NULL) {
+				if ((pitches.size() > 0) && (pitches.back() < 0)) {
+					// already stored one rest, so ignore this one
+				} else if (phraseQ && (strchr(notebuf, '}') != NULL)) {
+					pitches.push_back(-1);
+				} else if (restQ) {
+					pitches.push_back(-1);
+				}
+			} else {
+				pitch = Convert::kernToBase40(notebuf);
+				if ((pitch < 0) || (pitch > 10000)) {
+					// ignore rests and other strange things
+				} else {
+					pitches.push_back(pitch);
+					if (limitQ && ((int)pitches.size() >= limit)) {
+						pitchesQ = 0;
+					} else if (fermataQ && hasFermata(notebuf)) {
+						pitches.push_back(-1);
+					} else if (phraseQ && (strchr(token, '}') != NULL)) {
+						// observe that phrase marks only occur once
+						// in a multi-stop token, so have to search
+						// the entire multi-stop token for a phrase ending
+						// mark which is usually at the end of the token.
+						pitches.push_back(-1);
+					}
+				}
+			}
 		}
 
-		if (durations[i] == 16.0) {
-			strcpy(buffer, "L");
-		} else if (durations[i] == 8.0) {
-			strcpy(buffer, "B");
-		} else if (durations[i] == 12.0) {
-			strcpy(buffer, "B.");
-		} else {
-			Convert::durationToKernRhythm(buffer, durations[i]);
-		}
+		// all notes in a chord should have the same duration
+		// so not bothering with adjusting for the --end option.
 
-		if (durations[i] > 0 && (buffer[0] == 'q')) {
-			count = (int)durations[i];
-			for (j=0; j<count; j++) {
-				temps << "4";
-			}
-			if (durations[i] - count > 0) {
-				Convert::durationToKernRhythm(buffer, durations[i]-count);
+		if (durationsQ) {
+			if (notes[i].breakQ && (durations.empty() ||
+					(durations.back() != -1.0))) {
+				durations.push_back(-1.0);
 			}
-         len = strlen(buffer);
-         for (k=0; k<len; k++) {
-				if (buffer[k] == '.') {
-					temps << "d";
+
+			if ((!graceQ) && (strpbrk(token, "qQ") != NULL)) {
+				// don't count grace notes if not wanted
+			} else if (strchr(token, '_') != NULL) {
+				// ignore continuing ties
+			} else if (strchr(token, ']') != NULL) {
+				// ignore ending ties
+			} else if (strchr(token, 'r') != NULL) {
+				if (durpitch < 0) {
+					// ignore repeated rests
+				} else if (phraseQ && (strchr(token, '}') != NULL)) {
+					durpitch = -1;
+					durations.push_back(-1.0);
+				} else if (restQ) {
+					durpitch = -1;
+					durations.push_back(RESTDUR);
+				}
+			} else {
+				durpitch = Convert::kernToBase40(token);
+				if ((durpitch < 0) || (durpitch > 10000)) {
+					// ignore rests and other strange things
 				} else {
-					temps << buffer[k];
+					dur = infile.getTiedDuration(line, field);
+					if (info.longchar && (strchr(token, info.longchar) != NULL)) {
+						dur = 16.0;
+					}
+					if ((!graceQ) && (dur <= 0.0)) {
+						// for some reason grace note was not filtered
+						// before, so filter it now.
+					} else {
+						durations.push_back(dur);
+						if (limitQ && ((int)durations.size() >= limit)) {
+							durationsQ = 0;
+						} else if (fermataQ && hasFermata(token)) {
+							durpitch = -1;
+							durations.push_back(-1.0);
+						} else if (phraseQ && (strchr(token, '}') != NULL)) {
+							durpitch = -1;
+							durations.push_back(-1.0);
+						}
+					}
 				}
 			}
-			temps << " ";
+		}
 
-		} else {
-         len = strlen(buffer);
-         for (k=0; k<len; k++) {
-				if (buffer[k] == '.') {
-					temps << "d";
-				} else {
-					temps << buffer[k];
+		if (metricQ) {
+			if (notes[i].breakQ && (metricpositions.empty() ||
+					(metricpositions.back() != bignegative))) {
+				metriclevels.push_back(level);
+				metricpositions.push_back(bignegative);
+			}
+
+			if ((!graceQ) && (strpbrk(token, "qQ") != NULL)) {
+				// don't count grace notes if not wanted
+			} else if (strchr(token, '_') != NULL) {
+				// ignore continuing ties
+			} else if (strchr(token, ']') != NULL) {
+				// ignore ending ties
+			} else if (strchr(token, 'r') != NULL) {
+				if (metpitch < 0) {
+					// don't repeat segmentation markers
+				} else if ((phraseQ && (strchr(token, '}') != NULL)) || restQ) {
+					metpitch = -1;
+					metriclevels.push_back(level);
+					metricpositions.push_back(bignegative);
+				}
+			} else {
+				metpitch = 0;
+				metriclevels.push_back(-(double)info.metlev[line]);
+				metricpositions.push_back(record.getBeatR());
+				if ((fermataQ && hasFermata(token)) ||
+						(phraseQ && (strchr(token, '}') != NULL))) {
+					metpitch = -1;
+					metriclevels.push_back(level);
+					metricpositions.push_back(bignegative);
 				}
 			}
-			temps << " ";
 		}
 	}
-
-	temps << ends;
-	string temps2 = temps.str();
-
-	PerlRegularExpression pre;
-	// disallow 3.., and 3... rhythms
-	pre.sar(temps2, "3\\.\\.+", "X", "g");
-	// convert unknown rhythms into X:
-	pre.sar(temps2, "-2147483648", "X", "g");
-	pre.sar(temps2, "444448", "X", "g"); // wholenote tied to dotted quarter
-
-	cout << temps2 << flush;
 }
 
 
 
 //////////////////////////////
 //
-// printMetricLevel --
+// hasFermata -- returns true if there is a fermata (;) in the first
+//     subtoken of a token.
 //
 
-void printMetricLevel(vector<double>& levels) {
-	int i;
-	cout << R_METRIC_LEVEL_MARKER;
-	double value;
-	int ivalue;
-	for (i=0; i<(int)levels.size(); i++) {
-		value = levels[i];
-		if (value < -1000.0) {
-			// print rest marker.
-			cout << "R ";
-			continue;
-		}
-		ivalue = (int)value;
-		if (ivalue > 0) {
-			cout << "p";
-		} else if (ivalue < 0) {
-			cout << "m";
-			ivalue = -ivalue;
+int hasFermata(const char* token) {
+	int i = 0;
+	while ((token[i] != '\0') && !std::isspace((unsigned char)token[i])) {
+		if (token[i] == ';') {
+			return 1;
 		}
-		cout << ivalue << " ";
+		i++;
 	}
+	return 0;
 }
 
 
 
 //////////////////////////////
 //
-// printMetricPosition --
+// printPitchFeatures -- print the pitch features of a voice.  All
+//     features are generated in one pass through the pitch sequence
+//     and then printed in the fixed order: { # : % } j J
 //
 
-void printMetricPosition(vector<RationalNumber>& positions) {
-	int i;
-	cout << R_METRIC_POSITION_MARKER;
-	RationalNumber value;
-	for (i=0; i<(int)positions.size(); i++) {
-		if (positions[i] < -1000) {
-			cout << "R ";
-			continue;
+void printPitchFeatures(ostream& out, vector<int>& pitches, int tonic) {
+	int intervalQ = pstate[p12toneInterval];
+	int refinedQ  = pstate[pRefinedContour];
+	int grossQ    = pstate[pGrossContour];
+	int degreeQ   = pstate[pScaleDegree];
+	int musicalQ  = pstate[pMusicalInterval];
+	int twelveQ   = pstate[p12tonePitch];
+	int nameQ     = pstate[pPitch];
+
+	string intervals12;
+	string refined;
+	string gross;
+	string degrees;
+	string intervals;
+	string pitches12;
+	string names;
+
+	char buffer[128] = {0};
+	int midi = 0;
+	int lastmidi = 0;
+	int interval;
+	int pc;
+	int i, j;
+	for (i=0; i<(int)pitches.size(); i++) {
+		if (pitches[i] >= 0) {
+			midi = Convert::base40ToMidiNoteNumber(pitches[i]);
+		}
+
+		// features of the interval from the previous note:
+		if (i == 0) {
+			// no interval to first note
+		} else if (pitches[i-1] < 0) {
+			// print a rest marker
+			if (intervalQ) { intervals12 += 'R'; }
+			if (refinedQ)  { refined     += 'R'; }
+			if (grossQ)    { gross       += 'R'; }
+			if (musicalQ)  { intervals   += 'R'; }
+		} else if (pitches[i] >= 0) {
+			// a rest is printed on the next note
+			interval = pitches[i] - pitches[i-1];
+			if (intervalQ) {
+				if (midi > lastmidi) {
+					intervals12 += 'p';
+					intervals12 += to_string(midi - lastmidi);
+				} else if (midi < lastmidi) {
+					intervals12 += 'm';
+					intervals12 += to_string(lastmidi - midi);
+				} else {
+					intervals12 += "p0";
+				}
+			}
+			if (refinedQ) {
+				// augmented second is assigned to be a step
+				if (interval < 0) {
+					refined += (-interval < 9) ? 'd' : 'D';
+				} else if (interval > 0) {
+					refined += (interval < 9) ? 'u' : 'U';
+				} else {
+					refined += 's';
+				}
+			}
+			if (grossQ) {
+				if (interval < 0) {
+					gross += 'D';
+				} else if (interval > 0) {
+					gross += 'U';
+				} else {
+					gross += 'S';
+				}
+			}
+			if (musicalQ) {
+				appendMusicalInterval(intervals, interval);
+			}
+		}
+
+		// features of the note:
+		if (pitches[i] < 0) {
+			if (degreeQ) { degrees   += 'R'; }
+			if (twelveQ) { pitches12 += 'R'; }
+			if (nameQ)   { names     += "R "; }
+		} else {
+			if (degreeQ) {
+				degrees += to_string(
+					(Convert::base40ToDiatonic(pitches[i]-tonic+2+40)%7)+1);
+			}
+			if (twelveQ) {
+				pc = midi % 12;
+				if (pc < 10) {
+					pitches12 += to_string(pc);
+				} else if (pc == 10) {
+					pitches12 += 'A';
+				} else if (pc == 11) {
+					pitches12 += 'B';
+				} else {
+					pitches12 += 'X';
+				}
+			}
+			if (nameQ) {
+				Convert::base40ToKern(buffer, (pitches[i] % 40) + 3 * 40);
+				for (j=0; buffer[j] != '\0'; j++) {
+					names += (buffer[j] == '-') ? 'b' : buffer[j];
+				}
+				names += ' ';
+			}
 		}
-		value = positions[i];
-		cout << "x";
-		value.printTwoPart(cout, "_");
-		cout << ' ';
+
+		lastmidi = midi;
+	}
+
+	if (intervalQ) {
+		out << '\t' << P_12TONE_INTERVAL_MARKER       << intervals12;
+	}
+	if (refinedQ) {
+		out << '\t' << P_PITCH_REFINED_CONTOUR_MARKER << refined;
+	}
+	if (grossQ) {
+		out << '\t' << P_GROSS_CONTOUR_MARKER         << gross;
+	}
+	if (degreeQ) {
+		out << '\t' << P_SCALE_DEGREE_MARKER          << degrees;
+	}
+	if (musicalQ) {
+		out << '\t' << P_DIATONIC_INTERVAL_MARKER     << intervals;
+	}
+	if (twelveQ) {
+		out << '\t' << P_12TONE_PITCH_CLASS_MARKER    << pitches12;
+	}
+	if (nameQ) {
+		out << '\t' << P_PITCH_CLASS_MARKER           << names;
 	}
 }
 
@@ -1095,200 +1418,320 @@ void printMetricPosition(vector<RationalNumber>& positions) {
 
 //////////////////////////////
 //
-// printMetricRefinedContour --
+// appendMusicalInterval -- append the name of a base-40 interval
+//     (such as XM3 or xP5) to a musical interval feature.
 //
 
-void printMetricRefinedContour(vector<double>& levels) {
-	int i;
-	cout << R_METRIC_REFINED_CONTOUR_MARKER;
-	double value;
-	int ivalue;
-	double bvalue;
-	int bivalue;
-	int zvalue;
-	for (i=1; i<(int)levels.size(); i++) {
-		if (levels[i-1]  < -1000.0) {
-			// print a rest marker
-			cout << "R";
-			continue;
-		}
-		if (levels[i] < -1000.0) {
-			// ignore, rest printed in next loop
-			continue;
-		}
-		value = levels[i];
-		ivalue = (int)value;
-		bvalue = levels[i-1];
-		bivalue = (int)bvalue;
-		zvalue = ivalue - bivalue;
-		if (zvalue > 1) {
-			cout << "U";
-		} else if (zvalue == 1) {
-			cout << "u";
-		} else if (zvalue == 0) {
-			cout << "S";
-		} else if (zvalue == -1) {
-			cout << "d";
-		} else if (zvalue < -1) {
-			cout << "D";
-		} else {
-			cout << "x";
-		}
+void appendMusicalInterval(string& output, int interval) {
+	int direction;
+	if (interval < 0) {
+		direction = -1;
+		interval = -interval;
+	} else {
+		direction = +1;
+	}
+	int octave = interval / 40;
+	int degree = (Convert::base40ToDiatonic(interval+2)%7)+1 + octave * 7;
+
+	// need the direction for augmented/diminished unisons...
+	if (direction < 0) {
+		output += 'x';
+	} else if (interval != 0) {
+		output += 'X';
+	}
+
+	int accidental = Convert::base40ToAccidental(interval+2);
+	switch ((degree-1) % 7) {
+		case 0:   // 1st
+			switch (direction * abs(accidental)) {
+				case -2:  output += "dd"; break;
+				case -1:  output += "d";  break;
+				case  0:  output += "P";  break;
+				case +1:  output += "A";  break;
+				case +2:  output += "AA"; break;
+			}
+			break;
+		case 3:   // 4th
+		case 4:   // 5th
+			switch (accidental) {
+				case -2:  output += "dd"; break;
+				case -1:  output += "d";  break;
+				case  0:  output += "P";  break;
+				case +1:  output += "A";  break;
+				case +2:  output += "AA"; break;
+			}
+			break;
+		case 1:   // 2nd
+		case 2:   // 3rd
+		case 5:   // 6th
+		case 6:   // 7th
+			switch (accidental) {
+				case -3:  output += "dd"; break;
+				case -2:  output += "d";  break;
+				case -1:  output += "m";  break;
+				case  0:  output += "M";  break;
+				case +1:  output += "A";  break;
+				case +2:  output += "AA"; break;
+			}
 	}
+	output += to_string(degree);
 }
 
 
 
 //////////////////////////////
 //
-// printMetricGrossContour --
-//
+// printRhythmFeatures -- print the rhythm features of a voice.  The
+//     duration features are generated in one pass through the durations,
+//     and the metric features in one pass through the metric levels and
+//     positions, and then printed in the fixed order: ~ ^ ; & ' ` @ =
+//
+
+void printRhythmFeatures(ostream& out, vector<double>& durations,
+		vector<double>& levels, vector<RationalNumber>& positions) {
+	int dgrossQ    = pstate[pDurationGrossContour];
+	int drefinedQ  = pstate[pDurationRefinedContour];
+	int durationQ  = pstate[pDuration];
+	int beatQ      = pstate[pBeat];
+	int levelQ     = pstate[pMetricLevel];
+	int mrefinedQ  = pstate[pMetricRefinedContour];
+	int mgrossQ    = pstate[pMetricGrossContour];
+	int positionQ  = pstate[pMetricPosition];
+
+	string dgross;
+	string drefined;
+	string durationtext;
+	string beats;
+	string leveltext;
+	string mrefined;
+	string mgross;
+	stringstream positiontext;
 
-void printMetricGrossContour(vector<double>& levels) {
-	int i;
-	cout << R_METRIC_GROSS_CONTOUR_MARKER;
 	double value;
 	int ivalue;
-	double bvalue;
-	int bivalue;
 	int zvalue;
-	for (i=1; i<(int)levels.size(); i++) {
-		if (levels[i-1]  < -1000.0) {
-			// print a rest marker
-			cout << "R";
-			continue;
+	int i;
+	for (i=0; i<(int)durations.size(); i++) {
+		if (i == 0) {
+			// no contour to first note
+		} else if (durations[i-1] < 0.0) {
+			if (dgrossQ)   { dgross   += 'R'; }
+			if (drefinedQ) { drefined += 'R'; }
+		} else if (durations[i] >= 0.0) {
+			// a rest is printed on the next note
+			if (dgrossQ) {
+				if (durations[i] - durations[i-1] > 0) {
+					dgross += '>';
+				} else if (durations[i] - durations[i-1] < 0) {
+					dgross += '<';
+				} else {
+					// what is this line?
+					dgross += R_METRIC_POSITION_MARKER;
+				}
+			}
+			if (drefinedQ) {
+				if (durations[i-1] == 0.0) {
+					drefined += (durations[i] == 0.0) ? '=' : ']';
+				} else {
+					value = durations[i]/durations[i-1];
+					if (value > 2.0)       { drefined += ']'; }
+					else if (value > 1.0)  { drefined += '>'; }
+					else if (value == 1.0) { drefined += '='; }
+					else if (value >= 0.5) { drefined += '<'; }
+					else if (value < 0.5)  { drefined += '['; }
+					else                   { drefined += 'X'; }
+				}
+			}
 		}
-		if (levels[i] < -1000.0) {
-			// ignore, rest printed in next loop
-			continue;
+		if (durationQ) {
+			appendDuration(durationtext, durations[i]);
 		}
+	}
+
+	if (durationQ) {
+		PerlRegularExpression pre;
+		// disallow 3.., and 3... rhythms
+		pre.sar(durationtext, "3\\.\\.+", "X", "g");
+		// convert unknown rhythms into X:
+		pre.sar(durationtext, "-2147483648", "X", "g");
+		pre.sar(durationtext, "444448", "X", "g"); // wholenote tied to dotted quarter
+	}
+
+	// a metric position is stored with each metric level:
+	for (i=0; i<(int)levels.size(); i++) {
 		value = levels[i];
 		ivalue = (int)value;
-		bvalue = levels[i-1];
-		bivalue = (int)bvalue;
-		zvalue = ivalue - bivalue;
-		if (zvalue > 0) {
-			cout << "U";
-		} else if (zvalue < 0) {
-			cout << "D";
-		} else {
-			cout << "S";
+		if (beatQ) {
+			if (value < -1000.0) {
+				beats += 'R';
+			} else {
+				beats += (ivalue >= 0) ? '1' : '0';
+			}
+		}
+		if (levelQ) {
+			if (value < -1000.0) {
+				leveltext += "R ";
+			} else {
+				if (ivalue > 0) {
+					leveltext += 'p';
+				} else if (ivalue < 0) {
+					leveltext += 'm';
+					ivalue = -ivalue;
+				}
+				leveltext += to_string(ivalue);
+				leveltext += ' ';
+			}
+		}
+		if (i == 0) {
+			// no contour to first note
+		} else if (levels[i-1] < -1000.0) {
+			if (mrefinedQ) { mrefined += 'R'; }
+			if (mgrossQ)   { mgross   += 'R'; }
+		} else if (levels[i] >= -1000.0) {
+			// a rest is printed on the next note
+			zvalue = (int)levels[i] - (int)levels[i-1];
+			if (mrefinedQ) {
+				if (zvalue > 1)        { mrefined += 'U'; }
+				else if (zvalue == 1)  { mrefined += 'u'; }
+				else if (zvalue == 0)  { mrefined += 'S'; }
+				else if (zvalue == -1) { mrefined += 'd'; }
+				else                   { mrefined += 'D'; }
+			}
+			if (mgrossQ) {
+				if (zvalue > 0)        { mgross += 'U'; }
+				else if (zvalue < 0)   { mgross += 'D'; }
+				else                   { mgross += 'S'; }
+			}
+		}
+		if (positionQ) {
+			if (positions[i] < -1000) {
+				positiontext << "R ";
+			} else {
+				positiontext << "x";
+				positions[i].printTwoPart(positiontext, "_");
+				positiontext << ' ';
+			}
 		}
 	}
+
+	if (dgrossQ) {
+		out << '\t' << R_DURATION_GROSS_CONTOUR_MARKER   << dgross;
+	}
+	if (drefinedQ) {
+		out << '\t' << R_DURATION_REFINED_CONTOUR_MARKER << drefined;
+	}
+	if (durationQ) {
+		out << '\t' << R_DURATION_MARKER                 << durationtext;
+	}
+	if (beatQ) {
+		out << '\t' << R_BEAT_LEVEL_MARKER               << beats;
+	}
+	if (levelQ) {
+		out << '\t' << R_METRIC_LEVEL_MARKER             << leveltext;
+	}
+	if (mrefinedQ) {
+		out << '\t' << R_METRIC_REFINED_CONTOUR_MARKER   << mrefined;
+	}
+	if (mgrossQ) {
+		out << '\t' << R_METRIC_GROSS_CONTOUR_MARKER     << mgross;
+	}
+	if (positionQ) {
+		out << '\t' << R_METRIC_POSITION_MARKER          << positiontext.str();
+	}
 }
 
 
 
 //////////////////////////////
 //
-// printBeatLevel --
+// appendDuration -- append a duration to the duration feature.
+//     [2011/04/02] change code for Longa from 00 to L, and Breve from 0
+//     to B so that grace notes do not interact with breve duration.
 //
 
-void printBeatLevel(vector<double>& levels) {
-	int i;
-	cout << R_BEAT_LEVEL_MARKER;
-	double value;
-	int ivalue;
-	for (i=0; i<(int)levels.size(); i++) {
-		if (levels[i] < -1000.0) {
-			// print rest
-			cout << "R";
-			continue;
-		}
-		value = levels[i];
-		ivalue = (int)value;
-		if (ivalue >= 0) {
-			cout << 1;
-		} else {
-			cout << 0;
+void appendDuration(string& output, double duration) {
+	if (duration < 0) {
+		output += "R ";
+		return;
+	}
+
+	char buffer[128] = {0};
+	if (duration == 16.0) {
+		strcpy(buffer, "L");
+	} else if (duration == 8.0) {
+		strcpy(buffer, "B");
+	} else if (duration == 12.0) {
+		strcpy(buffer, "B.");
+	} else {
+		Convert::durationToKernRhythm(buffer, duration);
+	}
+
+	if ((duration > 0) && (buffer[0] == 'q')) {
+		int count = (int)duration;
+		output.append(count, '4');
+		if (duration - count > 0) {
+			Convert::durationToKernRhythm(buffer, duration-count);
 		}
 	}
-}
 
+	int k;
+	for (k=0; buffer[k] != '\0'; k++) {
+		output += (buffer[k] == '.') ? 'd' : buffer[k];
+	}
+	output += ' ';
+}
 
 
 
 //////////////////////////////
 //
-// printMusicalInterval --
+// processBibRecords -- print bibliographic records sorted into
+//    alphabetical order
 //
 
-void printMusicalInterval(vector<int>& pitches) {
-	cout << P_DIATONIC_INTERVAL_MARKER;
-	int octave;
-	int interval;
-	int degree;
-	int direction;
-	int i;
-	for (i=1; i<(int)pitches.size(); i++) {
-		if (pitches[i-1] < 0) {
-			// print a rest
-			cout << "R";
-			continue;
-		}
-		if (pitches[i] < 0) {
-			// skip, will be printed in next loop
-			continue;
-		}
-		interval = pitches[i] - pitches[i-1];
-		if (interval < 0) {
-			direction = -1;
-			interval = -interval;
-		} else {
-			direction = +1;
-		}
-		octave   = interval / 40;
-		degree   = (Convert::base40ToDiatonic(interval+2)%7)+1 + octave * 7;
-
-		// need the direction for augmented/diminished unisons...
-		//if (degree != 1) {
-		//   if (direction < 0) {
-		//      cout << 'x';
-		//   } else {
-		//      cout << 'X';
-		//   }
-		//}
-		if (direction < 0) {
-			cout << 'x';
-		} else if (interval != 0) {
-			cout << 'X';
-		}
+void processBibRecords(ostream& out, HumdrumFile &infile,
+		const char* bibfilter) {
 
-		int accidental = Convert::base40ToAccidental(interval+2);
-		switch ((degree-1) % 7) {
-			case 0:   // 1st
-				switch (direction * abs(accidental)) {
-					case -2:  cout << "dd"; break;
-					case -1:  cout << "d";  break;
-					case  0:  cout << "P";  break;
-					case +1:  cout << "A";  break;
-					case +2:  cout << "AA"; break;
-				}
-				break;
-			case 3:   // 4th
-			case 4:   // 5th
-				switch (accidental) {
-					case -2:  cout << "dd"; break;
-					case -1:  cout << "d";  break;
-					case  0:  cout << "P";  break;
-					case +1:  cout << "A";  break;
-					case +2:  cout << "AA"; break;
+	vector<HumdrumRecord*> bibs;
+	bibs.reserve(infile.getNumLines());
+	int i, j;
+	PerlRegularExpression pre;
+
+	vector<string> bfilt;
+	bfilt.reserve(100);
+	if (strcmp(bibfilter, "") != 0) {
+		PerlRegularExpression::getTokens(bfilt, "[:,\\s]+", bibfilter);
+	}
+
+	int valid;
+	char buffer[1024] = {0};
+	for (i=0; i<infile.getNumLines(); i++) {
+		if (infile[i].isBibliographic()) {
+			if (bfilt.size() > 0) {
+				valid = 0;
+				infile[i].getBibKey(buffer, 1000);
+				for (j=0; j<(int)bfilt.size(); j++) {
+					if (pre.search(buffer, bfilt[j].c_str(), "")) {
+						valid = 1;
+						break;
+					}
 				}
-				break;
-			case 1:   // 2nd
-			case 2:   // 3rd
-			case 5:   // 6th
-			case 6:   // 7th
-				switch (accidental) {
-					case -3:  cout << "dd"; break;
-					case -2:  cout << "d";  break;
-					case -1:  cout << "m";  break;
-					case  0:  cout << "M";  break;
-					case +1:  cout << "A";  break;
-					case +2:  cout << "AA"; break;
+				if (valid == 0) {
+					continue;
 				}
+			}
+			bibs.push_back(&infile[i]);
 		}
-		cout << degree;
+	}
+
+	qsort(bibs.data(), bibs.size(), sizeof(void*), bibsort);
+
+	string record;
+	for (i=0; i<(int)bibs.size(); i++) {
+		record = (*(bibs[i]))[0];
+		pre.sar(record, "\\t", " ", "g");
+		pre.sar(record, "\\s\\s+", " ", "g");
+		out << '\t' << record;
 	}
 }
 
@@ -1296,19 +1739,13 @@ void printMusicalInterval(vector<int>& pitches) {
 
 //////////////////////////////
 //
-// printScaleDegree --
+// bibsort -- for sorting the tracks
 //
 
-void printScaleDegree(vector<int>& pitches, int tonic) {
-	cout << P_SCALE_DEGREE_MARKER;
-	int i;
-	for (i=0; i<(int)pitches.size(); i++) {
-		if (pitches[i] < 0) {
-			cout << "R";
-			continue;
-		}
-		cout << (Convert::base40ToDiatonic(pitches[i]-tonic+2+40)%7)+1;
-	}
+int bibsort(const void* a, const void* b) {
+	HumdrumRecord& abib = **((HumdrumRecord**)a);
+	HumdrumRecord& bbib = **((HumdrumRecord**)b);
+	return strcmp(abib[0], bbib[0]);
 }
 
 
@@ -1318,12 +1755,12 @@ void printScaleDegree(vector<int>& pitches, int tonic) {
 // printMeter --
 //
 
-void printMeter(HumdrumFile& infile) {
+void printMeter(ostream& out, HumdrumFile& infile) {
 	int i;
 	int top;
 	int bottom;
 	int count = 0;
-	cout << "M";
+	out << "M";
 	for (i=0; i<infile.getNumLines(); i++) {
 		if (infile[i].isInterpretation()) {
 			if (infile[i][0][1] != 'M') {
@@ -1331,7 +1768,7 @@ void printMeter(HumdrumFile& infile) {
 			}
 			if (!std::isdigit(infile[i][0][2])) {
 				if (strcmp("*MX", infile[i][0]) == 0) {
-					cout << "irregular";
+					out << "irregular";
 					return;
 				}
 				continue;
@@ -1340,35 +1777,35 @@ void printMeter(HumdrumFile& infile) {
 			if (count != 2) {
 				continue;
 			}
-			cout << &(infile[i][0][2]);
+			out << &(infile[i][0][2]);
 			switch (top) {
 				case 4:
 				case 12:
-					cout << "quadruple";
+					out << "quadruple";
 					break;
 				case 3:
 				case 9:
-					cout << "triple";
+					out << "triple";
 					break;
 				case 2:
 				case 6:
-					cout << "duple";
+					out << "duple";
 					break;
-				default:   cout << "irregular";
+				default:   out << "irregular";
 			}
 			switch (top) {
 				case 6:
 				case 9:
 				case 12:
 				case 16:
-					cout << "compound";
+					out << "compound";
 					break;
 				case 1:
 				case 2:
 				case 3:
 				case 4:
 				case 5:
-					cout << "simple";
+					out << "simple";
 					break;
 			}
 			break;
@@ -1383,23 +1820,23 @@ void printMeter(HumdrumFile& infile) {
 // printKey --
 //
 
-void printKey(int mode, int tonic) {
+void printKey(ostream& out, int mode, int tonic) {
 	char buffer[128] = {0};
 
 	if (tonic < 0) {
 		// unknown key
-		cout << "ZX=";
+		out << "ZX=";
 		return;
 	}
 
 	if (mode) {
-		cout << 'z';   // minor
+		out << 'z';   // minor
 	} else {
-		cout << 'Z';   // major
+		out << 'Z';   // major
 	}
 
-	cout << Convert::base40ToKern(buffer, tonic + 3*40);
-	cout << '=';
+	out << Convert::base40ToKern(buffer, tonic + 3*40);
+	out << '=';
 }
 
 
@@ -1450,582 +1887,7 @@ void getKey(HumdrumFile& infile, int& mode, int& tonic) {
 
 //////////////////////////////
 //
-// print12tonePitch --
-//
-
-void print12tonePitch(vector<int>& pitches) {
-	cout << P_12TONE_PITCH_CLASS_MARKER;
-	int i;
-	int midi;
-	for (i=0; i<(int)pitches.size(); i++) {
-		if (pitches[i] < 0) {
-			cout << "R";
-			continue;
-		}
-		midi = Convert::base40ToMidiNoteNumber(pitches[i]) % 12;
-		if (midi < 10) {
-			cout << midi;
-		} else if (midi == 10) {
-			cout << 'A';
-		} else if (midi == 11) {
-			cout << 'B';
-		} else {
-			cout << 'X';
-		}
-	}
-}
-
-
-
-//////////////////////////////
-//
-// print12toneInterval --
-//
-
-void print12toneInterval(vector<int>& pitches) {
-	vector<int> midi(pitches.size());
-	cout << P_12TONE_INTERVAL_MARKER;
-	int i;
-	for (i=0; i<(int)pitches.size(); i++) {
-		if (pitches[i] < 0) {
-			midi[i] = -1000000;
-		} else {
-			midi[i] = Convert::base40ToMidiNoteNumber(pitches[i]);
-		}
-	}
-
-	for (i=1; i<(int)midi.size(); i++) {
-		if (midi[i-1] < -1000) {
-			// print a rest marker
-			cout << "R";
-			continue;
-		}
-		if (midi[i] < -1000) {
-			// ignore rest, printed on next round
-			continue;
-		}
-		if (midi[i] > midi[i-1]) {
-			cout << 'p' << midi[i] - midi[i-1];
-		} else if (midi[i] < midi[i-1]) {
-			cout << 'm' << midi[i-1] - midi[i];
-		} else {
-			cout << "p0";
-		}
-	}
-}
-
-
-
-//////////////////////////////
-//
-// printRefinedContour -- augmented second is assigned to be a step
-//
-
-void printRefinedContour(vector<int>& pitches) {
-	int i;
-	cout << P_PITCH_REFINED_CONTOUR_MARKER;
-
-	for (i=1; i<(int)pitches.size(); i++) {
-		if (pitches[i-1] < 0) {
-			// process a rest
-			cout << "R";
-			continue;
-		}
-		if (pitches[i] < 0) {
-			continue;
-		}
-		if (pitches[i] < pitches[i-1]) {
-			if (pitches[i-1] - pitches[i] < 9) {
-				cout << 'd';
-			} else {
-				cout << 'D';
-			}
-		} else if (pitches[i] > pitches[i-1]) {
-			if (pitches[i] - pitches[i-1] < 9) {
-				cout << 'u';
-			} else {
-				cout << 'U';
-			}
-		} else {
-			cout << 's';
-		}
-	}
-}
-
-
-
-//////////////////////////////
-//
-// printGrossContour --
-//
-
-void printGrossContour(vector<int>& pitches) {
-	int i;
-	cout << P_GROSS_CONTOUR_MARKER;
-
-	for (i=1; i<(int)pitches.size(); i++) {
-		if (pitches[i-1] < 0) {
-			// process a rest
-			cout << "R";
-			continue;
-		}
-		if (pitches[i] < 0) {
-			continue;
-		}
-		if (pitches[i] < pitches[i-1]) {
-			cout << 'D';
-		} else if (pitches[i] > pitches[i-1]) {
-			cout << 'U';
-		} else {
-			cout << 'S';
-		}
-	}
-}
-
-
-
-//////////////////////////////
-//
-// printPitch --
-//
-
-void printPitch(vector<int>& pitches) {
-	int i;
-	int j;
-	char buffer[128] = {0};
-	cout << P_PITCH_CLASS_MARKER;
-	for (i=0; i<(int)pitches.size(); i++) {
-		if (pitches[i] < 0) {
-			// process a rest marker
-			cout << "R ";
-			continue;
-		}
-		Convert::base40ToKern(buffer, (pitches[i] % 40) + 3 * 40);
-		j = 0;
-		while (buffer[j] != '\0') {
-			if (buffer[j] == '-') {
-				cout << 'b';
-			} else {
-				cout << buffer[j];
-			}
-			j++;
-		}
-		cout << " ";
-		// when not printing a terminal " ":
-		//if (i < (int)pitches.size()-1) {
-		//   cout << " ";
-		//}
-	}
-}
-
-
-
-//////////////////////////////
-//
-// extractMetricSequence --
-//
-
-void extractMetricSequence(vector<double>& metriclevels,
-		vector<RationalNumber>& metricpositions, HumdrumFile& infile,
-		int track, int layer) {
-	PerlRegularExpression pre;
-	vector<int> metlev;
-	infile.analyzeMetricLevel(metlev);
-	infile.analyzeRhythm();  // should already be done
-
-	int i, j;
-
-	metriclevels.reserve(1000);
-	metriclevels.resize(0);
-
-	metricpositions.reserve(1000);
-	metricpositions.resize(0);
-
-	RationalNumber aposition;
-	RationalNumber bignegative(-1000000,1);
-
-	int lastlayercount = 0;
-	int layercount = 0;
-
-	int pitch = 0;
-	double level;
-	for (i=0; i<infile.getNumLines(); i++) {
-		switch (infile[i].getType()) {
-			case E_humrec_data:
-				lastlayercount = layercount;
-				layercount = 0;
-				for (j=0; j<infile[i].getFieldCount(); j++) {
-					if (infile[i].getPrimaryTrack(j) != track) {
-						continue;
-					}
-					layercount++;
-					if (layer != layercount) {
-						continue;
-					}
-					if (strcmp(infile[i][j], ".") == 0) {
-						// ignore null tokens
-						break;
-					}
-
-					if ((lastlayercount != 0) && (lastlayercount < layer)) {
-						// insert segmentation marker into the data
-						// since this desired layer does not continue
-						// directly from the last occurance of the layer
-						if (metricpositions.back() != bignegative) {
-							// only append segmentation marker if a
-							// segmentation marker is not present in the
-							// pitch sequence already.
-							level = -1000000.0;
-							metriclevels.push_back(level);
-							metricpositions.push_back(bignegative);
-						}
-					}
-
-					// all notes in a chord should have the same duration
-					// so not bothering with adjusting for the --end option.
-
-					if ((!graceQ) && pre.search(infile[i][j], "q", "i")) {
-						// don't count grace notes if not wanted
-						continue;
-					}
-					if (strchr(infile[i][j], '_') != NULL) {
-						// ignore continuing ties
-						break;
-					}
-					if (strchr(infile[i][j], ']') != NULL) {
-						// ignore ending ties
-						break;
-					}
-					if (strchr(infile[i][j], 'r') != NULL) {
-						if (pitch < 0) {
-							// don't repeat segmentation markers
-							break;
-						}
-						if (phraseQ && pre.search(infile[i][j], "}", "")) {
-							pitch = -1;
-							level = -1000000.0;
-							metriclevels.push_back(level);
-							metricpositions.push_back(bignegative);
-							break;
-						}
-						if (!restQ) {
-							// ignore rests
-							break;
-						}
-						pitch = -1;
-						level = -1000000.0;
-						metriclevels.push_back(level);
-						metricpositions.push_back(bignegative);
-						break;
-					}
-					pitch = 0;  // used to keep track of rests
-					level = -(double)metlev[i];
-					aposition = infile[i].getBeatR();
-					metriclevels.push_back(level);
-					metricpositions.push_back(aposition);
-					if (fermataQ && pre.search(infile[i][j], "^[^\\s]*;", "")) {
-						pitch = -1;
-						level = -1000000.0;
-						metriclevels.push_back(level);
-						metricpositions.push_back(bignegative);
-					} else if (phraseQ && pre.search(infile[i][j], "}", "")) {
-						pitch = -1;
-						level = -1000000.0;
-						metriclevels.push_back(level);
-						metricpositions.push_back(bignegative);
-					}
-					break;
-				}
-				break;
-		}
-	}
-
-}
-
-
-
-//////////////////////////////
-//
-// extractDurationSequence -- Disallow 3... rhythms from being stored
-//    (equivalent to dotted half tied to eighth note?)
-//    Translate special "l" markers for longs into Long durations.
-//
-
-void extractDurationSequence(vector<double>& durations, HumdrumFile& infile,
-		int track, int layer) {
-	PerlRegularExpression pre;
-	durations.reserve(10000);
-	durations.resize(0);
-	char longchar = identifyLongMarker(infile);
-	double dur = 0;
-	int i, j;
-	int pitch = 0;
-
-	int lastlayercount = 0;
-	int layercount = 0;
-
-	for (i=0; i<infile.getNumLines(); i++) {
-		switch (infile[i].getType()) {
-			case E_humrec_none:
-			case E_humrec_empty:
-			case E_humrec_bibliography:
-			case E_humrec_global_comment:
-			case E_humrec_data_comment:
-			case E_humrec_interpretation:
-			case E_humrec_data_kern_measure:
-				break;
-			case E_humrec_data:
-				lastlayercount = layercount;
-				layercount = 0;
-				for (j=0; j<infile[i].getFieldCount(); j++) {
-					if (infile[i].getPrimaryTrack(j) != track) {
-						continue;
-					}
-					layercount++;
-					if (layer != layercount) {
-						continue;
-					}
-					if (strcmp(infile[i][j], ".") == 0) {
-						// ignore null tokens
-						break;
-					}
-
-					if ((lastlayercount != 0) && (lastlayercount < layer)) {
-						// insert segmentation marker into the data
-						// since this desired layer does not continue
-						// directly from the last occurance of the layer
-						if (durations.back() != -1.0) {
-							// only append segmentation marker if a
-							// segmentation marker is not present in the
-							// pitch sequence already.
-							dur   = -1.0;
-							durations.push_back(dur);
-						}
-					}
-
-					// all notes in a chord should have the same duration
-					// so not bothering with adjusting for the --end option.
-
-					if ((!graceQ) && pre.search(infile[i][j], "q", "i")) {
-						// don't count grace notes if not wanted
-						break;
-					}
-					if (strchr(infile[i][j], '_') != NULL) {
-						// ignore continuing ties
-						break;
-					}
-					if (strchr(infile[i][j], ']') != NULL) {
-						// ignore ending ties
-						break;
-					}
-					if (strchr(infile[i][j], 'r') != NULL) {
-						if (pitch < 0) {
-							// ignore repeated rests
-							break;
-						}
-						if (phraseQ && pre.search(infile[i][j], "}", "")) {
-							pitch = -1;
-							dur   = -1.0;
-							durations.push_back(dur);
-							break;
-						}
-						if (!restQ) {
-							// ignore rests
-							break;
-						}
-						pitch = -1;
-						dur   = RESTDUR;
-						durations.push_back(dur);
-						break;
-					}
-					pitch = Convert::kernToBase40(infile[i][j]);
-					if ((pitch < 0) || (pitch > 10000)) {
-						// ignore rests and other strange things
-						break;
-					}
-					dur = infile.getTiedDuration(i, j);
-					if (longchar && (strchr(infile[i][j], longchar) != NULL)) {
-						dur = 16.0;
-					}
-					if ((!graceQ) && (dur <= 0.0)) {
-						// for some reason grace note was not filtered before,
-						// so filter it now.
-						break;
-					}
-					durations.push_back(dur);
-					if (limitQ) {
-						if ((int)durations.size() >= limit) {
-							return;
-						}
-					}
-					if (fermataQ && pre.search(infile[i][j], "^[^\\s]*;", "")) {
-						pitch = -1;
-						dur   = -1.0;
-						durations.push_back(dur);
-					} else if (phraseQ && pre.search(infile[i][j], "}", "")) {
-						pitch = -1;
-						dur   = -1.0;
-						durations.push_back(dur);
-					}
-					break;
-				}
-				break;
-			default:
-				break;
-		}
-	}
-
-}
-
-
-
-
-//////////////////////////////
-//
-// extractPitchSequence --
-// restrictions:
-//   (1) **kern data expected is track being searched
-//   (2) chords will be ignored, only first note in chord will be processed.
-//
-
-void extractPitchSequence(vector<int>& pitches, HumdrumFile& infile,
-		int track, int layer) {
-	pitches.reserve(10000);
-	pitches.resize(0);
-	int pitch = 0;
-	int i, j;
-	PerlRegularExpression pre;
-
-	char notebuf[1024] = {0};
-	int subtokens = 0;
-
-	int lastlayercount = 0;
-	int layercount = 0;
-
-	for (i=0; i<infile.getNumLines(); i++) {
-		switch (infile[i].getType()) {
-			case E_humrec_none:
-			case E_humrec_empty:
-			case E_humrec_bibliography:
-			case E_humrec_global_comment:
-			case E_humrec_data_comment:
-			case E_humrec_interpretation:
-			case E_humrec_data_kern_measure:
-				break;
-			case E_humrec_data:
-				lastlayercount = layercount;
-				layercount = 0;
-				for (j=0; j<infile[i].getFieldCount(); j++) {
-					if (infile[i].getPrimaryTrack(j) != track) {
-						continue;
-					}
-					layercount++;
-					if (layer != layercount) {
-						continue;
-					}
-					if (strcmp(infile[i][j], ".") == 0) {
-						// ignore null tokens
-						break;
-					}
-
-					if ((lastlayercount != 0) && (lastlayercount < layer)) {
-						// insert segmentation marker into the data
-						// since this desired layer does not continue
-						// directly from the last occurance of the layer
-						if ((pitches.size() > 0) && (pitches.back() >= 0)) {
-							// only append segmentation marker if a
-							// segmentation marker is not present in the
-							// pitch sequence already.
-							pitch = -1;
-							pitches.push_back(pitch);
-						}
-					}
-
-					subtokens = infile[i].getTokenCount(j);
-					if (subtokens == 1) {
-						strcpy(notebuf, infile[i][j]);
-					} else if (endQ) {
-						infile[i].getToken(notebuf, j, subtokens-1, 1000);
-					} else {
-						infile[i].getToken(notebuf, j, 0, 1000);
-					}
-
-					if ((!graceQ) && pre.search(notebuf, "q", "i")) {
-						// don't count grace notes if not wanted
-						continue;
-					}
-					if (strchr(notebuf, '_') != NULL) {
-						// ignore continuing ties
-						break;
-					}
-					if (strchr(notebuf, ']') != NULL) {
-						// ignore ending ties
-						break;
-					}
-					if (strchr(notebuf, 'r') != NULL) {
-						if ((pitches.size() > 0) && (pitches.back() < 0)) {
-							// already stored one rest, so ignore this one
-							break;
-						}
-						if (phraseQ && pre.search(notebuf, "}", "")) {
-							pitch = -1;
-							pitches.push_back(pitch);
-							break;
-						}
-						if (!restQ) {
-							// ignore rests
-							break;
-						}
-						pitch = -1;
-						pitches.push_back(pitch);
-						break;
-					}
-					pitch = Convert::kernToBase40(notebuf);
-					if ((pitch < 0) || (pitch > 10000)) {
-						// ignore rests and other strange things
-						break;
-					}
-					pitches.push_back(pitch);
-					if (limitQ) {
-						if ((int)pitches.size() >= limit) {
-							return;
-						}
-					}
-					if (fermataQ && pre.search(notebuf, "^[^\\s]*;", "")) {
-						pitch = -1;
-						pitches.push_back(pitch);
-					} else if (phraseQ && pre.search(infile[i][j], "}", "")) {
-						// observe that phrase marks only occur once
-						// in a multi-stop token, so have to search
-						// the entire multi-stop token for a phrase ending mark
-						// which is usually at the end of the token.
-						pitch = -1;
-						pitches.push_back(pitch);
-						break;
-					}
-					break;
-				}
-				break;
-			default:
-				break;
-		}
-	}
-
-	if (debugQ) {
-		cout << "PITCHES: ";
-		for (i=0; i<(int)pitches.size(); i++) {
-			cout << pitches[i] << " ";
-		}
-		cout << endl;
-	}
-
-}
-
-
-
-//////////////////////////////
-//
-// checkOptions --
+// checkOptions --
 //
 
 void checkOptions(Options& opts, int argc, char* argv[]) {
@@ -2062,6 +1924,8 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	opts.define("p|PCH|pch|PC|pc|pitch-class|pitch=b", "pitch class");
 
 	opts.define("file=s",         "filename to use for standard input data");
+	opts.define("tix=s",          "also write n-gram index for themax to file");
+	opts.define("threads=i:1",    "number of threads for indexing files");
 	opts.define("t|istn|translate=s", "translation file which contains istn values");
 	opts.define("l|limit=i:20",   "limit the number of extracted features");
 
@@ -2127,9 +1991,15 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	limit       = opts.getInteger("limit");
 	istnQ       = opts.getBoolean("istn");
 	bibQ        = opts.getBoolean("bib");
-	istnfile    = opts.getString("istn").c_str();
+	istnfile    = opts.getString("istn");
 	dirprefixQ  = opts.getBoolean("dir-prefix");
 	verboseQ    = opts.getBoolean("verbose");
+	tixQ        = opts.getBoolean("tix");
+	tixfile     = opts.getString("tix");
+	threadcount = opts.getInteger("threads");
+	if (threadcount < 1) {
+		threadcount = 1;
+	}
 
 	if (dirprefixQ) {
 		dirprefix = opts.getString("dir-prefix");
@@ -2141,11 +2011,11 @@ void checkOptions(Options& opts, int argc, char* argv[]) {
 	}
 
 	if (opts.getBoolean("bibfilter")) {
-		bibfilter = opts.getString("bibfilter").c_str();
+		bibfilter = opts.getString("bibfilter");
 	}
 
 	if (istnQ) {
-		fillIstnDatabase(istndatabase, istnfile);
+		fillIstnDatabase(istndatabase, istnfile.c_str());
 	}
 
 	if (opts.getBoolean("all")) {
@@ -6,6 +6,7 @@
 // Last Modified: Thu Jun  3 18:01:43 PDT 2004 added -p option
 // Last Modified: Sat Jun 26 16:49:06 PDT 2010 added middle syllable markers
 // Last Modified: Thu Mar  5 21:19:58 PST 2015 Added --split option
+// Last Modified: Sat Oct 17 23:26:16 PDT 2026 exit if the file cannot be read
 // Filename:      ...sig/examples/all/xml2hum.cpp
 // Web Address:   http://sig.sapp.org/examples/museinfo/humdrum/xml2hum.cpp
 // Syntax:        C++; museinfo
@@ -49,7 +50,10 @@ void      printHumdrumPart  (HumdrumFile& hfile, const char* filebase,
 int main(int argc, char* argv[]) {
    checkOptions(options, argc, argv);
 
-   MusicXmlFile xmlfile(options.getArg(1).c_str());
+   MusicXmlFile xmlfile;
+   if (!xmlfile.read(options.getArg(1).c_str())) {
+      exit(1);
+   }
 
    if (printQ) {
       xmlfile.print();
@@ -6,6 +6,7 @@
 // Last Modified: Wed Mar 30 13:58:18 PST 2005 Fixed for compiling in GCC 3.4
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 Renamed SigCollection class
 // Last Modified: Wed Sep  8 17:26:13 PDT 2010 Added operator<< for chars
+// Last Modified: Sat Oct 17 18:33:52 PDT 2026 Added move constructor/operator=
 // Filename:      ...sig/maint/code/base/Array/Array.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/Array.cpp
 // Syntax:        C++ 
@@ -24,6 +25,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include <string.h>
+#include <utility>
 
 using namespace std;
 
@@ -44,6 +46,11 @@ template<class type>
 Array<type>::Array(Array<type>& anArray) : SigCollection<type>(anArray) { 
 }
 
+template<class type>
+Array<type>::Array(Array<type>&& anArray) : 
+   SigCollection<type>(std::move(anArray)) { 
+}
+
 template<class type>
 Array<type>::Array(int arraySize, type *anArray) : 
    SigCollection<type>(arraySize, anArray) { 
@@ -216,6 +223,15 @@ Array<type>& Array<type>::operator=(const Array<type>& anArray) {
 }
 
 
+template<class type>
+Array<type>& Array<type>::operator=(Array<type>&& anArray) {
+   if (this != &anArray) {
+      this->swap(anArray);
+   }
+   return *this;
+}
+
+
 
 //////////////////////////////
 //
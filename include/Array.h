@@ -8,6 +8,7 @@
 // Last Modified: Wed Sep  8 17:26:13 PDT 2010 added operator<< for chars
 // Last Modified: Wed Jan 11 15:53:55 PST 2012 added operator<< for ints
 // Last Modified: Fri Aug 10 15:57:25 PDT 2012 added setAll(#,#) function
+// Last Modified: Sat Oct 17 18:33:52 PDT 2026 added move constructor/operator=
 // Filename:      ...sig/maint/code/base/Array/Array.h
 // Web Address:   http://sig.sapp.org/include/sigBase/Array.h
 // Documentation: http://sig.sapp.org/doc/classes/Array
@@ -38,6 +39,7 @@ class Array : public SigCollection<type> {
                      Array             (void);
                      Array             (int arraySize);
                      Array             (Array<type>& aArray);
+                     Array             (Array<type>&& aArray);
                      Array             (int arraySize, type *anArray);
                     ~Array             ();
 
@@ -50,6 +52,7 @@ class Array : public SigCollection<type> {
       int            operator==        (const Array<type>& aArray);
       int            operator==        (const char* aString);
       Array<type>&   operator=         (const Array<type>& aArray);
+      Array<type>&   operator=         (Array<type>&& aArray);
       Array<type>&   operator=         (const char* string);
       Array<type>&   operator+=        (const Array<type>& aArray);
       Array<type>&   operator-=        (const Array<type>& aArray);
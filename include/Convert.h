@@ -13,6 +13,7 @@
 // Last Modified: Sat May 22 11:02:12 PDT 2010 (added RationalNumber)
 // Last Modified: Sun Dec 26 04:54:46 PST 2010 (added kernClefToBaseline)
 // Last Modified: Sat Jan 22 17:13:36 PST 2011 (added kernToDurationNoDots)
+// Last Modified: Sat Oct 17 18:04:49 PDT 2026 (added scanKernToken)
 // Filename:      ...sig/include/sigInfo/Convert.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/Convert.h
 // Syntax:        C++ 
@@ -34,6 +35,36 @@
 #include <string>
 
 
+//
+// KernTokenInfo -- everything which the kernTo* functions extract from
+//    a **kern token, filled in by Convert::scanKernToken().  For chords,
+//    the pitch, accidental, dot and tie information is taken from the
+//    first note; the duration, grace and beam information is taken from
+//    the entire token.
+//
+
+class KernTokenInfo {
+   public:
+                     KernTokenInfo     (void) { clear(); }
+      void           clear             (void);
+
+      RationalNumber duration;         // in quarter notes, 0 for grace notes
+      RationalNumber undotted;         // duration without augmentation dots
+      int            base40;           // -1 if null, E_base40_rest if rest,
+                                       // E_unknown if no pitch
+      int            dots;             // augmentation dot count
+      int            accidental;       // chromatic alteration (+1 = sharp)
+      char           pitchclass;       // 'a'..'g', 'r' for rest, 'x' if none
+      char           restQ;            // true if a rest
+      char           graceQ;           // true if a grace note ('q' or 'Q')
+      char           tiestartQ;        // true if '[' is present
+      char           tiecontQ;         // true if '_' is present
+      char           tieendQ;          // true if ']' is present
+      int            beamstarts;       // count of 'L' characters
+      int            beamends;         // count of 'J' characters
+};
+
+
 class Convert {
    public: 
  
@@ -51,6 +82,9 @@ class Convert {
 
    // conversions dealing with **kern data
 
+      static void      scanKernToken             (KernTokenInfo& info,
+                                                  const char* aKernString);
+      static KernTokenInfo scanKernToken         (const char* aKernString);
       static int       kernToMidiNoteNumber      (const string& aKernString);
       static char*     durationToKernRhythm      (char* output, double input, 
                                                    int timebase = 1);
@@ -0,0 +1,89 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 20:33:32 PDT 2026
+// Last Modified: Sat Oct 17 20:33:32 PDT 2026
+// Filename:      ...sig/include/sigInfo/EditDistance.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/EditDistance.h
+// Syntax:        C++
+//
+// Description:   Approximate matching of symbol sequences with the
+//                weighted edit distance used by simil.  Deleting an
+//                element which repeats the previous element in its
+//                sequence and substituting a repeated element can have
+//                separate weights.  When all weights are 1.0 the distance
+//                is the Levenshtein distance, which is calculated with
+//                Myers' bit-vector algorithm (64 pattern elements per
+//                machine word).  Otherwise a dynamic-programming table is
+//                used, which can be limited to a band around the diagonal
+//                and stopped early when a maximum distance is given.
+//                Tokens are converted into integer symbols with
+//                getSymbol() before matching.
+//
+
+#ifndef _EDITDISTANCE_H_INCLUDED
+#define _EDITDISTANCE_H_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+class EditDistance {
+   public:
+                     EditDistance      (void);
+                    ~EditDistance      ();
+
+      void           setWeights        (double r1, double r2, double d1,
+                                        double d2, double s0, double s1,
+                                        double s2, double s3);
+      int            isUnitWeight      (void) const;
+      void           setThreadCount    (int count);
+      int            getThreadCount    (void) const { return threadcount; }
+
+      int            getSymbol         (const string& token);
+      int            getSymbolCount    (void) const;
+
+      double         getDistance       (const vector<int>& s1, int offset1,
+                                        const vector<int>& s2, int offset2,
+                                        int length = -1,
+                                        double limit = -1.0) const;
+      void           scoreWindows      (vector<double>& results,
+                                        const vector<int>& sequence,
+                                        const vector<int>& pattern,
+                                        int count,
+                                        double limit = -1.0) const;
+      void           scoreCorpus       (vector<vector<double> >& results,
+                                        const vector<vector<int> >& corpus,
+                                        const vector<int>& pattern,
+                                        double limit = -1.0) const;
+      void           scoreCorpus       (vector<vector<double> >& results,
+                                        const vector<vector<int> >& corpus,
+                                        const vector<int>& pattern,
+                                        const vector<int>& counts,
+                                        double limit = -1.0) const;
+
+   protected:
+      double         weight_R1;      // deleting a repeated element of S1
+      double         weight_R2;      // deleting a repeated element of S2
+      double         weight_D1;      // deleting a non-repeated element of S1
+      double         weight_D2;      // deleting a non-repeated element of S2
+      double         weight_S0;      // sub by a non-repeated element
+      double         weight_S1;      // sub by an element repeated in S1
+      double         weight_S2;      // sub by an element repeated in S2
+      double         weight_S3;      // sub by an element repeated in both
+      int            threadcount;    // threads used by scoreCorpus()
+      map<string, int> symbols;      // symbol numbers of tokens
+
+      double         weightedDistance  (const int* s1, int context1,
+                                        const int* s2, int context2,
+                                        int length, double limit,
+                                        vector<double>& row) const;
+};
+
+
+#endif  /* _EDITDISTANCE_H_INCLUDED */
+
+
+
@@ -3,12 +3,15 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  8 20:19:26 PDT 1998
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 (renamed SigCollection class)
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 (sort when adding)
 // Filename:      ...sig/include/sigInfo/Enumeration.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/Enumeration.h
 // Syntax:        C++ 
 //
 // Description:   Messy yet functional way of handling enumerations
-//                and their string equivalents.
+//                and their string equivalents.  Lookups do not modify
+//                the enumeration, so they are thread-safe as long as no
+//                entries are being added at the same time.
 //
 
 #ifndef _ENUMERATION_H_INCLUDED
@@ -5,11 +5,20 @@
 // Last Modified: Wed Jun 10 22:57:02 PDT 1998
 // Last Modified: Fri Oct 13 15:04:45 PDT 2000 (changed name to EnumerationEI)
 // Last Modified: Sat Oct 14 19:16:34 PDT 2000 (extracted EnumerationEI.cpp)
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 (thread-safe lookups)
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 (lock-free lookups)
 // Filename:      ...sig/include/sigInfo/EnumerationEI.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/EnumerationEI.h
 // Syntax:        C++ 
 //
 // Description:   Enumeration database for Humdrum exclusive interpretations.
+//                The predefined interpretations are fixed when the
+//                database is constructed.  New interpretations are added
+//                while files are being parsed, and are stored in blocks
+//                which are never moved or freed, so that getName() and
+//                getValue() do not need a lock, and names returned by
+//                getName() remain valid for the rest of the program.
+//                Only add() is serialized.
 //
 
 #ifndef _ENUMERATIONEI_H_INCLUDED
@@ -19,6 +28,12 @@
 #include "Enumeration.h"
 #include "Enum_exInterp.h"
 
+#include <atomic>
+
+#define EI_BLOCK_SIZE  (256)    /* new interpretations per storage block */
+#define EI_BLOCK_COUNT (124)    /* keeps values below E_unknown          */
+#define EI_FIRST_VALUE (1000)   /* enumeration of first new interpretation */
+
 
 class EnumerationEI : public Enumeration {
    public:
@@ -27,9 +42,14 @@ class EnumerationEI : public Enumeration {
      int    add                  (const char* aString);
      void   add                  (int aValue, const char* aString, 
                                     int allocType = ENUM_TRANSIENT_ALLOC);
+     const char* getName         (int aValue);
+     int    getValue             (const char* aName);
 
    private:
-      static int nextenumeration;
+      const char**   blocks[EI_BLOCK_COUNT]; // names of new interpretations
+      atomic<int>    count;                  // number of new interpretations
+
+      int    findAdded           (const char* aName, int size);
 
 };
 
@@ -0,0 +1,56 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 17:39:08 PDT 2026
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026
+// Filename:      ...sig/include/sigInfo/HumdrumArena.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumArena.h
+// Syntax:        C++
+//
+// Description:   Bump allocator for the text of HumdrumRecords which
+//                belong to a HumdrumFileBasic.  Memory is taken from
+//                large chunks and is only released when the arena is
+//                cleared, so that a file can be parsed without a heap
+//                allocation for every field on every line.
+//
+
+#ifndef _HUMDRUMARENA_H_INCLUDED
+#define _HUMDRUMARENA_H_INCLUDED
+
+#include <vector>
+
+using namespace std;
+
+
+class HumdrumArena {
+   public:
+                        HumdrumArena       (void);
+                        HumdrumArena       (int aChunkSize);
+                       ~HumdrumArena       ();
+
+      char*             allocate           (int size);
+      char*             copy               (const char* aString, int length);
+      char*             copy               (const char* aString);
+      void              clear              (void);
+      void              reserve            (int size);
+      int               getChunkCount      (void) const;
+      void              swap               (HumdrumArena& anArena);
+
+   protected:
+      vector<char*>     chunks;            // storage blocks
+      vector<int>       chunksizes;        // allocated size of each block
+      int               current;           // index of block being filled
+      int               offset;            // next free byte in current block
+      int               chunksize;         // default size of new blocks
+
+   private:
+      // arenas hold raw pointers, so they are not copyable
+                        HumdrumArena       (const HumdrumArena& anArena);
+      HumdrumArena&     operator=          (const HumdrumArena& anArena);
+      void              nextChunk          (int size);
+};
+
+
+#endif  /* _HUMDRUMARENA_H_INCLUDED */
+
+
+
@@ -0,0 +1,55 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:41:20 PDT 2026
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026
+// Filename:      ...sig/include/sigInfo/HumdrumCache.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumCache.h
+// Syntax:        C++
+//
+// Description:   Binary precompiled form of the HumdrumFiles read from
+//                a source file (.humc files).  The cache stores the text
+//                of the records in a string pool laid out in the same way
+//                as the HumdrumArena storage used by the text parser,
+//                along with the field offsets, spine information, dot
+//                analysis and rhythm analysis of each line, so that the
+//                files can be loaded without parsing the text again.
+//                HumdrumStream uses a sibling cache (the source filename
+//                with ".humc" appended) when it is up to date.
+//
+
+#ifndef _HUMDRUMCACHE_H_INCLUDED
+#define _HUMDRUMCACHE_H_INCLUDED
+
+#include "HumdrumFile.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+class HumdrumCache {
+   public:
+      static string  getCacheName      (const string& sourcename);
+      static int     isCurrent         (const string& cachename,
+                                        const string& sourcename);
+      static int     write             (const string& cachename,
+                                        const string& sourcename,
+                                        vector<HumdrumFile*>& segments);
+      static int     read              (const string& cachename,
+                                        const string& sourcename,
+                                        vector<HumdrumFile*>& segments);
+
+   protected:
+      static void    writeSegment      (string& output, HumdrumFile& infile,
+                                        const string& sourcename);
+      static int     readSegment       (const char* data, size_t length,
+                                        size_t& position, HumdrumFile& infile,
+                                        const string& sourcename);
+};
+
+
+#endif  /* _HUMDRUMCACHE_H_INCLUDED */
+
+
+
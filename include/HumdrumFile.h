@@ -19,6 +19,17 @@
 // Last Modified: Sat Sep  5 22:03:28 PDT 2009 ArrayInt to Array<int>
 // Last Modified: Sun Jun 20 13:42:12 PDT 2010 Added rhythm list)
 // Last Modified: Mon Sep 16 20:26:17 PDT 2013 Added getMeasureNumber()
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 Added swap(), keepRhythmAnalysis()
+// Last Modified: Sat Oct 17 18:47:41 PDT 2026 Added incremental rhythm analysis
+// Last Modified: Sat Oct 17 19:04:14 PDT 2026 Added getNoteTable()
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026 HumdrumCache access
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 documented thread-safe reading
+// Last Modified: Sat Oct 17 21:23:05 PDT 2026 getTied*() use the note table
+// Last Modified: Sat Oct 17 22:47:20 PDT 2026 Limit incremental rhythm analysis
+// Last Modified: Sat Oct 17 22:53:35 PDT 2026 64-bit duration tracers
+// Last Modified: Sat Oct 17 23:19:37 PDT 2026 note table built by analyzeRhythm
+// Last Modified: Sat Oct 17 23:25:24 PDT 2026 getTied*() do not analyze
+// Last Modified: Sun Oct 18 00:16:12 PDT 2026 getTied*() scan without table
 // Filename:      ...sig/include/sigInfo/HumdrumFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumFile.h
 // Syntax:        C++ 
@@ -27,6 +38,21 @@
 //                Inherits HumdrumFileBasic and adds rhythmic and other
 //                types of analyses to the HumdrumFile class.
 //
+//                Threads: after analyzeRhythm(), a HumdrumFile which is
+//                not changed can be read by many threads at once without
+//                locks.  Functions which only read the file (records and
+//                tokens, getLine(), the is*() interpretation tests,
+//                getBeat(), getDuration(), getAbsBeat(), getBibValue()
+//                into a buffer owned by the calling thread, getNoteList(),
+//                getNoteArray(), getNoteTable(), the getTied*() functions
+//                and the analyze*() functions which fill arrays given by
+//                the caller) do not modify the file, and the shared
+//                Convert enumerations are fixed at startup, except that
+//                new exclusive interpretations are added to Convert::exint
+//                without disturbing readers.  Changing the file, reading
+//                into it, or analyzing its rhythm must not be done while
+//                other threads are accessing it.
+//
 
 #ifndef _HUMDRUMFILE_H_INCLUDED
 #define _HUMDRUMFILE_H_INCLUDED
@@ -35,6 +61,7 @@
 #include <vector>
 
 #include "HumdrumFileBasic.h"
+#include "HumdrumNoteTable.h"
 #include "NoteList.h"
 #include "ChordQuality.h"
 
@@ -81,7 +108,43 @@ using namespace std;
 
 ///////////////////////////////////////////////////////////////////////////
 
+//
+// RhythmCheckpoint -- the state of the rhythm analysis at the start of
+//    a line.  Checkpoints are stored at the start of the file and at each
+//    barline so that the analysis can be restarted after an edit.
+//
+
+class RhythmCheckpoint {
+   public:
+                        RhythmCheckpoint (void);
+                        RhythmCheckpoint (const RhythmCheckpoint& aPoint);
+      RhythmCheckpoint& operator=        (const RhythmCheckpoint& aPoint);
+      int               sameState        (const RhythmCheckpoint& aPoint) const;
+
+      int                             line;          // line of the checkpoint
+      RationalNumber64                absbeat;       // absbeat of the line
+      SigCollection<RationalNumber64> lastdurations; // duration tracers
+      SigCollection<RationalNumber64> runningstatus; // duration tracers
+      Array<int>                      ignore;        // free rhythm tracks
+      int                             init;
+      int                             datainit;
+      int                             foundstart;
+      RationalNumber                  measurebeats;  // current meter duration
+      RationalNumber                  timesig;       // **kern time signature
+      Array<RationalNumber>           rhythms;       // until next checkpoint
+
+      // results of linking incomplete measures (see fixIncompleteBarMeterR):
+      RationalNumber                  meterdur;      // time sig. of measure
+      int                             chained;       // linked to previous bar
+      int                             reach;         // last barline examined
+      int                             maxreach;      // largest reach up to here
+};
+
+///////////////////////////////////////////////////////////////////////////
+
 class HumdrumFile : public HumdrumFileBasic {
+   friend class HumdrumCache;  // loads/stores analyses in .humc files
+
    public:
                              HumdrumFile      (void);
                              HumdrumFile      (const HumdrumFile& aHumdrumFile);
@@ -91,6 +154,7 @@ class HumdrumFile : public HumdrumFileBasic {
                             ~HumdrumFile      ();
 
       void                   appendLine       (const char* aLine);
+      void                   appendLine       (const char* aLine, int length);
       void                   appendLine       (HumdrumRecord& aRecord);
       void                   appendLine       (HumdrumRecord* aRecord);
       static int             assemble         (HumdrumFile& output, int count, 
@@ -147,6 +211,7 @@ class HumdrumFile : public HumdrumFileBasic {
                                                Array<Array<int> >& nextpitches,
                                                int startLine = 0, 
                                                int endLine = 0);
+      const HumdrumNoteTable& getNoteTable    (void) const;
       double                 getTiedDuration  (int linenum, int field, 
                                                  int token = 0);
       RationalNumber         getTiedDurationR (int linenum, int field, 
@@ -163,13 +228,18 @@ class HumdrumFile : public HumdrumFileBasic {
       double                 getTotalDuration (void);
       RationalNumber         getTotalDurationR(void);
       HumdrumFile&           operator=        (const HumdrumFile& aFile);
+      void                   swap             (HumdrumFile& aFile);
       void                   read             (const char* filename);
       void                   read             (const string& filename);
       void                   read             (istream& inStream);
+      void                   read             (const char* contents,
+                                               size_t length);
 
       // analyses that generate internal data
       void                   analyzeRhythm    (const char* base = "", 
-                                                 int debug = 0);
+                                                 int debug = 0,
+                                                 int incremental = 0);
+      void                   keepRhythmAnalysis(void);
       void                   spaceEmptyLines  (void);
       int                    getMinTimeBase   (void);
       RationalNumber         getMinTimeBaseR  (void);
@@ -220,10 +290,14 @@ class HumdrumFile : public HumdrumFileBasic {
       void analyzeTempoMarkings(vector<double>& tempo, double tdefault = 60.0);
       void analyzeMeter(Array<double>& top, Array<double>& bottom, 
          int flag = AFLAG_NOCOMPOUND_METER);
+      void analyzeMeter(Array<double>& top, Array<double>& bottom, 
+         int flag, int startline, int stopline);
       void analyzeBeatDuration(Array<double>& beatdur, 
          int flag = AFLAG_COMPOUND_METER);
       void analyzeAttackAccentuation(Array<int>& atakcent);
       void analyzeMetricLevel(Array<int>& metlev);
+      void analyzeMetricLevel(Array<int>& metlev, int startline, 
+         int stopline);
       void analyzeMetricLevel(vector<int>& metlev);
 
       // sonority harmonic analyses
@@ -240,11 +314,17 @@ class HumdrumFile : public HumdrumFileBasic {
             int rhythmQ = 1, int binaryQ = 0, int tracknum = -1);
 
    protected:
-      int rhythmcheck;          // 1 = rhythm analysis has been done
-      int minrhythm;            // the least common multiple of all rhythms
+      int rhythmcheck; // 1 = rhythm analysis has been done
+      int minrhythm; // the least common multiple of all rhythms
       RationalNumber minrhythmR;  // the least common multiple of all rhythms
-      Array<RationalNumber> localrhythms;  // used with rhythmanalysis
+      Array<RationalNumber> localrhythms; // used with rhythmanalysis
       RationalNumber pickupdur; // duration of a pickup measure
+      string rhythmbase; // base used for the last rhythm analysis
+      int keeprhythmQ;          // 1 = don't redo rhythm analysis on next call
+      vector<RhythmCheckpoint> rhythmpoints; // for incremental analysis
+      vector<RationalNumber64> rawbeats; // beats before measure adjustments
+      HumdrumNoteTable notetable; // notes extracted by analyzeRhythm()
+      int notetableQ;           // 1 = notetable is up to date
 
    private:
       int            ispoweroftwo            (int value);
@@ -262,32 +342,47 @@ class HumdrumFile : public HumdrumFileBasic {
 
 
       // rhythm analysis functions:
-      void       privateRhythmAnalysis(const char* base = "", int debug = 0);
+      void       privateRhythmAnalysis(const char* base = "", int debug = 0,
+                         int firstline = -1, int lastline = -1);
+      void       addMinimumRhythm(Array<RationalNumber>& rhythms,
+                         RationalNumber& rbase);
+      void       clearRhythmCheckpoints(void);
       RationalNumber determineDurationR(HumdrumRecord& aRecord,
                         int& init, SigCollection<RationalNumber>& lastdurations,
                          SigCollection<RationalNumber>& runningstatus,
                          Array<int>& rhythms, Array<int>& ignore);
-      RationalNumber determineDurationR2(HumdrumRecord& aRecord,
-                        int& init, SigCollection<RationalNumber>& lastdurations,
-                         SigCollection<RationalNumber>& runningstatus,
+      RationalNumber64 determineDurationR2(HumdrumRecord& aRecord, int& init,
+                         SigCollection<RationalNumber64>& lastdurations,
+                         SigCollection<RationalNumber64>& runningstatus,
                          Array<RationalNumber>& rhythms, Array<int>& ignore);
       void       adjustForSpinePaths(HumdrumRecord& aRecord, 
-                         SigCollection<RationalNumber>& lastdurations, 
-                         SigCollection<RationalNumber>& runningstatus, 
+                         SigCollection<RationalNumber64>& lastdurations, 
+                         SigCollection<RationalNumber64>& runningstatus, 
 			 int& init, int& datastart, Array<int>& ignore);
       void       adjustForRhythmMarker(HumdrumRecord& aRecord,
                          int state, int spine, 
-                         SigCollection<RationalNumber>& lastdurations, 
-                         SigCollection<RationalNumber>& runningstatus, 
+                         SigCollection<RationalNumber64>& lastdurations, 
+                         SigCollection<RationalNumber64>& runningstatus, 
 			 int& init, int& datastart, Array<int>& ignore);
       void       fixIncompleteBarMeter(SigCollection<double>& meterbeats, 
                          SigCollection<double>& timebase);
-      void       fixIncompleteBarMeterR(
-		         SigCollection<RationalNumber>& meterbeats, 
-                         SigCollection<RationalNumber>& timebase, const char* base);
+      int        fixIncompleteBarMeterR(int startpoint, int matchpoint);
+      int        getMeterSignature(HumdrumRecord& record, int& top, 
+                         int& bottom);
+      const HumdrumNoteTable* getTieTable(void) const;
+      RationalNumber scanTiedDurationR(int linenum, int field, int token);
+      RationalNumber scanTotalTiedDurationR(int linenum, int field, 
+                         int token);
+      void       scanTiedStartLocation(int linenum, int field, int token, 
+                         int& tline, int& tcol, int& ttok);
+      RationalNumber scanTiedStartBeatR(int linenum, int field, int token);
+      RationalNumber64 getMeasureDurationR(int point, 
+                         const RationalNumber64& lastabs);
+      void       fixPickupBeats(const char* base);
       void       fixIrritatingPickupProblem(void);
-      void       initializeTracers(SigCollection<RationalNumber>& lastduration,
-                         SigCollection<RationalNumber>& runningstatus, 
+      void       initializeTracers(
+                         SigCollection<RationalNumber64>& lastduration,
+                         SigCollection<RationalNumber64>& runningstatus, 
                          HumdrumRecord& currRecord);
       int        GCD      (int a, int b);
       int        findlcm  (Array<int>& rhythms);
@@ -9,6 +9,13 @@
 // Last Modified: Tue Apr 24 16:54:50 PDT 2012 added readFromJrpURI()
 // Last Modified: Tue Dec 11 17:23:04 PST 2012 added fileName, segmentLevel
 // Last Modified: Sat Apr 27 13:36:16 PDT 2013 added changeField()
+// Last Modified: Sat Oct 17 17:39:08 PDT 2026 added arena storage for records
+// Last Modified: Sat Oct 17 17:49:13 PDT 2026 added memory-mapped reading
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 added swap()
+// Last Modified: Sat Oct 17 18:47:41 PDT 2026 added dirty line range tracking
+// Last Modified: Sat Oct 17 19:51:51 PDT 2026 static spine path functions
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 thread-safe reading, string getBibValue
+// Last Modified: Sat Oct 17 22:47:20 PDT 2026 records report their changes
 // Filename:      ...sig/include/sigInfo/HumdrumFileBasic.h
 // Web Address:   http://museinfo.sapp.org/include/sigInfo/HumdrumFileBasic.h
 // Syntax:        C++ 
@@ -22,6 +29,7 @@
 #define _HUMDRUMFILEBASIC_H_INCLUDED
 
 #include "HumdrumRecord.h"
+#include "HumdrumArena.h"
 #include "SigCollection.h"
 #include "Array.h"
 
@@ -49,6 +57,13 @@ using namespace std;
    #define CSTRING str().c_str()
 #endif
 
+// the following define is for reading files with mmap() inside of the
+// read() functions.  Comment out the define if your OS doesn't provide
+// POSIX memory-mapped files (the files will be read with ifstream).
+#ifndef VISUAL
+   #define USING_MMAP
+#endif
+
 
 ///////////////////////////////////////////////////////////////////////////
 
@@ -93,6 +108,8 @@ class HumdrumFileAddress {
 ///////////////////////////////////////////////////////////////////////////
 
 class HumdrumFileBasic {
+   friend class HumdrumLineReader;  // incremental spine/dot analysis
+
    public:
                              HumdrumFileBasic (void);
                              HumdrumFileBasic (const HumdrumFileBasic& 
@@ -102,12 +119,19 @@ class HumdrumFileBasic {
                             ~HumdrumFileBasic ();
 
       void                   appendLine       (const char* aLine);
+      void                   appendLine       (const char* aLine, int length);
       void                   appendLine       (HumdrumRecord& aRecord);
       void                   appendLine       (HumdrumRecord* aRecord);
       void                   setAllocation    (int allocation);
+      void                   setArenaStorage  (int state = 1);
       void                   changeField      (HumdrumFileAddress& add,
                                                const char* newField);
       void                   clear            (void);
+      void                   markDirty        (int startline, 
+                                               int endline = -1);
+      void                   clearDirty       (void);
+      int                    getDirtyStart    (void);
+      int                    getDirtyEnd      (void);
       void                   setFilename      (const string& filename);
       void                   setFilename      (const char* filename);
       string                 getFilename      (void);
@@ -121,6 +145,7 @@ class HumdrumFileBasic {
       const char*            getDotValue      (int index, int spinei);
       const char*            getLine          (int index);
       const char*            getBibValue      (char* buffer, const char* key);
+      string&                getBibValue      (string& buffer, const char* key);
       int                    getNumLines      (void);
       HumdrumRecord&         getRecord        (int index);
       int                    getSegmentCount  (void);
@@ -145,9 +170,12 @@ class HumdrumFileBasic {
       static void            makeVtsData      (string& vtsstring,
                                                HumdrumFileBasic& infile);
       HumdrumFileBasic&      operator=        (const HumdrumFileBasic& aFile);
+      void                   swap             (HumdrumFileBasic& aFile);
       void                   read             (const char* filename);
       void                   read             (const string& filename);
       void                   read             (istream& inStream);
+      void                   read             (const char* contents,
+                                               size_t length);
       HumdrumFileBasic       removeNullRecords(void);
       HumdrumRecord&         operator[]       (int index);
       const char*            operator[]       (HumdrumFileAddress& add);
@@ -164,27 +192,39 @@ class HumdrumFileBasic {
       string         fileName;      // storage for input file's name
       int            segmentLevel;  // storage for input file's segment level
       SigCollection  <HumdrumRecord*>  records;
+      HumdrumArena   arena;         // text storage for the records
+      int            arenaQ;        // boolean for storing records in arena
       int            maxtracks;           // max exclusive interpretation count
+      int            dirtystart;    // first line changed since clearDirty()
+      int            dirtyend;      // last line changed since clearDirty()
       vector<string> trackexinterp;
-      static char    empty[1];
+      static const char empty[1];
+
+      HumdrumRecord* newRecord        (void);
+      void           setRecordOwners  (int startindex = 0);
 
    private:
       static int intcompare(const void* a, const void* b);
 
       // spine analysis functions:
       void       privateSpineAnalysis(void);
-      int        predictNewSpineCount(HumdrumRecord& aRecord);
-      void       makeNewSpineInfo(vector<string>& spineinfo, 
+      static int predictNewSpineCount(HumdrumRecord& aRecord);
+      static void makeNewSpineInfo(vector<string>& spineinfo, 
                     HumdrumRecord& aRecord, int newsize, int& spineid,
                     vector<int>& ex);
-      void       simplifySpineString(string& spinestring);
-      void       simplifySpineInfo(vector<string>& info, int index);
+      static void simplifySpineString(string& spinestring);
+      static void simplifySpineInfo(vector<string>& info, int index);
 
       // determining the meaning of dots (null records)
       void       privateDotAnalysis(void);
-      void       readjustDotArrays(Array<int>& lastline, Array<int>& lastspine, 
-                       HumdrumRecord& record, int newsize);
+      static void readjustDotArrays(Array<int>& lastline,
+                       Array<int>& lastspine, HumdrumRecord& record,
+                       int newsize);
+
 
+      #ifdef USING_MMAP
+         int      readMappedFile           (const char* filename);
+      #endif
 
       // automatic URI downloading of data in read()
       #ifdef USING_URI
@@ -0,0 +1,99 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:51:51 PDT 2026
+// Last Modified: Sat Oct 17 19:51:51 PDT 2026
+// Filename:      ...sig/include/sigInfo/HumdrumLineReader.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumLineReader.h
+// Syntax:        C++
+//
+// Description:   Reads Humdrum data one line at a time.  Each record
+//                receives the same spine information, exclusive
+//                interpretations and dot analysis that it would have in
+//                a HumdrumFile, but the analysis is kept as running state
+//                so that only the current line is stored in memory.  The
+//                input is divided into segments in the same way as
+//                HumdrumFileSet: at !!!!SEGMENT: markers (which are not
+//                returned as records) and at a second exclusive
+//                interpretation line (the new segment has an empty
+//                filename).  Line numbers and dot line indexes are
+//                counted from the start of the current segment.
+//
+
+#ifndef _HUMDRUMLINEREADER_H_INCLUDED
+#define _HUMDRUMLINEREADER_H_INCLUDED
+
+#include "HumdrumRecord.h"
+#include "Array.h"
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+using namespace std;
+
+
+class HumdrumLineReader {
+   public:
+                     HumdrumLineReader  (void);
+                     HumdrumLineReader  (const char* filename);
+                     HumdrumLineReader  (const string& filename);
+                     HumdrumLineReader  (istream& instream);
+                    ~HumdrumLineReader  ();
+
+      int            open               (const char* filename);
+      int            open               (const string& filename);
+      void           open               (istream& instream);
+      void           close              (void);
+      int            read               (HumdrumRecord& record);
+
+      // information about the segment of the last record read:
+      int            isSegmentStart     (void) const { return segmentstartQ; }
+      int            getSegmentIndex    (void) const { return segmentindex; }
+      const string&  getFilename        (void) const { return segmentname; }
+      int            getLineCount       (void) const { return linecount; }
+      int            getMaxTracks       (void) const { return spineid; }
+      string         getTrackExInterp   (int track) const;
+      ostream&       printSegmentLabel  (ostream& out) const;
+      ostream&       printNonemptySegmentLabel(ostream& out) const;
+
+   protected:
+      istream*       input;          // stream being read
+      ifstream       infile;         // storage when reading from a file
+      string         line;           // buffer for the current line
+      string         basename;       // filename without directory
+      string         segmentname;    // filename of the current segment
+      string         nextname;       // filename of the next segment
+      int            nextQ;          // boolean for starting a new segment
+      int            segmentstartQ;  // boolean for first line of a segment
+      int            segmentindex;   // count of segments started - 1
+      int            linecount;      // lines read in the current segment
+      int            exclusivecount; // ** lines in the current segment
+
+      // spine analysis state:
+      int            init;           // boolean for inside of spines
+      int            spineid;        // highest spine number assigned
+      int            currentwidth;   // spine count for non-spine lines
+      int            prediction;     // spine count after a manipulator
+      int            predictionQ;    // boolean for checking prediction
+      vector<string> spineinfo;      // spine path of each active spine
+      vector<int>    exinterps;      // exclusive interpretation of spines
+      vector<string> trackexinterp;  // starting exclusive interpretations
+
+      // dot analysis state:
+      Array<int>     lastline;       // last non-null line in each spine
+      Array<int>     lastspine;      // last non-null field in each spine
+      int            newcount;       // spine count after a manipulator
+
+      void           initialize         (void);
+      void           startSegment       (void);
+      void           endSegment         (void);
+      void           analyzeSpines      (HumdrumRecord& record);
+      void           analyzeDots        (HumdrumRecord& record);
+};
+
+
+#endif  /* _HUMDRUMLINEREADER_H_INCLUDED */
+
+
+
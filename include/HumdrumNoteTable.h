@@ -0,0 +1,92 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:04:14 PDT 2026
+// Last Modified: Sat Oct 17 19:04:14 PDT 2026
+// Last Modified: Sat Oct 17 21:23:05 PDT 2026 added tie links and find()
+// Last Modified: Sat Oct 17 23:19:37 PDT 2026 added update()
+// Filename:      ...sig/include/sigInfo/HumdrumNoteTable.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumNoteTable.h
+// Syntax:        C++
+//
+// Description:   Table of all notes in the **kern spines of a HumdrumFile,
+//                stored as parallel arrays (one entry per note in each
+//                array) so that analyses can scan the notes without
+//                parsing the **kern tokens again.  Rests and null tokens
+//                are not included.  Use HumdrumFile::getNoteTable() to
+//                get the table for a file, which is extracted when its
+//                rhythm is analyzed (only the notes of the changed lines
+//                are extracted again after an incremental analysis).
+//                Notes which are tied together are linked in one pass
+//                through the table, which is used by the
+//                HumdrumFile::getTied*() functions.
+//
+
+#ifndef _HUMDRUMNOTETABLE_H_INCLUDED
+#define _HUMDRUMNOTETABLE_H_INCLUDED
+
+#include "RationalNumber64.h"
+
+#include <vector>
+
+using namespace std;
+
+class HumdrumFile;
+
+
+class HumdrumNoteTable {
+   public:
+                       HumdrumNoteTable  (void);
+                      ~HumdrumNoteTable  ();
+
+      void             build             (HumdrumFile& infile);
+      void             update            (HumdrumFile& infile, 
+                                          int startline, int stopline,
+                                          const RationalNumber64& delta);
+      void             clear             (void);
+      void             swap              (HumdrumNoteTable& aTable);
+      int              getSize           (void) const
+                                            { return (int)line.size(); }
+      int              isAttack          (int index) const
+                                            { return attack[index]; }
+      int              find              (int aLine, int aField,
+                                          int aSubtoken = 0) const;
+
+      // note location in the file:
+      vector<int>      line;          // line index of the note
+      vector<int>      field;         // field (spine) index on the line
+      vector<int>      subtoken;      // index of the note in a chord
+      vector<int>      track;         // primary track of the spine
+
+      // pitch:
+      vector<int>      base40;        // base-40 pitch
+      vector<int>      midi;          // MIDI key number
+
+      // rhythm (onset in the units of the rhythm analysis, durations in
+      // quarter notes, 0 for grace notes):
+      vector<RationalNumber64> onset;        // absolute beat of the line
+      vector<RationalNumber64> duration;     // duration of the note token
+      vector<RationalNumber64> tiedduration; // duration of the tied notes
+
+      // ties (notes which are not tied are a tie of one note):
+      vector<int>      tie;           // index of the first note in the tie
+      vector<int>      tienext;       // index of the next note, or -1
+      vector<int>      tieend;        // index of the last note in the tie
+      vector<char>     attack;        // 0 if the note continues a tie
+
+      vector<int>      level;         // metric level of the line
+
+   protected:
+      vector<int>      linestart;     // index of first note on/after a line
+      vector<char>     tieflags;      // tie markers of the note token
+
+      void             addLine           (HumdrumFile& infile, int aLine,
+                                          int aLevel);
+      void             linkTies          (void);
+      void             reserve           (int size);
+};
+
+
+#endif  /* _HUMDRUMNOTETABLE_H_INCLUDED */
+
+
+
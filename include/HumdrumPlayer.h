@@ -0,0 +1,197 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 22:16:50 PDT 2026
+// Last Modified: Sat Oct 17 22:16:50 PDT 2026
+// Filename:      ...sig/include/sigInfo/HumdrumPlayer.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumPlayer.h
+// Syntax:        C++
+//
+// Description:   Real-time playback of the **kern spines of a HumdrumFile.
+//                The times of all note-ons, note-offs and lines are
+//                calculated in advance from the rhythm analysis and the
+//                *MM tempo markings when a file is loaded.  A separate
+//                thread sends the MIDI messages to an output sink, sleeping
+//                until the absolute clock time of each event, so timing
+//                errors do not accumulate.  Changing the tempo scaling,
+//                pausing or seeking only moves the point where score time
+//                is anchored to the clock.  The latency of each message
+//                (the time after its deadline when it was sent) is
+//                measured for checking the timing of the output.
+//
+
+#ifndef _HUMDRUMPLAYER_H_INCLUDED
+#define _HUMDRUMPLAYER_H_INCLUDED
+
+#include "HumdrumFile.h"
+
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// HumdrumPlayerSink -- Destination for the MIDI messages of a
+//     HumdrumPlayer.  send() is called from the playback thread with
+//     the time in seconds since playback started.
+//
+
+class HumdrumPlayerSink {
+   public:
+      virtual       ~HumdrumPlayerSink  () { }
+      virtual void   send               (const unsigned char* data, int size,
+                                         double time) = 0;
+};
+
+
+// Stores the messages (and the time that they were sent) in memory.
+class HumdrumPlayerMemorySink : public HumdrumPlayerSink {
+   public:
+      virtual void   send               (const unsigned char* data, int size,
+                                         double time);
+      void           clear              (void);
+      int            getSize            (void) const
+                                           { return (int)time.size(); }
+
+      vector<double>                 time;     // send time of each message
+      vector<vector<unsigned char> > message;  // MIDI bytes of each message
+};
+
+
+// Writes the MIDI bytes to a file, such as a raw MIDI device
+// (/dev/snd/midiC1D0 for example).
+class HumdrumPlayerFileSink : public HumdrumPlayerSink {
+   public:
+                     HumdrumPlayerFileSink (void) { }
+                     HumdrumPlayerFileSink (const char* filename);
+      virtual       ~HumdrumPlayerFileSink ();
+
+      int            open               (const char* filename);
+      void           close              (void);
+      int            is_open            (void) { return outfile.is_open(); }
+      virtual void   send               (const unsigned char* data, int size,
+                                         double time);
+
+   protected:
+      ofstream       outfile;
+};
+
+
+class _HumdrumPlayerEvent {
+   public:
+      double         time;      // score time in seconds (tempo scaling 1.0)
+      int            line;      // line in the file
+      int            track;     // primary track of the note
+      int            note;      // index of the note (for matching note-offs)
+      int            type;      // see HUMPLAY_* in HumdrumPlayer.cpp
+      int            key;       // MIDI key number (before transposition)
+      double         accent;    // velocity multiplier for note-ons
+};
+
+
+class HumdrumPlayer {
+   public:
+                     HumdrumPlayer      (void);
+                    ~HumdrumPlayer      ();
+
+      // settings used when a file is loaded:
+      void           setDefaultTempo    (double tempo);
+      void           setShorten         (int milliseconds);
+      void           setMinimumDuration (int milliseconds);
+
+      // settings which can be changed while playing:
+      void           setSink            (HumdrumPlayerSink* aSink);
+      void           setChannel         (int channel);
+      void           setVelocity        (int velocity);
+      int            getVelocity        (void);
+      void           setTranspose       (int semitones);
+      int            getTranspose       (void);
+      void           setMute            (int track, int state = 1);
+      int            getMute            (int track);
+      void           setTempoScale      (double scale);
+      double         getTempoScale      (void);
+      void           setTempo           (double tempo);
+      double         getTempo           (void);
+
+      // playback:
+      void           load               (HumdrumFile& infile);
+      void           clear              (void);
+      void           play               (double delay = 0.0);
+      void           stop               (void);
+      void           pause              (void);
+      void           resume             (void);
+      int            isPaused           (void);
+      int            isFinished         (void);
+      void           seek               (int line);
+      void           silence            (void);
+      int            getLine            (void);
+
+      // timing statistics (in microseconds):
+      void           resetStatistics    (void);
+      int            getEventCount      (void);
+      double         getMeanLatency     (void);
+      double         getMaxLatency      (void);
+      double         getJitter          (void);
+
+   protected:
+      // schedule of the loaded file:
+      vector<_HumdrumPlayerEvent> events;     // sorted by time
+      vector<double>  linetime;       // score time of each line in seconds
+      vector<double>  linetempo;      // tempo of each line
+      vector<int>     lineindex;      // index in events of each line
+      vector<signed char> sounding;   // key sent for each note, or -1
+      double          defaulttempo;   // tempo before the first *MM
+      int             shorten;        // ms to remove from each note
+      int             minimum;        // minimum note duration in ms
+
+      // playback state (protected by the mutex):
+      HumdrumPlayerSink* sink;
+      int             channel;
+      int             velocity;
+      int             transpose;
+      vector<char>    mute;           // muted tracks
+      double          temposcale;
+      int             index;          // next event to play
+      int             currentline;    // line of the last event played
+      long long       anchorclock;    // clock time (ns) of anchorscore
+      double          anchorscore;    // score time at anchorclock
+      long long       starttime;      // clock time (ns) when play() called
+      int             pausedQ;
+      int             playingQ;       // true while the thread is running
+      int             stopQ;          // tells the thread to exit
+      int             generation;     // incremented when anchor moves
+
+      // latency statistics (in nanoseconds):
+      int             statcount;
+      double          statsum;
+      double          statsumsquares;
+      double          statmax;
+
+      thread          player;
+      mutex           lock;
+      condition_variable wakeup;
+
+      void           run                (void);
+      void           dispatch           (_HumdrumPlayerEvent& event,
+                                         long long deadline);
+      void           silenceNotes       (void);
+      double         getScoreTime       (long long now);
+      long long      getDeadline        (double time);
+      double         getBeatTime        (HumdrumFile& infile,
+                                         const RationalNumber64& beat,
+                                         int startline);
+      static long long getClockTime     (void);
+      static void    sleepUntil         (long long clocktime);
+      static bool    eventCompare       (const _HumdrumPlayerEvent& a,
+                                         const _HumdrumPlayerEvent& b);
+};
+
+
+#endif  /* _HUMDRUMPLAYER_H_INCLUDED */
+
+
+
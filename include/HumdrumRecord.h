@@ -13,6 +13,12 @@
 // Last Modified: Tue Jun 26 09:51:28 PDT 2012 Added interpretation type funcs.
 // Last Modified: Mon Dec 10 10:14:08 PST 2012 Added Array<char> getToken
 // Last Modified: Sat Apr 20 12:15:42 PDT 2013 Added isNulToken()
+// Last Modified: Sat Oct 17 17:39:08 PDT 2026 Added HumdrumArena storage
+// Last Modified: Sat Oct 17 17:49:13 PDT 2026 Added setLine with length
+// Last Modified: Sat Oct 17 18:56:50 PDT 2026 Added RationalNumber64 storage
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026 HumdrumCache access
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 lock-free interpretation tests
+// Last Modified: Sat Oct 17 22:47:20 PDT 2026 Report changes to owning file
 // Filename:      ...sig/include/sigInfo/HumdrumRecord.h
 // Webpage:       http://sig.sapp.org/include/sigInfo/HumdrumRecord.h
 // Syntax:        C++ 
@@ -29,11 +35,18 @@
 #include "EnumerationEI.h"
 #include "Enum_humdrumRecord.h"
 #include "RationalNumber.h"
+#include "RationalNumber64.h"
+#include "HumdrumArena.h"
 
 #include <vector>
 #include <iostream>
 
+class HumdrumFileBasic;
+
 class HumdrumRecord {
+   friend class HumdrumCache;      // loads/stores records in .humc files
+   friend class HumdrumFileBasic;  // sets the owner of its records
+
    public:
                         HumdrumRecord      (void);
                         HumdrumRecord      (const char* aLine, 
@@ -62,8 +75,10 @@ class HumdrumRecord {
                                               const char* compareString);
       double            getAbsBeat         (void) const;
       RationalNumber    getAbsBeatR        (void) const;
+      const RationalNumber64& getAbsBeatR64(void) const { return abslocR; }
       double            getBeat            (void) const;
       RationalNumber    getBeatR           (void) const;
+      const RationalNumber64& getBeatR64   (void) const { return meterlocR; }
       double            getMeasureDuration (void) const;
       RationalNumber    getMeasureDurationR(void) const;
       int               getDotLine         (int index);
@@ -72,6 +87,7 @@ class HumdrumRecord {
                                               { return getDotSpine(index); } 
       double            getDuration        (void) const;
       RationalNumber    getDurationR       (void) const;
+      const RationalNumber64& getDurationR64(void) const { return durationR; }
       int               getExInterpNum     (int fieldIndex) const;
       const char*       getExInterp        (int fieldIndex) const;
       int               getFieldCount      (void) const;
@@ -85,6 +101,7 @@ class HumdrumRecord {
       char*             getBibValue        (char* buffer, int maxsize = 0);
       char*             getBibKey          (Array<char>& buffer);
       char*             getBibValue        (Array<char>& buffer);
+      string&           getBibValue        (string& buffer);
       const char*       getBibLangIso639_2 (const char* string = NULL);
       static const char*getLanguageName    (const char* code);
       static const char*getBibliographicMeaning(Array<char>& output, 
@@ -218,31 +235,38 @@ class HumdrumRecord {
                                               const char* spinetrace = "");
       void              setSize            (int asize);
       void              setAllFields       (const char* astring);
+      void              setArena           (HumdrumArena* anArena);
+      void              rebindArena        (HumdrumArena* anArena);
+      HumdrumArena*     getArena           (void) const { return arena; }
       HumdrumRecord&    operator=          (const HumdrumRecord& aRecord);
       HumdrumRecord&    operator=          (const HumdrumRecord* aRecord);
       HumdrumRecord&    operator=          (const char* aRecord);
       const char*       operator[]         (int index) const;
       void              setAbsBeat         (double aValue);
       void              setAbsBeat         (int top, int bottom);
-      void              setAbsBeatR        (int top, int bottom);
+      void              setAbsBeatR        (int top, int bottom = 1);
       void              setAbsBeat         (const RationalNumber& aValue);
       void              setAbsBeatR        (const RationalNumber& aValue);
+      void              setAbsBeatR        (const RationalNumber64& aValue);
       void              setBeat            (double aValue);
       void              setBeat            (int top, int bottom);
-      void              setBeatR           (int top, int bottom);
+      void              setBeatR           (int top, int bottom = 1);
       void              setBeat            (const RationalNumber& aValue);
       void              setBeatR           (const RationalNumber& aValue);
+      void              setBeatR           (const RationalNumber64& aValue);
       void              setDotLine         (int index, int value);
       void              setDotSpine        (int index, int value);
       void              setDuration        (double aValue);
       void              setDuration        (int top, int bottom);
-      void              setDurationR       (int top, int bottom);
+      void              setDurationR       (int top, int bottom = 1);
       void              setDuration        (RationalNumber aValue);
       void              setDurationR       (RationalNumber aValue);
+      void              setDurationR       (const RationalNumber64& aValue);
       void              setExInterp        (int fieldIndex, int interpretation);
       void              setExInterp        (int fieldIndex, 
                                               const char* interpretation);
       void              setLine            (const char* aString); 
+      void              setLine            (const char* aString, int length);
       void              setToken           (int index, const char* aString);
       void              setToken           (int index, const string& aString);
       void              setLineNum         (int aLine);
@@ -259,6 +283,9 @@ class HumdrumRecord {
       SigCollection<char*> recordFields;   // data for humdrum text record
       vector<string>       spineids;       // spine tracing ids
       Array<int>           interpretation; // exclusive interpretation of data
+      HumdrumArena*        arena;          // owner of text if not NULL
+      HumdrumFileBasic*    owner;          // file containing record, or NULL
+      int                  ownerindex;     // line index of record in owner
 
       Array<int>           dotline;        // for resolving meaning of "."'s
       Array<int>           dotspine;       // for resolving meaning of "."'s
@@ -266,18 +293,28 @@ class HumdrumRecord {
 
       // data storage for rhythmic analysis in relation to entire Humdrum File.
       float             duration;       // duration of the record 
-      RationalNumber    durationR;      // duration of the record 
+      RationalNumber64  durationR;      // duration of the record 
       float             meterloc;       // metric position of the record
-      RationalNumber    meterlocR;      // metric position of the record
+      RationalNumber64  meterlocR;      // metric position of the record
       float             absloc;         // absolute beat location of the record
-      RationalNumber    abslocR;        // absolute beat location of the record
+      RationalNumber64  abslocR;        // absolute beat location of the record
       
+      // used by HumdrumCache for text stored in an arena:
+                        HumdrumRecord      (HumdrumArena* anArena,
+                                            char* aString);
+
       // private functions
       int               determineFieldCount(const char* aLine) const;
       int               determineType      (const char* aLine) const;
       void              makeRecordString   (void);
+      void              markOwnerDirty     (void);
+      char*             allocateString     (int length);
+      char*             copyString         (const char* aString);
+      void              freeString         (char* aString);
+      void              clearFields        (void);
       void              storeRecordFields  (void);
-      int               isParticularType   (const char* regexp,
+      static const char*findBibValue       (const char* record);
+      int               isParticularType   (int (*test)(const char* token),
                                             const char* exinterp);
 };
    
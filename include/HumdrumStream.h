@@ -3,6 +3,8 @@
 // Creation Date: Tue Dec 11 16:03:43 PST 2012
 // Last Modified: Tue Dec 11 16:03:46 PST 2012
 // Last Modified: Fri Mar 11 21:25:24 PST 2016 Changed to STL
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 Added worker thread prefetching
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026 Added .humc cache files
 // Filename:      ...sig/include/sigInfo/HumdrumStream.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumStream.h
 // Syntax:        C++ 
@@ -12,6 +14,12 @@
 //                have more than one data start/stop sequence.  This usually
 //                indicates multiple movements if stored in one file, or
 //                multiple works if coming in from standard input.
+//                When setThreadCount() is given more than one thread,
+//                the files in the file list are parsed in advance by
+//                worker threads and returned in the original order.
+//                Files in the file list which have an up-to-date
+//                binary cache (see HumdrumCache) are loaded from the
+//                cache instead of being parsed.
 //
 
 #ifndef _HUMDRUMSTREAM_H_INCLUDED
@@ -21,9 +29,14 @@
 #include "Options.h"
 
 #include <vector>
+#include <map>
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 
 // the following define is for compiling/not compiling the automatic
@@ -48,9 +61,15 @@ class HumdrumStream {
                       HumdrumStream      (char** list);
                       HumdrumStream      (const vector<string>& list);
                       HumdrumStream      (Options& options);
+                     ~HumdrumStream      ();
 
       int             setFileList        (char** list);
       int             setFileList        (const vector<string>& list);
+      void            setThreadCount     (int count, int prefetch = 0);
+      void            setRhythmAnalysis  (const char* base = "4");
+      void            setCacheUse        (int state = 1);
+      static int      writeCache         (const string& filename,
+                                          const char* base = "4");
 
       void            clear              (void);
       int             eof                (void);
@@ -68,6 +87,30 @@ class HumdrumStream {
       int             curfile;          // index into filelist
 
       vector<string>  universals;       // storage for universal comments
+      int             cacheQ;           // true if .humc caches are used
+
+      // parallel prefetching of the files in filelist:
+      int             threadcount;      // number of worker threads
+      int             prefetchlimit;    // max files parsed ahead of reader
+      int             rhythmQ;          // true if workers analyze rhythm
+      string          rhythmbase;       // base for analyzeRhythm()
+      vector<thread>  workers;          // threads parsing upcoming files
+      mutex           prefetchmutex;    // lock for variables below
+      condition_variable jobready;      // signals more files may be parsed
+      condition_variable resultready;   // signals a file has been parsed
+      int             nextjob;          // next index in filelist to parse
+      int             nextresult;       // next index in filelist to return
+      int             stopQ;            // true when workers should exit
+      map<int, vector<HumdrumFile*> > prefetched; // parsed by workers
+      deque<HumdrumFile*> pending;      // segments of last returned file
+                                        // (or loaded from a cache)
+
+      void            initialize         (void);
+      void            startThreads       (void);
+      void            stopThreads        (void);
+      void            prefetchWorker     (void);
+      int             getPrefetchedFile  (HumdrumFile& infile);
+      int             readCache          (const string& filename);
 
       // automatic URI downloading of data in read()
       #ifdef USING_URI
@@ -0,0 +1,138 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 22:09:46 PDT 2026
+// Last Modified: Sat Oct 17 22:09:46 PDT 2026
+// Last Modified: Sun Oct 18 01:05:40 PDT 2026 event times and order as in hum2mid
+// Filename:      ...sig/include/sigInfo/HumdrumToMidi.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/HumdrumToMidi.h
+// Syntax:        C++
+//
+// Description:   Converts the **kern spines of a HumdrumFile into a
+//                Standard MIDI File in the same way as the default
+//                settings of hum2mid.  Notes are read from the note table
+//                of the file, and events are written in time order as
+//                bytes (with variable-length delta times) directly into
+//                one buffer for each track, so no event lists have to be
+//                stored and sorted.  Note-offs waiting to be written (and
+//                note-ons of grace notes which hum2mid delays) are kept
+//                in a heap for each track.  The buffers are reused
+//                by the next call to convert(), so one object can convert
+//                many files.  Objects do not share any data, so each
+//                thread can convert files with its own HumdrumToMidi
+//                object (construct the objects before starting the threads,
+//                since the first construction sets up the instrument table).
+//
+
+#ifndef _HUMDRUMTOMIDI_H_INCLUDED
+#define _HUMDRUMTOMIDI_H_INCLUDED
+
+#include "HumdrumFile.h"
+#include "HumdrumInstrument.h"
+
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+
+class _HumdrumToMidiNoteOff {
+   public:
+      int            tick;      // absolute tick time of the note-off
+      int            serial;    // order in which the note-off was stored
+      unsigned char  command;   // 0x80 | channel (0x90 for a delayed note)
+      unsigned char  key;       // MIDI key number
+      unsigned char  velocity;  // release velocity
+};
+
+
+class HumdrumToMidi {
+   public:
+                     HumdrumToMidi          (void);
+                    ~HumdrumToMidi          ();
+
+      void           clear                  (void);
+
+      // conversion settings:
+      void           setTicksPerQuarterNote (int ticks);
+      int            getTicksPerQuarterNote (void) const { return tpq; }
+      void           setVelocity            (int velocity);
+      void           setFixedVelocity       (int velocity);
+      void           setTranspose           (int semitones);
+      void           setChannel             (int channel);
+      void           setType0               (int state = 1);
+      void           setPadding             (int state = 1);
+      void           setComments            (int state = 1);
+      void           setText                (int state = 1);
+      void           setInstruments         (int state = 1);
+
+      // conversion and output:
+      void           convert                (HumdrumFile& infile);
+      int            getTrackCount          (void) const;
+      int            getSize                (void) const;
+      void           getData                (vector<unsigned char>& data);
+      ostream&       write                  (ostream& out);
+      int            write                  (const char* filename);
+
+   protected:
+      int            tpq;           // ticks per quarter note
+      int            velocity;      // attack velocity of notes
+      int            fixedvelocityQ;// true if accents do not change velocity
+      int            transpose;     // transposition of notes in semitones
+      int            channel;       // fixed channel, or -1 for automatic
+      int            type0Q;        // true to store all tracks in one
+      int            padQ;          // true to add a silent note at end
+      int            commentQ;      // true to store global comments
+      int            textQ;         // true to store title and copyright
+      int            instrumentQ;   // true to store program changes
+      int            currenttranspose; // transposition at current line
+
+      HumdrumInstrument                      instruments;
+
+      // data for the file being converted:
+      int                                    ktrackcount;
+      vector<int>                            trackindex;   // by ptrack
+      vector<int>                            trackchannel; // by MIDI track
+      vector<vector<unsigned char> >         trackdata;
+      vector<int>                            tracktick;
+      vector<vector<_HumdrumToMidiNoteOff> > noteoffs;
+      vector<int>                            gracecount;   // by line
+      int                                    serial;
+
+      void           assignChannels         (HumdrumFile& infile);
+      void           storeGraceCounts       (HumdrumFile& infile);
+      void           storeTrackNames        (HumdrumFile& infile);
+      void           storeTitle             (HumdrumFile& infile);
+      void           storeTempo             (HumdrumFile& infile, int line,
+                                             int tick);
+      void           storeInterpretations   (HumdrumFile& infile, int line,
+                                             int tick);
+      void           storeTimeSignature     (HumdrumFile& infile, int line,
+                                             int tick);
+      void           storeKeySignature      (HumdrumFile& infile, int line,
+                                             int tick);
+      void           storeNotes             (HumdrumFile& infile, int line,
+                                             int tick, int& index);
+      void           storeEnding            (HumdrumFile& infile);
+
+      int            getTrack               (int ptrack) const;
+      void           storeEvent             (int track, int tick, int p0,
+                                             int p1, int p2 = -1);
+      void           storeMetaEvent         (int track, int tick, int type,
+                                             const char* data, int size);
+      void           storeNoteOff           (int track, int tick, int command,
+                                             int key, int velocity);
+      void           flushNoteOffs          (int track, int tick);
+      void           storeTick              (int track, int tick);
+      static void    storeVLV               (vector<unsigned char>& data,
+                                             int value);
+      static int     getTimeSignature       (const char* token, int& top,
+                                             int& bottom, int& bottom2);
+      static bool    noteOffCompare         (const _HumdrumToMidiNoteOff& a,
+                                             const _HumdrumToMidiNoteOff& b);
+};
+
+
+#endif  /* _HUMDRUMTOMIDI_H_INCLUDED */
+
+
+
@@ -0,0 +1,68 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:12:08 PDT 2026
+// Last Modified: Sat Oct 17 19:12:08 PDT 2026
+// Filename:      ...sig/include/sigInfo/KeyFinder.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/KeyFinder.h
+// Syntax:        C++
+//
+// Description:   Krumhansl-Schmuckler style key finding with a pair of
+//                major/minor key profiles.  The profiles are mean-centered
+//                once when they are set, so correlating a pitch-class
+//                histogram with all 24 keys only requires centering the
+//                histogram.  For sliding-window analyses, the notes of a
+//                file can be loaded into equal-duration segments which are
+//                stored as running sums, so that the histogram for any
+//                window of segments is calculated with 12 subtractions
+//                regardless of the window size.
+//
+
+#ifndef _KEYFINDER_H_INCLUDED
+#define _KEYFINDER_H_INCLUDED
+
+#include "HumdrumNoteTable.h"
+
+#include <vector>
+
+using namespace std;
+
+
+class KeyFinder {
+   public:
+                     KeyFinder          (void);
+                     KeyFinder          (const double* majorKey,
+                                         const double* minorKey);
+                    ~KeyFinder          ();
+
+      void           setProfiles        (const double* majorKey,
+                                         const double* minorKey);
+      int            correlate          (double* scores,
+                                         const double* histogram) const;
+
+      // sliding-window histograms:
+      void           loadSegments       (const HumdrumNoteTable& notes,
+                                         double totalduration, int segments);
+      void           clearSegments      (void);
+      int            getSegmentCount    (void) const { return segmentcount; }
+      void           getHistogram       (double* histogram, int start,
+                                         int count) const;
+
+   protected:
+      double         major[12];      // mean-centered major key profile
+      double         minor[12];      // mean-centered minor key profile
+      double         majorsquares;   // sum of squares of centered major
+      double         minorsquares;   // sum of squares of centered minor
+
+      int            segmentcount;   // number of segments loaded
+      vector<double> runningsum;     // (segmentcount+1)*12 running sums
+
+      static void    addToSegments      (vector<double>& segments, int pc,
+                                         double start, double dur,
+                                         double tdur, int count);
+};
+
+
+#endif  /* _KEYFINDER_H_INCLUDED */
+
+
+
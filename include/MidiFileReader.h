@@ -0,0 +1,123 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 22:24:23 PDT 2026
+// Last Modified: Sat Oct 17 22:24:23 PDT 2026
+// Filename:      ...sig/include/sigInfo/MidiFileReader.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/MidiFileReader.h
+// Syntax:        C++
+//
+// Description:   Read-only access to the events of a Standard MIDI File
+//                without copying them.  The file is memory-mapped and
+//                only the track chunks are located when it is opened.
+//                Events are decoded one at a time while iterating, either
+//                through a single track or through all tracks merged in
+//                time order.  Events at the same tick in the merged order
+//                are sorted by track, and then by their order in the
+//                track, which is the order given by smf::MidiFile after
+//                joinTracks().
+//
+//                The bytes of an event are indexed in the same way as an
+//                smf::MidiEvent: [0] is the command byte (also when running
+//                status was used in the file), and meta messages contain
+//                their type and length bytes, while system exclusive
+//                messages do not contain their length.
+//
+
+#ifndef _MIDIFILEREADER_H_INCLUDED
+#define _MIDIFILEREADER_H_INCLUDED
+
+#include <istream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+class MidiFileEvent {
+   public:
+      int                   tick;     // absolute tick time
+      int                   track;    // track index
+      unsigned char         command;  // command byte of the message
+      const unsigned char*  data;     // bytes after the command byte
+      int                   size;     // number of bytes in data
+
+      int   operator[]   (int index) const {
+                            if (index == 0) { return command; }
+                            if ((index < 0) || (index > size)) { return 0; }
+                            return data[index-1]; }
+      int   getSize      (void) const { return size + 1; }
+      int   isNoteOn     (void) const { return ((command & 0xf0) == 0x90)
+                                          && (size > 1) && (data[1] != 0); }
+      int   isNoteOff    (void) const { return ((command & 0xf0) == 0x80)
+                                          || (((command & 0xf0) == 0x90)
+                                          && (size > 1) && (data[1] == 0)); }
+      int   isMeta       (void) const { return command == 0xff; }
+};
+
+
+class _MidiFileTrackCursor {
+   public:
+      const unsigned char*  ptr;      // next byte to decode
+      const unsigned char*  end;      // end of the track data
+      int                   tick;     // absolute tick of the last event
+      int                   track;    // track index
+      unsigned char         running;  // running status command
+
+      int   next         (MidiFileEvent& event);
+};
+
+
+class MidiFileReader {
+   public:
+                        MidiFileReader     (void);
+                        MidiFileReader     (const char* filename);
+                        MidiFileReader     (const string& filename);
+                       ~MidiFileReader     ();
+
+      int               open               (const char* filename);
+      int               open               (const string& filename);
+      int               read               (istream& input);
+      void              close              (void);
+      int               isValid            (void) const { return validQ; }
+
+      int               getFormat          (void) const { return format; }
+      int               getTrackCount      (void) const
+                                              { return (int)trackstart.size(); }
+      int               getTicksPerQuarterNote(void) const { return tpq; }
+
+      // iterating through the events of one track (or of all tracks in
+      // time order if track is -1):
+      void              rewind             (int track = -1);
+      int               next               (MidiFileEvent& event);
+
+   protected:
+      const unsigned char*          mapping;    // contents of the file
+      long                          mappingsize;
+      int                           mappedQ;    // true if mapping is an mmap
+      int                           validQ;     // true if header was read
+      int                           format;     // 0 or 1 (or 2)
+      int                           tpq;        // ticks per quarter note
+      vector<const unsigned char*>  trackstart; // start of each track's data
+      vector<const unsigned char*>  trackend;   // end of each track's data
+
+      // iteration state:
+      vector<_MidiFileTrackCursor>  cursors;    // one for each track read
+      vector<MidiFileEvent>         pending;    // next event of each cursor
+      vector<int>                   heap;       // cursors ordered by time
+      int                           mergeQ;     // true if merging tracks
+
+      int               indexTracks        (void);
+      bool              heapCompare        (int a, int b) const;
+
+   private:
+      // readers hold a raw mapping, so they are not copyable
+                        MidiFileReader     (const MidiFileReader& aReader);
+      MidiFileReader&   operator=          (const MidiFileReader& aReader);
+      void              releaseMapping     (void);
+};
+
+
+#endif  /* _MIDIFILEREADER_H_INCLUDED */
+
+
+
@@ -0,0 +1,102 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 20:14:50 PDT 2026
+// Last Modified: Sat Oct 17 20:24:34 PDT 2026 added JIT compiling
+// Filename:      ...sig/include/sigInfo/MultiPatternMatcher.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/MultiPatternMatcher.h
+// Syntax:        C++
+//
+// Description:   Search a string for several regular expressions at once.
+//                The literal text which must occur in any match of each
+//                pattern is stored in one Aho-Corasick automaton, so that
+//                a single pass over the string finds which patterns can
+//                match.  Only those patterns are then checked with the
+//                regular expression library.  Patterns which are plain
+//                text (optionally anchored with ^ and $) are matched
+//                without a regular expression.  Patterns can use Perl
+//                (PCRE) or POSIX extended or basic syntax.
+//
+
+#ifndef _MULTIPATTERNMATCHER_H_INCLUDED
+#define _MULTIPATTERNMATCHER_H_INCLUDED
+
+#include "pcre.h"
+
+#include <regex.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+#define MPM_SYNTAX_PCRE      0
+#define MPM_SYNTAX_EXTENDED  1
+#define MPM_SYNTAX_BASIC     2
+
+
+class MultiPatternMatcher {
+   public:
+                     MultiPatternMatcher  (void);
+                    ~MultiPatternMatcher  ();
+
+      void           clear                (void);
+      void           setSyntax            (int syntax);
+      void           setIgnoreCase        (int state = 1);
+      void           setJit               (int state = 1);
+      int            addPattern           (const string& pattern);
+      int            getPatternCount      (void) const;
+      const string&  getPattern           (int index) const;
+      const string&  getError             (void) const { return error; }
+
+      int            search               (const char* text);
+      int            search               (const string& text);
+      int            isMatch              (int index) const;
+
+      static void    getRegexLiterals     (vector<string>& literals,
+                                           const string& regex,
+                                           int syntax = MPM_SYNTAX_PCRE);
+
+   protected:
+      int            syntax;         // regular expression syntax
+      int            icaseQ;         // boolean for ignoring case
+      int            jitQ;           // boolean for JIT compiling PCRE
+      string         error;          // message for last failed addPattern
+
+      // patterns:
+      vector<string>         patterns;   // the regular expressions
+      vector<int>            kinds;      // regex or (anchored) plain text
+      vector<string>         texts;      // plain text of text patterns
+      vector<vector<int> >   required;   // literals required by patterns
+      vector<pcre*>          pcres;      // compiled PCRE patterns
+      vector<pcre_extra*>    studies;    // studied PCRE patterns
+      vector<regex_t*>       posixes;    // compiled POSIX patterns
+      vector<char>           matches;    // results of last search
+
+      // Aho-Corasick automaton of the required literals:
+      int                    builtQ;     // boolean for automaton is current
+      vector<string>         literals;   // unique literals (case folded)
+      vector<int>            transitions;// 256 next states for each state
+      vector<vector<int> >   outputs;    // literals ending at each state
+      vector<unsigned int>   found;      // search stamp of found literals
+      unsigned int           stamp;      // current search stamp
+
+      void           build                (void);
+      int            addLiteral           (const string& literal);
+      int            compilePattern       (const string& pattern);
+      int            checkText            (int index, const char* text,
+                                           int length) const;
+      int            checkRegex           (int index, const char* text,
+                                           int length) const;
+      static void    foldCase             (string& text);
+      static int     isPlainText          (const string& text, int syntax);
+      static int     skipRegexQuantifier  (const string& regex, int index);
+      static int     skipRegexClass       (const string& regex, int index,
+                                           int syntax);
+      static int     findRegexGroupEnd    (const string& regex, int index,
+                                           int syntax);
+};
+
+
+#endif  /* _MULTIPATTERNMATCHER_H_INCLUDED */
+
+
+
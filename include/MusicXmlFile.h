@@ -3,11 +3,19 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed Mar 10 07:49:40 PST 2004
 // Last Modified: Sun Apr  4 23:17:36 PDT 2004
+// Last Modified: Sat Oct 17 23:26:16 PDT 2026 read input with expat (SAX)
+// Last Modified: Sat Oct 17 23:26:16 PDT 2026 read() returns 0 on errors
 // Filename:      ...sig/include/sigInfo/MusicXmlFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MusicXmlFile.h
 // Syntax:        C++ 
 //
-// Description:   A class which parses a MusicXML File.
+// Description:   A class which parses a MusicXML File.  The file is read
+//                with the expat SAX parser, and each <measure> is converted
+//                into part data as soon as its closing tag has been read.
+//                Only the part list and the measure elements are kept
+//                in memory, since the part data refers to them when
+//                generating Humdrum data (so memory use is not limited
+//                to one measure).
 //
 
 #ifndef _MUSICXMLFILE_H_INCLUDED
@@ -18,6 +26,7 @@
 #include "XMLDocumentBuilder.h"
 #include "XMLUtils.h"
 #include "XMLException.h"
+#include "xmlparse.h"
 
 #include "Array.h"
 #include "HumdrumFile.h"
@@ -185,7 +194,7 @@ class MusicXmlFile {
       int        getPartNumberFromId      (const char* buffer);
       ostream&   print                    (ostream& out = cout);
       ostream&   info                     (ostream& out = cout);
-      void       read                     (const char* aFile);
+      int        read                     (const char* aFile);
       static int staffcompare             (const void* A, const void* B);
       static int getMeasureNumber         (CSL::XML::CXMLObject* object);
       static int isGraceNote              (CSL::XML::CXMLObject* object);
@@ -230,12 +239,25 @@ class MusicXmlFile {
       char*       getCharacterData        (char* buffer, 
                                            CSL::XML::CXMLObject* object);
 
+      // expat input functions
+      static void startElementHandler     (void* userdata, 
+                                           const XML_Char* name,
+                                           const XML_Char** atts);
+      static void endElementHandler       (void* userdata, 
+                                           const XML_Char* name);
+      static void characterDataHandler    (void* userdata, 
+                                           const XML_Char* text, int length);
+      static void startCdataHandler       (void* userdata);
+      static void endCdataHandler         (void* userdata);
+      void      startElement              (const char* name, 
+                                           const char** atts);
+      void      endElement                (const char* name);
+      void      storeCharacterData        (int elementQ);
+
       // parsing functions
-      void      parse                     (void);
-      void      traverse                  (CSL::XML::CXMLObject* entry);
-      void      process                   (CSL::XML::CXMLObject* entry);
-      int       parseElement              (CSL::XML::CXMLObject* entry);
-      void      parsePart                 (CSL::XML::CXMLObject* entry, 
+      void      parseScorePart            (CSL::XML::CXMLObject* entry);
+      int       parsePart                 (CSL::XML::CXMLObject* entry);
+      void      parsePartMeasure          (CSL::XML::CXMLObject* entry, 
                                            int partnum);
       void      parseBackup               (CSL::XML::CXMLObject* object, 
                                            int partnum, long& ticktime);
@@ -328,6 +350,18 @@ class MusicXmlFile {
                               // voice in spine.
       int partvoiceticktime1; // used for adding interpreted rests in spine 1.
       CSL::XML::CXMLObject* lastchordhead;
+
+      // expat parsing state:
+      CSL::XML::CXMLFactory    xmlfactory;
+      CSL::XML::CXMLContainer* parsecontainer; // currently open element
+      CSL::XML::XMLString      parsetext;      // pending character data
+      int  parsecdataQ;       // true if inside of a CDATA section
+      int  parseretain;       // open <part-list>/<score-part>/<measure> count
+      int  parsepartcount;    // number of <part> elements read so far
+      int  parsepartnum;      // part number of the current <part>
+      int  parsepartstartQ;   // true if current <part> has been started
+      long parseticktime;     // starting tick time of the next measure
+      Array<char> filename;   // used to print the original file
       Array<int> partdynamics;  // used to identify if a part contains dynamics
       int humline;              // used to print lyrics
 
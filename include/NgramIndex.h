@@ -0,0 +1,138 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 18:26:56 PDT 2026
+// Last Modified: Sat Oct 17 18:26:56 PDT 2026
+// Filename:      ...sig/include/sigInfo/NgramIndex.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/NgramIndex.h
+// Syntax:        C++
+//
+// Description:   Binary inverted index of the character n-grams found
+//                in the feature fields of a themefinder index file
+//                (created by tindex and searched by themax).  Each
+//                feature in a tab-separated field starts with a marker
+//                character, and the text following the marker is split
+//                into trigrams which are stored with the line number
+//                and character offset where they occur.  Searching
+//                returns the lines which contain a literal string after
+//                a given marker, which is a superset of the lines that
+//                a regular expression requiring that literal can match.
+//
+//                The index is stored in a separate file (usually the
+//                name of the text index with ".tix" appended), which
+//                also records the size of the text index so that a
+//                stale index will not be used.
+//
+
+#ifndef _NGRAMINDEX_H_INCLUDED
+#define _NGRAMINDEX_H_INCLUDED
+
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+class NgramIndex {
+   public:
+                        NgramIndex         (void);
+                        NgramIndex         (const string& markers);
+                       ~NgramIndex         ();
+
+      // building an index:
+      void              setMarkers         (const string& markers);
+      void              addText            (const char* text, long length);
+      void              addLine            (const char* line, long length);
+      int               write              (const string& filename);
+
+      // searching an index:
+      int               read               (const string& filename,
+                                            long textsize = -1);
+      int               isValid            (void) const;
+      int               hasMarker          (char marker) const;
+      long              getTextSize        (void) const;
+      int               getLineCount       (void) const;
+      long              getLineOffset      (int line) const;
+      void              getControlLines    (vector<int>& lines) const;
+      int               searchLiteral      (vector<int>& lines, char marker,
+                                            const string& literal) const;
+      static void       intersect          (vector<int>& lines,
+                                            const vector<int>& other);
+      void              clear              (void);
+
+      static const int  NGRAM = 3;
+
+   protected:
+      // data for building an index:
+      string            markers;           // feature marker characters
+      string            partial;           // unterminated line in addText()
+      long              textsize;          // bytes of text added/indexed
+      vector<long>      lineoffsets;       // starting byte of each line
+      vector<int>       controllines;      // lines starting with '#'
+      struct Posting {
+         unsigned key;                     // marker and n-gram characters
+         unsigned line;                    // line number in text index
+         unsigned offset;                  // character offset after marker
+      };
+      vector<Posting>   postings;          // postings added so far
+
+      // data for searching a stored index:
+      char*             mapping;           // contents of the index file
+      long              mappingsize;       // size of the index file
+      int               mappedQ;           // true if mapping is an mmap
+      int               validQ;            // true if an index was read
+      const long long*  rlineoffsets;
+      const long long*  rkeystarts;
+      const unsigned*   rkeys;
+      const int*        rcontrollines;
+      const unsigned*   rpostlines;
+      const unsigned*   rpostoffsets;
+      long              rlinecount;
+      long              rkeycount;
+      long              rcontrolcount;
+
+      static bool       comparePostings    (const Posting& a,
+                                            const Posting& b);
+      static unsigned   makeKey            (char marker, const char* ngram);
+      int               findKey            (unsigned key, long& start,
+                                            long& end) const;
+      int               hasPosting         (long start, long end,
+                                            unsigned line,
+                                            unsigned offset) const;
+
+   private:
+      // indexes hold a raw mapping, so they are not copyable
+                        NgramIndex         (const NgramIndex& anIndex);
+      NgramIndex&       operator=          (const NgramIndex& anIndex);
+      void              releaseMapping     (void);
+};
+
+
+
+//////////////////////////////
+//
+// NgramIndexBuffer -- stream buffer which passes text through to
+//    another stream buffer while adding it to an NgramIndex, so that
+//    a program can build the index from its own standard output.
+//
+
+class NgramIndexBuffer : public streambuf {
+   public:
+                        NgramIndexBuffer   (streambuf* aTarget,
+                                            NgramIndex& anIndex);
+                       ~NgramIndexBuffer   ();
+
+   protected:
+      virtual int       overflow           (int ch);
+      virtual streamsize xsputn            (const char* text, streamsize count);
+      virtual int       sync               (void);
+
+      streambuf*        target;
+      NgramIndex&       index;
+};
+
+
+#endif  /* _NGRAMINDEX_H_INCLUDED */
+
+
+
@@ -2,6 +2,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun 29 14:25:53 PDT 2009
 // Last Modified: Mon Jun 29 14:26:01 PDT 2009
+// Last Modified: Sat Oct 17 17:55:33 PDT 2026 Added compiled pattern cache
+// Last Modified: Sat Oct 17 20:24:34 PDT 2026 Added JIT compilation
 // Filename:      ...sig/src/sig/PerlRegularExpression.h
 // Web Address:   http://sig.sapp.org/src/sig/PerlRegularExpression.h
 // Syntax:        C++; Perl Compatible Regular Expressions (http://www.pcre.org)
@@ -117,6 +119,20 @@ class PerlRegularExpression {
       void setSearchString          (const char* searchstring);
       void setReplaceString         (const char* replacestring);
 
+      // statistics for the process-wide cache of compiled patterns:
+      static long getCacheHits      (void);
+      static long getCacheMisses    (void);
+      static int  getCacheSize      (void);
+
+      // JIT compilation of studied patterns:
+      void setJit                   (int state = 1);
+      int  getJit                   (void) const { return jitQ; }
+      static int  isJitAvailable    (void);
+      static void setJitDefault     (int state);
+      static int  getJitDefault     (void);
+      static pcre_extra* studyPattern(pcre* code, int jit, 
+                                     const char** error);
+
    protected:
       char  ignorecaseQ;
       char  extendedQ;
@@ -124,6 +140,8 @@ class PerlRegularExpression {
       char  anchorQ;                // true if anchored search
       int   valid;
       int   studyQ;
+      int   cachedQ;                // true if pre/pe are owned by the cache
+      int   jitQ;                   // true if studied with JIT compiling
 
       pcre* pre;                    // Perl-Compatible RegEx compile structure
       pcre_extra* pe;               // Extra data structure for analyzing 
@@ -139,6 +157,8 @@ class PerlRegularExpression {
       Array<char> replace_string;
 
    private:
+      void releasePattern           (void);
+      int  getCachedPattern         (int compflags);
       void expandList               (Array<char>& expandlist, 
                                      const string& input); 
       void expandList               (vector<char>& expandlist, 
@@ -3,6 +3,7 @@
 // Creation Date: Wed May 19 21:10:47 PDT 2010
 // Last Modified: Thu Jan 27 03:49:20 PST 2011 added invert()
 // Last Modified: Thu Mar 21 12:55:38 PDT 2013 added isInteger()
+// Last Modified: Sat Oct 17 22:53:35 PDT 2026 added isValid()/setInvalid()
 // Filename:      ...sig/maint/code/base/RationalNumber/RationalNumber.h
 // Web Address:   http://sig.sapp.org/src/sigBase/RationalNumber.h
 // Syntax:        C++ 
@@ -71,6 +72,8 @@ class RationalNumber {
       int             isPositive    (void) const;
       int             isZero        (void) const;
       int             isInteger     (void) const;
+      int             isValid       (void) const { return _den != 0; }
+      void            setInvalid    (void) { _num = 0; _den = 0; }
 
       RationalNumber  _abs       (const RationalNumber &r);
       RationalNumber  _min       (const RationalNumber &p, 
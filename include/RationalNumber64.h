@@ -0,0 +1,105 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 18:56:50 PDT 2026
+// Last Modified: Sat Oct 17 18:56:50 PDT 2026
+// Last Modified: Sat Oct 17 23:31:10 PDT 2026 public setInvalid()
+// Filename:      ...sig/include/sigInfo/RationalNumber64.h
+// Web Address:   http://sig.sapp.org/include/sigInfo/RationalNumber64.h
+// Syntax:        C++
+//
+// Description:   Rational number class with 64-bit numerator and
+//                denominator, used for accumulating beat positions in
+//                files where the tuplets would overflow the int terms
+//                of RationalNumber.  Values are always kept in lowest
+//                terms with a positive denominator.  Sums and products
+//                of numbers with power-of-two denominators (the most
+//                common case in music) are reduced with bit shifts
+//                rather than a gcd.  If a result cannot be represented,
+//                the number becomes invalid (isValid() returns false,
+//                and any further calculations with it are also invalid)
+//                rather than silently wrapping around.
+//
+
+#ifndef _RATIONALNUMBER64_H_INCLUDED
+#define _RATIONALNUMBER64_H_INCLUDED
+
+#include "RationalNumber.h"
+
+#include <iostream>
+
+using std::ostream;
+
+
+class RationalNumber64 {
+   public:
+      constexpr           RationalNumber64  (void) : num(0), den(1) { }
+      constexpr           RationalNumber64  (long long aNumerator) :
+                                               num(aNumerator), den(1) { }
+                          RationalNumber64  (long long aNumerator,
+                                             long long aDenominator);
+                          RationalNumber64  (const RationalNumber& aNumber);
+
+      RationalNumber64    operator+         (const RationalNumber64& r) const;
+      RationalNumber64    operator-         (const RationalNumber64& r) const;
+      RationalNumber64    operator*         (const RationalNumber64& r) const;
+      RationalNumber64    operator/         (const RationalNumber64& r) const;
+      RationalNumber64    operator-         (void) const;
+      RationalNumber64&   operator+=        (const RationalNumber64& r);
+      RationalNumber64&   operator-=        (const RationalNumber64& r);
+      RationalNumber64&   operator*=        (const RationalNumber64& r);
+      RationalNumber64&   operator/=        (const RationalNumber64& r);
+
+      int                 operator==        (const RationalNumber64& r) const;
+      int                 operator!=        (const RationalNumber64& r) const;
+      int                 operator<         (const RationalNumber64& r) const;
+      int                 operator>         (const RationalNumber64& r) const;
+      int                 operator<=        (const RationalNumber64& r) const;
+      int                 operator>=        (const RationalNumber64& r) const;
+
+      constexpr long long getNumerator      (void) const { return num; }
+      constexpr long long getDenominator    (void) const { return den; }
+      constexpr int       isValid           (void) const { return den != 0; }
+      constexpr int       isZero            (void) const {
+                                               return (num == 0) &&
+                                                      (den != 0); }
+      constexpr int       isInteger         (void) const { return den == 1; }
+      constexpr int       isNegative        (void) const {
+                                               return (num < 0) &&
+                                                      (den != 0); }
+      constexpr int       isPositive        (void) const {
+                                               return (num > 0) &&
+                                                      (den != 0); }
+      double              getFloat          (void) const;
+      int                 isRationalNumber  (void) const;
+      RationalNumber      getRationalNumber (void) const;
+      void                setValue          (long long aNumerator,
+                                             long long aDenominator);
+      void                zero              (void) { num = 0; den = 1; }
+      void                setInvalid        (void) { num = 0; den = 0; }
+
+      static constexpr int isPowerOfTwo     (long long value) {
+                                               return (value > 0) &&
+                                                 ((value & (value-1)) == 0); }
+      static long long    gcd               (long long x, long long y);
+      static int          addOverflow       (long long a, long long b,
+                                             long long& result);
+      static int          multiplyOverflow  (long long a, long long b,
+                                             long long& result);
+
+   protected:
+      long long num;      // numerator
+      long long den;      // denominator, 0 if the number is invalid
+
+      static void         simplify          (RationalNumber64& r);
+      static int          compare           (const RationalNumber64& a,
+                                             const RationalNumber64& b);
+};
+
+
+ostream& operator<<(ostream& out, const RationalNumber64& aNumber);
+
+
+#endif  /* _RATIONALNUMBER64_H_INCLUDED */
+
+
+
@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Dec 24 18:20:23 PST 2002
 // Last Modified: Mon Feb 10 17:08:20 PST 2003 (added voice-leading)
+// Last Modified: Sat Oct 17 23:27:44 PDT 2026 (table-driven scoring)
+// Last Modified: Sun Oct 18 00:24:20 PDT 2026 (restored calculateBatch)
 // Filename:      ...sig/include/sigInfo/RootSpectrum.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/RootSpectrum.h
 // Syntax:        C++ 
@@ -95,6 +97,12 @@ class RootSpectrum {
       int         calculate        (IntervalWeight& distances, 
                                     HumdrumFile& infile, int startline, 
                                     int stopline, int debugQ = 0);
+      void        calculateBatch   (Array<double>& scores, Array<int>& roots,
+                                    IntervalWeight& distances,
+                                    Array<int>& pitches,
+                                    Array<double>& durations,
+                                    Array<double>& levels,
+                                    Array<int>& offsets);
    private:
       Array <double> values;        // scores for each root.
       double         power;         // for scaling inverse scores
@@ -113,6 +121,12 @@ class RootSpectrum {
       static int     minfloat       (const void* a, const void* b);
       double         durationscaling(double duration);
       double         metricscaling  (double level);
+      static void    fillWeightTable(Array<double>& table, 
+                                    IntervalWeight& distances);
+      static void    scoreNotes     (double* scores, const double* table,
+                                    const int* pitches, 
+                                    const double* durscales,
+                                    const double* metscales, int count);
       double         getMelodicScaling(int root, int note, 
                                     Array<int>& lastpitches, 
                                     Array<int>& nextpitches, 
@@ -6,6 +6,7 @@
 // Last Modified: Wed Mar 30 14:00:16 PST 2005 Fixed for compiling in GCC 3.4
 // Last Modified: Fri Jun 12 22:58:34 PDT 2009 renamed SigCollection class
 // Last Modified: Fri Aug 10 09:17:03 PDT 2012 added reverse()
+// Last Modified: Sat Oct 17 18:33:52 PDT 2026 geometric growth, move, reserve
 // Filename:      ...sig/maint/code/base/SigCollection/SigCollection.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/SigCollection.cpp
 // Syntax:        C++ 
@@ -22,10 +23,30 @@
 #include "SigCollection.h"
 #include <iostream>
 #include <stdlib.h>
+#include <utility>
+#include <type_traits>
 
 
 using namespace std;
 
+//////////////////////////////
+//
+// sigMoveElement -- move an element into new storage, or copy it if the
+//     element type cannot be assigned from a temporary.
+//
+
+template<class type>
+inline void sigMoveElement(type& destination, type& source, std::true_type) {
+   destination = std::move(source);
+}
+
+template<class type>
+inline void sigMoveElement(type& destination, type& source, std::false_type) {
+   destination = source;
+}
+
+
+
 //////////////////////////////
 //
 // SigCollection::SigCollection --
@@ -81,6 +102,21 @@ SigCollection<type>::SigCollection(SigCollection<type>& aSigCollection) {
 }
 
 
+template<class type>
+SigCollection<type>::SigCollection(SigCollection<type>&& aSigCollection) {
+   this->size = aSigCollection.size;
+   this->allocSize = aSigCollection.allocSize;
+   this->array = aSigCollection.array;
+   this->allowGrowthQ = aSigCollection.allowGrowthQ;
+   this->growthAmount = aSigCollection.growthAmount;
+   this->maxSize = aSigCollection.maxSize;
+
+   aSigCollection.size = 0;
+   aSigCollection.allocSize = 0;
+   aSigCollection.array = NULL;
+}
+
+
 
 //////////////////////////////
 //
@@ -96,6 +132,44 @@ SigCollection<type>::~SigCollection() {
 
 
 
+//////////////////////////////
+//
+// SigCollection::operator= -- copy the contents of another collection,
+//     or take over the storage of a temporary collection.
+//
+
+template<class type>
+SigCollection<type>& SigCollection<type>::operator=(
+      const SigCollection<type>& aSigCollection) {
+   if (this == &aSigCollection) {
+      return *this;
+   }
+   if (this->allocSize < aSigCollection.size) {
+      this->size = 0;
+      this->reallocate(aSigCollection.size);
+   }
+   this->size = aSigCollection.size;
+   for (int i=0; i<this->size; i++) {
+      this->array[i] = aSigCollection.array[i];
+   }
+   this->allowGrowthQ = aSigCollection.allowGrowthQ;
+   this->growthAmount = aSigCollection.growthAmount;
+   this->maxSize = aSigCollection.maxSize;
+   return *this;
+}
+
+
+template<class type>
+SigCollection<type>& SigCollection<type>::operator=(
+      SigCollection<type>&& aSigCollection) {
+   if (this != &aSigCollection) {
+      this->swap(aSigCollection);
+   }
+   return *this;
+}
+
+
+
 //////////////////////////////
 //
 // SigCollection::allowGrowth --
@@ -149,24 +223,64 @@ void SigCollection<type>::append(type *element) {
 
 //////////////////////////////
 //
-// SigCollection::grow --
+// SigCollection::grow -- increase the allocated size by at least growamt
+//     (or the growth amount if growamt is not positive).  The allocation
+//     is at least doubled so that a sequence of appends takes amortized
+//     constant time per element.
 // 	default parameter: growamt = -1
 //
 
 template<class type>
 void SigCollection<type>::grow(long growamt) {
-   this->allocSize += growamt > 0 ? growamt : this->growthAmount;
-   if (this->maxSize != 0 && this->getAllocSize() > this->maxSize) {
+   long needed = this->allocSize + (growamt > 0 ? growamt : this->growthAmount);
+   if (needed <= this->allocSize) {
+      needed = this->allocSize + 1;
+   }
+   if (this->maxSize != 0 && needed > this->maxSize) {
       std::cerr << "Error: Maximum size allowed for array exceeded." << std::endl;
       exit(1);
    }
- 
-   type *temp = new type[this->getAllocSize()];
-   for (int i=0; i<size; i++) {
-      temp[i] = this->array[i];
+
+   long newsize = 2 * this->allocSize;
+   if (newsize < needed) {
+      newsize = needed;
    }
-   delete [] this->array;
-   this->array = temp;
+   if (this->maxSize != 0 && newsize > this->maxSize) {
+      newsize = this->maxSize;
+   }
+   this->reallocate(newsize);
+}
+
+
+
+//////////////////////////////
+//
+// SigCollection::reserve -- make sure that space is allocated for at
+//     least aSize elements without changing the size of the collection.
+//
+
+template<class type>
+void SigCollection<type>::reserve(long aSize) {
+   if (aSize > this->getAllocSize()) {
+      this->reallocate(aSize);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// SigCollection::swap -- exchange the contents of two collections.
+//
+
+template<class type>
+void SigCollection<type>::swap(SigCollection<type>& aSigCollection) {
+   std::swap(this->size, aSigCollection.size);
+   std::swap(this->allocSize, aSigCollection.allocSize);
+   std::swap(this->array, aSigCollection.array);
+   std::swap(this->allowGrowthQ, aSigCollection.allowGrowthQ);
+   std::swap(this->growthAmount, aSigCollection.growthAmount);
+   std::swap(this->maxSize, aSigCollection.maxSize);
 }
 
 
@@ -248,7 +362,7 @@ void SigCollection<type>::setAllocSize(long aSize) {
    if (aSize <= this->getAllocSize()) {
       this->shrinkTo(aSize);
    } else {
-      this->grow(aSize-this->getAllocSize());
+      this->reallocate(aSize);
       this->size = aSize;
    }
 }
@@ -343,17 +457,35 @@ void SigCollection<type>::shrinkTo(long aSize) {
       exit(1);
    }
 
-   type *temp = new type[aSize];
-   for (int i=0; i<this->size; i++) {
-      temp[i] = this->array[i];
-   }
-   delete [] this->array;
-   this->array = temp;
+   this->reallocate(aSize);
+}
+
 
-   allocSize = aSize;
-   if (size > allocSize) {
-      size = allocSize;
+
+//////////////////////////////
+//
+// SigCollection::reallocate -- move the elements into new storage
+//     which has space for exactly aSize elements.
+//
+
+template<class type>
+void SigCollection<type>::reallocate(long aSize) {
+   if (this->size > aSize) {
+      this->size = aSize;
    }
+   type *temp = NULL;
+   if (aSize > 0) {
+      temp = new type[aSize];
+      for (long i=0; i<this->size; i++) {
+         sigMoveElement(temp[i], this->array[i],
+               typename std::is_assignable<type&, type&&>::type());
+      }
+   }
+   if (this->array != NULL) {
+      delete [] this->array;
+   }
+   this->array = temp;
+   this->allocSize = aSize;
 }
 
 
@@ -6,6 +6,7 @@
 // Last Modified: Wed Sep  8 17:18:15 PDT 2010 added getGrowth()
 // Last Modified: Fri Aug 10 09:17:03 PDT 2012 added reverse()
 // Last Modified: Wed Dec 12 14:56:58 PST 2012 added decrease()
+// Last Modified: Sat Oct 17 18:33:52 PDT 2026 geometric growth, move, reserve
 // Filename:      ...sig/maint/code/base/SigCollection/SigCollection.h
 // Web Address:   http://sig.sapp.org/include/sigBase/SigCollection.h
 // Documentation: http://sig.sapp.org/doc/classes/SigCollection
@@ -30,8 +31,12 @@ class SigCollection {
                 SigCollection     (int arraySize);
                 SigCollection     (int arraySize, type *aCollection);
                 SigCollection     (SigCollection<type>& aCollection);
+                SigCollection     (SigCollection<type>&& aCollection);
                ~SigCollection     ();
 
+      SigCollection<type>& operator= (const SigCollection<type>& aCollection);
+      SigCollection<type>& operator= (SigCollection<type>&& aCollection);
+
       void      allowGrowth       (int status = 1);
       void      append            (type& element);
       void      appendcopy        (type element);
@@ -47,6 +52,8 @@ class SigCollection {
       type&     operator[]        (int arrayIndex);
       type      operator[]        (int arrayIndex) const;
       void      grow              (long growamt = -1);
+      void      reserve           (long aSize);
+      void      swap              (SigCollection<type>& aCollection);
       type&     last              (int index = 0);
       int       increase          (int addcount = 1);
       int       decrease          (int subcount = 1);
@@ -58,12 +65,13 @@ class SigCollection {
       long      allocSize;        // maximum allowable array size
       type     *array;            // where the array data is stored
       char      allowGrowthQ;     // allow/disallow growth
-      long      growthAmount;     // number of elements to grow by if index
+      long      growthAmount;     // minimum number of elements to grow by if
 				  //    element one beyond max size is accessed
       long maxSize;               // the largest size the array is allowed 
                                   //    to grow to, if 0, then ignore max
   
       void      shrinkTo          (long aSize);
+      void      reallocate        (long aSize);
 };
 
 
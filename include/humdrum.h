@@ -22,8 +22,10 @@
 // basic classes:
    #include "HumdrumRecord.h"
    #include "HumdrumStream.h"
+   #include "HumdrumCache.h"
    #include "HumdrumFile.h"
    #include "HumdrumFileSet.h"
+   #include "HumdrumLineReader.h"
    #include "humdrumfileextras.h"
    #include "HumdrumFileBasic.h"
    #include "EnumerationData.h"
@@ -32,10 +34,16 @@
    #include "ChordQuality.h"
    #include "Identify.h"
    #include "HumdrumInstrument.h"
+   #include "HumdrumPlayer.h"
+   #include "HumdrumToMidi.h"
    #include "IntervalWeight.h"
+   #include "KeyFinder.h"
    #include "RootSpectrum.h"
    #include "Maxwell.h"
+   #include "MidiFileReader.h"
+   #include "EditDistance.h"
    #include "RationalNumber.h"
+   #include "RationalNumber64.h"
 
 // support classes borrowed from sig++
    #include "SigCollection.h"
@@ -45,6 +53,7 @@
    #include "PixelColor.h"
    #include "EnvelopeString.h"
    #include "PerlRegularExpression.h"
+   #include "MultiPatternMatcher.h"
 
 // have to include for some template bug:
 //   #include "Options.cpph"
@@ -20,6 +20,8 @@
 // Last Modified: Sat Jan 22 17:13:36 PST 2011 (added kernToDurationNoDots)
 // Last Modified: Thu Jan 26 18:10:29 PST 2012 (fixed kotoToDurationR)
 // Last Modified: Sun Apr 29 10:01:44 PDT 2018 (convert const char* to strings)
+// Last Modified: Sat Oct 17 18:04:49 PDT 2026 (added scanKernToken)
+// Last Modified: Sun Oct 18 00:30:12 PDT 2026 (long rhythm numbers)
 // Filename:      ...sig/src/sigInfo/Convert.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/Convert.cpp
 // Syntax:        C++
@@ -31,9 +33,9 @@
 
 #include "Convert.h"
 #include "HumdrumEnumerations.h"
-#include "PerlRegularExpression.h"
 
 #include <math.h>
+#include <limits.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -65,6 +67,204 @@ EnumerationInterval   Convert::intervalNames;
 // conversions dealing with **kern data
 //
 
+//////////////////////////////
+//
+// KernTokenInfo::clear -- set to the values for an empty token.
+//
+
+void KernTokenInfo::clear(void) {
+   duration   = 0;
+   undotted   = 0;
+   base40     = -1;
+   dots       = 0;
+   accidental = 0;
+   pitchclass = 'x';
+   restQ      = 0;
+   graceQ     = 0;
+   tiestartQ  = 0;
+   tiecontQ   = 0;
+   tieendQ    = 0;
+   beamstarts = 0;
+   beamends   = 0;
+}
+
+
+
+//////////////////////////////
+//
+// Convert::scanKernToken -- extract the rhythm, pitch, tie, grace and
+//    beam information from a **kern token in a single pass over the
+//    string.  All of the other kernTo* functions are based on this one.
+//
+//    Rhythms consisting of two numbers separated by a single character,
+//    such as "3%2", are non-standard rhythms with a duration of 2/3 of
+//    a whole note.  A rhythm made only of zeros is a breve (0), long (00),
+//    maxima (000), etc.  A rhythm number which is too large for an int
+//    is not a valid rhythm, and gives a duration of 0.
+//
+
+KernTokenInfo Convert::scanKernToken(const char* aKernString) {
+   KernTokenInfo info;
+   Convert::scanKernToken(info, aKernString);
+   return info;
+}
+
+
+void Convert::scanKernToken(KernTokenInfo& info, const char* aKernString) {
+   info.clear();
+   if ((aKernString == NULL) || (aKernString[0] == '\0')) {
+      return;
+   }
+   if ((aKernString[0] == '.') && (aKernString[1] == '\0')) {
+      // null token
+      info.dots = 1;
+      return;
+   }
+
+   const char* s = aKernString;
+   const char* pitch = NULL;  // location of the first pitch letter
+   int firstnote  = 1;        // false after the first space in a chord
+   int digitsQ    = 0;        // true if any rhythm digits found
+   int nonzeroQ   = 0;        // true if any digit other than 0 found
+   int zerorun    = 0;        // length of current sequence of zeros
+   int maxzeros   = 0;        // longest sequence of zeros
+   int rhythm     = -1;       // value of the first number in the token
+   int rtop       = -1;       // numerator of non-standard rhythm
+   int rbot       = -1;       // denominator of non-standard rhythm
+   int rbotnextQ  = 0;        // true if next number is the denominator
+   int overflowQ  = 0;        // true if a rhythm number is too large
+   int number = 0;
+   int i = 0;
+
+   while (s[i] != '\0') {
+      if (isdigit(s[i])) {
+         digitsQ = 1;
+         number = 0;
+         while (isdigit(s[i])) {
+            if (s[i] == '0') {
+               zerorun++;
+               if (zerorun > maxzeros) {
+                  maxzeros = zerorun;
+               }
+            } else {
+               nonzeroQ = 1;
+               zerorun = 0;
+            }
+            if (number > (INT_MAX - (s[i] - '0')) / 10) {
+               // saturate rather than overflow
+               number = INT_MAX;
+               overflowQ = 1;
+            } else {
+               number = number * 10 + (s[i] - '0');
+            }
+            i++;
+         }
+         zerorun = 0;
+         if (rhythm < 0) {
+            rhythm = number;
+         }
+         if (rbotnextQ) {
+            rbot = number;
+            rbotnextQ = 0;
+         } else if ((rtop < 0) && (s[i] != '\0') && isdigit(s[i+1])) {
+            rtop = number;
+            rbotnextQ = 1;
+         }
+         continue;
+      }
+
+      switch (s[i]) {
+         case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
+         case 'g': case 'r': case 'A': case 'B': case 'C': case 'D':
+         case 'E': case 'F': case 'G': case 'R':
+            if (pitch == NULL) {
+               pitch = s + i;
+            }
+            break;
+         case '.': if (firstnote) { info.dots++;          } break;
+         case '#': if (firstnote) { info.accidental++;    } break;
+         case '-': if (firstnote) { info.accidental--;    } break;
+         case 'n': if (firstnote) { info.accidental = 0;  } break;
+         case '[': if (firstnote) { info.tiestartQ = 1;   } break;
+         case '_': if (firstnote) { info.tiecontQ = 1;    } break;
+         case ']': if (firstnote) { info.tieendQ = 1;     } break;
+         case 'q': case 'Q': info.graceQ = 1;               break;
+         case 'L': info.beamstarts++;                       break;
+         case 'J': info.beamends++;                         break;
+         case ' ': firstnote = 0;                           break;
+      }
+      i++;
+   }
+
+   // pitch information
+   if (pitch == NULL) {
+      info.base40 = E_unknown;
+   } else if ((pitch[0] == 'r') || (pitch[0] == 'R')) {
+      info.base40 = E_base40_rest;
+      info.pitchclass = 'r';
+      info.restQ = 1;
+   } else {
+      info.pitchclass = tolower(pitch[0]);
+      int output = 0;
+      switch (info.pitchclass) {
+         case 'a': output = E_root_a; break;
+         case 'b': output = E_root_b; break;
+         case 'c': output = E_root_c; break;
+         case 'd': output = E_root_d; break;
+         case 'e': output = E_root_e; break;
+         case 'f': output = E_root_f; break;
+         case 'g': output = E_root_g; break;
+      }
+      int octave = 1;
+      while (pitch[octave] == pitch[0]) {
+         octave++;
+      }
+      if (islower(pitch[0])) {
+         output += (3 + octave) * 40;
+      } else {
+         output += (4 - octave) * 40;
+      }
+      // first and second accidental signs after the pitch letter
+      for (i=octave; (i<octave+2) && (pitch[i] != '\0'); i++) {
+         if (pitch[i] == '-') {
+            output--;
+         } else if (pitch[i] == '#') {
+            output++;
+         }
+      }
+      if (output < 0) {
+         cerr << "Error: pitch \"" << pitch << "\" is too low." << endl;
+         exit(1);
+      }
+      info.base40 = output;
+   }
+
+   // rhythm information
+   if (info.graceQ || !digitsQ || overflowQ) {
+      return;
+   }
+   if (rbot >= 0) {
+      info.undotted = RationalNumber(rbot, rtop) * 4;
+   } else if (!nonzeroQ) {
+      if (maxzeros > 10) {
+         maxzeros = 10;
+      }
+      info.undotted = 8 << (maxzeros - 1);
+   } else if (rhythm == 0) {
+      info.undotted = 8;
+   } else {
+      info.undotted.setValue(4, rhythm);
+   }
+   info.duration = info.undotted;
+   RationalNumber dotvalue = info.undotted;
+   for (i=0; i<info.dots; i++) {
+      dotvalue /= 2;
+      info.duration += dotvalue;
+   }
+}
+
+
+
 //////////////////////////////
 //
 // Convert::kernToMidiNoteNumber -- -1 means a rest or other negative
@@ -416,19 +616,9 @@ double Convert::kernToDurationNoDots(const string& aKernString) {
 //
 
 RationalNumber Convert::kernToDurationNoDotsR (const string& aKernString) {
-   int dotcount = 0;
-   for (int i=0; i<(int)aKernString.size(); i++) {
-      if (aKernString[i] == '.') {
-         dotcount++;
-      }
-   }
-
-   RationalNumber rn = Convert::kernToDurationR(aKernString);
-   if (dotcount > 0) {
-      rn = rn * (int)(pow(2.0, dotcount));
-      rn = rn / (int)(pow(2.0, dotcount+1) - 1);
-   }
-   return rn;
+   KernTokenInfo info;
+   Convert::scanKernToken(info, aKernString.c_str());
+   return info.undotted;
 }
 
 
@@ -448,114 +638,9 @@ double Convert::kernToDuration(const string& aKernString) {
 
 
 RationalNumber Convert::kernToDurationR(const string& aKernString) {
-    RationalNumber zero(0,1);
-
-    PerlRegularExpression pre;
-
-   // check for grace notes
-   if ((aKernString.find('q') != std::string::npos) ||
-         (aKernString.find('Q') != std::string::npos)) {
-      return zero;
-   }
-
-   // check for dots to modify rhythm
-   // also add an exit if a space is found, so that dots
-   // from multiple notes in chord notes do not get accidentally
-   // get counted together (input to this function should be a
-   // single note, but chords may accidentally be sent to this
-   // function instead).
-   int dotcount = 0;
-   for (int i=0; i<(int)aKernString.size(); i++) {
-      if (aKernString[i] == '.') {
-         dotcount++;
-      }
-      if (aKernString[i] == ' ') {
-         break;
-      }
-   }
-
-   // parse special rhythms which can't be represented in
-   // classical **kern definition.  A non-standard rhythm
-   // consists of two numbers separated by any character.
-   if (pre.search(aKernString, "(\\d+)[^\\d](\\d+)", "")) {
-      int rtop = atoi(pre.getSubmatch(1));
-      int rbot = atoi(pre.getSubmatch(2));
-      RationalNumber original(rbot, rtop);  // duration is inverse
-      RationalNumber output(rbot, rtop);    // duration is inverse
-      original *= 4;  // adjust to quarter note count;
-      output *= 4;    // adjust to quarter note count;
-      for (int i=0; i<dotcount; i++) {
-         output += original / (int)(pow(2.0, (double)(i+1)));
-      }
-      return output;
-   }
-
-   int index = 0;
-   while ((index < (int)aKernString.size()) && !isdigit(aKernString[index])) {
-      index++;
-   }
-   if (index >= (int)aKernString.size()) {
-      // no rhythm data found
-      return zero;
-   }
-
-   // should now be at start of kern rhythm
-   int orhythm = 0;
-   while ((index < (int)aKernString.size()) && isdigit(aKernString[index])) {
-      orhythm *= 10;
-      orhythm += aKernString[index] - '0';
-      index++;
-   }
-
-   RationalNumber oduration(0,1);
-   if ((aKernString.find('0') != std::string::npos) &&
-       (aKernString.find('1') == std::string::npos) &&
-       (aKernString.find('2') == std::string::npos) &&
-       (aKernString.find('3') == std::string::npos) &&
-       (aKernString.find('4') == std::string::npos) &&
-       (aKernString.find('5') == std::string::npos) &&
-       (aKernString.find('6') == std::string::npos) &&
-       (aKernString.find('7') == std::string::npos) &&
-       (aKernString.find('8') == std::string::npos) &&
-       (aKernString.find('9') == std::string::npos)    ) {
-      if (aKernString.find("0000000000") != std::string::npos) { // exotic rhythm
-         oduration = 4096;
-      } else if (aKernString.find("000000000") != std::string::npos) { // exotic rhythm
-         oduration = 2048;
-      } else if (aKernString.find("00000000") != std::string::npos) { // exotic rhythm
-         oduration = 1024;
-      } else if (aKernString.find("0000000") != std::string::npos) { // exotic rhythm
-         oduration = 512;
-      } else if (aKernString.find("000000") != std::string::npos) { // exotic rhythm
-         oduration = 256;
-      } else if (aKernString.find("00000") != std::string::npos) { // exotic rhythm
-         oduration = 128;
-      } else if (aKernString.find("0000") != std::string::npos) { // exotic rhythm
-         oduration = 64;
-      } else if (aKernString.find("000") != std::string::npos) { // 000 = maxima
-         oduration = 32;
-      } else if (aKernString.find("00") != std::string::npos) {  // 00 = long
-         oduration = 16;
-      } else { // 0 == breve
-         oduration = 8;
-      }
-
-   } else {
-      // now know everything to create a duration
-      if (orhythm == 0) {
-         oduration = 8;
-      } else {
-         oduration = 4;
-         oduration /= orhythm;
-      }
-   }
-
-   RationalNumber duration = oduration;
-   for (int i=0; i<dotcount; i++) {
-      duration += oduration / (int)(pow(2.0, (double)(i+1)));
-   }
-
-   return duration;
+   KernTokenInfo info;
+   Convert::scanKernToken(info, aKernString.c_str());
+   return info.duration;
 }
 
 
@@ -577,20 +662,10 @@ int Convert::kernToDiatonicPitch(const string& buffer) {
 //
 
 int Convert::kernToDiatonicAlteration(const string& buffer) {
-   int output = 0;
-   for (int i=0; i<(int)buffer.size(); i++) {
-      if (buffer[i] == 'n') {
-         output = 0;
-      } else if (buffer[i] == '#') {
-         output++;
-      } else if (buffer[i] == '-') {
-         output--;
-      } else if (buffer[i] == ' ') {
-         // only check the first note in the input **kern token
-         break;
-      }
-   }
-   return output;
+   // only check the first note in the input **kern token
+   KernTokenInfo info;
+   Convert::scanKernToken(info, buffer.c_str());
+   return info.accidental;
 }
 
 
@@ -678,28 +753,9 @@ int Convert::base40IntervalToDiatonic(int base40interval) {
 //
 
 int Convert::kernToDiatonicPitchClass(const string& buffer) {
-   int character;
-   for (int i=0; i<(int)buffer.size(); i++) {
-      character = tolower(buffer[i]);
-      if (character == 'a') {
-         return 'a';
-      } else if (character == 'b') {
-         return 'b';
-      } else if (character == 'c') {
-         return 'c';
-      } else if (character == 'd') {
-         return 'd';
-      } else if (character == 'e') {
-         return 'e';
-      } else if (character == 'f') {
-         return 'f';
-      } else if (character == 'g') {
-         return 'g';
-      } else if (character == 'r') {
-         return 'r';
-      }
-   }
-   return 'x';  // no pitch or rest found in data.
+   KernTokenInfo info;
+   Convert::scanKernToken(info, buffer.c_str());
+   return info.pitchclass;  // 'x' if no pitch or rest found in data.
 }
 
 
@@ -1972,33 +2028,9 @@ int Convert::base40ToMidiNoteNumber(int base40value) {
 //
 
 int Convert::kernToBase40(const string& kernfield) {
-   if (kernfield.empty()) {
-      return -1;
-   }
-
-   if (kernfield == ".") {
-      return -1;
-   }
-
-   int note = E_unknown;
-   for (int i=0; i<(int)kernfield.size(); i++) {
-      if (isalpha(kernfield[i])) {
-         switch (toupper(kernfield[i])) {
-            case 'A': case 'B': case 'C': case 'D':
-            case 'E': case 'F': case 'G':
-               note = kernNoteToBase40(&kernfield[i]);
-               goto finishup;
-               break;
-            case 'R':
-               return E_base40_rest;
-               break;
-         }
-      }
-   }
-
-finishup:
-
-   return note;
+   KernTokenInfo info;
+   Convert::scanKernToken(info, kernfield.c_str());
+   return info.base40;
 }
 
 
@@ -3046,7 +3078,7 @@ void Convert::base12ToTnSetNameAllSubsets(Array<int>& list, Array<int>& notes) {
    const char* name;
    int cardinality;
    int enumeration;
-   int number;
+   int number = 0;
    for (i=0; i<combinations.getSize(); i++) {
       name = Convert::base12ToTnSetName(combinations[i]);
       if (sscanf(name, "%d-%d", &cardinality, &enumeration)) {
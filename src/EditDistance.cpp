@@ -0,0 +1,511 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 20:33:32 PDT 2026
+// Last Modified: Sat Oct 17 20:33:32 PDT 2026
+// Filename:      ...sig/src/sigInfo/EditDistance.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/EditDistance.cpp
+// Syntax:        C++
+//
+// Description:   Approximate matching of symbol sequences with the
+//                weighted edit distance used by simil.
+//
+
+#include "EditDistance.h"
+
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// _EditPattern -- Bit vectors for Myers' algorithm.  Bit i of the vector
+//    for a symbol is set if the symbol is at position i of the pattern.
+//    The symbols of the pattern are stored in sorted order, and the
+//    symbols of the text are converted into indexes of this list (or -1
+//    if the symbol is not in the pattern).
+//
+
+#define ED_WORD_BITS 64
+
+class _EditPattern {
+   public:
+      void set(const int* pattern, int size);
+      int  find(int symbol) const;
+      void encode(vector<int>& codes, const int* text, int size) const;
+      int  distance(int plength, const int* codes, int tlength);
+
+      int              length;    // number of elements in the pattern
+      int              blocks;    // number of words for each bit vector
+      vector<int>      alphabet;  // sorted unique symbols of the pattern
+      vector<uint64_t> peq;       // bit vectors for each alphabet entry
+      vector<uint64_t> pv;        // positive vertical differences
+      vector<uint64_t> mv;        // negative vertical differences
+};
+
+
+void _EditPattern::set(const int* pattern, int size) {
+   length = size;
+   blocks = (size + ED_WORD_BITS - 1) / ED_WORD_BITS;
+   alphabet.assign(pattern, pattern + size);
+   sort(alphabet.begin(), alphabet.end());
+   alphabet.erase(unique(alphabet.begin(), alphabet.end()), alphabet.end());
+   peq.assign(alphabet.size() * blocks, 0);
+   for (int i=0; i<size; i++) {
+      int index = find(pattern[i]);
+      peq[index * blocks + i / ED_WORD_BITS] |=
+            (uint64_t)1 << (i % ED_WORD_BITS);
+   }
+}
+
+
+int _EditPattern::find(int symbol) const {
+   vector<int>::const_iterator it = lower_bound(alphabet.begin(),
+         alphabet.end(), symbol);
+   if ((it == alphabet.end()) || (*it != symbol)) {
+      return -1;
+   }
+   return (int)(it - alphabet.begin());
+}
+
+
+void _EditPattern::encode(vector<int>& codes, const int* text,
+      int size) const {
+   codes.resize(size);
+   for (int i=0; i<size; i++) {
+      codes[i] = find(text[i]);
+   }
+}
+
+
+//
+// distance -- Levenshtein distance between the first plength elements
+//    of the pattern and the text (Myers 1999, with the block carries of
+//    Hyyro 2003).  The score is read from the row of the last element of
+//    the pattern prefix, since the rows below it do not affect it.
+//
+
+int _EditPattern::distance(int plength, const int* codes, int tlength) {
+   if (plength <= 0) {
+      return tlength;
+   }
+   int words = (plength + ED_WORD_BITS - 1) / ED_WORD_BITS;
+   int last  = (plength - 1) % ED_WORD_BITS;
+   pv.assign(words, ~(uint64_t)0);
+   mv.assign(words, 0);
+   int score = plength;
+   const uint64_t* eqs;
+   uint64_t eq, xv, xh, ph, mh, hinneg;
+   int hin, hout;
+   int i, b;
+   for (i=0; i<tlength; i++) {
+      eqs = codes[i] < 0 ? NULL : &peq[codes[i] * blocks];
+      hin = 1;   // the top row increases by one for each text element
+      for (b=0; b<words; b++) {
+         eq = eqs == NULL ? 0 : eqs[b];
+         hinneg = hin < 0 ? 1 : 0;
+         xv = eq | mv[b];
+         eq |= hinneg;
+         xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+         ph = mv[b] | ~(xh | pv[b]);
+         mh = pv[b] & xh;
+         if (b == words - 1) {
+            hout = (int)((ph >> last) & 1) - (int)((mh >> last) & 1);
+         } else {
+            hout = (int)(ph >> (ED_WORD_BITS-1)) - (int)(mh >> (ED_WORD_BITS-1));
+         }
+         ph <<= 1;
+         mh <<= 1;
+         mh |= hinneg;
+         if (hin > 0) {
+            ph |= 1;
+         }
+         pv[b] = mh | ~(xv | ph);
+         mv[b] = ph & xv;
+         hin = hout;
+      }
+      score += hin;
+   }
+   return score;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Worker for EditDistance::scoreCorpus().  Threads take blocks of
+// sequences (in order) until all have been scored.
+//
+
+#define ED_CORPUS_BLOCK 16
+
+static void scoreCorpusBlocks(const EditDistance* distance,
+      vector<vector<double> >* results, const vector<vector<int> >* corpus,
+      const vector<int>* pattern, const vector<int>* counts, double limit,
+      std::atomic<int>* nextblock) {
+   int size = (int)corpus->size();
+   int start;
+   int i;
+   while ((start = nextblock->fetch_add(ED_CORPUS_BLOCK)) < size) {
+      for (i=start; (i<start+ED_CORPUS_BLOCK) && (i<size); i++) {
+         distance->scoreWindows((*results)[i], (*corpus)[i], *pattern,
+               (*counts)[i], limit);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::EditDistance --
+//
+
+EditDistance::EditDistance(void) {
+   setWeights(1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0);
+   threadcount = 1;
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::~EditDistance --
+//
+
+EditDistance::~EditDistance() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::setWeights -- Set the cost of each edit operation.  S1 is
+//     the first sequence given to getDistance() or the sequence given to
+//     scoreWindows(), and S2 is the second sequence or the pattern.
+//
+
+void EditDistance::setWeights(double r1, double r2, double d1, double d2,
+      double s0, double s1, double s2, double s3) {
+   weight_R1 = r1;
+   weight_R2 = r2;
+   weight_D1 = d1;
+   weight_D2 = d2;
+   weight_S0 = s0;
+   weight_S1 = s1;
+   weight_S2 = s2;
+   weight_S3 = s3;
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::isUnitWeight -- Returns true if all weights are 1.0, in
+//     which case distances are calculated with bit vectors.
+//
+
+int EditDistance::isUnitWeight(void) const {
+   return (weight_R1 == 1.0) && (weight_R2 == 1.0) && (weight_D1 == 1.0) &&
+          (weight_D2 == 1.0) && (weight_S0 == 1.0) && (weight_S1 == 1.0) &&
+          (weight_S2 == 1.0) && (weight_S3 == 1.0);
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::setThreadCount -- Set the number of threads which
+//     scoreCorpus() uses.
+//
+
+void EditDistance::setThreadCount(int count) {
+   threadcount = count < 1 ? 1 : count;
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::getSymbol -- Return the symbol number of a token, adding
+//     it to the list of symbols if necessary.  Not thread-safe.
+//
+
+int EditDistance::getSymbol(const string& token) {
+   map<string, int>::iterator it = symbols.find(token);
+   if (it != symbols.end()) {
+      return it->second;
+   }
+   int symbol = (int)symbols.size();
+   symbols[token] = symbol;
+   return symbol;
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::getSymbolCount -- Return the number of different tokens
+//     given to getSymbol().
+//
+
+int EditDistance::getSymbolCount(void) const {
+   return (int)symbols.size();
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::getDistance -- Return the edit distance between the
+//     elements of two sequences starting at the given offsets.  The
+//     length compared is the smaller of the remaining lengths of the
+//     sequences and the length parameter (if not negative).  An element
+//     is repeated if it is the same as the previous element of its
+//     sequence, including elements before the offsets.  If the limit is
+//     not negative, the calculation can stop when the distance is known to
+//     be larger than the limit, and the value returned is then only a
+//     lower bound for the distance.
+//     default value: length = -1
+//     default value: limit  = -1.0
+//
+
+double EditDistance::getDistance(const vector<int>& s1, int offset1,
+      const vector<int>& s2, int offset2, int length, double limit) const {
+   if (offset1 < 0) { offset1 = 0; }
+   if (offset2 < 0) { offset2 = 0; }
+   int len = min((int)s1.size() - offset1, (int)s2.size() - offset2);
+   if ((length >= 0) && (length < len)) {
+      len = length;
+   }
+   if (len <= 0) {
+      return 0.0;
+   }
+
+   if (isUnitWeight()) {
+      _EditPattern pattern;
+      vector<int> codes;
+      pattern.set(s2.data() + offset2, len);
+      pattern.encode(codes, s1.data() + offset1, len);
+      return (double)pattern.distance(len, codes.data(), len);
+   }
+
+   vector<double> row;
+   return weightedDistance(s1.data() + offset1, offset1 > 0,
+         s2.data() + offset2, offset2 > 0, len, limit, row);
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::scoreWindows -- Compare the pattern to the sequence
+//     starting at each of the first count positions of the sequence, in
+//     the way that simil does.  Each comparison uses the length of the
+//     pattern or of the rest of the sequence, whichever is smaller, and
+//     the first element of each is not considered repeated.  Positions
+//     past the end of the sequence have a distance of 0.  See getDistance()
+//     for the limit.
+//     default value: limit = -1.0
+//
+
+void EditDistance::scoreWindows(vector<double>& results,
+      const vector<int>& sequence, const vector<int>& pattern, int count,
+      double limit) const {
+   results.resize(count < 0 ? 0 : count);
+   int plen = (int)pattern.size();
+   int slen = (int)sequence.size();
+   int len;
+   int i;
+
+   if (isUnitWeight()) {
+      // The bit vectors of the pattern are prepared once, and the
+      // distances to prefixes of the pattern are read from the same
+      // vectors at the end of the sequence.
+      _EditPattern bits;
+      vector<int> codes;
+      bits.set(pattern.data(), plen);
+      bits.encode(codes, sequence.data(), slen);
+      for (i=0; i<(int)results.size(); i++) {
+         len = min(plen, slen - i);
+         if (len <= 0) {
+            results[i] = 0.0;
+         } else {
+            results[i] = bits.distance(len, codes.data() + i, len);
+         }
+      }
+      return;
+   }
+
+   vector<double> row;
+   for (i=0; i<(int)results.size(); i++) {
+      len = min(plen, slen - i);
+      if (len <= 0) {
+         results[i] = 0.0;
+      } else {
+         results[i] = weightedDistance(sequence.data() + i, 0,
+               pattern.data(), 0, len, limit, row);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// EditDistance::scoreCorpus -- Score a pattern against every sequence
+//     of a corpus with scoreWindows(), using the thread count given by
+//     setThreadCount().  The number of positions scored in each sequence
+//     is given by the counts list, or otherwise is each position where the
+//     entire pattern fits into the sequence.
+//     default value: limit = -1.0
+//
+
+void EditDistance::scoreCorpus(vector<vector<double> >& results,
+      const vector<vector<int> >& corpus, const vector<int>& pattern,
+      double limit) const {
+   vector<int> counts(corpus.size());
+   for (int i=0; i<(int)corpus.size(); i++) {
+      counts[i] = max(0, (int)corpus[i].size() - (int)pattern.size() + 1);
+   }
+   scoreCorpus(results, corpus, pattern, counts, limit);
+}
+
+
+void EditDistance::scoreCorpus(vector<vector<double> >& results,
+      const vector<vector<int> >& corpus, const vector<int>& pattern,
+      const vector<int>& counts, double limit) const {
+   results.resize(corpus.size());
+   std::atomic<int> nextblock(0);
+   int blocks = ((int)corpus.size() + ED_CORPUS_BLOCK - 1) / ED_CORPUS_BLOCK;
+   int count = min(threadcount, blocks);
+   if (count <= 1) {
+      scoreCorpusBlocks(this, &results, &corpus, &pattern, &counts, limit,
+            &nextblock);
+      return;
+   }
+   vector<std::thread> workers;
+   int i;
+   for (i=0; i<count; i++) {
+      workers.push_back(std::thread(scoreCorpusBlocks, this, &results,
+            &corpus, &pattern, &counts, limit, &nextblock));
+   }
+   for (i=0; i<(int)workers.size(); i++) {
+      workers[i].join();
+   }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// EditDistance::weightedDistance -- Edit distance with the weights for
+//     repeated elements, calculated one row of the table at a time as in
+//     the original simil program.  If context1 or context2 is true, the
+//     element before the start of that sequence is used to decide whether
+//     the first element is repeated.
+//
+//     When a limit is given and no weight is negative, only the cells
+//     within limit/w of the diagonal are calculated (w being the smallest
+//     deletion weight), since any path through a cell further away needs
+//     more deletions than the limit allows.  The calculation stops when
+//     every cell of a row is larger than the limit.
+//
+
+double EditDistance::weightedDistance(const int* s1, int context1,
+      const int* s2, int context2, int length, double limit,
+      vector<double>& row) const {
+   int len = length;
+   row.resize(len + 1);
+   double* mn = row.data();
+
+   double minweight = min(min(weight_R1, weight_R2),
+         min(weight_D1, weight_D2));
+   double minsub = min(min(weight_S0, weight_S1), min(weight_S2, weight_S3));
+   int limitQ = (limit >= 0.0) && (minweight >= 0.0) && (minsub >= 0.0);
+   int band = len;
+   if (limitQ && (minweight > 0.0) && (limit / minweight < len)) {
+      band = (int)floor(limit / minweight);
+   }
+
+   double cost, val, m;
+   double rowmin;
+   int rep1, rep2;
+   int i, j;
+   int start, end;
+
+   // first row: deletions of the elements of s1
+   m = 0.0;
+   mn[0] = 0.0;
+   for (i=0; i<len; i++) {
+      if (i < band) {
+         rep1 = ((i > 0) || context1) && (s1[i] == s1[i-1]);
+         m += rep1 ? weight_R1 : weight_D1;
+         mn[i+1] = m;
+      } else {
+         mn[i+1] = HUGE_VAL;
+      }
+   }
+
+   for (j=0; j<len; j++) {
+      rep2 = ((j > 0) || context2) && (s2[j] == s2[j-1]);
+      // cells i+1 are calculated for row j+1 where |i+1 - (j+1)| <= band
+      start = j - band;
+      if (start <= 0) {
+         start = 0;
+         cost = mn[0];
+         m = cost + (rep2 ? weight_R2 : weight_D2);
+         mn[0] = m;
+         rowmin = m;
+      } else {
+         cost = mn[start];
+         m = HUGE_VAL;
+         mn[start] = HUGE_VAL;
+         rowmin = HUGE_VAL;
+      }
+      end = min(len, j + band + 1);
+
+      for (i=start; i<end; i++) {
+         rep1 = ((i > 0) || context1) && (s1[i] == s1[i-1]);
+         m += rep1 ? weight_R1 : weight_D1;
+         if (s1[i] == s2[j]) {
+            val = cost;
+         } else if (rep1) {
+            val = cost + (rep2 ? weight_S3 : weight_S1);
+         } else {
+            val = cost + (rep2 ? weight_S2 : weight_S0);
+         }
+         if (val < m) {
+            m = val;
+         }
+         cost = mn[i+1];
+         val = cost + (rep2 ? weight_R2 : weight_D2);
+         if (val < m) {
+            m = val;
+         }
+         mn[i+1] = m;
+         if (m < rowmin) {
+            rowmin = m;
+         }
+      }
+
+      if (limitQ && (rowmin > limit)) {
+         // every path to the end passes through this row
+         return rowmin;
+      }
+   }
+
+   return mn[len];
+}
+
+
+
@@ -3,12 +3,16 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun  8 21:45:27 PDT 1998
 // Last Modified: Tue Jun 23 14:06:21 PDT 1998
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 (sort when adding)
 // Filename:      ...sig/src/sigInfo/Enumeration.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/Convert.cpp
 // Syntax:        C++ 
 //
 // Description:   Messy yet functional way of handling enumerations
-//                and their string equivalents.
+//                and their string equivalents.  The lookup tables are
+//                sorted when entries are added, so lookups do not modify
+//                the enumeration and can be done by several threads at
+//                once when no more entries are being added.
 //
 
 #include "Enumeration.h"
@@ -50,13 +54,13 @@ Enumeration::Enumeration(const Enumeration& aSet) {
    sortByValue.setSize(size);
    sortByName.allowGrowth();
    sortByName.setSize(size);
-   sortQ = aSet.sortQ;
 
    for (int i=0; i<size; i++) {
       associations[i] = aSet.associations[i];
-      sortByValue[i] = aSet.sortByValue[i];
-      sortByName[i] = aSet.sortByName[i];
    }
+
+   // the lookup tables must point to this object's associations:
+   sort();
 }
 
 
@@ -88,7 +92,9 @@ void Enumeration::add(const EnumerationData& aDatum) {
    associations[associations.getSize()] = aDatum;
    sortByValue[sortByValue.getSize()] = NULL;
    sortByName[sortByName.getSize()] = NULL;
-   sortQ = 0;
+   // sort now rather than in the next lookup, since the associations
+   // may have moved in memory while growing:
+   sort();
 }
 
 
@@ -294,6 +300,7 @@ void Enumeration::printByValue(ostream& out) {
    
 void Enumeration::setNullName(const char* aName, int allocType) {
    associations[0].setName(aName, allocType);
+   sort();
 }
 
 
@@ -306,7 +313,8 @@ void Enumeration::setNullName(const char* aName, int allocType) {
 
 //////////////////////////////
 //
-// Enumeration::checksort --
+// Enumeration::checksort -- the tables are sorted by add(), so this
+//     only has an effect if sortQ was cleared by a derived class.
 //
 
 void Enumeration::checksort(void) {
@@ -5,6 +5,8 @@
 // Last Modified: Fri Oct 13 15:04:45 PDT 2000 (changed name to EnumerationEI)
 // Last Modified: Sat Oct 14 19:12:37 PDT 2000 (extracted .cpp file)
 // Last Modified: Sun Mar 24 12:10:00 PST 2002 (small changes for visual c++)
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 (thread-safe lookups)
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 (lock-free lookups)
 // Filename:      ...sig/src/sigInfo/EnumerationEI.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/EnumerationEI.cpp
 // Syntax:        C++ 
@@ -14,45 +16,143 @@
 
 #include "EnumerationEI.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+
 #ifndef OLDCPP
    using namespace std;
 #endif
 
-// static declarations
-int EnumerationEI::nextenumeration = 1000;
+// new interpretations are added one at a time:
+static mutex EnumerationEIMutex;
 
 
 ///////////////////////////////
 //
-// EnumerationEI::EnumerationEI --
+// EnumerationEI::EnumerationEI -- The predefined interpretations are
+//     stored in the Enumeration base class, which is not changed after
+//     this constructor finishes.
 //
 
 EnumerationEI::EnumerationEI(void) : Enumeration() {
-   add(E_UNKNOWN_EXINT, E_UNKNOWN_EXINT_NAME,  ENUM_FIXED_ALLOC);
+   Enumeration::add(E_UNKNOWN_EXINT, E_UNKNOWN_EXINT_NAME,  ENUM_FIXED_ALLOC);
 
    // standard types of exclusive interpretations
-   add(E_KERN_EXINT   , E_KERN_EXINT_NAME   ,  ENUM_FIXED_ALLOC);
+   Enumeration::add(E_KERN_EXINT   , E_KERN_EXINT_NAME   ,  ENUM_FIXED_ALLOC);
 
    // museinfo pre defined exclusive interpretations
-   add(E_QUAL_EXINT   , E_QUAL_EXINT_NAME    , ENUM_FIXED_ALLOC);
+   Enumeration::add(E_QUAL_EXINT   , E_QUAL_EXINT_NAME    , ENUM_FIXED_ALLOC);
+
+   for (int i=0; i<EI_BLOCK_COUNT; i++) {
+      blocks[i] = NULL;
+   }
+   count.store(0);
 }
 
 
 
 ///////////////////////////////
 //
-// EnumerationEI::add --
+// EnumerationEI::add -- Add a new interpretation and return its value.
+//     Adding a name which is already in the database returns the
+//     existing value, so that two threads which both failed to find
+//     the same new interpretation will agree on its value.  The name
+//     is published only after it is stored, so getName() and getValue()
+//     can run at the same time as add().
 //
 
 int EnumerationEI::add(const char* aString) { 
-   add(nextenumeration++, aString);
-   return nextenumeration-1; 
+   int value = getValue(aString);
+   if (value != E_unknown) {
+      return value;
+   }
+
+   lock_guard<mutex> lock(EnumerationEIMutex);
+   int size = count.load(memory_order_relaxed);
+   value = findAdded(aString, size);
+   if (value != E_unknown) {
+      return value;
+   }
+
+   int block = size / EI_BLOCK_SIZE;
+   if (block >= EI_BLOCK_COUNT) {
+      cerr << "Error: too many exclusive interpretations" << endl;
+      exit(1);
+   }
+   if (blocks[block] == NULL) {
+      blocks[block] = new const char*[EI_BLOCK_SIZE];
+   }
+   char* name = new char[strlen(aString)+1];
+   strcpy(name, aString);
+   blocks[block][size % EI_BLOCK_SIZE] = name;
+   count.store(size+1, memory_order_release);
+
+   return EI_FIRST_VALUE + size; 
 }
 
+
+//
+// Adding an interpretation with a given value should only be done 
+// before the database is used by more than one thread.
+//
+
 void EnumerationEI::add(int aValue, const char* aString, int allocType) { 
+   lock_guard<mutex> lock(EnumerationEIMutex);
    Enumeration::add(aValue, aString, allocType); 
 }
 
 
 
+///////////////////////////////
+//
+// EnumerationEI::getName --
+//
+
+const char* EnumerationEI::getName(int aValue) {
+   int index = aValue - EI_FIRST_VALUE;
+   if ((index >= 0) && (index < count.load(memory_order_acquire))) {
+      return blocks[index / EI_BLOCK_SIZE][index % EI_BLOCK_SIZE];
+   }
+   return Enumeration::getName(aValue);
+}
+
+
+
+///////////////////////////////
+//
+// EnumerationEI::getValue --
+//
+
+int EnumerationEI::getValue(const char* aName) {
+   int value = Enumeration::getValue(aName);
+   if (value != E_unknown) {
+      return value;
+   }
+   return findAdded(aName, count.load(memory_order_acquire));
+}
+
+
+
+///////////////////////////////
+//
+// EnumerationEI::findAdded -- search the first size interpretations
+//     which were added by add(const char*).  Returns E_unknown if the
+//     name was not found.
+//
+
+int EnumerationEI::findAdded(const char* aName, int size) {
+   const char* name;
+   for (int i=0; i<size; i++) {
+      name = blocks[i / EI_BLOCK_SIZE][i % EI_BLOCK_SIZE];
+      if ((name[0] == aName[0]) && (strcmp(name, aName) == 0)) {
+         return EI_FIRST_VALUE + i;
+      }
+   }
+   return E_unknown;
+}
+
+
+
 // md5sum: ff8a4d9c9c5eef33726b3ecd3e1b4f56 EnumerationEI.cpp [20050403]
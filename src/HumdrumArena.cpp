@@ -0,0 +1,195 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 17:39:08 PDT 2026
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026
+// Filename:      ...sig/src/sigInfo/HumdrumArena.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumArena.cpp
+// Syntax:        C++
+//
+// Description:   Bump allocator for the text of HumdrumRecords which
+//                belong to a HumdrumFileBasic.
+//
+
+#include "HumdrumArena.h"
+
+#include <string.h>
+#include <utility>
+
+
+//////////////////////////////
+//
+// HumdrumArena::HumdrumArena --
+//     default value: aChunkSize = 65536
+//
+
+HumdrumArena::HumdrumArena(void) {
+   current   = 0;
+   offset    = 0;
+   chunksize = 65536;
+}
+
+
+HumdrumArena::HumdrumArena(int aChunkSize) {
+   current   = 0;
+   offset    = 0;
+   chunksize = aChunkSize;
+   if (chunksize < 1024) {
+      chunksize = 1024;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::~HumdrumArena --
+//
+
+HumdrumArena::~HumdrumArena() {
+   for (int i=0; i<(int)chunks.size(); i++) {
+      delete [] chunks[i];
+      chunks[i] = NULL;
+   }
+   chunks.clear();
+   chunksizes.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::allocate -- Return storage for size bytes.  The memory
+//     remains valid until the arena is cleared or destroyed.
+//
+
+char* HumdrumArena::allocate(int size) {
+   if (size < 1) {
+      size = 1;
+   }
+   if ((current >= (int)chunks.size()) ||
+         (offset + size > chunksizes[current])) {
+      nextChunk(size);
+   }
+   char* output = chunks[current] + offset;
+   offset += size;
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::copy -- Store a null-terminated copy of the given string.
+//
+
+char* HumdrumArena::copy(const char* aString, int length) {
+   char* output = allocate(length + 1);
+   memcpy(output, aString, length);
+   output[length] = '\0';
+   return output;
+}
+
+
+char* HumdrumArena::copy(const char* aString) {
+   return copy(aString, strlen(aString));
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::clear -- Invalidate all previous allocations.  The
+//     chunks are kept for reuse by the next file which is read.
+//
+
+void HumdrumArena::clear(void) {
+   current = 0;
+   offset  = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::reserve -- Make sure that the next size bytes can be
+//     allocated from a single chunk (such as when the size of the input
+//     file is known in advance).
+//
+
+void HumdrumArena::reserve(int size) {
+   if ((current < (int)chunks.size()) &&
+         (offset + size <= chunksizes[current])) {
+      return;
+   }
+   nextChunk(size);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::getChunkCount -- Return the number of blocks which
+//     have been allocated from the heap.
+//
+
+int HumdrumArena::getChunkCount(void) const {
+   return (int)chunks.size();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumArena::swap -- Exchange storage with another arena.  Strings
+//     allocated from either arena remain valid, but now belong to the
+//     other arena object.
+//
+
+void HumdrumArena::swap(HumdrumArena& anArena) {
+   chunks.swap(anArena.chunks);
+   chunksizes.swap(anArena.chunksizes);
+   std::swap(current, anArena.current);
+   std::swap(offset, anArena.offset);
+   std::swap(chunksize, anArena.chunksize);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// private functions
+//
+
+//////////////////////////////
+//
+// HumdrumArena::nextChunk -- Move to the next chunk which can hold at
+//     least size bytes, reusing chunks left over from before the last
+//     clear() if possible.
+//
+
+void HumdrumArena::nextChunk(int size) {
+   int i;
+   int start = current + 1;
+   if ((current == 0) && (offset == 0)) {
+      start = 0;
+   }
+   for (i=start; i<(int)chunks.size(); i++) {
+      if (chunksizes[i] >= size) {
+         current = i;
+         offset  = 0;
+         return;
+      }
+   }
+
+   int newsize = chunksize;
+   if (size > newsize) {
+      newsize = size;
+   }
+   chunks.push_back(new char[newsize]);
+   chunksizes.push_back(newsize);
+   current = (int)chunks.size() - 1;
+   offset  = 0;
+}
+
+
+
@@ -0,0 +1,802 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:41:20 PDT 2026
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026
+// Last Modified: Sat Oct 17 23:25:24 PDT 2026 extract the note table on loading
+// Last Modified: Sat Oct 17 23:31:10 PDT 2026 nanosecond modification times
+// Last Modified: Sun Oct 18 01:14:13 PDT 2026 check the dot analysis ranges
+// Filename:      ...sig/src/sigInfo/HumdrumCache.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumCache.cpp
+// Syntax:        C++
+//
+// Description:   Binary precompiled form of the HumdrumFiles read from
+//                a source file (.humc files).
+//
+// File layout:   A HumcHeader followed by one block for each segment
+//                (HumdrumFile) in the source.  Each segment block is:
+//                   HumcSegment
+//                   HumcLine     [linecount]
+//                   int fields   [fieldcount]   pool offsets of fields
+//                   int ids      [idcount]      pool offsets of spine ids
+//                   int interps  [interpcount]  index into names
+//                   int dots     [2*dotcount]   dotline/dotspine pairs
+//                   int names    [2*namecount]  exinterp value/pool offset
+//                   int tracks   [trackcount]   pool offsets
+//                   int rhythms  [2*rhythmcount] localrhythms
+//                   char pool    [poolsize]
+//                Each section starts on an 8-byte boundary so that the
+//                tables can be used directly from a memory-mapped file.
+//                Numbers are stored in the byte order of the writing
+//                computer, and a cache with a different byte order is
+//                ignored.
+//
+
+#include "HumdrumCache.h"
+#include "Convert.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <limits.h>
+
+#include <map>
+#include <fstream>
+
+#include <sys/types.h>   /* off_t           */
+#include <sys/stat.h>    /* stat            */
+#include <sys/mman.h>    /* mmap, munmap    */
+#include <fcntl.h>       /* open            */
+#include <unistd.h>      /* close           */
+
+#define HUMC_VERSION    2
+#define HUMC_BYTEORDER  0x01020304
+#define HUMC_SOURCE     (-1)   // segment filename is the source filename
+
+struct HumcHeader {
+   char      magic[4];         // "HUMC"
+   int       version;          // HUMC_VERSION
+   int       byteorder;        // HUMC_BYTEORDER
+   int       segmentcount;     // number of HumdrumFiles in the cache
+   long long sourcesize;       // size of the source file
+   long long sourcetime;       // modification time of the source (ns)
+};
+
+struct HumcSegment {
+   int       linecount;
+   int       fieldcount;       // total fields on all lines
+   int       idcount;          // total spine ids on all lines
+   int       interpcount;      // total exclusive interpretations
+   int       dotcount;         // total dot analysis entries
+   int       namecount;        // exclusive interpretation names
+   int       trackcount;       // size of trackexinterp
+   int       rhythmcount;      // size of localrhythms
+   int       maxtracks;
+   int       segmentlevel;
+   int       filename;         // pool offset, or HUMC_SOURCE
+   int       rhythmbase;       // pool offset
+   int       rhythmcheck;
+   int       minrhythm;
+   int       minrhythmR[2];
+   int       pickupdur[2];
+   long long poolsize;
+};
+
+struct HumcLine {
+   int       type;
+   int       lineno;
+   int       spinewidth;
+   int       text;             // pool offset of the line
+   int       fieldcount;
+   int       idcount;
+   int       interpcount;
+   int       dotcount;
+   float     duration;
+   float     meterloc;
+   float     absloc;
+   int       padding;
+   long long durationR[2];
+   long long meterlocR[2];
+   long long abslocR[2];
+};
+
+
+// helper functions for building and scanning the cache:
+static void   appendBytes      (string& output, const void* data, size_t size);
+static void   alignOutput      (string& output);
+static size_t alignPosition    (size_t position);
+static int    addPoolString    (string& pool, const char* text);
+static int    addPoolString    (string& pool, map<string, int>& shared,
+                                const string& text);
+static void   storeRational    (long long* output, const RationalNumber64& r);
+static void   loadRational     (RationalNumber64& r, const long long* input);
+static int    getSourceInfo    (const string& filename, long long& size,
+                                long long& mtime);
+static long long getModTime    (const struct stat& info);
+static inline int inPool       (int offset, int poolsize);
+
+
+
+//////////////////////////////
+//
+// HumdrumCache::getCacheName -- Return the name of the cache for the
+//     given source file: the source filename with ".humc" appended.
+//
+
+string HumdrumCache::getCacheName(const string& sourcename) {
+   return sourcename + ".humc";
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumCache::isCurrent -- Returns true if the cache file exists and
+//     was written after the last modification of the source file (compared
+//     in nanoseconds, so that a source file saved again within the same
+//     second as the cache is noticed).  The contents of the cache are
+//     verified by read().
+//
+
+int HumdrumCache::isCurrent(const string& cachename,
+      const string& sourcename) {
+   struct stat cacheinfo;
+   struct stat sourceinfo;
+   if (stat(cachename.c_str(), &cacheinfo) != 0) {
+      return 0;
+   }
+   if (stat(sourcename.c_str(), &sourceinfo) != 0) {
+      return 0;
+   }
+   if (!S_ISREG(cacheinfo.st_mode) || !S_ISREG(sourceinfo.st_mode)) {
+      return 0;
+   }
+   return getModTime(cacheinfo) >= getModTime(sourceinfo);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumCache::write -- Store the HumdrumFiles which were read from the
+//     source file.  The cache is written to a temporary file which is
+//     then renamed, so that programs reading the cache at the same time
+//     never see a partial file.  Returns 0 if the cache could not be
+//     written.
+//
+
+int HumdrumCache::write(const string& cachename, const string& sourcename,
+      vector<HumdrumFile*>& segments) {
+   HumcHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, "HUMC", 4);
+   header.version      = HUMC_VERSION;
+   header.byteorder    = HUMC_BYTEORDER;
+   header.segmentcount = (int)segments.size();
+   if (!getSourceInfo(sourcename, header.sourcesize, header.sourcetime)) {
+      return 0;
+   }
+
+   string output;
+   appendBytes(output, &header, sizeof(header));
+   alignOutput(output);
+   for (int i=0; i<(int)segments.size(); i++) {
+      writeSegment(output, *segments[i], sourcename);
+   }
+
+   string tempname = cachename;
+   tempname += ".tmp";
+   tempname += to_string((long long)getpid());
+   ofstream outfile(tempname.c_str(), ios::out | ios::binary);
+   if (!outfile.is_open()) {
+      return 0;
+   }
+   outfile.write(output.data(), output.size());
+   outfile.close();
+   if (outfile.fail()) {
+      unlink(tempname.c_str());
+      return 0;
+   }
+   if (rename(tempname.c_str(), cachename.c_str()) != 0) {
+      unlink(tempname.c_str());
+      return 0;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumCache::read -- Load the HumdrumFiles stored in the cache of the
+//     source file.  The cache file is memory-mapped, the string pool of
+//     each segment is copied with a single allocation into the arena of
+//     its HumdrumFile, and the records are pointed into the pool.  Returns
+//     0 (with segments empty) if the cache is missing, damaged, from a
+//     different version or computer, or does not match the current size
+//     and modification time of the source file; in that case the source
+//     should be parsed instead.  The HumdrumFiles in segments are
+//     allocated with new and should be deleted by the caller.
+//
+
+int HumdrumCache::read(const string& cachename, const string& sourcename,
+      vector<HumdrumFile*>& segments) {
+   segments.clear();
+
+   long long sourcesize;
+   long long sourcetime;
+   if (!getSourceInfo(sourcename, sourcesize, sourcetime)) {
+      return 0;
+   }
+
+   int fd = open(cachename.c_str(), O_RDONLY);
+   if (fd < 0) {
+      return 0;
+   }
+   struct stat info;
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode) ||
+         (info.st_size < (off_t)sizeof(HumcHeader))) {
+      close(fd);
+      return 0;
+   }
+   size_t length = (size_t)info.st_size;
+   void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (data == MAP_FAILED) {
+      return 0;
+   }
+
+   const HumcHeader& header = *(const HumcHeader*)data;
+   int status = (memcmp(header.magic, "HUMC", 4) == 0) &&
+         (header.version == HUMC_VERSION) &&
+         (header.byteorder == HUMC_BYTEORDER) &&
+         (header.sourcesize == sourcesize) &&
+         (header.sourcetime == sourcetime) &&
+         (header.segmentcount >= 0);
+
+   size_t position = alignPosition(sizeof(HumcHeader));
+   HumdrumFile* file;
+   for (int i=0; status && (i<header.segmentcount); i++) {
+      file = new HumdrumFile;
+      segments.push_back(file);
+      status = readSegment((const char*)data, length, position, *file,
+            sourcename);
+   }
+   munmap(data, length);
+
+   if (!status) {
+      for (int i=0; i<(int)segments.size(); i++) {
+         delete segments[i];
+      }
+      segments.clear();
+      return 0;
+   }
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// HumdrumCache::writeSegment -- Append the binary form of a HumdrumFile
+//     to the output.  Spine ids, exclusive interpretation names and other
+//     repeated strings are only stored once in the string pool.
+//
+
+void HumdrumCache::writeSegment(string& output, HumdrumFile& infile,
+      const string& sourcename) {
+   int i, j;
+   int linecount = infile.getNumLines();
+
+   string pool;
+   map<string, int> shared;       // pool offsets of repeated strings
+   map<int, int>    nameindex;    // exinterp value to names index
+   vector<int>      names;        // value/pool offset pairs
+
+   vector<HumcLine> lines(linecount);
+   vector<int> fields;
+   vector<int> ids;
+   vector<int> interps;
+   vector<int> dots;
+
+   HumdrumRecord* record;
+   const char* name;
+   map<int, int>::iterator it;
+   for (i=0; i<linecount; i++) {
+      record = infile.records[i];
+      HumcLine& line = lines[i];
+      memset(&line, 0, sizeof(line));
+      line.type        = record->type;
+      line.lineno      = record->lineno;
+      line.spinewidth  = record->spinewidth;
+      line.text        = addPoolString(pool, record->getLine());
+      line.fieldcount  = record->recordFields.getSize();
+      line.idcount     = (int)record->spineids.size();
+      line.interpcount = record->interpretation.getSize();
+      line.dotcount    = record->dotline.getSize();
+      line.duration    = record->duration;
+      line.meterloc    = record->meterloc;
+      line.absloc      = record->absloc;
+      storeRational(line.durationR, record->durationR);
+      storeRational(line.meterlocR, record->meterlocR);
+      storeRational(line.abslocR,   record->abslocR);
+
+      for (j=0; j<line.fieldcount; j++) {
+         fields.push_back(addPoolString(pool, record->recordFields[j]));
+      }
+      for (j=0; j<line.idcount; j++) {
+         ids.push_back(addPoolString(pool, shared, record->spineids[j]));
+      }
+      for (j=0; j<line.interpcount; j++) {
+         it = nameindex.find(record->interpretation[j]);
+         if (it == nameindex.end()) {
+            // exclusive interpretation numbers are assigned when the
+            // program runs, so store the name to look the number up
+            // when loading.  Values without a name are stored as is.
+            name = Convert::exint.getName(record->interpretation[j]);
+            nameindex[record->interpretation[j]] = (int)names.size() / 2;
+            interps.push_back((int)names.size() / 2);
+            names.push_back(record->interpretation[j]);
+            names.push_back(name[0] == '\0' ? -1 :
+                  addPoolString(pool, shared, name));
+         } else {
+            interps.push_back(it->second);
+         }
+      }
+      for (j=0; j<line.dotcount; j++) {
+         dots.push_back(record->dotline[j]);
+         dots.push_back(record->dotspine[j]);
+      }
+   }
+
+   vector<int> tracks;
+   for (i=0; i<(int)infile.trackexinterp.size(); i++) {
+      tracks.push_back(addPoolString(pool, shared, infile.trackexinterp[i]));
+   }
+
+   vector<int> rhythms;
+   for (i=0; i<infile.localrhythms.getSize(); i++) {
+      rhythms.push_back(infile.localrhythms[i].getNumerator());
+      rhythms.push_back(infile.localrhythms[i].getDenominator());
+   }
+
+   HumcSegment segment;
+   memset(&segment, 0, sizeof(segment));
+   segment.linecount     = linecount;
+   segment.fieldcount    = (int)fields.size();
+   segment.idcount       = (int)ids.size();
+   segment.interpcount   = (int)interps.size();
+   segment.dotcount      = (int)dots.size() / 2;
+   segment.namecount     = (int)names.size() / 2;
+   segment.trackcount    = (int)tracks.size();
+   segment.rhythmcount   = (int)rhythms.size() / 2;
+   segment.maxtracks     = infile.maxtracks;
+   segment.segmentlevel  = infile.segmentLevel;
+   if (infile.fileName == sourcename) {
+      segment.filename   = HUMC_SOURCE;
+   } else {
+      segment.filename   = addPoolString(pool, infile.fileName.c_str());
+   }
+   segment.rhythmbase    = addPoolString(pool, infile.rhythmbase.c_str());
+   segment.rhythmcheck   = infile.rhythmcheck;
+   segment.minrhythm     = infile.minrhythm;
+   segment.minrhythmR[0] = infile.minrhythmR.getNumerator();
+   segment.minrhythmR[1] = infile.minrhythmR.getDenominator();
+   segment.pickupdur[0]  = infile.pickupdur.getNumerator();
+   segment.pickupdur[1]  = infile.pickupdur.getDenominator();
+   segment.poolsize      = (long long)pool.size();
+
+   appendBytes(output, &segment, sizeof(segment));
+   alignOutput(output);
+   appendBytes(output, lines.data(), lines.size() * sizeof(HumcLine));
+   alignOutput(output);
+   appendBytes(output, fields.data(), fields.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, ids.data(), ids.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, interps.data(), interps.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, dots.data(), dots.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, names.data(), names.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, tracks.data(), tracks.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, rhythms.data(), rhythms.size() * sizeof(int));
+   alignOutput(output);
+   appendBytes(output, pool.data(), pool.size());
+   alignOutput(output);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumCache::readSegment -- Load the segment starting at the given
+//     position of the cache data into a HumdrumFile, and advance the
+//     position to the next segment.  Returns 0 if the segment does not
+//     fit inside of the data, refers to text outside of its pool, or has
+//     a null token which refers to a line or field outside of the segment.
+//
+
+int HumdrumCache::readSegment(const char* data, size_t length,
+      size_t& position, HumdrumFile& infile, const string& sourcename) {
+   int i, j;
+
+   if (position + sizeof(HumcSegment) > length) {
+      return 0;
+   }
+   const HumcSegment& segment = *(const HumcSegment*)(data + position);
+   if ((segment.linecount < 0) || (segment.fieldcount < 0) ||
+         (segment.idcount < 0) || (segment.interpcount < 0) ||
+         (segment.dotcount < 0) || (segment.namecount < 0) ||
+         (segment.trackcount < 0) || (segment.rhythmcount < 0) ||
+         (segment.poolsize < 0) || (segment.poolsize >= INT_MAX)) {
+      return 0;
+   }
+   position = alignPosition(position + sizeof(HumcSegment));
+
+   // locate the tables of the segment:
+   size_t sizes[9];
+   sizes[0] = (size_t)segment.linecount * sizeof(HumcLine);
+   sizes[1] = (size_t)segment.fieldcount * sizeof(int);
+   sizes[2] = (size_t)segment.idcount * sizeof(int);
+   sizes[3] = (size_t)segment.interpcount * sizeof(int);
+   sizes[4] = (size_t)segment.dotcount * 2 * sizeof(int);
+   sizes[5] = (size_t)segment.namecount * 2 * sizeof(int);
+   sizes[6] = (size_t)segment.trackcount * sizeof(int);
+   sizes[7] = (size_t)segment.rhythmcount * 2 * sizeof(int);
+   sizes[8] = (size_t)segment.poolsize;
+   const char* tables[9];
+   for (i=0; i<9; i++) {
+      if ((position > length) || (sizes[i] > length - position)) {
+         return 0;
+      }
+      tables[i] = data + position;
+      position = alignPosition(position + sizes[i]);
+   }
+   const HumcLine* lines   = (const HumcLine*)tables[0];
+   const int*      fields  = (const int*)tables[1];
+   const int*      ids     = (const int*)tables[2];
+   const int*      interps = (const int*)tables[3];
+   const int*      dots    = (const int*)tables[4];
+   const int*      names   = (const int*)tables[5];
+   const int*      tracks  = (const int*)tables[6];
+   const int*      rhythms = (const int*)tables[7];
+   const char*     source  = tables[8];
+   int             poolsize = (int)segment.poolsize;
+
+   // All strings in the pool are null-terminated, so every offset into
+   // the pool is valid if the pool ends in a null.
+   if ((poolsize > 0) && (source[poolsize-1] != '\0')) {
+      return 0;
+   }
+
+   // check the table sizes declared by the lines:
+   long long fieldsum  = 0;
+   long long idsum     = 0;
+   long long interpsum = 0;
+   long long dotsum    = 0;
+   for (i=0; i<segment.linecount; i++) {
+      if ((lines[i].fieldcount < 0) || (lines[i].idcount < 0) ||
+            (lines[i].interpcount < 0) || (lines[i].dotcount < 0)) {
+         return 0;
+      }
+      if (!inPool(lines[i].text, poolsize)) {
+         return 0;
+      }
+      fieldsum  += lines[i].fieldcount;
+      idsum     += lines[i].idcount;
+      interpsum += lines[i].interpcount;
+      dotsum    += lines[i].dotcount;
+   }
+   if ((fieldsum != segment.fieldcount) || (idsum != segment.idcount) ||
+         (interpsum != segment.interpcount) || (dotsum != segment.dotcount)) {
+      return 0;
+   }
+   for (i=0; i<segment.fieldcount; i++) {
+      if (!inPool(fields[i], poolsize)) {
+         return 0;
+      }
+   }
+   for (i=0; i<segment.idcount; i++) {
+      if (!inPool(ids[i], poolsize)) {
+         return 0;
+      }
+   }
+   for (i=0; i<segment.trackcount; i++) {
+      if (!inPool(tracks[i], poolsize)) {
+         return 0;
+      }
+   }
+   if (segment.filename != HUMC_SOURCE) {
+      if (!inPool(segment.filename, poolsize)) {
+         return 0;
+      }
+   }
+   if (!inPool(segment.rhythmbase, poolsize)) {
+      return 0;
+   }
+
+   // look up the exclusive interpretation numbers for this program:
+   vector<int> values(segment.namecount);
+   const char* name;
+   for (i=0; i<segment.namecount; i++) {
+      if (names[2*i+1] < 0) {
+         values[i] = names[2*i];
+         continue;
+      }
+      if (!inPool(names[2*i+1], poolsize)) {
+         return 0;
+      }
+      name = source + names[2*i+1];
+      values[i] = Convert::exint.getValue(name);
+      if ((values[i] == E_unknown) || (values[i] == E_UNKNOWN_EXINT)) {
+         Convert::exint.add(name);
+         values[i] = Convert::exint.getValue(name);
+      }
+   }
+   for (i=0; i<segment.interpcount; i++) {
+      if ((interps[i] < 0) || (interps[i] >= segment.namecount)) {
+         return 0;
+      }
+   }
+
+   // a null token refers to no line (-1, -1) or to a field of a line:
+   int dotline;
+   int dotspine;
+   for (i=0; i<segment.dotcount; i++) {
+      dotline  = dots[2*i];
+      dotspine = dots[2*i+1];
+      if ((dotline == -1) && (dotspine == -1)) {
+         continue;
+      }
+      if ((dotline < 0) || (dotline >= segment.linecount)) {
+         return 0;
+      }
+      if ((dotspine < 0) || (dotspine >= lines[dotline].fieldcount)) {
+         return 0;
+      }
+   }
+
+   // everything has been checked, so fill in the HumdrumFile:
+   infile.clear();
+   char* pool = infile.arena.allocate(poolsize);
+   memcpy(pool, source, poolsize);
+
+   infile.records.setSize(segment.linecount);
+   HumdrumRecord* record;
+   for (i=0; i<segment.linecount; i++) {
+      const HumcLine& line = lines[i];
+      record = new HumdrumRecord(&infile.arena, pool + line.text);
+      record->type         = line.type;
+      record->lineno       = line.lineno;
+      record->spinewidth   = line.spinewidth;
+      record->duration     = line.duration;
+      record->meterloc     = line.meterloc;
+      record->absloc       = line.absloc;
+      loadRational(record->durationR, line.durationR);
+      loadRational(record->meterlocR, line.meterlocR);
+      loadRational(record->abslocR,   line.abslocR);
+
+      record->recordFields.setSize(line.fieldcount);
+      for (j=0; j<line.fieldcount; j++) {
+         record->recordFields[j] = pool + fields[j];
+      }
+      fields += line.fieldcount;
+
+      record->spineids.resize(line.idcount);
+      for (j=0; j<line.idcount; j++) {
+         record->spineids[j] = pool + ids[j];
+      }
+      ids += line.idcount;
+
+      record->interpretation.setSize(line.interpcount);
+      for (j=0; j<line.interpcount; j++) {
+         record->interpretation[j] = values[interps[j]];
+      }
+      interps += line.interpcount;
+
+      record->dotline.setSize(line.dotcount);
+      record->dotspine.setSize(line.dotcount);
+      for (j=0; j<line.dotcount; j++) {
+         record->dotline[j]  = dots[2*j];
+         record->dotspine[j] = dots[2*j+1];
+      }
+      dots += 2 * line.dotcount;
+
+      infile.records[i] = record;
+   }
+   infile.setRecordOwners();
+
+   infile.maxtracks = segment.maxtracks;
+   infile.segmentLevel = segment.segmentlevel;
+   if (segment.filename == HUMC_SOURCE) {
+      infile.fileName = sourcename;
+   } else {
+      infile.fileName = pool + segment.filename;
+   }
+   infile.trackexinterp.resize(segment.trackcount);
+   for (i=0; i<segment.trackcount; i++) {
+      infile.trackexinterp[i] = pool + tracks[i];
+   }
+
+   infile.localrhythms.setSize(segment.rhythmcount);
+   for (i=0; i<segment.rhythmcount; i++) {
+      infile.localrhythms[i] = RationalNumber(rhythms[2*i], rhythms[2*i+1]);
+   }
+   infile.rhythmcheck = segment.rhythmcheck;
+   infile.rhythmbase  = pool + segment.rhythmbase;
+   infile.minrhythm   = segment.minrhythm;
+   infile.minrhythmR  = RationalNumber(segment.minrhythmR[0],
+         segment.minrhythmR[1]);
+   infile.pickupdur   = RationalNumber(segment.pickupdur[0],
+         segment.pickupdur[1]);
+
+   if (infile.rhythmcheck) {
+      // Keep the stored rhythm analysis when the program asks for it.
+      // There are no rhythm checkpoints, so an incremental analysis
+      // after editing the file will analyze the whole file again.
+      // The note table is not stored, so extract it from the analysis.
+      infile.notetable.build(infile);
+      infile.notetableQ = 1;
+      infile.keepRhythmAnalysis();
+      infile.clearDirty();
+   } else {
+      infile.markDirty(0, segment.linecount - 1);
+   }
+
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// helper functions
+//
+
+//////////////////////////////
+//
+// appendBytes -- add raw data to the end of the output.
+//
+
+static void appendBytes(string& output, const void* data, size_t size) {
+   if (size > 0) {
+      output.append((const char*)data, size);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// alignOutput -- pad the output with nulls to the next 8-byte boundary.
+//
+
+static void alignOutput(string& output) {
+   output.resize(alignPosition(output.size()), '\0');
+}
+
+
+
+//////////////////////////////
+//
+// alignPosition -- round up to the next 8-byte boundary.
+//
+
+static size_t alignPosition(size_t position) {
+   return (position + 7) & ~(size_t)7;
+}
+
+
+
+//////////////////////////////
+//
+// addPoolString -- add a null-terminated string to the string pool and
+//     return its offset.  The second form only stores each distinct
+//     string once.
+//
+
+static int addPoolString(string& pool, const char* text) {
+   int offset = (int)pool.size();
+   if (text != NULL) {
+      pool.append(text);
+   }
+   pool.push_back('\0');
+   return offset;
+}
+
+
+static int addPoolString(string& pool, map<string, int>& shared,
+      const string& text) {
+   map<string, int>::iterator it = shared.find(text);
+   if (it != shared.end()) {
+      return it->second;
+   }
+   int offset = addPoolString(pool, text.c_str());
+   shared[text] = offset;
+   return offset;
+}
+
+
+
+//////////////////////////////
+//
+// storeRational -- store the numerator and denominator of a rational
+//     number (the denominator is 0 for invalid numbers).
+//
+
+static void storeRational(long long* output, const RationalNumber64& r) {
+   output[0] = r.getNumerator();
+   output[1] = r.getDenominator();
+}
+
+
+
+//////////////////////////////
+//
+// loadRational -- restore a rational number written by storeRational().
+//
+
+static void loadRational(RationalNumber64& r, const long long* input) {
+   if (input[1] == 0) {
+      r.setInvalid();
+   } else {
+      r.setValue(input[0], input[1]);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// getSourceInfo -- return the size and modification time (in nanoseconds)
+//     of a file.
+//
+
+static int getSourceInfo(const string& filename, long long& size,
+      long long& mtime) {
+   struct stat info;
+   if (stat(filename.c_str(), &info) != 0) {
+      return 0;
+   }
+   size  = (long long)info.st_size;
+   mtime = getModTime(info);
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// getModTime -- return the modification time of a file in nanoseconds.
+//
+
+static long long getModTime(const struct stat& info) {
+   #ifdef __APPLE__
+      return (long long)info.st_mtimespec.tv_sec * 1000000000LL +
+            info.st_mtimespec.tv_nsec;
+   #else
+      return (long long)info.st_mtim.tv_sec * 1000000000LL +
+            info.st_mtim.tv_nsec;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// inPool -- returns true if offset is the position of a string in a
+//     pool of the given size.
+//
+
+static inline int inPool(int offset, int poolsize) {
+   return (offset >= 0) && (offset < poolsize);
+}
+
+
+
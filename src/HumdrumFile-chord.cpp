@@ -4,6 +4,8 @@
 // Creation Date: Mon May 14 12:26:45 PDT 2001
 // Last Modified: Tue May 15 11:23:21 PDT 2001
 // Last Modified: Sun Mar 24 12:10:00 PST 2002 (small changes for visual c++)
+// Last Modified: Sat Oct 17 19:25:32 PDT 2026 (precalculate note weights)
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 (removed static buffer)
 // Filename:      ...sig/src/sigInfo/HumdrumFile-chord.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile.cpp
 // Syntax:        C++ 
@@ -135,13 +137,27 @@ int HumdrumFile::measureChordRoot1(Array<double>& scores,
 // cout << "Notelist size is: " << notelist.getSize() << endl;
 // cout << "Scores size is: " << scores.getSize() << endl;
 
+   // interval and note weights do not depend on the root:
+   double intervalweight[40];
+   for (p=0; p<40; p++) {
+      intervalweight[p] = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
+   }
+   Array<double> durweight(count);
+   Array<double> levweight(count);
+   Array<int>    pitch(count);
+   for (j=0; j<count; j++) {
+      durweight[j] = delta + log(notelist[j].getDur())/log(2.0);
+      levweight[j] = lambda + log(notelist[j].getLevel())/log(2.0);
+      pitch[j]     = notelist[j].getPitch() - 2 + 40;
+   }
+
    for (i=0; i<40; i++) {
       asum = bsum = 0.0;
       for (j=0; j<count; j++) {
-         p = (notelist[j].getPitch() - i - 2 + 40) % 40;
-         I = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
-         asum += I * (delta + log(notelist[j].getDur())/log(2.0));
-         bsum += I * (lambda + log(notelist[j].getLevel())/log(2.0));
+         p = (pitch[j] - i) % 40;
+         I = intervalweight[p];
+         asum += I * durweight[j];
+         bsum += I * levweight[j];
       }
       scores[i] = sqrt(asum * asum + bsum * bsum)/count;
       if (scores[i] < scores[max]) {
@@ -224,13 +240,28 @@ int HumdrumFile::measureChordRoot2(Array<double>& scores,
 
 // cout << "Notelist size is: " << notelist.getSize() << endl;
 // cout << "Scores size is: " << scores.getSize() << endl;
+
+   // interval and note weights do not depend on the root:
+   double intervalweight[40];
+   for (p=0; p<40; p++) {
+      intervalweight[p] = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
+   }
+   Array<double> durweight(count);
+   Array<double> levweight(count);
+   Array<int>    pitch(count);
+   for (j=0; j<count; j++) {
+      durweight[j] = offset + log(notelist[j].getDur())/log(2.0);
+      levweight[j] = offset + log(notelist[j].getLevel())/log(2.0);
+      pitch[j]     = notelist[j].getPitch() - 2 + 40;
+   }
+
    for (i=0; i<40; i++) {
       asum = bsum = 0.0;
       for (j=0; j<count; j++) {
-         p = (notelist[j].getPitch() - 2 - i + 40) % 40;
-         I = sqrt(alpha * alpha * vx[p] * vx[p] + vy[p] * vy[p]);
-         asum += I * delta * (offset + log(notelist[j].getDur())/log(2.0));
-         bsum += I * lambda * (offset + log(notelist[j].getLevel())/log(2.0));
+         p = (pitch[j] - i) % 40;
+         I = intervalweight[p];
+         asum += I * delta * durweight[j];
+         bsum += I * lambda * levweight[j];
       }
       scores[i] = (asum + bsum)/count;
       if (scores[i] < scores[max]) {
@@ -382,7 +413,7 @@ void HumdrumFile::generateNoteList(NoteListArray& notelist,
    int i, j, k;
    int ii, jj;
    int ccount;
-   static char buffer[1024] = {0};
+   char buffer[1024] = {0};
    int pitch;
    int token;
    int spine;
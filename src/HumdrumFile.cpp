@@ -45,6 +45,17 @@
 // Last Modified: Wed Feb  2 17:51:57 PST 2011 Partial fix for breve beat
 // Last Modified: Tue Apr 16 23:18:16 PDT 2013 Added attackQ to gBase12PchLst
 // Last Modified: Mon Sep 16 20:26:17 PDT 2013 Added getMeasureNumber()
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 Added swap(), keepRhythmAnalysis()
+// Last Modified: Sat Oct 17 18:33:52 PDT 2026 getNoteArray() uses reserve()
+// Last Modified: Sat Oct 17 18:47:41 PDT 2026 Added incremental rhythm analysis
+// Last Modified: Sat Oct 17 19:04:14 PDT 2026 Added getNoteTable()
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 thread-safe reading functions
+// Last Modified: Sat Oct 17 21:23:05 PDT 2026 getTied*() use the note table
+// Last Modified: Sat Oct 17 22:47:20 PDT 2026 Limit incremental rhythm analysis
+// Last Modified: Sat Oct 17 22:53:35 PDT 2026 64-bit duration tracers
+// Last Modified: Sat Oct 17 23:19:37 PDT 2026 note table built by analyzeRhythm
+// Last Modified: Sat Oct 17 23:25:24 PDT 2026 getTied*() do not analyze
+// Last Modified: Sun Oct 18 00:16:12 PDT 2026 getTied*() scan without table
 // Filename:      ...sig/src/sigInfo/HumdrumFile.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFile.cpp
 // Syntax:        C++ 
@@ -65,6 +76,8 @@
 #include <cctype>
 #include <math.h>
 
+#include <utility>
+
 #ifndef OLDCPP
    #include <fstream>
    #include <iostream>
@@ -90,6 +103,114 @@
 
 
 
+///////////////////////////////////////////////////////////////////////////
+//
+// RhythmCheckpoint class functions --
+//
+
+
+
+//////////////////////////////
+//
+// RhythmCheckpoint::RhythmCheckpoint --
+//
+
+RhythmCheckpoint::RhythmCheckpoint(void) {
+   line = 0;
+   absbeat = 0;
+   ignore.setSize(0);
+   init = 0;
+   datainit = 0;
+   foundstart = 0;
+   measurebeats = 0;
+   timesig = 0;
+   rhythms.setSize(0);
+   meterdur = 0;
+   chained = 0;
+   reach = 0;
+   maxreach = 0;
+}
+
+
+RhythmCheckpoint::RhythmCheckpoint(const RhythmCheckpoint& aPoint) {
+   ignore.setSize(0);
+   rhythms.setSize(0);
+   *this = aPoint;
+}
+
+
+
+//////////////////////////////
+//
+// RhythmCheckpoint::operator= --
+//
+
+RhythmCheckpoint& RhythmCheckpoint::operator=(const RhythmCheckpoint& aPoint) {
+   if (&aPoint == this) {
+      return *this;
+   }
+   line          = aPoint.line;
+   absbeat       = aPoint.absbeat;
+   lastdurations = aPoint.lastdurations;
+   runningstatus = aPoint.runningstatus;
+   ignore        = aPoint.ignore;
+   init          = aPoint.init;
+   datainit      = aPoint.datainit;
+   foundstart    = aPoint.foundstart;
+   measurebeats  = aPoint.measurebeats;
+   timesig       = aPoint.timesig;
+   rhythms       = aPoint.rhythms;
+   meterdur      = aPoint.meterdur;
+   chained       = aPoint.chained;
+   reach         = aPoint.reach;
+   maxreach      = aPoint.maxreach;
+   return *this;
+}
+
+
+
+//////////////////////////////
+//
+// RhythmCheckpoint::sameState -- returns true if the analysis state
+//     (not including the absolute beat position) is the same.
+//
+
+int RhythmCheckpoint::sameState(const RhythmCheckpoint& aPoint) const {
+   if ((init != aPoint.init) || (datainit != aPoint.datainit) ||
+         (foundstart != aPoint.foundstart) ||
+         (measurebeats != aPoint.measurebeats) ||
+         (timesig != aPoint.timesig)) {
+      return 0;
+   }
+   if ((lastdurations.getSize() != aPoint.lastdurations.getSize()) ||
+       (runningstatus.getSize() != aPoint.runningstatus.getSize()) ||
+       (ignore.getSize() != aPoint.ignore.getSize())) {
+      return 0;
+   }
+   int i;
+   for (i=0; i<lastdurations.getSize(); i++) {
+      if (lastdurations[i] != aPoint.lastdurations[i]) {
+         return 0;
+      }
+   }
+   for (i=0; i<runningstatus.getSize(); i++) {
+      if (runningstatus[i] != aPoint.runningstatus[i]) {
+         return 0;
+      }
+   }
+   for (i=0; i<ignore.getSize(); i++) {
+      if (ignore[i] != aPoint.ignore[i]) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
 //////////////////////////////
 //
 // HumdrumFile::HumdrumFile --
@@ -101,6 +222,8 @@ HumdrumFile::HumdrumFile(void) : HumdrumFileBasic() {
    minrhythmR = 0;
    pickupdur = -1;
    localrhythms.setSize(0);
+   keeprhythmQ = 0;
+   notetableQ = 0;
 }
 
 
@@ -111,6 +234,8 @@ HumdrumFile::HumdrumFile(const HumdrumFile& aHumdrumFile) :
    minrhythmR = 0;
    pickupdur = -1;
    localrhythms.setSize(0);
+   keeprhythmQ = 0;
+   notetableQ = 0;
 }
 
 HumdrumFile::HumdrumFile(const HumdrumFileBasic& aHumdrumFile) :
@@ -120,6 +245,8 @@ HumdrumFile::HumdrumFile(const HumdrumFileBasic& aHumdrumFile) :
    minrhythmR = 0;
    pickupdur = -1;
    localrhythms.setSize(0);
+   keeprhythmQ = 0;
+   notetableQ = 0;
 }
 
 
@@ -129,6 +256,8 @@ HumdrumFile::HumdrumFile(const char* filename) : HumdrumFileBasic(filename) {
    minrhythmR = 0;
    pickupdur = -1;
    localrhythms.setSize(0);
+   keeprhythmQ = 0;
+   notetableQ = 0;
 }
 
 
@@ -146,13 +275,75 @@ HumdrumFile::~HumdrumFile() {
 
 //////////////////////////////
 //
-// HumdrumFile::analyzeRhythm --
-//     default values: base = "", debug = 0
-//
+// HumdrumFile::analyzeRhythm --  If incremental is true and the file
+//     was analyzed before with the same base, then only the lines from
+//     the barline before the first changed line (see markDirty()) up to
+//     the next barline where the analysis state matches the previous
+//     analysis are processed again, along with any incomplete measures
+//     linked to them.  The absolute beats of any following lines are
+//     shifted if the duration of the changed region is different.
+//     Changes before the second barline of the file cause a complete
+//     analysis, since they can change the pickup beats.
+//     default values: base = "", debug = 0, incremental = 0
+//
+
+void HumdrumFile::analyzeRhythm(const char* base, int debug, int incremental) {
+   int firstline = getDirtyStart();
+   int lastline  = getDirtyEnd();
+
+   // Rebuild the text of any changed records now, so that getLine()
+   // does not modify the records while the file is read by threads.
+   // Only lines which were changed can have text to rebuild.
+   if (firstline >= 0) {
+      for (int i=firstline; (i<=lastline) && (i<getNumLines()); i++) {
+         (*this)[i].getLine();
+      }
+   }
 
-void HumdrumFile::analyzeRhythm(const char* base, int debug) {
-   privateRhythmAnalysis(base, debug);
+   if (keeprhythmQ && rhythmcheck && !debug && (rhythmbase == base)) {
+      // analysis was already done by HumdrumStream prefetching (or
+      // was loaded from a HumdrumCache file)
+      keeprhythmQ = 0;
+   } else if (incremental && !debug && rhythmcheck && (rhythmbase == base) && 
+         !rhythmpoints.empty() && (getNumLines() >= (int)rawbeats.size())) {
+      keeprhythmQ = 0;
+      if (firstline >= 0) {
+         if (firstline >= (int)rawbeats.size()) {
+            // The beat of an appended line is set by the line before it.
+            firstline = (int)rawbeats.size() - 1;
+         }
+         privateRhythmAnalysis(base, debug, firstline, lastline);
+      }
+   } else {
+      keeprhythmQ = 0;
+      privateRhythmAnalysis(base, debug);
+   }
+   clearDirty();
    rhythmcheck = 1;
+   rhythmbase = base;
+
+   // Extract the note table here rather than when it is first needed,
+   // so that reading it (and the getTied*() functions) never changes
+   // the file.
+   if (!notetableQ) {
+      notetable.build(*this);
+      notetableQ = 1;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::keepRhythmAnalysis -- The next call to analyzeRhythm() will
+//     not redo the analysis if it uses the same base as the current
+//     analysis.  Used when the analysis is done in advance by a
+//     HumdrumStream worker thread, so that programs do not need to
+//     know whether or not their input was prefetched.
+//
+
+void HumdrumFile::keepRhythmAnalysis(void) {
+   keeprhythmQ = rhythmcheck;
 }
 
 
@@ -316,6 +507,12 @@ void HumdrumFile::appendLine(const char* aLine) {
 }
 
 
+void HumdrumFile::appendLine(const char* aLine, int length) {
+   HumdrumFileBasic::appendLine(aLine, length);
+   rhythmcheck = 0;
+}
+
+
 void HumdrumFile::appendLine(HumdrumRecord& aRecord) {
    HumdrumFileBasic::appendLine(aRecord);
    rhythmcheck = 0;
@@ -1391,6 +1588,10 @@ void HumdrumFile::clear(void) {
    rhythmcheck = 0;
    pickupdur = -1;
    localrhythms.setSize(0);
+   keeprhythmQ = 0;
+   notetable.clear();
+   notetableQ = 0;
+   clearRhythmCheckpoints();
 }
 
 
@@ -1420,12 +1621,18 @@ int HumdrumFile::getMeasureNumber(int line) {
       // to return the measure number of the previous barline.
       return -1;
    }
-   PerlRegularExpression pre;
-   int measurenumber = -1;
+   const char* ptr;
    for (j=0; j<infile[line].getFieldCount(); j++) {
-      if (pre.search(infile[line][j], "^=[^\\d]*(\\d+)", "")) {
-         measurenumber = atoi(pre.getSubmatch(1));
-         return measurenumber;
+      ptr = infile[line][j];
+      if (ptr[0] != '=') {
+         continue;
+      }
+      // the first number after the "=":
+      while ((*ptr != '\0') && !std::isdigit((unsigned char)*ptr)) {
+         ptr++;
+      }
+      if (*ptr != '\0') {
+         return atoi(ptr);
       }
    }
 
@@ -1888,10 +2095,10 @@ void HumdrumFile::getNoteArray(Array<double>& absbeat,
    }
 
    // estimate the largest amount necessary:
-   absbeat.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-   pitches.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-   durations.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-   levels.setSize(score.getNumLines() * score.getMaxTracks() * 10);
+   absbeat.reserve(score.getNumLines() * score.getMaxTracks() * 10);
+   pitches.reserve(score.getNumLines() * score.getMaxTracks() * 10);
+   durations.reserve(score.getNumLines() * score.getMaxTracks() * 10);
+   levels.reserve(score.getNumLines() * score.getMaxTracks() * 10);
 
    absbeat.setGrowth(score.getNumLines());
    pitches.setGrowth(score.getNumLines());
@@ -1915,7 +2122,7 @@ void HumdrumFile::getNoteArray(Array<double>& absbeat,
    int i, j, k;
    int ii, jj;
    int ccount;
-   static char buffer[1024] = {0};
+   char buffer[1024] = {0};
    int pitch;
    double beatvalue;
    double duration;
@@ -2035,10 +2242,10 @@ void HumdrumFile::getNoteArray2(Array<double>& absbeat,
    }
 
    // estimate the largest amount necessary:
-   absbeat.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-   pitches.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-   durations.setSize(score.getNumLines() * score.getMaxTracks() * 10);
-   levels.setSize(score.getNumLines() * score.getMaxTracks() * 10);
+   absbeat.reserve(score.getNumLines() * score.getMaxTracks() * 10);
+   pitches.reserve(score.getNumLines() * score.getMaxTracks() * 10);
+   durations.reserve(score.getNumLines() * score.getMaxTracks() * 10);
+   levels.reserve(score.getNumLines() * score.getMaxTracks() * 10);
    lastpitches.setSize(score.getNumLines() * score.getMaxTracks() * 10);
    nextpitches.setSize(score.getNumLines() * score.getMaxTracks() * 10);
 
@@ -2077,7 +2284,7 @@ void HumdrumFile::getNoteArray2(Array<double>& absbeat,
    int i, j, k;
    int ii, jj;
    int ccount;
-   static char buffer[1024] = {0};
+   char buffer[1024] = {0};
    int pitch;
    double beatvalue;
    double duration;
@@ -2218,12 +2425,28 @@ void HumdrumFile::convertKernStringToArray(Array<int>& array,
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::getNoteTable -- return a table of all notes in the
+//     **kern spines.  The table is extracted by analyzeRhythm(), so it
+//     is empty if the rhythm has not been analyzed, and does not show
+//     changes made to the file after the last analysis.
+//
+
+const HumdrumNoteTable& HumdrumFile::getNoteTable(void) const {
+   return notetable;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::getTiedDuration -- returns the total duration of
 //   a tied note if the first note is the beginning of a tie.
 //   Returns the duration of the note if not a tied note, or
-//   zero if the specified field is not a note.
+//   zero if the specified field is not a note.  The ties are looked
+//   up in the note table (see getNoteTable()) if it is current, and
+//   otherwise found by searching through the tokens of the file.
 //     default value: token = 0;
 //
 
@@ -2236,6 +2459,137 @@ double HumdrumFile::getTiedDuration(int linenum, int field, int token) {
 
 RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field, 
       int token) {
+   const HumdrumNoteTable* table = getTieTable();
+   if (table == NULL) {
+      return scanTiedDurationR(linenum, field, token);
+   }
+   const HumdrumNoteTable& notes = *table;
+   int index = notes.find(linenum, field, token);
+   if (index < 0) {
+      // not a note in a **kern spine
+      char buffer[128] = {0};
+      (*this)[linenum].getToken(buffer, field, token);
+      return Convert::kernToDurationR(buffer);
+   }
+   if (notes.isAttack(index) && (notes.tie[index] == index)) {
+      return notes.tiedduration[index].getRationalNumber();
+   }
+   return notes.duration[index].getRationalNumber();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTotalTiedDuration -- return the duration of a tied
+// group of notes, even if the the current note is not the first
+// note in the tied group.
+//
+
+RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field, 
+      int token) {
+   const HumdrumNoteTable* table = getTieTable();
+   if (table == NULL) {
+      return scanTotalTiedDurationR(linenum, field, token);
+   }
+   const HumdrumNoteTable& notes = *table;
+   int index = notes.find(linenum, field, token);
+   if (index < 0) {
+      return getTiedDurationR(linenum, field, token);
+   }
+   return notes.tiedduration[index].getRationalNumber();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTiedStartLocation -- returns the location of the
+//     first note of the tie which contains the given note (which can
+//     be a note in a chord).  Returns the given location if the note
+//     is not tied or is not a note.
+//
+
+void HumdrumFile::getTiedStartLocation(int linenum, int field, int token, 
+      int& tline, int& tcol, int& ttok) {
+   const HumdrumNoteTable* table = getTieTable();
+   if (table == NULL) {
+      scanTiedStartLocation(linenum, field, token, tline, tcol, ttok);
+      return;
+   }
+   const HumdrumNoteTable& notes = *table;
+   int index = notes.find(linenum, field, token);
+   if (index < 0) {
+      tline = linenum; 
+      tcol  = field;
+      ttok  = token;
+      return;
+   }
+   int head = notes.tie[index];
+   tline = notes.line[head];
+   tcol  = notes.field[head];
+   ttok  = notes.subtoken[head];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTiedStartBeat -- returns the absolute beat of the
+//     first note of the tie which contains the given note.
+//     default value: token = 0;
+//
+
+double HumdrumFile::getTiedStartBeat(int linenum, int field, int token) {
+   RationalNumber anum;
+   anum = getTiedStartBeatR(linenum, field, token);
+   return anum.getFloat();
+}
+
+
+
+RationalNumber HumdrumFile::getTiedStartBeatR(int linenum, int field, 
+      int token) {
+   const HumdrumNoteTable* table = getTieTable();
+   if (table == NULL) {
+      return scanTiedStartBeatR(linenum, field, token);
+   }
+   const HumdrumNoteTable& notes = *table;
+   int index = notes.find(linenum, field, token);
+   if (index < 0) {
+      return (*this)[linenum].getAbsBeatR();
+   }
+   return notes.onset[notes.tie[index]].getRationalNumber();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getTieTable -- return the note table for the getTied*()
+//     functions, or NULL if the rhythm has not been analyzed or the
+//     file was changed after the last analysis (see markDirty()), in
+//     which case the ties are found with the scanTied*() functions.
+//
+
+const HumdrumNoteTable* HumdrumFile::getTieTable(void) const {
+   if (!notetableQ || (dirtystart >= 0)) {
+      return NULL;
+   }
+   return &notetable;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::scanTiedDurationR -- getTiedDurationR() for files
+//     without a current note table: search forward through the tokens
+//     of the spine for the end of the tie.
+//
+
+RationalNumber HumdrumFile::scanTiedDurationR(int linenum, int field, 
+      int token) {
    HumdrumFile& file = *this;
    int length = file.getNumLines();
    char buffer[128] = {0};
@@ -2298,13 +2652,11 @@ RationalNumber HumdrumFile::getTiedDurationR(int linenum, int field,
 
 //////////////////////////////
 //
-// HumdrumFile::getTotalTiedDuration -- return the duration of a tied
-// group of notes, even if the the current note is not the first
-// note in the tied group (i.e., go fine the first note in the
-// group and then run the getTiedDurationR() function
+// HumdrumFile::scanTotalTiedDurationR -- getTotalTiedDurationR() for
+//     files without a current note table.
 //
 
-RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field, 
+RationalNumber HumdrumFile::scanTotalTiedDurationR(int linenum, int field, 
       int token) {
    char buffer[128] = {0};
    (*this)[linenum].getToken(buffer, field, token);
@@ -2313,14 +2665,14 @@ RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field,
       int tline;
       int tcol;
       int ttok;
-      getTiedStartLocation(linenum, field, token, tline, tcol, ttok);
+      scanTiedStartLocation(linenum, field, token, tline, tcol, ttok);
       if ((tline < 0) || (tcol < 0) || (ttok < 0)) {
-         return getTiedDurationR(linenum, field, token);
+         return scanTiedDurationR(linenum, field, token);
       } else{
-         return getTiedDurationR(tline, tcol, ttok);
+         return scanTiedDurationR(tline, tcol, ttok);
       }
    } else {
-      return getTiedDurationR(linenum, field, token);
+      return scanTiedDurationR(linenum, field, token);
    }
 }
 
@@ -2328,10 +2680,13 @@ RationalNumber HumdrumFile::getTotalTiedDurationR(int linenum, int field,
 
 //////////////////////////////
 //
-// HumdrumFile::getTiedStartLocation --  Need to generalize to chords.
+// HumdrumFile::scanTiedStartLocation -- getTiedStartLocation() for files
+//     without a current note table: search backward through the tokens
+//     of the spine for the start of the tie.  Notes in chords after the
+//     first one are not handled.
 //
 
-void HumdrumFile::getTiedStartLocation(int linenum, int field, int token, 
+void HumdrumFile::scanTiedStartLocation(int linenum, int field, int token, 
       int& tline, int& tcol, int& ttok) {
 
    RationalNumber startbeat = -1;
@@ -2407,77 +2762,21 @@ void HumdrumFile::getTiedStartLocation(int linenum, int field, int token,
 
 //////////////////////////////
 //
-// HumdrumFile::getTiedStartBeat --
-//     default value: token = 0;
+// HumdrumFile::scanTiedStartBeatR -- getTiedStartBeatR() for files
+//     without a current note table (the rhythm must still be analyzed
+//     for the beat to be known).
 //
 
-double HumdrumFile::getTiedStartBeat(int linenum, int field, int token) {
-   RationalNumber anum;
-   anum = getTiedStartBeatR(linenum, field, token);
-   return anum.getFloat();
-}
-
-
-
-RationalNumber HumdrumFile::getTiedStartBeatR(int linenum, int field, 
+RationalNumber HumdrumFile::scanTiedStartBeatR(int linenum, int field, 
       int token) {
-   RationalNumber startbeat = -1;
-   HumdrumFile& file = *this;
-   int length = file.getNumLines();
-   char buffer[128] = {0};
-   RationalNumber duration = 0;   // total duration of tied notes.
-   int done = 0;                  // true when end of tied note is found
-   int startpitch = 0;            // starting pitch of the tie
-   int matchpitch = 0;            // current matching pitch of the tie
-   
-   file[linenum].getToken(buffer, field, token);
-   // should be == NULL and not != NULL? [20110218]
-   if (strchr(buffer, '[') == NULL) {
-      duration = Convert::kernToDurationR(buffer);
-      // allow for enharmonic ties:
-      startpitch = Convert::kernToMidiNoteNumber(buffer);
-   } else {
-      startbeat = file[linenum].getAbsBeatR();
-      return startbeat;
+   int tline;
+   int tcol;
+   int ttok;
+   scanTiedStartLocation(linenum, field, token, tline, tcol, ttok);
+   if (tline < 0) {
+      tline = linenum;
    }
-
-   int m;
-   int ptrack = file[linenum].getPrimaryTrack(field);
-   int currentLine = linenum + 1;
-   while (!done && currentLine < length) {
-      if (file[currentLine].getType() != E_humrec_data) {
-         currentLine++;
-         continue;
-      }
-
-      for (m=0; m<file[currentLine].getFieldCount(); m++) {
-         if (ptrack != file[currentLine].getPrimaryTrack(m)) {
-            continue;
-         }
-
-         if (strchr(file[currentLine][m], '_')) {
-            matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-            if (startpitch == matchpitch) {
-               duration += Convert::kernToDurationR(file[currentLine][m]);
-            } else {
-               done = 1;
-            }
-            break;
-         } else if (strchr(file[currentLine][m], ']')) {
-            matchpitch = Convert::kernToMidiNoteNumber(file[currentLine][m]);
-            if (startpitch == matchpitch) {
-               duration += Convert::kernToDurationR(file[currentLine][m]);
-               done = 1;
-            } else {
-               done = 1;
-            }
-            break;
-         }
-      }
-      currentLine++;
-   }
-
-   return startbeat;
+   return (*this)[tline].getAbsBeatR();
 }
 
 
@@ -2520,16 +2819,26 @@ HumdrumFile& HumdrumFile::operator=(const HumdrumFile& aFile) {
       delete records[i];
       records[i] = NULL;
    }
+   arena.clear();
 
    records.setSize(aFile.records.getSize());
    for (i=0; i<aFile.records.getSize(); i++) {
-      records[i] = new HumdrumRecord;
+      records[i] = newRecord();
       *(records[i]) = *(aFile.records[i]);
    }
+   setRecordOwners();
 
    rhythmcheck = aFile.rhythmcheck;
+   rhythmbase = aFile.rhythmbase;
+   keeprhythmQ = 0;
    maxtracks = aFile.maxtracks;
    localrhythms = aFile.localrhythms;
+   rhythmpoints = aFile.rhythmpoints;
+   rawbeats = aFile.rawbeats;
+   dirtystart = aFile.dirtystart;
+   dirtyend = aFile.dirtyend;
+   notetable = aFile.notetable;
+   notetableQ = aFile.notetableQ;
 
    // Store the filename. Also should store the segment number
    // and maybe other stuff (see HumdrumFileBasic.h for newer
@@ -2541,6 +2850,37 @@ HumdrumFile& HumdrumFile::operator=(const HumdrumFile& aFile) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::swap -- Exchange the contents of two HumdrumFiles,
+//     including the rhythm analysis, without copying any records.
+//
+
+void HumdrumFile::swap(HumdrumFile& aFile) {
+   if (&aFile == this) {
+      return;
+   }
+   HumdrumFileBasic::swap(aFile);
+
+   Array<RationalNumber> temprhythms;
+   temprhythms = localrhythms;
+   localrhythms = aFile.localrhythms;
+   aFile.localrhythms = temprhythms;
+
+   std::swap(rhythmcheck, aFile.rhythmcheck);
+   std::swap(minrhythm, aFile.minrhythm);
+   std::swap(minrhythmR, aFile.minrhythmR);
+   std::swap(pickupdur, aFile.pickupdur);
+   std::swap(keeprhythmQ, aFile.keeprhythmQ);
+   rhythmbase.swap(aFile.rhythmbase);
+   rhythmpoints.swap(aFile.rhythmpoints);
+   rawbeats.swap(aFile.rawbeats);
+   notetable.swap(aFile.notetable);
+   std::swap(notetableQ, aFile.notetableQ);
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::read -- read in a humdrum file.
@@ -2555,12 +2895,27 @@ void HumdrumFile::read(const string& filename) {
 void HumdrumFile::read(const char* filename) {
    HumdrumFileBasic::read(filename);
    rhythmcheck = 0;
+   notetable.clear();
+   notetableQ = 0;
+   clearRhythmCheckpoints();
 }
 
 
 void HumdrumFile::read(istream& inStream) {
    HumdrumFileBasic::read(inStream);
    rhythmcheck = 0;
+   notetable.clear();
+   notetableQ = 0;
+   clearRhythmCheckpoints();
+}
+
+
+void HumdrumFile::read(const char* contents, size_t length) {
+   HumdrumFileBasic::read(contents, length);
+   rhythmcheck = 0;
+   notetable.clear();
+   notetableQ = 0;
+   clearRhythmCheckpoints();
 }
 
 
@@ -2586,16 +2941,24 @@ int HumdrumFile::rhythmQ(void) {
 
 //////////////////////////////
 //
-// HumdrumFile::privateRhythmAnalysis --
-//     default value: base = "", debug = 0
+// HumdrumFile::privateRhythmAnalysis -- If firstline is not negative,
+//     then the analysis is restarted at the checkpoint before firstline,
+//     and stops at the first checkpoint after lastline which has the
+//     same analysis state as in the previous analysis.  If the checkpoint
+//     before firstline is not after the first barline, then the entire
+//     file is analyzed.
+//     default value: base = "", debug = 0, firstline = -1, lastline = -1
 //
 
-void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
+void HumdrumFile::privateRhythmAnalysis(const char* base, int debug,
+      int firstline, int lastline) {
    int init = 0;                   // marker indicating when the data starts
    int datainit = 0;               // marker indicating when the data starts
 
    minrhythm = 0;                  // keeping track of the min timebase 
    minrhythmR = 0;
+   int tableQ = notetableQ;        // note table of previous analysis
+   notetableQ = 0;                 // note onsets may change
    Array<int> rhythms;
    Array<RationalNumber> rhythmsR;
 
@@ -2609,27 +2972,21 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
 
    HumdrumFile& infile = *this;
    RationalNumber summation(0,1);  // for summing measure duration
-   RationalNumber duration;
+   RationalNumber64 duration;
    HumdrumRecord tempRecord;       // for *beat: interpretation
    // const char* slash;              // for metronome marking
    RationalNumber measureBeats(0,1);
-   // for fixing meter locations:
-
-   SigCollection<RationalNumber> meterbeats; 
-   SigCollection<RationalNumber> timebaseC;
-
-   meterbeats.setSize(getNumLines());
-   timebaseC.setSize(getNumLines());
-   meterbeats.allowGrowth(0);
-   timebaseC.allowGrowth(0);
+   RationalNumber timesig;         // time signature in first **kern spine
+   PerlRegularExpression pre;
+   PerlRegularExpression pre2;
 
    Array<int> ignore;              // for avoiding free rhythm spines
    ignore.setSize(infile.getMaxTracks());
    ignore.setAll(0);
 
    // for analyzing record durations:
-   SigCollection<RationalNumber> lastdurations;
-   SigCollection<RationalNumber> runningstatus;
+   SigCollection<RationalNumber64> lastdurations;
+   SigCollection<RationalNumber64> runningstatus;
 
    // int fixedTimebase = 0;
    RationalNumber timebase = 4;
@@ -2651,7 +3008,100 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
    int nonblank = 0;
    int foundstart = 0;
    int i;
-   for (i=0; i<infile.getNumLines(); i++) {
+
+   // For an incremental analysis, restore the state at the last
+   // checkpoint before the first changed line.  The beats of the lines
+   // from the first barline which may be linked to the changed measures
+   // (see fixIncompleteBarMeterR()) are restored to their values before
+   // the measure adjustments, which are redone for those lines.
+   vector<RhythmCheckpoint> oldpoints;
+   int oldcount = (int)rawbeats.size();
+   int oldindex = 0;
+   int startline = 0;
+   int startpoint = 0;
+   int matchline = -1;
+   int matchpoint = -1;
+   RationalNumber64 delta(0,1);    // change in duration before matchline
+   oldpoints.swap(rhythmpoints);
+   if (firstline >= 0) {
+      int k = (int)oldpoints.size() - 1;
+      while ((k > 0) && (oldpoints[k].line > firstline)) {
+         k--;
+      }
+      int firstbar = infile[oldpoints[0].line].isMeasure() ? 0 : 1;
+      if ((k <= firstbar) || 
+            (oldpoints[k].ignore.getSize() != infile.getMaxTracks())) {
+         // analyze the entire file
+         firstline = -1;
+      } else {
+         RhythmCheckpoint& restart = oldpoints[k];
+         startline     = restart.line;
+         lastdurations = restart.lastdurations;
+         runningstatus = restart.runningstatus;
+         ignore        = restart.ignore;
+         init          = restart.init;
+         datainit      = restart.datainit;
+         foundstart    = restart.foundstart;
+         measureBeats  = restart.measurebeats;
+         timesig       = restart.timesig;
+         rhythmpoints.assign(oldpoints.begin(), oldpoints.begin() + k);
+         oldindex = k + 1;
+         // include earlier measures which were linked to the changed ones
+         startpoint = k;
+         while ((startpoint > 0) && 
+               (oldpoints[startpoint-1].maxreach >= startline)) {
+            startpoint--;
+         }
+         for (i=oldpoints[startpoint].line; i<=startline; i++) {
+            infile[i].setBeatR(rawbeats[i]);
+         }
+      }
+   }
+   if ((startline == 0) && (infile.getNumLines() > 0)) {
+      // clear any beats of a previous analysis of the first line,
+      // since they are not set by the analysis of earlier lines.
+      infile[0].setAbsBeatR(0);
+      infile[0].setBeatR(0);
+   }
+   rawbeats.resize(infile.getNumLines());
+
+   RhythmCheckpoint point;
+   for (i=startline; i<infile.getNumLines(); i++) {
+      if ((i == startline) || (infile[i].getType() == E_humrec_data_measure)) {
+         point.line          = i;
+         point.absbeat       = infile[i].getAbsBeatR64();
+         point.lastdurations = lastdurations;
+         point.runningstatus = runningstatus;
+         point.ignore        = ignore;
+         point.init          = init;
+         point.datainit      = datainit;
+         point.foundstart    = foundstart;
+         point.measurebeats  = measureBeats;
+         point.timesig       = timesig;
+         point.reach         = i;
+         point.maxreach      = i;
+         if (i != startline) {
+            rhythmpoints.back().rhythms = rhythmsR;
+            rhythmpoints.back().meterdur = timesig;
+            rhythmsR.setSize(0);
+         }
+         if ((firstline >= 0) && (i > lastline) && (i < oldcount)) {
+            while ((oldindex < (int)oldpoints.size()) && 
+                  (oldpoints[oldindex].line < i)) {
+               oldindex++;
+            }
+            if ((oldindex < (int)oldpoints.size()) && 
+                  (oldpoints[oldindex].line == i) && 
+                  point.sameState(oldpoints[oldindex])) {
+               // The rest of the analysis is the same as before.
+               matchline = i;
+               matchpoint = (int)rhythmpoints.size();
+               break;
+            }
+         }
+         rhythmpoints.push_back(point);
+      }
+
       if (debug != 0) {
          cout << "processing line " << (i+1) << " of input ..." << endl;
          cout << infile[i] << endl;
@@ -2665,8 +3115,8 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
          case E_humrec_data_comment:
             infile[i].setDurationR(0,1);
             if (i+1 < infile.getNumLines()) {
-               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR());
-               infile[i+1].setBeatR(infile[i].getBeatR());
+               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR64());
+               infile[i+1].setBeatR(infile[i].getBeatR64());
             }
             if (datainit == 0) {
                infile[i].setBeatR(0,1);
@@ -2679,8 +3129,8 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
             }
             infile[i].setDurationR(0,1);
             if (i+1 < infile.getNumLines()) {
-               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR());
-               infile[i+1].setBeatR(infile[i].getBeatR());
+               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR64());
+               infile[i+1].setBeatR(infile[i].getBeatR64());
             }
             if (debug) {
                cout << "Beat position of line is " 
@@ -2692,7 +3142,6 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
                initializeTracers(lastdurations, runningstatus, infile[i]);
             } else {
                // check for time signature
-               PerlRegularExpression pre;
                if (pre.search(infile[i][0], "^\\*M(\\d+)/(\\d+)", "")) {
                   int top = atoi(pre.getSubmatch(1));
                   int bot = atoi(pre.getSubmatch(2));
@@ -2732,6 +3181,27 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
                adjustForSpinePaths(infile[i], lastdurations, runningstatus, 
                      init, datainit, ignore);
             }
+            // time signature of the first **kern spine, used for
+            // linking incomplete measures:
+            for (ii=0; ii<infile[i].getFieldCount(); ii++) {
+               if (!infile[i].isExInterp(ii, "**kern")) {
+                  continue;
+               }
+               if (pre.search(infile[i][ii], "^\\*M(\\d+)/(\\d+)")) {
+                  if (pre2.search(infile[i][ii], 
+                        "^\\*M(\\d+)/(\\d+)%(\\d+)")) {
+                     timesig  = atoi(pre2.getSubmatch(1));
+                     timesig /= atoi(pre2.getSubmatch(2));
+                     timesig *= atoi(pre2.getSubmatch(3));
+                     timesig *= 4;
+                  } else {
+                     timesig  = atoi(pre.getSubmatch(1));
+                     timesig /= atoi(pre.getSubmatch(2));
+                     timesig *= 4;
+                  }
+               }
+               break;
+            }
             //if (datainit == 0) {
             //   infile[i].setBeatR(0,1);
             //   if (debug) {
@@ -2744,7 +3214,7 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
             summation.setValue(0,1);
             infile[i].setDurationR(0,1);
             if (i+1 < infile.getNumLines()) {
-               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR());
+               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR64());
                // infile[i+1].setBeatR(summation);
                infile[i+1].setBeatR(summation + 1);
                // infile[i].setBeatR(0,1);
@@ -2775,8 +3245,8 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
             if (nonblank == 0) {
                infile[i].setDurationR(0,1);
                if (i+1 < infile.getNumLines()) {
-                  infile[i+1].setAbsBeatR(infile[i].getAbsBeatR());
-                  infile[i+1].setBeatR(infile[i].getBeatR());
+                  infile[i+1].setAbsBeatR(infile[i].getAbsBeatR64());
+                  infile[i+1].setBeatR(infile[i].getBeatR64());
                }
                break;
             }
@@ -2793,13 +3263,13 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
 
             infile[i].setDurationR(duration);
             if (datainit && i+1 < infile.getNumLines()) {
-               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR() + duration);
-               infile[i+1].setBeatR(infile[i].getBeatR() + duration);
+               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR64() + duration);
+               infile[i+1].setBeatR(infile[i].getBeatR64() + duration);
             } else if (datainit == 0) {
                datainit = 1;
-               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR() + duration);
+               infile[i+1].setAbsBeatR(infile[i].getAbsBeatR64() + duration);
                infile[i].setBeatR(1);
-               infile[i+1].setBeatR(infile[i].getBeatR() + duration);
+               infile[i+1].setBeatR(infile[i].getBeatR64() + duration);
             }
 
             break;
@@ -2808,57 +3278,59 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
             exit(1);
       }
 
-      meterbeats[i] = measureBeats;
-      timebaseC[i] = timebase;
-   }
-
-   // set the durtion of each measure (barline)
-   RationalNumber lastabs = infile[infile.getNumLines()-1].getAbsBeatR();
-   RationalNumber currentabs;
-   RationalNumber difference;
-   int barcount = 0;
-   for (i=infile.getNumLines()-1; i>=0; i--) {
-      if (!infile[i].isMeasure()) {
-         continue;
-      }
-      barcount++;
-      currentabs = infile[i].getAbsBeatR();
-      difference = lastabs - currentabs;
-      lastabs = currentabs;
-      infile[i].setBeatR(difference);
-   }
-
-   if (barcount > 0) {
-      fixIncompleteBarMeterR(meterbeats, timebaseC, base);
+      rawbeats[i] = infile[i].getBeatR64();
    }
 
-   // Fix cases where the first barline is not given in the data
-   // Currently, the measure will be labeled as 0, and the beats 
-   // will be offset from 0 rather than 1.
-   int dataline = -1;
-   int barlineindex = -1;
-   for (i=0; i<infile.getNumLines(); i++) {
-      if ((dataline == -1) && (infile[i].isData())) {
-         dataline = i;
-         continue;
-      }
-      if (infile[i].isBarline()) {
-         if (dataline >= 0) {
-            barlineindex = i;
+   if (matchline >= 0) {
+      // Keep the previous analysis of the following lines, only
+      // shifting the absolute beats by the change in duration.
+      // Barlines mark pickup measures with a negative duration, which
+      // depends on their absolute beat.
+      rawbeats[matchline] = infile[matchline].getBeatR64();
+      delta = infile[matchline].getAbsBeatR64() -
+            oldpoints[oldindex].absbeat;
+      if (delta != 0) {
+         RationalNumber64 abs;
+         RationalNumber64 beat;
+         for (i=matchline+1; i<infile.getNumLines(); i++) {
+            abs = infile[i].getAbsBeatR64() + delta;
+            infile[i].setAbsBeatR(abs);
+            if (!infile[i].isMeasure()) {
+               continue;
+            }
+            beat = infile[i].getBeatR64();
+            if (beat < 0) {
+               beat = -beat;
+            }
+            if ((abs < beat) && !abs.isZero()) {
+               beat = -beat;
+            }
+            infile[i].setBeatR(beat);
          }
-         break;
       }
+      for (i=oldindex; i<(int)oldpoints.size(); i++) {
+         rhythmpoints.push_back(oldpoints[i]);
+         rhythmpoints.back().absbeat += delta;
+      }
+   } else {
+      rhythmpoints.back().rhythms = rhythmsR;
+      rhythmpoints.back().meterdur = timesig;
    }
-   if (barlineindex >= 0) {
-      if (dataline >= 0) {
-         if (infile[dataline].getBeatR() == 0) {
-            for (i=dataline; i<barlineindex; i++) {
-               infile[i].setBeatR(infile[i].getBeatR() + 1);
-            }
-         }
+
+   // collect the rhythms found between each checkpoint:
+   rhythmsR.setSize(0);
+   for (i=0; i<(int)rhythmpoints.size(); i++) {
+      for (int j=0; j<rhythmpoints[i].rhythms.getSize(); j++) {
+         addMinimumRhythm(rhythmsR, rhythmpoints[i].rhythms[j]);
       }
    }
 
+   // set the duration of each measure (barline), and link incomplete
+   // measures.
+   int endline = fixIncompleteBarMeterR(startpoint, matchpoint);
+   if (firstline < 0) {
+      fixPickupBeats(base);
+   }
 
    rhythms.setSize(rhythmsR.getSize());
    for (i=0; i<rhythms.getSize(); i++) {
@@ -2885,23 +3357,6 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
 
    // spaceEmptyLines();
 
-   // adjust the duration markers for each measure
-   RationalNumber lastbeat = (*this)[getNumLines()-1].getAbsBeatR();
-   RationalNumber curbeat(0,1);
-   for (i=getNumLines()-1; i>=0; i--) {
-      if ((*this)[i].getType() == E_humrec_data_measure) {
-         curbeat = (*this)[i].getAbsBeatR(); 
-         (*this)[i].setBeatR(lastbeat - curbeat);
-         lastbeat = curbeat;
-         // mark pickup-beats with a negative duration
-         if ((*this)[i].getAbsBeatR() < (*this)[i].getBeatR()) {
-            if (!(*this)[i].getAbsBeatR().isZero()) {
-               (*this)[i].setBeatR((*this)[i].getBeatR() * -1);
-            }
-         }
-      }
-   }
-
    // add offset of +1 if there are no barlines present in the file
    //if (measurecount == 0) {
    //   for (i=0; i<infile.getNumLines(); i++) {
@@ -2914,6 +3369,20 @@ void HumdrumFile::privateRhythmAnalysis(const char* base, int debug) {
 
    // this will eventually replace minrhythm:
    minrhythmR = getMinimumRationalRhythm(rhythmsR);
+
+   // Only the notes of the lines which were analyzed again need to be
+   // extracted again, unless an interpretation was changed (which can
+   // change the spines or the meter of the following lines).  Otherwise
+   // the table is extracted again by analyzeRhythm().
+   if ((firstline >= 0) && tableQ) {
+      for (i=firstline; (i<=lastline) && (i<infile.getNumLines()); i++) {
+         if (infile[i].isInterpretation()) {
+            return;
+         }
+      }
+      notetable.update(infile, rhythmpoints[startpoint].line, endline, delta);
+      notetableQ = 1;
+   }
 }
 
 
@@ -3141,13 +3610,13 @@ int HumdrumFile::GCD(int a, int b) {
 //
 
 void HumdrumFile::initializeTracers(
-      SigCollection<RationalNumber>& lastdurations,
-      SigCollection<RationalNumber>& runningstatus, HumdrumRecord& currRecord) {
+      SigCollection<RationalNumber64>& lastdurations,
+      SigCollection<RationalNumber64>& runningstatus, HumdrumRecord& currRecord) {
    lastdurations.allowGrowth(1);
    runningstatus.allowGrowth(1);
    lastdurations.setSize(0);
    runningstatus.setSize(0);
-   RationalNumber zero(0,1);
+   RationalNumber64 zero(0,1);
    int i;
    for (i=0; i<currRecord.getFieldCount(); i++) {
       if (currRecord.getExInterpNum(i) == E_KERN_EXINT ||
@@ -3165,141 +3634,188 @@ void HumdrumFile::initializeTracers(
 
 //////////////////////////////
 //
-// HumdrumFile::fixIncompleteBarMeterR -- resolve when incomplete bars are
-//    supposed to be the ends of measures rather than the
-//    beginnings of measures.
+// HumdrumFile::fixIncompleteBarMeterR -- Set the beat of each barline to
+//    the duration of its measure, and resolve when incomplete bars are
+//    supposed to be the ends of measures rather than the beginnings of
+//    measures.  The barlines are processed from the rhythm checkpoint
+//    startpoint to the end of the file.  If matchpoint is not negative,
+//    the analysis from that checkpoint onwards is the same as in the
+//    previous analysis, so the processing stops at the first following
+//    barline which was not linked to the previous measure in either
+//    analysis.  Returns the last line whose beat may have changed.
 //
 
-void HumdrumFile::fixIncompleteBarMeterR(
-      SigCollection<RationalNumber>& meterbeats,
-      SigCollection<RationalNumber>& timebase, const char* base) {
-
+int HumdrumFile::fixIncompleteBarMeterR(int startpoint, int matchpoint) {
    HumdrumFile& file = *this;
-  
-   Array<int> barlocs;
-   barlocs.setSize(file.getNumLines());
-   barlocs.setSize(0);
-
-   int i, j;
-   for (i=0; i<file.getNumLines(); i++) {
-      if (!file[i].isMeasure()) {
-         continue;
+   int pointcount = (int)rhythmpoints.size();
+   int lastline = file.getNumLines() - 1;
+   RationalNumber64 lastabs = file[lastline].getAbsBeatR64();
+   RationalNumber64 barsum;
+   RationalNumber64 timedur;
+
+   // Find the chains of successive underfilled measures which add up
+   // to the time signature of the first measure in the chain.  The
+   // chain starting at checkpoint i ends at checkpoint chainend[i-startpoint].
+   vector<int> chainend;
+   int stoppoint = pointcount;
+   int i = startpoint;
+   int j, k;
+   while (i < pointcount) {
+      if ((matchpoint >= 0) && (i > matchpoint) && 
+            !rhythmpoints[i].chained) {
+         stoppoint = i;
+         break;
+      }
+      RhythmCheckpoint& point = rhythmpoints[i];
+      point.chained = 0;
+      point.reach = point.line;
+      j = i;
+      if (file[point.line].isMeasure()) {
+         timedur = point.meterdur;
+         barsum = getMeasureDurationR(i, lastabs);
+         // if the measure is overfilled, multiple measures cannot be
+         // linked together.
+         if (barsum < timedur) {
+            for (j=i+1; j<pointcount; j++) {
+               barsum += getMeasureDurationR(j, lastabs);
+               if (barsum >= timedur) {
+                  break;
+               }
+            }
+            if (j < pointcount) {
+               point.reach = rhythmpoints[j].line;
+            } else {
+               point.reach = rhythmpoints[pointcount-1].line;
+            }
+            if ((j == pointcount) || (barsum != timedur)) {
+               // measures cannot be combined into the expected duration
+               // based on the time signature.
+               j = i;
+            }
+         }
+      }
+      chainend.resize(i - startpoint + 1, -1);
+      chainend[i - startpoint] = j;
+      for (k=i+1; k<=j; k++) {
+         rhythmpoints[k].chained = 1;
+         rhythmpoints[k].reach = rhythmpoints[k].line;
       }
-      barlocs.append(i);
+      i = j + 1;
+   }
+   chainend.resize(stoppoint - startpoint, -1);
+
+   // Lines after the changed region which may be linked to measures in
+   // it are set to the beats before any previous linking:
+   int endline = lastline;
+   if (stoppoint < pointcount) {
+      endline = rhythmpoints[stoppoint].line - 1;
    }
-   for (i=0; i<barlocs.getSize()-1; i++) {
-      file[barlocs[i]].setBeatR(
-            file[barlocs[i+1]].getAbsBeatR() - 
-            file[barlocs[i]].getAbsBeatR()
-         );
+   if (matchpoint >= 0) {
+      for (i=rhythmpoints[matchpoint].line+1; i<=endline; i++) {
+         file[i].setBeatR(rawbeats[i]);
+      }
    }
-   file[barlocs.last()].setBeatR(
-       file[file.getNumLines()-1].getAbsBeatR() -
-       file[barlocs.last()].getAbsBeatR()
-   );
 
- 
-   Array<RationalNumber> timedur;  // timesig dur at each bar
-   timedur.setSize(barlocs.getSize());
-   timedur.setSize(0);
-   PerlRegularExpression pre;
-   PerlRegularExpression pre2;
-   int top, bot, bot2;
-   RationalNumber rat;
-   int barcounter = 0;
-   for (i=0; i<file.getNumLines(); i++) {
-      if (file[i].isMeasure()) {
-         barcounter++;
-         timedur.append(rat);
+   // set the duration of each measure (barline):
+   for (i=startpoint; i<stoppoint; i++) {
+      if (file[rhythmpoints[i].line].isMeasure()) {
+         file[rhythmpoints[i].line].setBeatR(getMeasureDurationR(i, lastabs));
       }
-      if (!file[i].isInterpretation()) {
+   }
+
+   // make the meter values increase instead of reset after each 
+   // internal barline of a chain:
+   RationalNumber64 correction;
+   int line;
+   for (i=startpoint; i<stoppoint; i++) {
+      j = chainend[i - startpoint];
+      if ((j < 0) || (j == i)) {
          continue;
       }
-      for (j=0; j<file[i].getFieldCount(); j++) {
-         if (!file[i].isExInterp(j, "**kern")) {
+      int chainendline = lastline;
+      if (j < pointcount - 1) {
+         chainendline = rhythmpoints[j+1].line - 1;
+      }
+      correction = file[rhythmpoints[i].line].getBeatR64();
+      for (line=rhythmpoints[i+1].line+1; line<=chainendline; line++) {
+         if (file[line].isMeasure()) {
+            correction += file[line].getBeatR64();
             continue;
          }
-         if (pre.search(file[i][j], "^\\*M(\\d+)/(\\d+)")) {
-            if (pre2.search(file[i][j], "^\\*M(\\d+)/(\\d+)%(\\d+)")) {
-               top  = atoi(pre2.getSubmatch(1));
-               bot  = atoi(pre2.getSubmatch(2));
-               bot2 = atoi(pre2.getSubmatch(3));
-               rat  = top;
-               rat  /= bot;
-               rat  *= bot2;
-               rat  *= 4;
-            } else {
-               top = atoi(pre.getSubmatch(1));
-               bot = atoi(pre.getSubmatch(2));
-               rat = top;
-               rat /= bot;
-               rat *= 4;       // deal with different scalings later...
-            }
-            if (barcounter > 0) {
-               timedur.last() = rat;
-            }
-         }
-         break;
+         file[line].setBeatR(file[line].getBeatR64() + correction);
       }
    }
 
-   // debuging: show bar number, expected sum, actual sum
-   // for (i=0; i<barlocs.getSize(); i++) {
-   //    cout << file[barlocs[i]][0] << "\t" << timedur[i] 
-   //         << "\t" << file[barlocs[i]].getBeatR()
-   //         << endl;
-   // }
-
-   int ii;
-   for (i=0; i<barlocs.getSize(); i++) {
-      if (timedur[i] == file[barlocs[i]].getBeatR()) {
-         // the duration of the measure matches what is expected
-         // so continue to next measure.
+   // mark pickup measures with a negative duration:
+   RationalNumber64 abs;
+   for (i=startpoint; i<stoppoint; i++) {
+      line = rhythmpoints[i].line;
+      if (!file[line].isMeasure()) {
          continue;
       }
-      if (timedur[i] < file[barlocs[i]].getBeatR()) {
-         // measure is overfilled, so cannot link multiple measures
-         // together.
-         continue;
+      abs = file[line].getAbsBeatR64();
+      if ((abs < file[line].getBeatR64()) && !abs.isZero()) {
+         file[line].setBeatR(-file[line].getBeatR64());
       }
-      // the measure is underfilled, so try to link a chain of 
-      // successive measures to the expected duration 
-      // If the time signature changes inside one of these measures,
-      // this will need to be handled properly.
-      RationalNumber barsum = file[barlocs[i]].getBeatR();
-      RationalNumber temp;
-      for (j=i+1; j<barlocs.getSize(); j++) {
-         barsum += file[barlocs[j]].getBeatR();
-         if (barsum > timedur[i]) {
-            // measures cannot be combined into the expected duration
-            // based on the time signature.
-            break;
-         } else if (barsum == timedur[i]) {
-            // the sequence of multiple measures adds up to the 
-            // expected time signature, so make the meter values increase
-            // instead of reset after each internal barline
-            int endline = file.getNumLines()-1;
-            if (j < barlocs.getSize() - 1) {
-               endline = barlocs[j+1]-1;
-            }
-            RationalNumber correction = file[barlocs[i]].getBeatR();
-            for (ii=barlocs[i+1]+1; ii<=endline; ii++) {
-               if (file[ii].isMeasure()) {
-                  correction += file[ii].getBeatR();
-                  continue;
-               }
-               temp = file[ii].getBeatR() + correction;
-               file[ii].setBeat(temp);
-            }
-            i += j-i;
-            break;
-         }
+   }
+
+   // Update the largest reach of linking up to each checkpoint, which
+   // is used to find the measures which need to be processed again
+   // after an edit.
+   for (i=startpoint; i<pointcount; i++) {
+      int maxreach = rhythmpoints[i].reach;
+      if ((i > 0) && (rhythmpoints[i-1].maxreach > maxreach)) {
+         maxreach = rhythmpoints[i-1].maxreach;
       }
+      if ((i >= stoppoint) && (rhythmpoints[i].maxreach == maxreach)) {
+         break;
+      }
+      rhythmpoints[i].maxreach = maxreach;
+   }
+
+   return endline;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::getMeasureDurationR -- Return the duration of the measure
+//    starting at the given rhythm checkpoint, which is measured to the
+//    next checkpoint, or to the last line of the file.
+//
+
+RationalNumber64 HumdrumFile::getMeasureDurationR(int point,
+      const RationalNumber64& lastabs) {
+   if (point + 1 < (int)rhythmpoints.size()) {
+      return rhythmpoints[point+1].absbeat - rhythmpoints[point].absbeat;
    }
+   return lastabs - rhythmpoints[point].absbeat;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::fixPickupBeats -- adjust the beats of the lines before
+//    the first barline for pickup measures.
+//
 
-   if (barlocs.getSize() == 0) {
+void HumdrumFile::fixPickupBeats(const char* base) {
+   HumdrumFile& file = *this;
+   int firstbar = -1;
+   int i;
+   for (i=0; i<(int)rhythmpoints.size(); i++) {
+      if (file[rhythmpoints[i].line].isMeasure()) {
+         firstbar = i;
+         break;
+      }
+   }
+   if (firstbar < 0) {
       return;
    }
+   int barline = rhythmpoints[firstbar].line;
+   RationalNumber timedur = rhythmpoints[firstbar].meterdur;
 
    // Only handle pickup measures for quarter note beats for now.
    // Pickups in other time bases are being messed up by the line
@@ -3308,25 +3824,51 @@ void HumdrumFile::fixIncompleteBarMeterR(
    // calculation.  
    if (strcmp(base, "4") == 0) {
       pickupdur = 0;
-      if (file[barlocs[0]].getAbsBeatR() > 0) {
-         if (file[barlocs[0]].getAbsBeatR() < timedur[0]) {
-            pickupdur = file[barlocs[0]].getAbsBeatR();
+      if (file[barline].getAbsBeatR() > 0) {
+         if (file[barline].getAbsBeatR() < timedur) {
+            pickupdur = file[barline].getAbsBeatR();
          }
       }
    }
    if (pickupdur > 0) {
       // int dataQ = 0;
-      for (i=0; i<barlocs[0]; i++) {
+      for (i=0; i<barline; i++) {
          // if (file[i].isData()) {
          //    dataQ = 1;
          // }
          //if (!dataQ) {
          //   continue;
          //}
-         file[i].setBeat(timedur[0]-pickupdur+file[i].getBeatR()+1);      
+         file[i].setBeat(timedur-pickupdur+file[i].getBeatR()+1);      
       }
    }
 
+   // Fix cases where the first barline is not given in the data
+   // Currently, the measure will be labeled as 0, and the beats 
+   // will be offset from 0 rather than 1.
+   int dataline = -1;
+   int barlineindex = -1;
+   for (i=0; i<file.getNumLines(); i++) {
+      if ((dataline == -1) && (file[i].isData())) {
+         dataline = i;
+         continue;
+      }
+      if (file[i].isBarline()) {
+         if (dataline >= 0) {
+            barlineindex = i;
+         }
+         break;
+      }
+   }
+   if (barlineindex >= 0) {
+      if (dataline >= 0) {
+         if (file[dataline].getBeatR64().isZero()) {
+            for (i=dataline; i<barlineindex; i++) {
+               file[i].setBeatR(file[i].getBeatR64() + 1);
+            }
+         }
+      }
+   }
 }
 
 
@@ -3337,12 +3879,12 @@ void HumdrumFile::fixIncompleteBarMeterR(
 //
 
 void HumdrumFile::adjustForRhythmMarker(HumdrumRecord& aRecord,
-      int state, int spine, SigCollection<RationalNumber>& lastdurations, 
-      SigCollection<RationalNumber>& runningstatus, int& init, int& datastart,
+      int state, int spine, SigCollection<RationalNumber64>& lastdurations, 
+      SigCollection<RationalNumber64>& runningstatus, int& init, int& datastart,
       Array<int>& ignore) {
 
-   SigCollection<RationalNumber> newdurations;
-   SigCollection<RationalNumber> newstatus;
+   SigCollection<RationalNumber64> newdurations;
+   SigCollection<RationalNumber64> newstatus;
    newdurations.setSize(lastdurations.getSize() + 4);
    newstatus.setSize(runningstatus.getSize() + 4);
    newdurations.setGrowth(newdurations.getSize());
@@ -3370,7 +3912,7 @@ void HumdrumFile::adjustForRhythmMarker(HumdrumRecord& aRecord,
          } else {
             // stop ignoring
             ignore[aRecord.getPrimaryTrack(i)-1] = 0;
-            RationalNumber zero(0,1);
+            RationalNumber64 zero(0,1);
             lastdurations.append(zero);
             runningstatus.append(zero);
          }
@@ -3411,16 +3953,16 @@ void HumdrumFile::adjustForRhythmMarker(HumdrumRecord& aRecord,
 //
 
 void HumdrumFile::adjustForSpinePaths(HumdrumRecord& aRecord, 
-      SigCollection<RationalNumber>& lastdurations, 
-      SigCollection<RationalNumber>& runningstatus,
+      SigCollection<RationalNumber64>& lastdurations, 
+      SigCollection<RationalNumber64>& runningstatus,
       int& init, int& datastart, Array<int>& ignore) {
 
    int spinecount = aRecord.getFieldCount();
    int subcount;
    int inindex = 0;
 
-   SigCollection<RationalNumber> newdurations;
-   SigCollection<RationalNumber> newstatus;
+   SigCollection<RationalNumber64> newdurations;
+   SigCollection<RationalNumber64> newstatus;
    newdurations.allowGrowth();
    newstatus.allowGrowth();
    newstatus.setSize(runningstatus.getSize() + 4);
@@ -3523,6 +4065,48 @@ void HumdrumFile::adjustForSpinePaths(HumdrumRecord& aRecord,
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::addMinimumRhythm -- add a rhythm to the list used to
+//     calculate the minimum rhythm, unless the list already contains
+//     an integer multiple of it.
+//
+
+void HumdrumFile::addMinimumRhythm(Array<RationalNumber>& rhythms,
+      RationalNumber& rbase) {
+   RationalNumber value;
+   for (int z=0; z<rhythms.getSize(); z++) {
+      if (rbase == 0) {
+         return;
+      }
+      value = rhythms[z] / rbase;
+      if (value.getDenominator() == 1) {
+         // if the duration of rbase is an integer
+         // multiple of a particular rhythm, then stop
+         // processing, since the minimum rhythm calculation
+         // will not need to know anything about rbase.
+         return;
+      }
+   }
+   rhythms.append(rbase);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFile::clearRhythmCheckpoints -- forget the saved state of the
+//     last rhythm analysis, so that the next analysis is done on the
+//     entire file.
+//
+
+void HumdrumFile::clearRhythmCheckpoints(void) {
+   rhythmpoints.clear();
+   rawbeats.clear();
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::determineDurationR2 -- determines the duration of the **kern
@@ -3533,9 +4117,9 @@ void HumdrumFile::adjustForSpinePaths(HumdrumRecord& aRecord,
 //	           Array<RationalNumber>& rhythms.
 //
 
-RationalNumber HumdrumFile::determineDurationR2(HumdrumRecord& aRecord,
-      int& init, SigCollection<RationalNumber>& lastdurations, 
-      SigCollection<RationalNumber>& runningstatus,
+RationalNumber64 HumdrumFile::determineDurationR2(HumdrumRecord& aRecord,
+      int& init, SigCollection<RationalNumber64>& lastdurations, 
+      SigCollection<RationalNumber64>& runningstatus,
       Array<RationalNumber>& rhythms, Array<int>& ignore) {
    int i;
    // initialization:
@@ -3554,7 +4138,7 @@ RationalNumber HumdrumFile::determineDurationR2(HumdrumRecord& aRecord,
 
    // Step (1): if lastdurations == runningstatus, then zero running
    // status.
-   RationalNumber zero(0,1);
+   RationalNumber64 zero(0,1);
    for (i=0; i<runningstatus.getSize(); i++) {
       if ((runningstatus[i] - lastdurations[i]) == zero) {
          runningstatus[i].zero();
@@ -3605,37 +4189,17 @@ RationalNumber HumdrumFile::determineDurationR2(HumdrumRecord& aRecord,
 
             if (lastdurations[count] != 0) {
                // have a legitimate rhythm, store it in the rhythms array.
-               RationalNumber sss = lastdurations[count];
+               RationalNumber sss = lastdurations[count].getRationalNumber();
                // Convert::durationRToKernRhythm(rbuff, sss);
                RationalNumber rbase = sss.getInversion() * 4;
                // int rbase  = atoi(rbuff);
                // int length = strlen(rbuff);
-               int z;
                // for (z=length-1; z>0; z--) {
                //    if (rbuff[z] == '.') {
                //       rbase = 2 * rbase;
                //    }
                // }
-               int done = 0;
-               RationalNumber value;
-               for (z=0; z<rhythms.getSize(); z++) {
-                  if (rbase == 0) {
-                     done = 1;
-                     break;
-                  }
-                  value = rhythms[z] / rbase;
-                  if (value.getDenominator() == 1) {
-                     // if the duration of rbase is an integer
-                     // multiple of a particular rhythm, then stop
-                     // processing, since the minimum rhythm calculation
-                     // will not need to know anything about rbase.
-                     done = 1;
-                     break;
-                  }
-               }
-               if (!done) {
-                  rhythms.append(rbase);
-               }
+               addMinimumRhythm(rhythms, rbase);
 
             }
 
@@ -3670,11 +4234,16 @@ RationalNumber HumdrumFile::determineDurationR2(HumdrumRecord& aRecord,
    }
 
    // Step (3): find minimum duration by subtracting last from running
-   RationalNumber min(99999999,1);
-   RationalNumber testval;
+   RationalNumber64 min(99999999,1);
+   RationalNumber64 testval;
 
    for (i=0; i<lastdurations.getSize(); i++) {
       testval = lastdurations[i] - runningstatus[i];
+      if (!testval.isValid()) {
+         cout << "Error on line: " << aRecord.getLineNum() 
+              << ": rhythm overflow in **kern spine " << i+1 << endl;
+         exit(1);
+      }
       if (testval.isNegative()) {   
          cout << "Error on line: " << aRecord.getLineNum() 
               << ": problem with rhythm in **kern spine " 
@@ -3750,7 +4319,7 @@ RationalNumber HumdrumFile::determineDurationR(HumdrumRecord& aRecord,
    int q;
    int count = 0;
    int stype = 0;
-   static char rbuff[32] = {0};
+   char rbuff[32] = {0};
    for (i=0; i<aRecord.getFieldCount(); i++) {
       if (ignore[aRecord.getPrimaryTrack(i)-1] != 0) {
          stype = 0;
@@ -4122,6 +4691,21 @@ void HumdrumFile::analyzeTempoMarkings(Array<double>& tempo, double tdefault) {
 
 void HumdrumFile::analyzeMeter(Array<double>& top, Array<double>& bottom,
       int flag) {
+   top.setSize(getNumLines());
+   bottom.setSize(getNumLines());
+   analyzeMeter(top, bottom, flag, 0, getNumLines() - 1);
+}
+
+
+//
+// Only extract the time signatures of the lines from startline to 
+// stopline.  The arrays must already have an entry for each line.
+// The time signature before startline is found by searching backwards
+// from startline.
+//
+
+void HumdrumFile::analyzeMeter(Array<double>& top, Array<double>& bottom,
+      int flag, int startline, int stopline) {
    int    compoundQ   = flag & (0x01<<COMPOUND_METER_BIT);
    double goodtop     = -1.0;
    double goodbottom  = -1.0;
@@ -4129,42 +4713,29 @@ void HumdrumFile::analyzeMeter(Array<double>& top, Array<double>& bottom,
    int    testbottom  = -1;
 
    HumdrumFile& score = *this;
-   top.setSize(score.getNumLines());
-   bottom.setSize(score.getNumLines());
 
-   int j;
    int line;
-   int count;
-   for (line=0; line<score.getNumLines(); line++) {
-      if (score[line].getType() == E_humrec_interpretation) {
-         for (j=0; j<score[line].getFieldCount(); j++) {
-            if (score[line].getExInterpNum(j) != E_KERN_EXINT) {
-               continue;
-            }
-            if ((strncmp(score[line][j], "*M", 2) == 0) &&
-                  std::isdigit(score[line][j][2]) &&
-                  (strchr(score[line][j], '/') != NULL)) {
-               count = sscanf(score[line][j], "*M%d/%d", &testtop,
-                     &testbottom);
-               if (goodbottom == 0.0) {
-                  // cannot handle 00 (long which is 1/4 rhythm)
-                  goodbottom = 0.5;
-               }
-               if (count != 2) {
-                  continue;
-               } else {          
-                  goodtop = testtop;
-                  goodbottom = testbottom;
-               }
+   int start = startline;
+   for (line=startline-1; line>=0; line--) {
+      if (score[line].getType() != E_humrec_interpretation) {
+         continue;
+      }
+      if (getMeterSignature(score[line], testtop, testbottom) >= 0) {
+         start = line;
+         break;
+      }
+   }
 
-               if (compoundQ && (testtop % 3 == 0) && (testtop != 3)) {
-                  goodtop = goodtop / 3.0;
-                  goodbottom = 4.0/goodbottom * 3.0;
-               } else {
-                  goodbottom = 4.0/goodbottom;
-               }
-               break;
-            }
+   for (line=start; line<=stopline; line++) {
+      if ((score[line].getType() == E_humrec_interpretation) && 
+            (getMeterSignature(score[line], testtop, testbottom) >= 0)) {
+         goodtop = testtop;
+         goodbottom = testbottom;
+         if (compoundQ && (testtop % 3 == 0) && (testtop != 3)) {
+            goodtop = goodtop / 3.0;
+            goodbottom = 4.0/goodbottom * 3.0;
+         } else {
+            goodbottom = 4.0/goodbottom;
          }
       }
 
@@ -4175,6 +4746,33 @@ void HumdrumFile::analyzeMeter(Array<double>& top, Array<double>& bottom,
 
 
 
+//////////////////////////////
+//
+// HumdrumFile::getMeterSignature -- Return the field of the first time signature 
+//    in a **kern spine of an interpretation record, or -1 if there
+//    is none.
+//
+
+int HumdrumFile::getMeterSignature(HumdrumRecord& record, int& top, 
+      int& bottom) {
+   int j;
+   for (j=0; j<record.getFieldCount(); j++) {
+      if (record.getExInterpNum(j) != E_KERN_EXINT) {
+         continue;
+      }
+      if ((strncmp(record[j], "*M", 2) == 0) &&
+            std::isdigit(record[j][2]) &&
+            (strchr(record[j], '/') != NULL)) {
+         if (sscanf(record[j], "*M%d/%d", &top, &bottom) == 2) {
+            return j;
+         }
+      }
+   }
+   return -1;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFile::analyzeBeatDuration -- determine the duration of a beat
@@ -4246,6 +4844,17 @@ void HumdrumFile::analyzeMetricLevel(vector<int>& metlev) {
 
 
 void HumdrumFile::analyzeMetricLevel(Array<int>& metlev) {
+   analyzeMetricLevel(metlev, 0, getNumLines() - 1);
+}
+
+
+//
+// Only analyze the lines from startline to stopline.  The metric
+// levels of the other lines are set to 0.
+//
+
+void HumdrumFile::analyzeMetricLevel(Array<int>& metlev, int startline,
+      int stopline) {
    HumdrumFile& score = *this;
    int i;
    metlev.setSize(score.getNumLines());
@@ -4255,15 +4864,18 @@ void HumdrumFile::analyzeMetricLevel(Array<int>& metlev) {
    Array<double> msigtop; 
    Array<double> msigbottom; 
 
-   analyzeMeter(msigtop, msigbottom);
+   msigtop.setSize(score.getNumLines());
+   msigbottom.setSize(score.getNumLines());
+   analyzeMeter(msigtop, msigbottom, AFLAG_NOCOMPOUND_METER, startline, 
+         stopline);
    iscompound.setSize(msigtop.getSize());
    iscompound.zero();
 
    int mval;
    int ltop = 0;
    int lbottom = 0;
-   for (i=0; i<iscompound.getSize(); i++) {
-      if ((i > 0) && (ltop == msigtop[i]) && (lbottom == msigbottom[i])) {
+   for (i=startline; i<=stopline; i++) {
+      if ((i > startline) && (ltop == msigtop[i]) && (lbottom == msigbottom[i])) {
          iscompound[i] = iscompound[i-1];
       } else {
          mval = (int)(msigtop[i] * msigbottom[i] + 0.45);
@@ -4286,7 +4898,7 @@ void HumdrumFile::analyzeMetricLevel(Array<int>& metlev) {
    double testtriplet;
    double testhigher;
    double highertriplet;
-   for (i=0; i<score.getNumLines(); i++) {
+   for (i=startline; i<=stopline; i++) {
       if (!score[i].isData()) {
          continue;
       }
@@ -18,6 +18,15 @@
 // Last Modified: Tue Apr 24 16:37:34 PDT 2012 added jrp:// URI
 // Last Modified: Tue Dec 11 17:23:04 PST 2012 added fileName, segmentLevel
 // Last Modified: Mon Apr  1 16:44:32 PDT 2013 added printNonemptySegmentLevel
+// Last Modified: Sat Oct 17 17:39:08 PDT 2026 added arena storage for records
+// Last Modified: Sat Oct 17 17:49:13 PDT 2026 added memory-mapped reading
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 added swap()
+// Last Modified: Sat Oct 17 18:33:52 PDT 2026 setAllocation() uses reserve()
+// Last Modified: Sat Oct 17 18:47:41 PDT 2026 added dirty line range tracking
+// Last Modified: Sat Oct 17 23:31:16 PDT 2026 getTrackExInterp() range check
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 thread-safe reading, string getBibValue
+// Last Modified: Sat Oct 17 22:47:20 PDT 2026 records report their changes
+// Last Modified: Sun Oct 18 00:26:33 PDT 2026 constructors use setGrowth()
 // Filename:      ...sig/src/sigInfo/HumdrumFileBasic.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumFileBasic.cpp
 // Syntax:        C++ 
@@ -40,8 +49,17 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <utility>
+
+#ifdef USING_MMAP
+   #include <sys/types.h>   /* off_t           */
+   #include <sys/stat.h>    /* fstat           */
+   #include <sys/mman.h>    /* mmap, munmap    */
+   #include <fcntl.h>       /* open            */
+   #include <unistd.h>      /* close           */
+#endif
 
-char HumdrumFileBasic::empty[1] = {0};
+const char HumdrumFileBasic::empty[1] = {0};
 
 
 ///////////////////////////////////////////////////////////////////////////
@@ -203,6 +221,9 @@ HumdrumFileBasic::HumdrumFileBasic(void) {
    records.setGrowth(1000000);      // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   dirtystart = -1;
+   dirtyend = -1;
 }
 
 
@@ -213,6 +234,9 @@ HumdrumFileBasic::HumdrumFileBasic(const HumdrumFileBasic& aHumdrumFileBasic) {
    records.setGrowth(1000000);      // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   dirtystart = -1;
+   dirtyend = -1;
 
    *this = aHumdrumFileBasic;
 }
@@ -222,9 +246,12 @@ HumdrumFileBasic::HumdrumFileBasic(const char* filename) {
    records.setSize(100000);          // initial storage size 100000 lines
    records.setSize(0);
    records.allowGrowth();          
-   records.setAllocSize(1000000);    // grow in increments of 1000000 lines
+   records.setGrowth(1000000);      // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   dirtystart = -1;
+   dirtyend = -1;
 
    ifstream infile(filename, ios::in);
 
@@ -255,9 +282,12 @@ HumdrumFileBasic::HumdrumFileBasic(const string& filename) {
    records.setSize(100000);          // initial storage size 100000 lines
    records.setSize(0);
    records.allowGrowth();          
-   records.setAllocSize(1000000);    // grow in increments of 1000000 lines
+   records.setGrowth(1000000);      // grow in increments of 1000000 lines
    maxtracks = 0;
    segmentLevel = 0;
+   arenaQ = 1;
+   dirtystart = -1;
+   dirtyend = -1;
 
    ifstream infile(filename.data(), ios::in);
 
@@ -297,12 +327,7 @@ void HumdrumFileBasic::setAllocation(int allocation) {
    if (allocation > 10000000) {
       return;
    }
-   int currentsize = records.getSize();
-   if (currentsize < allocation) {
-      records.setSize(allocation);
-      records.setSize(currentsize);
-      records.setAllocSize(allocation);
-   }
+   records.reserve(allocation);
 }
 
 
@@ -346,17 +371,31 @@ void HumdrumFileBasic::analyzeDots(void) {
 
 void HumdrumFileBasic::appendLine(const char* aLine) {
    HumdrumRecord* aRecord;
-   aRecord = new HumdrumRecord;
+   aRecord = newRecord();
    aRecord->setLine(aLine);
    records[records.getSize()] = aRecord;
+   setRecordOwners(records.getSize()-1);
+   markDirty(records.getSize()-1);
+}
+
+
+void HumdrumFileBasic::appendLine(const char* aLine, int length) {
+   HumdrumRecord* aRecord;
+   aRecord = newRecord();
+   aRecord->setLine(aLine, length);
+   records[records.getSize()] = aRecord;
+   setRecordOwners(records.getSize()-1);
+   markDirty(records.getSize()-1);
 }
 
 
 void HumdrumFileBasic::appendLine(HumdrumRecord& aRecord) {
    HumdrumRecord *tempRecord;
-   tempRecord = new HumdrumRecord;
+   tempRecord = newRecord();
    *tempRecord = aRecord;
    records[records.getSize()] = tempRecord;
+   setRecordOwners(records.getSize()-1);
+   markDirty(records.getSize()-1);
 }
    
 
@@ -366,6 +405,54 @@ void HumdrumFileBasic::appendLine(HumdrumRecord* aRecord) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::setArenaStorage -- Turn on/off storing the text of
+//     lines added to the file in the file's arena (on by default).  When
+//     off, each field of each line is allocated separately on the heap.
+//     Only affects lines which are added after calling this function.
+//     default value: state = 1
+//
+
+void HumdrumFileBasic::setArenaStorage(int state) {
+   arenaQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::newRecord -- Allocate an empty record for the file,
+//     attached to the arena if arena storage is active.
+//
+
+HumdrumRecord* HumdrumFileBasic::newRecord(void) {
+   HumdrumRecord* output = new HumdrumRecord;
+   if (arenaQ) {
+      output->setArena(&arena);
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::setRecordOwners -- Attach the records from the given
+//     index to the end of the file to this file, so that changes made
+//     to them are reported to markDirty().
+//     default value: startindex = 0
+//
+
+void HumdrumFileBasic::setRecordOwners(int startindex) {
+   for (int i=startindex; i<records.getSize(); i++) {
+      records[i]->owner = this;
+      records[i]->ownerindex = i;
+   }
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBasic::clear -- removes all lines from the humdrum file
@@ -381,9 +468,76 @@ void HumdrumFileBasic::clear(void) {
       }
    }
    records.setSize(0);
+   arena.clear();
    maxtracks = 0;
    segmentLevel = 0;
    trackexinterp.clear();
+   clearDirty();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::markDirty -- Record that lines in the given range
+//     have been added or changed since the last call to clearDirty().
+//     The range is merged with any previously marked lines.  Lines
+//     added with appendLine() and changes made to the text of the
+//     records in the file (changeField(), setToken(), changeToken(),
+//     setLine(), etc.) are marked automatically.
+//     default value: endline = -1 (same as startline)
+//
+
+void HumdrumFileBasic::markDirty(int startline, int endline) {
+   if (endline < startline) {
+      endline = startline;
+   }
+   if (startline < 0) {
+      return;
+   }
+   if ((dirtystart < 0) || (startline < dirtystart)) {
+      dirtystart = startline;
+   }
+   if (endline > dirtyend) {
+      dirtyend = endline;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::clearDirty -- Forget about any changed lines, such
+//     as after an analysis has been updated for them.
+//
+
+void HumdrumFileBasic::clearDirty(void) {
+   dirtystart = -1;
+   dirtyend = -1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getDirtyStart -- Return the first line changed since
+//     the last call to clearDirty(), or -1 if no lines have changed.
+//
+
+int HumdrumFileBasic::getDirtyStart(void) {
+   return dirtystart;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumFileBasic::getDirtyEnd -- Return the last line changed since
+//     the last call to clearDirty(), or -1 if no lines have changed.
+//
+
+int HumdrumFileBasic::getDirtyEnd(void) {
+   return dirtyend;
 }
 
 
@@ -578,10 +732,15 @@ int HumdrumFileBasic::getMaxTracks(void) {
 
 //////////////////////////////
 //
-// HumdrumFileBasic::getTrackExInterp --
+// HumdrumFileBasic::getTrackExInterp -- Returns an empty string for
+//     tracks which do not start on the first exclusive interpretation
+//     line (such as a spine added later with *+).
 //
 
 string HumdrumFileBasic::getTrackExInterp(int track) {
+   if ((track < 1) || (track > (int)trackexinterp.size())) {
+      return "";
+   }
    return trackexinterp[track-1];
 }
 
@@ -708,6 +867,36 @@ const char* HumdrumFileBasic::getBibValue(char* buffer, const char* key) {
 }
 
 
+//
+// string version
+//
+
+string& HumdrumFileBasic::getBibValue(string& buffer, const char* key) {
+   buffer.clear();
+   HumdrumFileBasic& hfile = *this;
+
+   string newkey;
+   if (strncmp(key, "!!!", 3) != 0) {
+      newkey = "!!!";
+   }
+   newkey += key;
+
+   int i;
+   for (i=0; i<hfile.getNumLines(); i++) {
+      if (!hfile[i].isBibliographic()) {
+         continue;
+      }
+      if (strncmp(hfile[i][0], newkey.c_str(), newkey.size()) != 0) {
+         continue;
+      }
+      hfile[i].getBibValue(buffer);
+      break;
+   }
+
+   return buffer;
+}
+
+
 
 //////////////////////////////
 //
@@ -786,14 +975,18 @@ HumdrumFileBasic& HumdrumFileBasic::operator=(const HumdrumFileBasic& aFile) {
       delete records[i];
       records[i] = NULL;
    }
+   arena.clear();
 
    records.setSize(aFile.records.getSize());
    for (i=0; i<aFile.records.getSize(); i++) {
-      records[i] = new HumdrumRecord;
+      records[i] = newRecord();
       *(records[i]) = *(aFile.records[i]);
    }
+   setRecordOwners();
 
    maxtracks = aFile.maxtracks;
+   dirtystart = aFile.dirtystart;
+   dirtyend = aFile.dirtyend;
 
    trackexinterp.clear();
    trackexinterp.resize(aFile.trackexinterp.size());
@@ -805,6 +998,60 @@ HumdrumFileBasic& HumdrumFileBasic::operator=(const HumdrumFileBasic& aFile) {
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::swap -- Exchange the contents of two files.  Only
+//     the record pointers are exchanged; text stored in the arena of
+//     one file moves along with its records to the other file.
+//
+
+void HumdrumFileBasic::swap(HumdrumFileBasic& aFile) {
+   if (&aFile == this) {
+      return;
+   }
+
+   int i;
+   int count = records.getSize();
+   SigCollection<HumdrumRecord*> temp;
+   temp.setSize(count);
+   for (i=0; i<count; i++) {
+      temp[i] = records[i];
+   }
+   records.setSize(aFile.records.getSize());
+   for (i=0; i<aFile.records.getSize(); i++) {
+      records[i] = aFile.records[i];
+   }
+   aFile.records.setSize(count);
+   for (i=0; i<count; i++) {
+      aFile.records[i] = temp[i];
+   }
+
+   arena.swap(aFile.arena);
+   for (i=0; i<records.getSize(); i++) {
+      if (records[i]->getArena() == &aFile.arena) {
+         records[i]->rebindArena(&arena);
+      }
+   }
+   for (i=0; i<aFile.records.getSize(); i++) {
+      if (aFile.records[i]->getArena() == &arena) {
+         aFile.records[i]->rebindArena(&aFile.arena);
+      }
+   }
+
+   setRecordOwners();
+   aFile.setRecordOwners();
+
+   std::swap(arenaQ, aFile.arenaQ);
+   std::swap(segmentLevel, aFile.segmentLevel);
+   std::swap(maxtracks, aFile.maxtracks);
+   std::swap(dirtystart, aFile.dirtystart);
+   std::swap(dirtyend, aFile.dirtyend);
+   fileName.swap(aFile.fileName);
+   trackexinterp.swap(aFile.trackexinterp);
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBasic::read -- read in a Humdrum file.
@@ -841,12 +1088,19 @@ void HumdrumFileBasic::read(const char* filename) {
    }
 #endif
 
+#ifdef USING_MMAP
+   if (readMappedFile(filename)) {
+      return;
+   }
+#endif
+
    int i;
    for (i=0; i<records.getSize(); i++) {
       delete records[i];
       records[i] = NULL;
    }
    records.setSize(0);
+   arena.clear();
 
    #ifndef OLDCPP
       ifstream infile(filename, ios::in);
@@ -868,13 +1122,13 @@ void HumdrumFileBasic::read(const char* filename) {
 
 	setFilename(filename);
 
-   char templine[4096];
+   string templine;
    while (!infile.eof()) {
-      infile.getline(templine, 4096, '\n');
-      if (infile.eof() && (strcmp(templine, "") == 0)) {
+      getline(infile, templine, '\n');
+      if (infile.eof() && (strcmp(templine.c_str(), "") == 0)) {
          break;
       } else {
-         appendLine(templine);
+         appendLine(templine.c_str());
       }
    }
    analyzeSpines();
@@ -883,8 +1137,7 @@ void HumdrumFileBasic::read(const char* filename) {
 
 
 void HumdrumFileBasic::read(istream& inStream) {
-   char* templine;
-   templine = new char[4096];
+   string templine;
    int linecount = 0;
 
    if (inStream.peek() == '%') {
@@ -895,44 +1148,131 @@ void HumdrumFileBasic::read(istream& inStream) {
    }
 
    while (!inStream.eof()) {
-      inStream.getline(templine, 4096);
+      getline(inStream, templine);
 #ifdef USING_URI
-      if ((linecount++ == 0) && (strstr(templine, "://") != NULL)) {
-         if (strncmp(templine, "http://", strlen("http://")) == 0) {
-            readFromHttpURI(templine);
-            delete [] templine;
+      if ((linecount++ == 0) && (strstr(templine.c_str(), "://") != NULL)) {
+         if (strncmp(templine.c_str(), "http://", strlen("http://")) == 0) {
+            readFromHttpURI(templine.c_str());
             return;
          }
-         if (strncmp(templine, "humdrum://", strlen("humdrum://")) == 0) {
-            readFromHumdrumURI(templine);
-            delete [] templine;
+         if (strncmp(templine.c_str(), "humdrum://", strlen("humdrum://")) == 0) {
+            readFromHumdrumURI(templine.c_str());
             return;
          } 
-         if (strncmp(templine, "hum://", strlen("hum://")) == 0) {
-            readFromHumdrumURI(templine);
-            delete [] templine;
+         if (strncmp(templine.c_str(), "hum://", strlen("hum://")) == 0) {
+            readFromHumdrumURI(templine.c_str());
             return;
          } 
-         if (strncmp(templine, "h://", strlen("h://")) == 0) {
-            readFromHumdrumURI(templine);
-            delete [] templine;
+         if (strncmp(templine.c_str(), "h://", strlen("h://")) == 0) {
+            readFromHumdrumURI(templine.c_str());
             return;
          } 
       }
 #endif
-      if (inStream.eof() && (strcmp(templine, "") == 0)) {
+      if (inStream.eof() && (strcmp(templine.c_str(), "") == 0)) {
          break;
       } else {
-         appendLine(templine);
+         appendLine(templine.c_str());
       }
    }
    analyzeSpines();
    analyzeDots();
-   delete [] templine;
 }
 
 
 
+//////////////////////////////
+//
+// HumdrumFileBasic::read -- Read Humdrum data from a buffer in memory
+//     rather than from a file or stream.  The buffer does not need to be
+//     null-terminated and is not referenced after the function returns.
+//     Lines are split with memchr(), so there is no limit on the length
+//     of a line.
+//
+
+void HumdrumFileBasic::read(const char* contents, size_t length) {
+   int i;
+   for (i=0; i<records.getSize(); i++) {
+      delete records[i];
+      records[i] = NULL;
+   }
+   records.setSize(0);
+   arena.clear();
+
+   if ((length > 0) && (contents[0] == '%')) {
+      stringstream pdfData;
+      pdfData.write(contents, length);
+      stringstream embeddedData;
+      extractEmbeddedDataFromPdf(embeddedData, pdfData);
+      read(embeddedData);
+      return;
+   }
+
+   // Each line is stored twice in the arena (see HumdrumRecord::setLine),
+   // so reserve enough space to parse the whole file out of one chunk.
+   if (arenaQ && (length < 0x3fffffff)) {
+      arena.reserve(2 * (int)length + 2);
+   }
+
+   const char* start   = contents;
+   const char* end     = contents + length;
+   const char* newline = NULL;
+   while (start < end) {
+      newline = (const char*)memchr(start, '\n', end - start);
+      if (newline == NULL) {
+         appendLine(start, end - start);
+         break;
+      }
+      appendLine(start, newline - start);
+      start = newline + 1;
+   }
+   analyzeSpines();
+   analyzeDots();
+}
+
+
+
+#ifdef USING_MMAP
+
+//////////////////////////////
+//
+// HumdrumFileBasic::readMappedFile -- Read a regular file by mapping it
+//     into memory.  Returns 0 if the file cannot be mapped (such as for
+//     a pipe or an empty file) so that the caller can fall back on
+//     reading with an input stream.
+//
+
+int HumdrumFileBasic::readMappedFile(const char* filename) {
+   int fd = open(filename, O_RDONLY);
+   if (fd < 0) {
+      return 0;
+   }
+   struct stat info;
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode) || 
+         (info.st_size <= 0)) {
+      close(fd);
+      return 0;
+   }
+   size_t length = (size_t)info.st_size;
+   void* data = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (data == MAP_FAILED) {
+      return 0;
+   }
+   #ifdef MADV_SEQUENTIAL
+      madvise(data, length, MADV_SEQUENTIAL);
+   #endif
+
+   read((const char*)data, length);
+   munmap(data, length);
+   setFilename(filename);
+   return 1;
+}
+
+#endif
+
+
+
 //////////////////////////////
 //
 // HumdrumFileBasic::removeNullRecords
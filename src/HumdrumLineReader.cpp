@@ -0,0 +1,449 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:51:51 PDT 2026
+// Last Modified: Sat Oct 17 19:51:51 PDT 2026
+// Filename:      ...sig/src/sigInfo/HumdrumLineReader.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumLineReader.cpp
+// Syntax:        C++
+//
+// Description:   Reads Humdrum data one line at a time, keeping the
+//                spine path and dot analyses of HumdrumFileBasic as
+//                running state.
+//
+
+#include "HumdrumLineReader.h"
+#include "HumdrumFileBasic.h"
+#include "Convert.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::HumdrumLineReader --
+//
+
+HumdrumLineReader::HumdrumLineReader(void) {
+   initialize();
+}
+
+
+HumdrumLineReader::HumdrumLineReader(const char* filename) {
+   initialize();
+   open(filename);
+}
+
+
+HumdrumLineReader::HumdrumLineReader(const string& filename) {
+   initialize();
+   open(filename);
+}
+
+
+HumdrumLineReader::HumdrumLineReader(istream& instream) {
+   initialize();
+   open(instream);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::~HumdrumLineReader --
+//
+
+HumdrumLineReader::~HumdrumLineReader() {
+   close();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::initialize --
+//
+
+void HumdrumLineReader::initialize(void) {
+   input          = NULL;
+   nextQ          = 0;
+   segmentstartQ  = 0;
+   segmentindex   = -1;
+   linecount      = 0;
+   exclusivecount = 0;
+   init           = 0;
+   spineid        = 0;
+   currentwidth   = 0;
+   prediction     = 0;
+   predictionQ    = 0;
+   newcount       = 0;
+   lastline.setSize(0);
+   lastspine.setSize(0);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::open -- Start reading from a file or stream.  The
+//     first segment is given the filename without its directory (or an
+//     empty filename for a stream), unless the data starts with a
+//     !!!!SEGMENT: marker.  Returns 0 if the file cannot be opened.
+//
+
+int HumdrumLineReader::open(const char* filename) {
+   close();
+   infile.open(filename);
+   if (!infile.is_open()) {
+      return 0;
+   }
+   input = &infile;
+   const char* ptr = strrchr(filename, '/');
+   basename = ptr == NULL ? filename : ptr + 1;
+   nextname = basename;
+   nextQ = 1;
+   return 1;
+}
+
+
+int HumdrumLineReader::open(const string& filename) {
+   return open(filename.c_str());
+}
+
+
+void HumdrumLineReader::open(istream& instream) {
+   close();
+   input = &instream;
+   basename = "";
+   nextname = "";
+   nextQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::close --
+//
+
+void HumdrumLineReader::close(void) {
+   if (input != NULL) {
+      endSegment();
+   }
+   if (infile.is_open()) {
+      infile.close();
+   }
+   infile.clear();
+   initialize();
+   spineinfo.clear();
+   exinterps.clear();
+   trackexinterp.clear();
+   segmentname = "";
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::read -- Read the next line of the input into the
+//     record.  Returns 0 when there is no more input.  The record should
+//     not use arena storage, since the text of each line would then be
+//     kept until the arena is cleared.
+//
+
+int HumdrumLineReader::read(HumdrumRecord& record) {
+   if (input == NULL) {
+      return 0;
+   }
+
+   const char* ptr;
+   segmentstartQ = 0;
+   while (getline(*input, line)) {
+      if (strncmp(line.c_str(), "!!!!SEGMENT:", 12) == 0) {
+         endSegment();
+         ptr = line.c_str() + 12;
+         while (isspace(*ptr)) {
+            ptr++;
+         }
+         nextname = ptr;
+         nextQ = 1;
+         continue;
+      }
+      if ((strncmp(line.c_str(), "**", 2) == 0) && (exclusivecount > 0) &&
+            !nextQ) {
+         // only one exclusive interpretation line is allowed in a
+         // segment, so start a new segment with an empty filename.
+         endSegment();
+         nextname = "";
+         nextQ = 1;
+      }
+      if (nextQ) {
+         startSegment();
+      }
+      if (strncmp(line.c_str(), "**", 2) == 0) {
+         exclusivecount++;
+      }
+
+      record.setLine(line.c_str(), (int)line.size());
+      record.setLineNum(++linecount);
+      analyzeSpines(record);
+      analyzeDots(record);
+      return 1;
+   }
+
+   endSegment();
+   input = NULL;
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::getTrackExInterp -- return the starting exclusive
+//     interpretation of a track in the current segment (offset from 1).
+//
+
+string HumdrumLineReader::getTrackExInterp(int track) const {
+   if ((track < 1) || (track > (int)trackexinterp.size())) {
+      return "";
+   }
+   return trackexinterp[track-1];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::printSegmentLabel -- print a !!!!SEGMENT: marker
+//     for the current segment.
+//
+
+ostream& HumdrumLineReader::printSegmentLabel(ostream& out) const {
+   out << "!!!!SEGMENT: " << segmentname << endl;
+   return out;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::printNonemptySegmentLabel -- print a !!!!SEGMENT:
+//     marker if the current segment has a filename.
+//
+
+ostream& HumdrumLineReader::printNonemptySegmentLabel(ostream& out) const {
+   if (segmentname.size() > 0) {
+      printSegmentLabel(out);
+   }
+   return out;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::startSegment -- Clear the analysis state for a new
+//     segment.
+//
+
+void HumdrumLineReader::startSegment(void) {
+   segmentname = nextname;
+   nextQ = 0;
+   segmentstartQ = 1;
+   segmentindex++;
+   linecount = 0;
+   exclusivecount = 0;
+
+   init = 0;
+   spineid = 0;
+   currentwidth = 0;
+   prediction = 0;
+   predictionQ = 0;
+   spineinfo.clear();
+   exinterps.resize(1);
+   exinterps[0] = 0;
+   trackexinterp.clear();
+
+   lastline.setSize(0);
+   lastspine.setSize(0);
+   newcount = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::endSegment -- Check that the spines of the current
+//     segment were terminated properly.
+//
+
+void HumdrumLineReader::endSegment(void) {
+   if (predictionQ && (prediction != 0)) {
+      cerr << "Error in termination of humdrum data" << endl;
+   }
+   predictionQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::analyzeSpines -- Assign spine paths and exclusive
+//     interpretations to the fields of the record, as is done for a
+//     complete file in HumdrumFileBasic::privateSpineAnalysis().  The
+//     spine count predicted by a spine manipulator is checked when
+//     the next line with spines is read.
+//
+
+void HumdrumLineReader::analyzeSpines(HumdrumRecord& record) {
+   int n = linecount;
+   int type = record.getType();
+   int i;
+
+   if (predictionQ && ((type & E_humrec_data) == E_humrec_data)) {
+      if (prediction != record.getFieldCount()) {
+         cerr << "Error on line " << n << ": "
+              << "spine count does not match:"
+              << " prediction = " << prediction
+              << " actual = " << record.getFieldCount()
+              << endl;
+         exit(1);
+      }
+      predictionQ = 0;
+   }
+
+   if (type == E_humrec_data || type == E_humrec_data_measure ||
+         type == E_humrec_data_comment) {
+      if (init == 0) {
+         cerr << "Error on line " << n
+              << " of data: no starting interpretation" << endl;
+         exit(1);
+      }
+      record.copySpineInfo(spineinfo, n);
+      currentwidth = record.getFieldCount();
+      record.setSpineWidth(currentwidth);
+   } else if (type == E_humrec_interpretation) {
+      currentwidth = record.getFieldCount();
+      if (!init) {
+         init = 1;
+         if (!record.hasExclusiveQ()) {
+            cerr << "Error on line " << n << " of file: "
+                 << "No starting exclusive interpretation" << endl;
+            exit(1);
+         }
+         if (spineinfo.size() != 0) {
+            cerr << "Error on line " << n << endl;
+            exit(1);
+         }
+         int value;
+         for (i=0; i<record.getFieldCount(); i++) {
+            if (strncmp("**", record[i], 2) != 0) {
+               cerr << "Error on line " << n << ": nonexclusive" << endl;
+            }
+            trackexinterp.push_back(record[i]);
+            spineid++;
+            spineinfo.push_back(to_string(spineid));
+            value = Convert::exint.getValue(record[i]);
+            if (spineid != (int)exinterps.size()) {
+               cerr << "Error in exclusive interpretation allocation.";
+               cerr << "Line: " << n << endl;
+               exit(1);
+            }
+            if (value == E_unknown) {
+               value = Convert::exint.add(record[i]);
+            }
+            exinterps.push_back(value);
+         }
+         record.copySpineInfo(spineinfo, n);
+         record.setSpineWidth(currentwidth);
+      } else if (record.hasExclusiveQ() || record.hasPathQ()) {
+         prediction = HumdrumFileBasic::predictNewSpineCount(record);
+         predictionQ = 1;
+         record.setSpineWidth(currentwidth);
+         currentwidth = prediction;
+         record.copySpineInfo(spineinfo, n);
+         HumdrumFileBasic::makeNewSpineInfo(spineinfo, record, prediction,
+               spineid, exinterps);
+         if (prediction == 0) {
+            init = 0;
+         }
+      } else {
+         // plain tandem interpretation
+         record.copySpineInfo(spineinfo, n);
+         record.setSpineWidth(currentwidth);
+      }
+   } else {
+      // global comment, bibliography information, or null line
+      record.setSpineWidth(currentwidth);
+   }
+
+   // provide exclusive interpretation ownerships to the record spines
+   if ((type & E_humrec_data) == E_humrec_data) {
+      int spineindex;
+      const char* ptr;
+      for (i=0; i<record.getFieldCount(); i++) {
+         ptr = record.getSpineInfo(i).c_str();
+         while (ptr[0] != '\0' && !isdigit(ptr[0])) {
+            ptr++;
+         }
+         spineindex = atoi(ptr);
+         if (spineindex < (int)exinterps.size()) {
+            record.setExInterp(i, exinterps[spineindex]);
+         }
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumLineReader::analyzeDots -- Store the line and field of the data
+//     which null tokens in the record refer to, as is done for a
+//     complete file in HumdrumFileBasic::privateDotAnalysis().
+//
+
+void HumdrumLineReader::analyzeDots(HumdrumRecord& record) {
+   int i = linecount - 1;
+   int j;
+   int count;
+   if (strncmp(record[0], "**", 2) == 0) {
+      count = record.getFieldCount();
+      lastline.setSize(count);
+      lastspine.setSize(count);
+      for (j=0; j<count; j++) {
+         lastline[j] = -1;
+         lastspine[j] = -1;
+      }
+      return;
+   } else if (record.hasPathQ()) {
+      newcount = HumdrumFileBasic::predictNewSpineCount(record);
+      HumdrumFileBasic::readjustDotArrays(lastline, lastspine, record,
+            newcount);
+      return;
+   }
+
+   if (record.getType() == E_humrec_data) {
+      if (newcount != 0 && newcount != record.getFieldCount()) {
+         cerr << "Error on line " << i+1 << ": invalid number of spines"
+              << endl;
+         exit(1);
+      }
+      newcount = 0;
+      count = record.getFieldCount();
+      for (j=0; j<count; j++) {
+         if (strcmp(record[j], ".") == 0) {
+            record.setDotLine(j, lastline[j]);
+            record.setDotSpine(j, lastspine[j]);
+         } else {
+            lastline[j] = i;
+            lastspine[j] = j;
+         }
+      }
+   }
+}
+
+
+
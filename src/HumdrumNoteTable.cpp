@@ -0,0 +1,405 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:04:14 PDT 2026
+// Last Modified: Sat Oct 17 19:04:14 PDT 2026
+// Last Modified: Sat Oct 17 21:23:05 PDT 2026 added tie links and find()
+// Last Modified: Sat Oct 17 23:19:37 PDT 2026 added update()
+// Filename:      ...sig/src/sigInfo/HumdrumNoteTable.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumNoteTable.cpp
+// Syntax:        C++
+//
+// Description:   Table of all notes in the **kern spines of a HumdrumFile,
+//                stored as parallel arrays.
+//
+
+#include "HumdrumNoteTable.h"
+#include "HumdrumFile.h"
+#include "Convert.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+// tie markers of a note token (see tieflags):
+#define NOTETABLE_TIESTART  0x01
+#define NOTETABLE_TIECONT   0x02
+#define NOTETABLE_TIEEND    0x04
+
+
+//////////////////////////////
+//
+// replaceRows -- Replace count entries of a column of the table,
+//    starting at index start, with the entries of rows.
+//
+
+template<class TYPE>
+static void replaceRows(vector<TYPE>& column, int start, int count,
+      const vector<TYPE>& rows) {
+   if ((int)rows.size() == count) {
+      std::copy(rows.begin(), rows.end(), column.begin() + start);
+      return;
+   }
+   column.erase(column.begin() + start, column.begin() + start + count);
+   column.insert(column.begin() + start, rows.begin(), rows.end());
+}
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::HumdrumNoteTable --
+//
+
+HumdrumNoteTable::HumdrumNoteTable(void) {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::~HumdrumNoteTable --
+//
+
+HumdrumNoteTable::~HumdrumNoteTable() {
+   clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::clear --
+//
+
+void HumdrumNoteTable::clear(void) {
+   line.clear();
+   field.clear();
+   subtoken.clear();
+   track.clear();
+   base40.clear();
+   midi.clear();
+   onset.clear();
+   duration.clear();
+   tiedduration.clear();
+   tie.clear();
+   tienext.clear();
+   tieend.clear();
+   attack.clear();
+   level.clear();
+   tieflags.clear();
+   linestart.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::swap -- exchange the contents of two tables.
+//
+
+void HumdrumNoteTable::swap(HumdrumNoteTable& aTable) {
+   line.swap(aTable.line);
+   field.swap(aTable.field);
+   subtoken.swap(aTable.subtoken);
+   track.swap(aTable.track);
+   base40.swap(aTable.base40);
+   midi.swap(aTable.midi);
+   onset.swap(aTable.onset);
+   duration.swap(aTable.duration);
+   tiedduration.swap(aTable.tiedduration);
+   tie.swap(aTable.tie);
+   tienext.swap(aTable.tienext);
+   tieend.swap(aTable.tieend);
+   attack.swap(aTable.attack);
+   level.swap(aTable.level);
+   tieflags.swap(aTable.tieflags);
+   linestart.swap(aTable.linestart);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::build -- Extract the notes from a HumdrumFile.  The
+//     rhythm of the file should already be analyzed (otherwise it will be
+//     analyzed with the default base).
+//
+
+void HumdrumNoteTable::build(HumdrumFile& infile) {
+   clear();
+   if (!infile.rhythmQ()) {
+      infile.analyzeRhythm();
+   }
+
+   Array<int> metlev;
+   infile.analyzeMetricLevel(metlev);
+
+   int i;
+   int estimate = 0;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (infile[i].isData()) {
+         estimate += infile[i].getFieldCount();
+      }
+   }
+   reserve(estimate);
+
+   linestart.resize(infile.getNumLines() + 1);
+   for (i=0; i<infile.getNumLines(); i++) {
+      linestart[i] = (int)line.size();
+      if (infile[i].isData()) {
+         addLine(infile, i, metlev[i]);
+      }
+   }
+   linestart[infile.getNumLines()] = (int)line.size();
+
+   linkTies();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::update -- Extract the notes of the lines from
+//     startline to stopline again after the rhythm of the file was
+//     analyzed again for those lines, and add delta to the onsets of
+//     the notes after them.  The other lines must not have been changed
+//     since the table was built, except for their absolute beats.
+//
+
+void HumdrumNoteTable::update(HumdrumFile& infile, int startline, 
+      int stopline, const RationalNumber64& delta) {
+   if ((int)linestart.size() != infile.getNumLines() + 1) {
+      build(infile);
+      return;
+   }
+
+   Array<int> metlev;
+   infile.analyzeMetricLevel(metlev, startline, stopline);
+
+   int i;
+   int start = linestart[startline];
+   int count = linestart[stopline+1] - start;
+   HumdrumNoteTable rows;
+   for (i=startline; i<=stopline; i++) {
+      linestart[i] = start + rows.getSize();
+      if (infile[i].isData()) {
+         rows.addLine(infile, i, metlev[i]);
+      }
+   }
+   int shift = rows.getSize() - count;
+   for (i=stopline+1; i<(int)linestart.size(); i++) {
+      linestart[i] += shift;
+   }
+
+   replaceRows(line,     start, count, rows.line);
+   replaceRows(field,    start, count, rows.field);
+   replaceRows(subtoken, start, count, rows.subtoken);
+   replaceRows(track,    start, count, rows.track);
+   replaceRows(base40,   start, count, rows.base40);
+   replaceRows(midi,     start, count, rows.midi);
+   replaceRows(onset,    start, count, rows.onset);
+   replaceRows(duration, start, count, rows.duration);
+   replaceRows(level,    start, count, rows.level);
+   replaceRows(tieflags, start, count, rows.tieflags);
+
+   if (delta != 0) {
+      for (i=start+rows.getSize(); i<getSize(); i++) {
+         onset[i] += delta;
+      }
+   }
+
+   linkTies();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::addLine -- Add the notes of a data line to the
+//     end of the table, without linking their ties.
+//
+
+void HumdrumNoteTable::addLine(HumdrumFile& infile, int aLine, int aLevel) {
+   HumdrumRecord& record = infile[aLine];
+   KernTokenInfo info;
+   char buffer[1024] = {0};
+   int tokencount;
+   int ptrack;
+   int flags;
+   int j, k;
+   for (j=0; j<record.getFieldCount(); j++) {
+      if (record.getExInterpNum(j) != E_KERN_EXINT) {
+         continue;
+      }
+      if (strcmp(record[j], ".") == 0) {
+         continue;
+      }
+      ptrack = record.getPrimaryTrack(j);
+      // only chords need to be split into subtokens
+      tokencount = 1;
+      if (strchr(record[j], ' ') != NULL) {
+         tokencount = record.getTokenCount(j);
+      }
+      for (k=0; k<tokencount; k++) {
+         if (tokencount == 1) {
+            Convert::scanKernToken(info, record[j]);
+         } else {
+            record.getToken(buffer, j, k, 1000);
+            Convert::scanKernToken(info, buffer);
+         }
+         if (info.restQ || (info.base40 < 0) ||
+               (info.base40 == E_unknown)) {
+            continue;
+         }
+         flags = 0;
+         if (info.tiestartQ) { flags |= NOTETABLE_TIESTART; }
+         if (info.tiecontQ)  { flags |= NOTETABLE_TIECONT;  }
+         if (info.tieendQ)   { flags |= NOTETABLE_TIEEND;   }
+         line.push_back(aLine);
+         field.push_back(j);
+         subtoken.push_back(k);
+         track.push_back(ptrack);
+         base40.push_back(info.base40);
+         midi.push_back(Convert::base40ToMidiNoteNumber(info.base40));
+         onset.push_back(record.getAbsBeatR64());
+         duration.push_back(info.duration);
+         level.push_back(aLevel);
+         tieflags.push_back((char)flags);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::linkTies -- Link the tied notes in one pass through
+//     the table.  Tied notes are linked by primary track and MIDI key
+//     number (allowing for enharmonic ties, and ties on any note of a
+//     chord).  A tie continuation which does not match an open tie is
+//     treated as the start of a new tie group, and a tie start replaces
+//     an unfinished tie on the same key in the track.
+//
+
+void HumdrumNoteTable::linkTies(void) {
+   int size = getSize();
+   tie.resize(size);
+   tienext.assign(size, -1);
+   tieend.resize(size);
+   attack.resize(size);
+   tiedduration.assign(size, RationalNumber64(0));
+
+   int maxtrack = 0;
+   int index;
+   for (index=0; index<size; index++) {
+      if (track[index] > maxtrack) {
+         maxtrack = track[index];
+      }
+   }
+
+   // open ties for each track (index of the first note in the tie):
+   vector<vector<int> > openties(maxtrack + 1);
+
+   int key;
+   int head;
+   int m;
+   for (index=0; index<size; index++) {
+      key = midi[index];
+      head = -1;
+      if (tieflags[index] & (NOTETABLE_TIECONT | NOTETABLE_TIEEND)) {
+         vector<int>& open = openties[track[index]];
+         for (m=0; m<(int)open.size(); m++) {
+            if (midi[open[m]] == key) {
+               head = open[m];
+               if (!(tieflags[index] & NOTETABLE_TIECONT)) {
+                  open.erase(open.begin() + m);
+               }
+               break;
+            }
+         }
+         attack[index] = 0;
+      } else {
+         attack[index] = 1;
+      }
+      if (head < 0) {
+         head = index;
+         tieend[index] = index;
+         if (tieflags[index] & NOTETABLE_TIESTART) {
+            vector<int>& open = openties[track[index]];
+            for (m=0; m<(int)open.size(); m++) {
+               if (midi[open[m]] == key) {
+                  open.erase(open.begin() + m);
+                  break;
+               }
+            }
+            open.push_back(index);
+         }
+      } else {
+         tienext[tieend[head]] = index;
+         tieend[head] = index;
+         tieend[index] = index;
+      }
+      tie[index] = head;
+      tiedduration[head] += duration[index];
+   }
+
+   for (index=0; index<size; index++) {
+      if (tie[index] != index) {
+         tiedduration[index] = tiedduration[tie[index]];
+         tieend[index] = tieend[tie[index]];
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::find -- return the index of a note in the table
+//     from its location in the file, or -1 if there is no note at the
+//     location (such as a rest or a null token).  Only the notes on 
+//     the given line are searched.
+//     default value: aSubtoken = 0
+//
+
+int HumdrumNoteTable::find(int aLine, int aField, int aSubtoken) const {
+   if ((aLine < 0) || (aLine >= (int)linestart.size() - 1)) {
+      return -1;
+   }
+   int i;
+   for (i=linestart[aLine]; i<linestart[aLine+1]; i++) {
+      if ((field[i] == aField) && (subtoken[i] == aSubtoken)) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumNoteTable::reserve -- allocate space for the expected number
+//     of notes.
+//
+
+void HumdrumNoteTable::reserve(int size) {
+   line.reserve(size);
+   field.reserve(size);
+   subtoken.reserve(size);
+   track.reserve(size);
+   base40.reserve(size);
+   midi.reserve(size);
+   onset.reserve(size);
+   duration.reserve(size);
+   tiedduration.reserve(size);
+   tie.reserve(size);
+   tienext.reserve(size);
+   tieend.reserve(size);
+   attack.reserve(size);
+   level.reserve(size);
+   tieflags.reserve(size);
+}
+
+
+
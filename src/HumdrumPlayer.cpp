@@ -0,0 +1,1013 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 22:16:50 PDT 2026
+// Last Modified: Sat Oct 17 22:16:50 PDT 2026
+// Last Modified: Sat Oct 17 23:36:11 PDT 2026 accents scale the velocity of one note
+// Filename:      ...sig/src/sigInfo/HumdrumPlayer.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumPlayer.cpp
+// Syntax:        C++
+//
+// Description:   Real-time playback of the **kern spines of a HumdrumFile
+//                from a precalculated schedule of events.
+//
+
+#include "HumdrumPlayer.h"
+#include "HumdrumNoteTable.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <errno.h>
+#include <time.h>
+
+#include <algorithm>
+#include <chrono>
+
+// event types, in the order that events at the same time are played:
+#define HUMPLAY_NOTEOFF 0
+#define HUMPLAY_LINE    1
+#define HUMPLAY_NOTEON  2
+
+// The playback thread waits on the condition variable (so that it can be
+// woken up by pause(), seek(), etc.) until this many nanoseconds before
+// the next event, and then sleeps until the exact time of the event:
+#define SLEEP_MARGIN 2000000LL
+
+
+//////////////////////////////
+//
+// HumdrumPlayerMemorySink::send --
+//
+
+void HumdrumPlayerMemorySink::send(const unsigned char* data, int size,
+      double aTime) {
+   time.push_back(aTime);
+   message.push_back(vector<unsigned char>(data, data + size));
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayerMemorySink::clear --
+//
+
+void HumdrumPlayerMemorySink::clear(void) {
+   time.clear();
+   message.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayerFileSink::HumdrumPlayerFileSink --
+//
+
+HumdrumPlayerFileSink::HumdrumPlayerFileSink(const char* filename) {
+   open(filename);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayerFileSink::~HumdrumPlayerFileSink --
+//
+
+HumdrumPlayerFileSink::~HumdrumPlayerFileSink() {
+   close();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayerFileSink::open -- Returns 0 if the file could not be opened.
+//
+
+int HumdrumPlayerFileSink::open(const char* filename) {
+   close();
+   outfile.open(filename, ios::out | ios::binary);
+   return outfile.is_open();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayerFileSink::close --
+//
+
+void HumdrumPlayerFileSink::close(void) {
+   if (outfile.is_open()) {
+      outfile.close();
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayerFileSink::send -- Each message is flushed immediately,
+//     since the file may be a MIDI device.
+//
+
+void HumdrumPlayerFileSink::send(const unsigned char* data, int size,
+      double aTime) {
+   if (!outfile.is_open()) {
+      return;
+   }
+   outfile.write((const char*)data, size);
+   outfile.flush();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::HumdrumPlayer --
+//
+
+HumdrumPlayer::HumdrumPlayer(void) {
+   defaulttempo = 120.0;
+   shorten      = 0;
+   minimum      = 30;
+   sink         = NULL;
+   channel      = 0;
+   velocity     = 64;
+   transpose    = 0;
+   temposcale   = 1.0;
+   index        = 0;
+   currentline  = -1;
+   anchorclock  = 0;
+   anchorscore  = 0.0;
+   starttime    = 0;
+   pausedQ      = 0;
+   playingQ     = 0;
+   stopQ        = 0;
+   generation   = 0;
+   resetStatistics();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::~HumdrumPlayer --
+//
+
+HumdrumPlayer::~HumdrumPlayer() {
+   stop();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setDefaultTempo -- Tempo used until the first *MM
+//     marking in the file (default 120).  Used by the next call to load().
+//
+
+void HumdrumPlayer::setDefaultTempo(double tempo) {
+   if (tempo > 0.0) {
+      defaulttempo = tempo;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setShorten -- Number of milliseconds (at the written
+//     tempo) to remove from the end of each note (default 0).  Used by
+//     the next call to load().
+//
+
+void HumdrumPlayer::setShorten(int milliseconds) {
+   shorten = milliseconds < 0 ? 0 : milliseconds;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setMinimumDuration -- The shortest duration in
+//     milliseconds that a note can be shortened to (default 30).  Used
+//     by the next call to load().
+//
+
+void HumdrumPlayer::setMinimumDuration(int milliseconds) {
+   minimum = milliseconds < 0 ? 0 : milliseconds;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setSink -- Set the destination of the MIDI messages.
+//     The sink is not deleted by the player.
+//
+
+void HumdrumPlayer::setSink(HumdrumPlayerSink* aSink) {
+   lock_guard<mutex> guard(lock);
+   silenceNotes();
+   sink = aSink;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setChannel -- MIDI channel (offset from 0) for all notes.
+//
+
+void HumdrumPlayer::setChannel(int aChannel) {
+   lock_guard<mutex> guard(lock);
+   silenceNotes();
+   channel = aChannel & 0x0f;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setVelocity -- Attack velocity of notes (default 64).
+//     Accents (x1.3) and sforzandos (x1.5) increase the velocity of the
+//     accented note only.
+//
+
+void HumdrumPlayer::setVelocity(int aVelocity) {
+   lock_guard<mutex> guard(lock);
+   if (aVelocity < 1) {
+      aVelocity = 1;
+   } else if (aVelocity > 127) {
+      aVelocity = 127;
+   }
+   velocity = aVelocity;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getVelocity --
+//
+
+int HumdrumPlayer::getVelocity(void) {
+   lock_guard<mutex> guard(lock);
+   return velocity;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setTranspose -- Transpose the notes which start after
+//     this point by the given number of semitones.
+//
+
+void HumdrumPlayer::setTranspose(int semitones) {
+   lock_guard<mutex> guard(lock);
+   transpose = semitones;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getTranspose --
+//
+
+int HumdrumPlayer::getTranspose(void) {
+   lock_guard<mutex> guard(lock);
+   return transpose;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setMute -- Do not play the notes in the given (primary)
+//     track which start after this point.
+//
+
+void HumdrumPlayer::setMute(int track, int state) {
+   if (track < 0) {
+      return;
+   }
+   lock_guard<mutex> guard(lock);
+   if (track >= (int)mute.size()) {
+      mute.resize(track+1, 0);
+   }
+   mute[track] = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getMute --
+//
+
+int HumdrumPlayer::getMute(int track) {
+   lock_guard<mutex> guard(lock);
+   if ((track < 0) || (track >= (int)mute.size())) {
+      return 0;
+   }
+   return mute[track];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setTempoScale -- Multiply the tempo of the file by the
+//     given factor.  The current position in the score is anchored to the
+//     current time, so the change takes effect immediately.
+//
+
+void HumdrumPlayer::setTempoScale(double scale) {
+   if (scale <= 0.0) {
+      return;
+   }
+   lock_guard<mutex> guard(lock);
+   if (!pausedQ) {
+      long long now = getClockTime();
+      anchorscore = getScoreTime(now);
+      anchorclock = now;
+   }
+   temposcale = scale;
+   generation++;
+   wakeup.notify_all();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getTempoScale --
+//
+
+double HumdrumPlayer::getTempoScale(void) {
+   lock_guard<mutex> guard(lock);
+   return temposcale;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::setTempo -- Set the tempo scaling so that the current
+//     line plays at the given tempo.
+//
+
+void HumdrumPlayer::setTempo(double tempo) {
+   double current = defaulttempo;
+   {
+      lock_guard<mutex> guard(lock);
+      if (!linetempo.empty()) {
+         current = linetempo[currentline < 0 ? 0 : currentline];
+      }
+   }
+   if (tempo > 0.0) {
+      setTempoScale(tempo / current);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getTempo -- Return the (scaled) tempo of the current line.
+//
+
+double HumdrumPlayer::getTempo(void) {
+   lock_guard<mutex> guard(lock);
+   if (linetempo.empty()) {
+      return defaulttempo * temposcale;
+   }
+   return linetempo[currentline < 0 ? 0 : currentline] * temposcale;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::load -- Calculate the times of the notes and lines in
+//     the file.  The rhythm of the file must be analyzed with
+//     analyzeRhythm("4") beforehand.  Stops any file being played.
+//
+
+void HumdrumPlayer::load(HumdrumFile& infile) {
+   clear();
+
+   int i, j;
+   int lines = infile.getNumLines();
+   linetime.resize(lines);
+   linetempo.resize(lines);
+   lineindex.resize(lines);
+
+   double tempo = defaulttempo;
+   double value;
+   double time = 0.0;
+   for (i=0; i<lines; i++) {
+      if (infile[i].isInterpretation()) {
+         for (j=0; j<infile[i].getFieldCount(); j++) {
+            if ((strncmp(infile[i][j], "*MM", 3) == 0) &&
+                  isdigit(infile[i][j][3])) {
+               value = atof(&infile[i][j][3]);
+               if (value > 0.0) {
+                  tempo = value;
+               }
+               break;
+            }
+         }
+      }
+      linetempo[i] = tempo;
+      linetime[i]  = time;
+      time += infile[i].getDuration() * 60.0 / tempo;
+   }
+
+   const HumdrumNoteTable& notes = infile.getNoteTable();
+   events.reserve(lines + 2 * notes.getSize());
+
+   _HumdrumPlayerEvent event;
+   event.track  = 0;
+   event.note   = -1;
+   event.key    = 0;
+   event.accent = 1.0;
+   event.type   = HUMPLAY_LINE;
+   for (i=0; i<lines; i++) {
+      event.time = linetime[i];
+      event.line = i;
+      events.push_back(event);
+   }
+
+   char buffer[1024] = {0};
+   double endtime;
+   double duration;
+   for (i=0; i<notes.getSize(); i++) {
+      if (!notes.isAttack(i) || (notes.midi[i] < 0)) {
+         continue;
+      }
+      event.line  = notes.line[i];
+      event.track = notes.track[i];
+      event.note  = i;
+      event.key   = notes.midi[i];
+      infile[event.line].getToken(buffer, notes.field[i], notes.subtoken[i],
+            1000);
+      event.accent = 1.0;
+      if (strchr(buffer, '^') != NULL) {
+         event.accent *= 1.3;
+      }
+      if (strchr(buffer, 'z') != NULL) {
+         event.accent *= 1.5;
+      }
+
+      endtime = getBeatTime(infile, notes.onset[i] + notes.tiedduration[i],
+            event.line);
+      duration = endtime - linetime[event.line];
+      if (shorten > 0) {
+         duration -= shorten / 1000.0;
+         if (duration < minimum / 1000.0) {
+            duration = minimum / 1000.0;
+         }
+      }
+      if (strchr(buffer, '\'') != NULL) {
+         // staccato
+         duration *= 0.5;
+      }
+      if (duration < 0.001) {
+         // keep the note-off after the note-on
+         duration = 0.001;
+      }
+
+      event.time = linetime[event.line];
+      event.type = HUMPLAY_NOTEON;
+      events.push_back(event);
+      event.time += duration;
+      event.type = HUMPLAY_NOTEOFF;
+      events.push_back(event);
+   }
+   stable_sort(events.begin(), events.end(), eventCompare);
+
+   for (i=0; i<(int)events.size(); i++) {
+      if (events[i].type == HUMPLAY_LINE) {
+         lineindex[events[i].line] = i;
+      }
+   }
+   sounding.resize(notes.getSize());
+   std::fill(sounding.begin(), sounding.end(), -1);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::clear -- Stop playing and remove the loaded file.
+//
+
+void HumdrumPlayer::clear(void) {
+   stop();
+   events.clear();
+   linetime.clear();
+   linetempo.clear();
+   lineindex.clear();
+   sounding.clear();
+   index = 0;
+   currentline = -1;
+   anchorscore = 0.0;
+   pausedQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::play -- Start playing from the current position after
+//     the given number of seconds.  Starts the playback thread if it is
+//     not running.
+//
+
+void HumdrumPlayer::play(double delay) {
+   unique_lock<mutex> guard(lock);
+   long long now = getClockTime();
+   starttime   = now;
+   anchorclock = now + (long long)(delay * 1000000000.0);
+   if (index < (int)events.size()) {
+      anchorscore = events[index].time;
+   }
+   pausedQ = 0;
+   generation++;
+   if (!playingQ) {
+      stopQ    = 0;
+      playingQ = 1;
+      player   = thread(&HumdrumPlayer::run, this);
+   }
+   wakeup.notify_all();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::stop -- Stop the playback thread and turn off any
+//     notes which are sounding.  The position in the file is kept.
+//
+
+void HumdrumPlayer::stop(void) {
+   {
+      lock_guard<mutex> guard(lock);
+      if (!playingQ) {
+         return;
+      }
+      stopQ = 1;
+      wakeup.notify_all();
+   }
+   player.join();
+   lock_guard<mutex> guard(lock);
+   playingQ = 0;
+   silenceNotes();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::pause -- Stop playing at the current position.
+//
+
+void HumdrumPlayer::pause(void) {
+   lock_guard<mutex> guard(lock);
+   if (pausedQ) {
+      return;
+   }
+   anchorscore = getScoreTime(getClockTime());
+   pausedQ = 1;
+   silenceNotes();
+   generation++;
+   wakeup.notify_all();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::resume -- Continue playing after pause().
+//
+
+void HumdrumPlayer::resume(void) {
+   lock_guard<mutex> guard(lock);
+   if (!pausedQ) {
+      return;
+   }
+   anchorclock = getClockTime();
+   pausedQ = 0;
+   generation++;
+   wakeup.notify_all();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::isPaused --
+//
+
+int HumdrumPlayer::isPaused(void) {
+   lock_guard<mutex> guard(lock);
+   return pausedQ;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::isFinished -- Returns true if all events in the file
+//     have been played.
+//
+
+int HumdrumPlayer::isFinished(void) {
+   lock_guard<mutex> guard(lock);
+   return index >= (int)events.size();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::seek -- Continue playing from the start of the given line.
+//
+
+void HumdrumPlayer::seek(int line) {
+   lock_guard<mutex> guard(lock);
+   silenceNotes();
+   if (line < 0) {
+      line = 0;
+   }
+   if (line >= (int)lineindex.size()) {
+      index = (int)events.size();
+      currentline = (int)lineindex.size() - 1;
+   } else {
+      index = lineindex[line];
+      currentline = line - 1;
+      anchorscore = linetime[line];
+   }
+   anchorclock = getClockTime();
+   generation++;
+   wakeup.notify_all();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::silence -- Turn off the notes which are sounding.
+//
+
+void HumdrumPlayer::silence(void) {
+   lock_guard<mutex> guard(lock);
+   silenceNotes();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getLine -- Return the index of the last line which
+//     has been played, or -1 if none.
+//
+
+int HumdrumPlayer::getLine(void) {
+   lock_guard<mutex> guard(lock);
+   return currentline;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::resetStatistics --
+//
+
+void HumdrumPlayer::resetStatistics(void) {
+   lock_guard<mutex> guard(lock);
+   statcount      = 0;
+   statsum        = 0.0;
+   statsumsquares = 0.0;
+   statmax        = 0.0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getEventCount -- Number of MIDI messages sent since the
+//     statistics were reset.
+//
+
+int HumdrumPlayer::getEventCount(void) {
+   lock_guard<mutex> guard(lock);
+   return statcount;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getMeanLatency -- Average time in microseconds after
+//     their deadlines that MIDI messages were sent.
+//
+
+double HumdrumPlayer::getMeanLatency(void) {
+   lock_guard<mutex> guard(lock);
+   if (statcount == 0) {
+      return 0.0;
+   }
+   return statsum / statcount / 1000.0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getMaxLatency -- Largest latency in microseconds.
+//
+
+double HumdrumPlayer::getMaxLatency(void) {
+   lock_guard<mutex> guard(lock);
+   return statmax / 1000.0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getJitter -- Standard deviation of the latency
+//     in microseconds.
+//
+
+double HumdrumPlayer::getJitter(void) {
+   lock_guard<mutex> guard(lock);
+   if (statcount == 0) {
+      return 0.0;
+   }
+   double mean = statsum / statcount;
+   double variance = statsumsquares / statcount - mean * mean;
+   if (variance < 0.0) {
+      variance = 0.0;
+   }
+   return sqrt(variance) / 1000.0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// HumdrumPlayer::run -- Playback thread.  Waits until the deadline of
+//     the next event, then plays all events which are due.
+//
+
+void HumdrumPlayer::run(void) {
+   unique_lock<mutex> guard(lock);
+   long long deadline;
+   long long now;
+   int gen;
+   while (!stopQ) {
+      if (pausedQ || (index >= (int)events.size())) {
+         wakeup.wait(guard);
+         continue;
+      }
+      gen = generation;
+      deadline = getDeadline(events[index].time);
+      now = getClockTime();
+      if (deadline - now > SLEEP_MARGIN) {
+         wakeup.wait_for(guard,
+               chrono::nanoseconds(deadline - now - SLEEP_MARGIN));
+         continue;
+      }
+      if (deadline > now) {
+         guard.unlock();
+         sleepUntil(deadline);
+         guard.lock();
+         if ((gen != generation) || stopQ) {
+            continue;
+         }
+      }
+      while ((index < (int)events.size()) && !pausedQ) {
+         deadline = getDeadline(events[index].time);
+         if (deadline > getClockTime()) {
+            break;
+         }
+         dispatch(events[index], deadline);
+         index++;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::dispatch -- Send the MIDI message for an event.  Called
+//     with the lock held.
+//
+
+void HumdrumPlayer::dispatch(_HumdrumPlayerEvent& event, long long deadline) {
+   unsigned char message[3];
+   switch (event.type) {
+      case HUMPLAY_LINE:
+         currentline = event.line;
+         return;
+
+      case HUMPLAY_NOTEON:
+         {
+            if ((event.track < (int)mute.size()) && mute[event.track]) {
+               return;
+            }
+            int key = event.key + transpose;
+            if ((key < 0) || (key > 127)) {
+               return;
+            }
+            int vel = (int)(velocity * event.accent + 0.5);
+            if (vel > 127) {
+               vel = 127;
+            }
+            sounding[event.note] = key;
+            message[0] = 0x90 | channel;
+            message[1] = key;
+            message[2] = vel;
+         }
+         break;
+
+      case HUMPLAY_NOTEOFF:
+         if (sounding[event.note] < 0) {
+            return;
+         }
+         message[0] = 0x80 | channel;
+         message[1] = sounding[event.note];
+         message[2] = 0;
+         sounding[event.note] = -1;
+         break;
+
+      default:
+         return;
+   }
+
+   if (sink == NULL) {
+      return;
+   }
+   long long now = getClockTime();
+   sink->send(message, 3, (now - starttime) / 1000000000.0);
+
+   double latency = (double)(now - deadline);
+   statcount++;
+   statsum += latency;
+   statsumsquares += latency * latency;
+   if (latency > statmax) {
+      statmax = latency;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::silenceNotes -- Send note-offs for the notes which are
+//     sounding.  Called with the lock held.
+//
+
+void HumdrumPlayer::silenceNotes(void) {
+   unsigned char message[3];
+   double time = (getClockTime() - starttime) / 1000000000.0;
+   int i;
+   for (i=0; i<(int)sounding.size(); i++) {
+      if (sounding[i] < 0) {
+         continue;
+      }
+      if (sink != NULL) {
+         message[0] = 0x80 | channel;
+         message[1] = sounding[i];
+         message[2] = 0;
+         sink->send(message, 3, time);
+      }
+      sounding[i] = -1;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getScoreTime -- Position in the score (in seconds at
+//     a tempo scaling of 1.0) at the given clock time.
+//
+
+double HumdrumPlayer::getScoreTime(long long now) {
+   if (pausedQ) {
+      return anchorscore;
+   }
+   return anchorscore + (now - anchorclock) / 1000000000.0 * temposcale;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getDeadline -- Clock time when the given score time
+//     should be played.
+//
+
+long long HumdrumPlayer::getDeadline(double time) {
+   return anchorclock +
+         (long long)((time - anchorscore) / temposcale * 1000000000.0);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getBeatTime -- Return the score time of an absolute beat
+//     position, using the tempo of the last line at or before the beat.
+//     startline is a line at or before the beat.
+//
+
+double HumdrumPlayer::getBeatTime(HumdrumFile& infile,
+      const RationalNumber64& beat, int startline) {
+   int line = startline;
+   int lines = infile.getNumLines();
+   while ((line + 1 < lines) && (infile[line+1].getAbsBeatR64() <= beat)) {
+      line++;
+   }
+   return linetime[line] + (beat - infile[line].getAbsBeatR64()).getFloat()
+         * 60.0 / linetempo[line];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::getClockTime -- Monotonic clock time in nanoseconds.
+//
+
+long long HumdrumPlayer::getClockTime(void) {
+   #if defined(VISUAL) || defined(__APPLE__)
+      return chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count();
+   #else
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::sleepUntil -- Sleep until the given clock time
+//     (from getClockTime()).
+//
+
+void HumdrumPlayer::sleepUntil(long long clocktime) {
+   #if defined(VISUAL) || defined(__APPLE__)
+      // no clock_nanosleep():
+      this_thread::sleep_until(chrono::steady_clock::time_point(
+            chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::nanoseconds(clocktime))));
+   #else
+      struct timespec deadline;
+      deadline.tv_sec  = clocktime / 1000000000LL;
+      deadline.tv_nsec = clocktime % 1000000000LL;
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline,
+            NULL) == EINTR) {
+         // interrupted by a signal: sleep again until the deadline
+      }
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumPlayer::eventCompare -- Sort events by time, with note-offs
+//     before lines before note-ons at the same time.
+//
+
+bool HumdrumPlayer::eventCompare(const _HumdrumPlayerEvent& a,
+      const _HumdrumPlayerEvent& b) {
+   if (a.time != b.time) {
+      return a.time < b.time;
+   }
+   return a.type < b.type;
+}
+
+
+
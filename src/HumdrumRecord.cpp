@@ -22,6 +22,12 @@
 // Last Modified: Sun Dec 26 12:18:34 PST 2010 added setToken
 // Last Modified: Mon Jul 30 16:10:45 PDT 2012 added setSize and setAllFields
 // Last Modified: Mon Dec 10 10:14:08 PST 2012 added Array<char> getToken
+// Last Modified: Sat Oct 17 17:39:08 PDT 2026 added HumdrumArena storage
+// Last Modified: Sat Oct 17 17:49:13 PDT 2026 added setLine with length
+// Last Modified: Sat Oct 17 18:56:50 PDT 2026 added RationalNumber64 storage
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026 added arena text constructor
+// Last Modified: Sat Oct 17 21:10:16 PDT 2026 lock-free interpretation tests
+// Last Modified: Sat Oct 17 22:47:20 PDT 2026 report changes to owning file
 // Filename:      ...sig/src/sigInfo/HumdrumRecord.cpp
 // Webpage:       http://sig.sapp.org/src/sigInfo/HumdrumRecord.cpp
 // Syntax:        C++ 
@@ -37,6 +43,7 @@
 
 #include "Convert.h"
 #include "HumdrumRecord.h"
+#include "HumdrumFileBasic.h"
 #include "PerlRegularExpression.h"
 #include <sstream>
 
@@ -58,6 +65,9 @@ HumdrumRecord::HumdrumRecord(void) {
    spinewidth = 0;
 
    type = E_unknown;
+   arena = NULL;
+   owner = NULL;
+   ownerindex = -1;
    recordString = new char[1];
    recordString[0] = '\0';
    modifiedQ = 0;
@@ -96,6 +106,9 @@ HumdrumRecord::HumdrumRecord(const char* aLine, int aLineNum) {
 
    lineno = aLineNum;
    type = determineType(aLine);
+   arena = NULL;
+   owner = NULL;
+   ownerindex = -1;
    recordString = new char[1];
    recordString[0] = '\0';
    modifiedQ = 0;
@@ -132,6 +145,9 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
    spinewidth = aRecord.spinewidth;
    type = aRecord.type;
    lineno = aRecord.lineno;
+   arena = NULL;
+   owner = NULL;
+   ownerindex = -1;
    recordString = new char[strlen(aRecord.recordString)+1];
    strcpy(recordString, aRecord.recordString);
    modifiedQ = aRecord.modifiedQ;
@@ -155,6 +171,38 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
 }
 
 
+// Record for text which is already stored in an arena, without parsing
+// the text or preallocating the arrays, since HumdrumCache fills them in
+// with their final sizes.
+
+HumdrumRecord::HumdrumRecord(HumdrumArena* anArena, char* aString) {
+   duration = 0.0;
+   durationR.zero();
+   meterloc = 0.0;
+   meterlocR.zero();
+   absloc   = 0.0;
+   abslocR.zero();
+   spinewidth = 0;
+
+   type = E_unknown;
+   arena = anArena;
+   owner = NULL;
+   ownerindex = -1;
+   recordString = aString;
+   modifiedQ = 0;
+   lineno = -1;
+
+   recordFields.allowGrowth(1);
+   recordFields.setGrowth(132);
+   interpretation.allowGrowth(1);
+   interpretation.setGrowth(132);
+   dotline.allowGrowth(1);
+   dotline.setGrowth(132);
+   dotspine.allowGrowth(1);
+   dotspine.setGrowth(132);
+}
+
+
 
 //////////////////////////////
 //
@@ -162,18 +210,7 @@ HumdrumRecord::HumdrumRecord(const HumdrumRecord& aRecord) {
 //
 
 HumdrumRecord::~HumdrumRecord() {
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
-   int i;
-   for (i=0; i<recordFields.getSize(); i++) {
-      if (recordFields[i] != NULL) {
-         delete [] recordFields[i];
-         recordFields[i] = NULL;
-      }
-   }
-   recordFields.setSize(0);
+   clearFields();
 
    spineids.clear();
 
@@ -224,14 +261,13 @@ void HumdrumRecord::changeField(int aField, const char* aString) {
       return;
    }
 
-   if (recordFields[aField] != NULL) {
-      delete [] recordFields[aField];
-      recordFields[aField] = NULL;
-   }
-   recordFields[aField] = new char[strlen(aString) + 1];
-   strcpy(recordFields[aField], aString);
+   // copy before freeing in case aString is a part of the old field
+   char* newfield = copyString(aString);
+   freeString(recordFields[aField]);
+   recordFields[aField] = newfield;
    
    modifiedQ = 1;
+   markOwnerDirty();
 }
 
 
@@ -430,44 +466,15 @@ char* HumdrumRecord::getBibKey(Array<char>& buffer) {
 //
 
 char* HumdrumRecord::getBibValue(char* buffer, int maxsize) {
-
-   if (!isBibliographic()) {
-      buffer[0] = '\0';
-      return buffer;
+   const char* value = NULL;
+   if (isBibliographic()) {
+      value = findBibValue(recordString);
    }
-
-   PerlRegularExpression pre;
-   if (pre.search(recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
-      strcpy(buffer, pre.getSubmatch(1));
+   if (value == NULL) {
+      buffer[0] = '\0';
       return buffer;
    }
-
-/*
-   int length = strlen(recordString);
-   int i;
-   int j;
-
-   for (i=3; i<length; i++) {
-      if (recordString[i] == ':') {
-         i++;
-         while ((i < length) && (std::isspace(recordString[i]))) {
-            i++;
-         }
-         strncpy(buffer, recordString + i, maxsize);
-         length = strlen(buffer);
-         for (j=length-1; j>=0; j++) {
-            if (std::isspace(buffer[j])) {
-               buffer[j] = '\0';
-            } else {
-               break;
-            }
-         }
-         return buffer;
-      }
-
-   }
-*/
-   buffer[0] = '\0';
+   strcpy(buffer, value);
    return buffer;
 }
 
@@ -477,24 +484,62 @@ char* HumdrumRecord::getBibValue(char* buffer, int maxsize) {
 //
 
 char* HumdrumRecord::getBibValue(Array<char>& buffer) {
-   if (!isBibliographic()) {
+   const char* value = NULL;
+   if (isBibliographic()) {
+      value = findBibValue(recordString);
+   }
+   if (value == NULL) {
       buffer.setSize(1);
       buffer[0] = '\0';
       return buffer.getBase();
    }
+   buffer.setSize(strlen(value)+1);
+   strcpy(buffer.getBase(), value);
+   return buffer.getBase();
+}
 
-   PerlRegularExpression pre;
-   int length;
-   if (pre.search(recordString, "^!!![^:]+:\\s*(.*)\\s*$", "")) {
-      length = strlen(pre.getSubmatch(1));
-      buffer.setSize(length+1);
-      strcpy(buffer.getBase(), pre.getSubmatch());
-      return buffer.getBase();
+
+//
+// string version
+//
+
+string& HumdrumRecord::getBibValue(string& buffer) {
+   const char* value = NULL;
+   if (isBibliographic()) {
+      value = findBibValue(recordString);
    }
+   if (value == NULL) {
+      buffer.clear();
+   } else {
+      buffer = value;
+   }
+   return buffer;
+}
 
-   buffer.setSize(1);
-   buffer[0] = '\0';
-   return buffer.getBase();
+
+
+//////////////////////////////
+//
+// HumdrumRecord::findBibValue -- returns the start of the value in
+//    the text of a bibliographic record: the text after the first
+//    colon without leading spaces (trailing spaces are kept).  Returns
+//    NULL if there is no colon after a non-empty key.
+//
+
+const char* HumdrumRecord::findBibValue(const char* record) {
+   if ((strncmp(record, "!!!", 3) != 0) || (record[3] == '\0') || 
+         (record[3] == ':')) {
+      return NULL;
+   }
+   const char* ptr = strchr(record+4, ':');
+   if (ptr == NULL) {
+      return NULL;
+   }
+   ptr++;
+   while ((*ptr != '\0') && std::isspace((unsigned char)*ptr)) {
+      ptr++;
+   }
+   return ptr;
 }
 
 
@@ -504,8 +549,10 @@ char* HumdrumRecord::getBibValue(Array<char>& buffer) {
 // HumdrumRecord::getAbsBeat -- returns the absolute beat location
 //    in the file.  This value is by default 0, but can be set
 //    manally with the setAbsBeat() function, or by calling
-//    HumdrumFile::analyzeRhythm().  abslocR() returns the rational
-//    value of the absolute beat.
+//    HumdrumFile::analyzeRhythm().  getAbsBeatR() returns the rational
+//    value of the absolute beat, and getAbsBeatR64() returns the value
+//    as it is stored (which may not fit into a RationalNumber in files
+//    with complicated tuplets).
 //
 
 double HumdrumRecord::getAbsBeat(void) const { 
@@ -514,7 +561,7 @@ double HumdrumRecord::getAbsBeat(void) const {
 
 
 RationalNumber HumdrumRecord::getAbsBeatR(void) const { 
-   return abslocR;
+   return abslocR.getRationalNumber();
 }
 
 
@@ -557,7 +604,7 @@ double HumdrumRecord::getBeat(void) const {
 
 
 RationalNumber HumdrumRecord::getBeatR(void) const { 
-   return meterlocR;
+   return meterlocR.getRationalNumber();
 }
 
 
@@ -584,7 +631,7 @@ RationalNumber HumdrumRecord::getMeasureDurationR(void) const {
    if (!isBarline()) {
       return zero;
    }
-   return meterlocR;
+   return meterlocR.getRationalNumber();
 }
 
 
@@ -602,7 +649,7 @@ double HumdrumRecord::getDuration(void) const {
 }
 
 RationalNumber HumdrumRecord::getDurationR(void) const { 
-   return durationR;
+   return durationR.getRationalNumber();
 }
 
 
@@ -912,7 +959,7 @@ void HumdrumRecord::changeToken(int spineIndex, int tokenIndex,
    separatorstr[0] = separator;
 
    char *buff;
-   buff = new char[strlen(record[spineIndex]) + strlen(newtoken) + 1];
+   buff = allocateString(strlen(record[spineIndex]) + strlen(newtoken));
    buff[0] = '\0';
    char* oldtoken = strtok((char*)record[spineIndex], separatorstr);
    int token = 0;
@@ -930,9 +977,10 @@ void HumdrumRecord::changeToken(int spineIndex, int tokenIndex,
       }
    }
 
-   delete [] recordFields[spineIndex];
+   freeString(recordFields[spineIndex]);
    recordFields[spineIndex] = buff;
    modifiedQ = 1;
+   markOwnerDirty();
 }
 
 
@@ -989,7 +1037,7 @@ char* HumdrumRecord::getToken(char* buffer, int fieldIndex, int tokenIndex,
    int location = 0;
    const char* string = (*this)[fieldIndex];
    // char temp[strlen(string) + 1];  // can't do in MS Visual C++ 6.0
-   static char temp[1024] = {0};      // doing this instead
+   char temp[1024] = {0};             // doing this instead
    strcpy(temp, string);
    char *current = NULL;
    current = strtok(temp, sepstring);
@@ -1053,16 +1101,38 @@ string HumdrumRecord::getToken(int fieldIndex, int tokenIndex, int buffersize,
 //////////////////////////////
 //
 // HumdrumRecord::getTokens -- return a list of all subtokens in token.
+//    A separator at the start or end of the token is ignored, and a
+//    separator directly following another separator is kept at the
+//    start of the next subtoken (as PerlRegularExpression::getTokens()
+//    does with a single-character separator).
 //    Default value: separator = ' ';
 //
 
 void HumdrumRecord::getTokens(Array<Array<char> >& tokens, int fieldIndex, 
       char separator) {
-   char sep[2] = {0};
    HumdrumRecord& arecord = *this;
-   sep[0] = separator;
-   PerlRegularExpression pre;
-   pre.getTokens(tokens, sep, arecord[fieldIndex]);
+   const char* ptr = arecord[fieldIndex];
+   const char* end;
+   int length;
+   int index;
+
+   tokens.setSize(0);
+   if (*ptr == separator) {
+      ptr++;
+   }
+   while (*ptr != '\0') {
+      end = strchr(ptr+1, separator);
+      if (end == NULL) {
+         end = ptr + strlen(ptr);
+      }
+      length = (int)(end - ptr);
+      index = tokens.getSize();
+      tokens.setSize(index+1);
+      tokens[index].setSize(length+1);
+      strncpy(tokens[index].getBase(), ptr, length);
+      tokens[index][length] = '\0';
+      ptr = (*end == '\0') ? end : end + 1;
+   }
 }
 
 
@@ -1203,9 +1273,8 @@ int HumdrumRecord::isNullToken(int index) {
 //
 
 int HumdrumRecord::hasNoteAttack(int field) {
-   PerlRegularExpression pre;
    Array<Array<char> > notes;
-   pre.getTokens(notes, " ", (*this)[field]);
+   getTokens(notes, field, ' ');
    int i;
    for (i=0; i<notes.getSize(); i++) {
       if (strcmp(notes[i].getBase(), ".") == 0) {
@@ -1250,18 +1319,49 @@ int HumdrumRecord::isRest(int field) {
 
 
 
+//////////////////////////////
+//
+// Tandem interpretation tests -- The tokens are examined by the
+//     *Token() functions below rather than with regular expressions,
+//     so that the tests do not allocate memory or use the shared
+//     regular expression cache, and can be used by many threads at
+//     once.  The comment above each function gives the regular
+//     expression which it matches.
+//
+
+static int isDigit(char ch) {
+   return (ch >= '0') && (ch <= '9');
+}
+
+static int isLowerCase(char ch) {
+   return (ch >= 'a') && (ch <= 'z');
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumRecord::isOriginalClef -- returns true if a clef, but prefixed
 //     with "o" to indicate the clef in the original source.
 //
 
-#define REGEX_ISORIGINALCLEF "^\\*oclef[CFG]v?\\d+" 
+// /^\*oclef[CFG]v?\d+/
+static int isOriginalClefToken(const char* token) {
+   if (strncmp(token, "*oclef", 6) != 0) {
+      return 0;
+   }
+   if ((token[6] != 'C') && (token[6] != 'F') && (token[6] != 'G')) {
+      return 0;
+   }
+   if (token[7] == 'v') {
+      return isDigit(token[8]);
+   }
+   return isDigit(token[7]);
+}
 
 int HumdrumRecord::isOriginalClef(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;
-   if (pre.search(aRecord[index], "^\\*oclef[CFG]v?\\d+")) {
+   if (isOriginalClefToken(aRecord[index])) {
       return 1;
    } 
    if (strcmp("*oclefX", aRecord[index]) == 0) {
@@ -1276,7 +1376,7 @@ int HumdrumRecord::isOriginalClef(int index) {
 }
 
 int HumdrumRecord::isAllOriginalClef(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISORIGINALCLEF, "**kern");
+   return HumdrumRecord::isParticularType(isOriginalClefToken, "**kern");
 }
 
 
@@ -1287,12 +1387,23 @@ int HumdrumRecord::isAllOriginalClef(void) {
 //    clef tandem interpretation record.
 //
 
-#define REGEX_ISCLEF "^\\*clef[CFG]v?\\d+" 
+// /^\*clef[CFG]v?\d+/
+static int isClefToken(const char* token) {
+   if (strncmp(token, "*clef", 5) != 0) {
+      return 0;
+   }
+   if ((token[5] != 'C') && (token[5] != 'F') && (token[5] != 'G')) {
+      return 0;
+   }
+   if (token[6] == 'v') {
+      return isDigit(token[7]);
+   }
+   return isDigit(token[6]);
+}
 
 int HumdrumRecord::isClef(int index) {
    HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;
-   if (pre.search(aRecord[index], REGEX_ISCLEF)) {
+   if (isClefToken(aRecord[index])) {
       return 1;
    } 
    if (strcmp("*clefX", aRecord[index]) == 0) {
@@ -1307,7 +1418,7 @@ int HumdrumRecord::isClef(int index) {
 }
 
 int HumdrumRecord::isAllClef(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISCLEF, "**kern");
+   return HumdrumRecord::isParticularType(isClefToken, "**kern");
 }
 
 
@@ -1318,11 +1429,11 @@ int HumdrumRecord::isAllClef(void) {
 //    exclusive interpretation (presumably **kern data).
 //
 
-int HumdrumRecord::isParticularType(const char* regexp, const char* exinterp) {
+int HumdrumRecord::isParticularType(int (*test)(const char* token),
+      const char* exinterp) {
    int output = 1;
    int j;
    int count = 0;
-   PerlRegularExpression pre;
    HumdrumRecord& aRecord = *this;
    for (j=0; j<aRecord.getFieldCount(); j++) {
       if (!aRecord.isExInterp(j, "**kern")) {
@@ -1333,7 +1444,7 @@ int HumdrumRecord::isParticularType(const char* regexp, const char* exinterp) {
          continue;
       }
       count++;
-      if (!pre.search(aRecord[j], regexp)) {
+      if (!test(aRecord[j])) {
          output = 0;
          break;
       }
@@ -1353,19 +1464,30 @@ int HumdrumRecord::isParticularType(const char* regexp, const char* exinterp) {
 // HumdrumRecord::isKey --
 //
 
-#define REGEX_ISKEY "^\\*[A-Ga-g][-#n]?:"
-
-int HumdrumRecord::isKey(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISKEY)) {
+// /^\*[A-Ga-g][-#n]?:/
+static int isKeyToken(const char* token) {
+   if (token[0] != '*') {
+      return 0;
+   }
+   if (!(((token[1] >= 'A') && (token[1] <= 'G')) || 
+         ((token[1] >= 'a') && (token[1] <= 'g')))) {
+      return 0;
+   }
+   if (token[2] == ':') {
       return 1;
    }
+   if ((token[2] == '-') || (token[2] == '#') || (token[2] == 'n')) {
+      return token[3] == ':';
+   }
    return 0;
 }
 
+int HumdrumRecord::isKey(int index) { 
+   return isKeyToken((*this)[index]);
+}
+
 int HumdrumRecord::isAllKey(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISKEY, "**kern");
+   return HumdrumRecord::isParticularType(isKeyToken, "**kern");
 }
 
 
@@ -1375,19 +1497,26 @@ int HumdrumRecord::isAllKey(void) {
 // HumdrumRecord::isKeySig --
 //
 
-#define REGEX_ISKEYSIG "^\\*[kK]\\[[A-Ga-g#-]*\\]"
+// /^\*[kK]\[[A-Ga-g#-]*\]/
+static int isKeySigToken(const char* token) {
+   if ((token[0] != '*') || ((token[1] != 'k') && (token[1] != 'K')) ||
+         (token[2] != '[')) {
+      return 0;
+   }
+   const char* ptr = token + 3;
+   while (((*ptr >= 'A') && (*ptr <= 'G')) || ((*ptr >= 'a') && (*ptr <= 'g')) ||
+         (*ptr == '#') || (*ptr == '-')) {
+      ptr++;
+   }
+   return *ptr == ']';
+}
 
 int HumdrumRecord::isKeySig(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISKEYSIG)) {
-      return 1;
-   }
-   return 0;
+   return isKeySigToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllKeySig(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISKEYSIG, "**kern");
+   return HumdrumRecord::isParticularType(isKeySigToken, "**kern");
 }
 
 
@@ -1397,19 +1526,17 @@ int HumdrumRecord::isAllKeySig(void) {
 // HumdrumRecord::isTempo --
 //
 
-#define REGEX_ISTEMPO "^\\*MM\\d+\\.?\\d*"
+// /^\*MM\d+\.?\d*/
+static int isTempoToken(const char* token) {
+   return (strncmp(token, "*MM", 3) == 0) && isDigit(token[3]);
+}
 
 int HumdrumRecord::isTempo(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISTEMPO)) {
-      return 1;
-   }
-   return 0;
+   return isTempoToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllTempo(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISTEMPO, "**kern");
+   return HumdrumRecord::isParticularType(isTempoToken, "**kern");
 }
 
 
@@ -1419,19 +1546,24 @@ int HumdrumRecord::isAllTempo(void) {
 // HumdrumRecord::isTimeSig --
 //
 
-#define REGEX_ISTIMESIG "^\\*M\\d+/\\d+"
+// /^\*M\d+\/\d+/
+static int isTimeSigToken(const char* token) {
+   if ((token[0] != '*') || (token[1] != 'M') || !isDigit(token[2])) {
+      return 0;
+   }
+   const char* ptr = token + 3;
+   while (isDigit(*ptr)) {
+      ptr++;
+   }
+   return (ptr[0] == '/') && isDigit(ptr[1]);
+}
 
 int HumdrumRecord::isTimeSig(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISTIMESIG)) {
-      return 1;
-   }
-   return 0;
+   return isTimeSigToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllTimeSig(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISTIMESIG, "**kern");
+   return HumdrumRecord::isParticularType(isTimeSigToken, "**kern");
 }
 
 
@@ -1441,19 +1573,17 @@ int HumdrumRecord::isAllTimeSig(void) {
 // HumdrumRecord::isMetSig --
 //
 
-#define REGEX_ISMETSIG "^\\*met\\([^)]*\\)"
+// /^\*met\([^)]*\)/
+static int isMetSigToken(const char* token) {
+   return (strncmp(token, "*met(", 5) == 0) && (strchr(token+5, ')') != NULL);
+}
 
 int HumdrumRecord::isMetSig(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISMETSIG)) {
-      return 1;
-   }
-   return 0;
+   return isMetSigToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllMetSig(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISMETSIG, "**kern");
+   return HumdrumRecord::isParticularType(isMetSigToken, "**kern");
 }
 
 
@@ -1463,19 +1593,17 @@ int HumdrumRecord::isAllMetSig(void) {
 // HumdrumRecord::isTranspose --  Work on splitting up this into two cases.
 //
 
-#define REGEX_ISTRANSPOSE "^\\*ITr"
+// /^\*ITr/
+static int isTransposeToken(const char* token) {
+   return strncmp(token, "*ITr", 4) == 0;
+}
 
 int HumdrumRecord::isTranspose(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISTRANSPOSE)) {
-      return 1;
-   }
-   return 0;
+   return isTransposeToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllTranspose(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISTRANSPOSE, "**kern");
+   return HumdrumRecord::isParticularType(isTransposeToken, "**kern");
 }
 
 
@@ -1485,19 +1613,18 @@ int HumdrumRecord::isAllTranspose(void) {
 // HumdrumRecord::isInstrumentType --
 //
 
-#define REGEX_ISINSTRUMENTTYPE "^\\*I[a-z]{2,5}"
+// /^\*I[a-z]{2,5}/
+static int isInstrumentTypeToken(const char* token) {
+   return (token[0] == '*') && (token[1] == 'I') && isLowerCase(token[2]) &&
+         isLowerCase(token[3]);
+}
 
 int HumdrumRecord::isInstrumentType(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], "^\\*I[a-z]{2,5}")) {
-      return 1;
-   }
-   return 0;
+   return isInstrumentTypeToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllInstrumentType(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTTYPE, "**kern");
+   return HumdrumRecord::isParticularType(isInstrumentTypeToken, "**kern");
 }
 
 
@@ -1507,19 +1634,17 @@ int HumdrumRecord::isAllInstrumentType(void) {
 // HumdrumRecord::isInstrumentClass --
 //
 
-#define REGEX_ISINSTRUMENTCLASS "^\\*IC[a-z]+"
+// /^\*IC[a-z]+/
+static int isInstrumentClassToken(const char* token) {
+   return (strncmp(token, "*IC", 3) == 0) && isLowerCase(token[3]);
+}
 
 int HumdrumRecord::isInstrumentClass(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTCLASS)) {
-      return 1;
-   }
-   return 0;
+   return isInstrumentClassToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllInstrumentClass(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTCLASS, "**kern");
+   return HumdrumRecord::isParticularType(isInstrumentClassToken, "**kern");
 }
 
 
@@ -1529,19 +1654,17 @@ int HumdrumRecord::isAllInstrumentClass(void) {
 // HumdrumRecord::isInstrumentName --
 //
 
-#define REGEX_ISINSTRUMENTNAME "^\\*I\""
+// /^\*I"/
+static int isInstrumentNameToken(const char* token) {
+   return strncmp(token, "*I\"", 3) == 0;
+}
 
 int HumdrumRecord::isInstrumentName(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTNAME)) {
-      return 1;
-   }
-   return 0;
+   return isInstrumentNameToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllInstrumentName(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTNAME, "**kern");
+   return HumdrumRecord::isParticularType(isInstrumentNameToken, "**kern");
 }
 
 
@@ -1551,19 +1674,17 @@ int HumdrumRecord::isAllInstrumentName(void) {
 // HumdrumRecord::isInstrumentAbbr --
 //
 
-#define REGEX_ISINSTRUMENTABBR "^\\*I\'"
+// /^\*I'/
+static int isInstrumentAbbrToken(const char* token) {
+   return strncmp(token, "*I\'", 3) == 0;
+}
 
 int HumdrumRecord::isInstrumentAbbr(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTNAME)) {
-      return 1;
-   }
-   return 0;
+   return isInstrumentAbbrToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllInstrumentAbbr(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTABBR, "**kern");
+   return HumdrumRecord::isParticularType(isInstrumentAbbrToken, "**kern");
 }
 
 
@@ -1573,19 +1694,17 @@ int HumdrumRecord::isAllInstrumentAbbr(void) {
 // HumdrumRecord::isInstrumentNum --
 //
 
-#define REGEX_ISINSTRUMENTNUM "^\\*I#"
+// /^\*I#/
+static int isInstrumentNumToken(const char* token) {
+   return strncmp(token, "*I#", 3) == 0;
+}
 
 int HumdrumRecord::isInstrumentNum(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISINSTRUMENTNUM)) {
-      return 1;
-   }
-   return 0;
+   return isInstrumentNumToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllInstrumentNum(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISINSTRUMENTNUM, "**kern");
+   return HumdrumRecord::isParticularType(isInstrumentNumToken, "**kern");
 }
 
 
@@ -1595,19 +1714,21 @@ int HumdrumRecord::isAllInstrumentNum(void) {
 // HumdrumRecord::isLabelExpansion --
 //
 
-#define REGEX_ISLABELEXPANSION "^\\*>\\[[^]]*\\]$"
+// /^\*>\[[^]]*\]$/
+static int isLabelExpansionToken(const char* token) {
+   if (strncmp(token, "*>[", 3) != 0) {
+      return 0;
+   }
+   const char* ptr = strchr(token+3, ']');
+   return (ptr != NULL) && (ptr[1] == '\0');
+}
 
 int HumdrumRecord::isLabelExpansion(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISLABELEXPANSION)) {
-      return 1;
-   }
-   return 0;
+   return isLabelExpansionToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllLabelExpansion(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISLABELEXPANSION, "**kern");
+   return HumdrumRecord::isParticularType(isLabelExpansionToken, "**kern");
 }
 
 
@@ -1617,19 +1738,26 @@ int HumdrumRecord::isAllLabelExpansion(void) {
 // HumdrumRecord::isLabelVariant --
 //
 
-#define REGEX_ISLABELVARIANT "^\\*>[^[]+\\[[^]]*\\]$"
+// /^\*>[^[]+\[[^]]*\]$/
+static int isLabelVariantToken(const char* token) {
+   if ((strncmp(token, "*>", 2) != 0) || (token[2] == '\0') || 
+         (token[2] == '[')) {
+      return 0;
+   }
+   const char* ptr = strchr(token+3, '[');
+   if (ptr == NULL) {
+      return 0;
+   }
+   ptr = strchr(ptr+1, ']');
+   return (ptr != NULL) && (ptr[1] == '\0');
+}
 
 int HumdrumRecord::isLabelVariant(int index) {
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISLABELVARIANT)) {
-      return 1;
-   }
-   return 0;
+   return isLabelVariantToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllLabelVariant(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISLABELVARIANT, "**kern");
+   return HumdrumRecord::isParticularType(isLabelVariantToken, "**kern");
 }
 
 
@@ -1639,19 +1767,18 @@ int HumdrumRecord::isAllLabelVariant(void) {
 // HumdrumRecord::isLabelMarker --
 //
 
-#define REGEX_ISLABELMARKER "^\\*>[^[]+$"
+// /^\*>[^[]+$/
+static int isLabelMarkerToken(const char* token) {
+   return (strncmp(token, "*>", 2) == 0) && (token[2] != '\0') && 
+         (strchr(token+2, '[') == NULL);
+}
 
 int HumdrumRecord::isLabelMarker(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISLABELMARKER)) {
-      return 1;
-   }
-   return 0;
+   return isLabelMarkerToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllLabelMarker(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISLABELMARKER, "**kern");
+   return HumdrumRecord::isParticularType(isLabelMarkerToken, "**kern");
 }
 
 
@@ -1661,41 +1788,38 @@ int HumdrumRecord::isAllLabelMarker(void) {
 // HumdrumRecord::isStaffNumber --
 //
 
-#define REGEX_ISSTAFFNUMBER "^\\*staff\\d"
+// /^\*staff\d/
+static int isStaffNumberToken(const char* token) {
+   return (strncmp(token, "*staff", 6) == 0) && isDigit(token[6]);
+}
 
 int HumdrumRecord::isStaffNumber(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISSTAFFNUMBER)) {
-      return 1;
-   }
-   return 0;
+   return isStaffNumberToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllStaffNumber(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISSTAFFNUMBER, "**kern");
+   return HumdrumRecord::isParticularType(isStaffNumberToken, "**kern");
 }
 
 
+
 //////////////////////////////
 //
 // HumdrumRecord::isSysStaffNumber -- Andreas's variant on staff numbering
 //     which is local to a particular system on a specific page.
 //
 
-#define REGEX_ISSYSSTAFFNUMBER "^\\*staff:\\d"
+// /^\*staff:\d/
+static int isSysStaffNumberToken(const char* token) {
+   return (strncmp(token, "*staff:", 7) == 0) && isDigit(token[7]);
+}
 
 int HumdrumRecord::isSysStaffNumber(int index) { 
-   HumdrumRecord& aRecord = *this;
-   PerlRegularExpression pre;   
-   if (pre.search(aRecord[index], REGEX_ISSYSSTAFFNUMBER)) {
-      return 1;
-   }
-   return 0;
+   return isSysStaffNumberToken((*this)[index]);
 }
 
 int HumdrumRecord::isAllSysStaffNumber(void) {
-   return HumdrumRecord::isParticularType(REGEX_ISSYSSTAFFNUMBER, "**kern");
+   return HumdrumRecord::isParticularType(isSysStaffNumberToken, "**kern");
 }
 
 
@@ -1944,8 +2068,7 @@ void HumdrumRecord::insertField(int index, const char* aField, int anInterp,
 
    // add the field
    interpretation[index] = anInterp;
-   recordFields[index]   = new char[strlen(aField)+1];
-   strcpy(recordFields[index], aField);
+   recordFields[index]   = copyString(aField);
    spineids[index] = spinetrace;
 
    int dummy = -1;
@@ -1953,6 +2076,7 @@ void HumdrumRecord::insertField(int index, const char* aField, int anInterp,
    dotspine.append(dummy);
 
    modifiedQ = 1;
+   markOwnerDirty();
 }
 
 
@@ -1991,40 +2115,26 @@ HumdrumRecord& HumdrumRecord::operator=(const HumdrumRecord& aRecord) {
 
    int i;
    type = aRecord.type;
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
+   clearFields();
    if (aRecord.recordString != NULL) {
-      recordString = new char[strlen(aRecord.recordString)+1];
-      strcpy(recordString, aRecord.recordString);
+      recordString = copyString(aRecord.recordString);
    }
    modifiedQ = aRecord.modifiedQ;
    interpretation.setSize(aRecord.interpretation.getSize());
 
-   for (i=0; i<recordFields.getSize(); i++) {
-      if (recordFields[i] != NULL) {
-         delete [] recordFields[i];
-         recordFields[i] = NULL;
-      }
-   }
-
    recordFields.setSize(aRecord.recordFields.getSize());
    spineids.clear();
    spineids.resize(aRecord.spineids.size());
 
-   int allocSize = 0;
    for (i=0; i<aRecord.getFieldCount(); i++) {
       if (interpretation.getSize() > 0) {
           interpretation[i] = aRecord.interpretation[i];
       }
-      allocSize = strlen(aRecord.recordFields[i]) + 1;
-
-      recordFields[i] = new char[allocSize];
-      strcpy(recordFields[i], aRecord.recordFields[i]);
+      recordFields[i] = copyString(aRecord.recordFields[i]);
 
       spineids[i] = aRecord.spineids[i];
    }
+   markOwnerDirty();
  
    return *this;
 }
@@ -2071,6 +2181,7 @@ const char* HumdrumRecord::operator[](int index) const {
 //    in the file.  This value is by default 0, but can be set
 //    manally with the setAbsBeat() function, or by calling
 //    HumdrumFile::analyzeRhythm().
+//    default value: bottom = 1 (setAbsBeatR)
 //
 
 void HumdrumRecord::setAbsBeat(double aValue) { 
@@ -2091,6 +2202,11 @@ void HumdrumRecord::setAbsBeatR(const RationalNumber& aValue) {
    absloc = abslocR.getFloat();
 }
 
+void HumdrumRecord::setAbsBeatR(const RationalNumber64& aValue) { 
+   abslocR = aValue;
+   absloc = abslocR.getFloat();
+}
+
 void HumdrumRecord::setAbsBeatR(int top, int bottom) {
    abslocR.setValue(top, bottom);
 }
@@ -2107,6 +2223,7 @@ void HumdrumRecord::setAbsBeat(int top, int bottom) {
 //    in the file.  This value is by default 0, but can be set
 //    manally with the setBeat() function, or by calling
 //    HumdrumFile::analyzeRhythm().
+//    default value: bottom = 1 (setBeatR)
 //
 
 void HumdrumRecord::setBeat(double aValue) { 
@@ -2131,6 +2248,10 @@ void HumdrumRecord::setBeatR(const RationalNumber& aValue) {
    meterlocR = aValue;
 }
 
+void HumdrumRecord::setBeatR(const RationalNumber64& aValue) { 
+   meterlocR = aValue;
+}
+
 
 //////////////////////////////
 //
@@ -2159,6 +2280,7 @@ void HumdrumRecord::setDotSpine(int index, int value) {
 //    HumdrumRecord line in a HumdrumFile.  This value is by default 0, 
 //    but can be set manally with the setAbsBeat() function, or by 
 //    calling HumdrumFile::analyzeRhythm().
+//    default value: bottom = 1 (setDurationR)
 //
 
 void HumdrumRecord::setDuration(double aValue) { 
@@ -2183,6 +2305,10 @@ void HumdrumRecord::setDurationR(RationalNumber aValue) {
    durationR = aValue;
 }
 
+void HumdrumRecord::setDurationR(const RationalNumber64& aValue) { 
+   durationR = aValue;
+}
+
 
 
 //////////////////////////////
@@ -2232,11 +2358,11 @@ void HumdrumRecord::setExInterp(int index, const char* interpString) {
 //
 
 void HumdrumRecord::setToken(int index, const char* aString) {
-   delete [] recordFields[index];
-   int len = strlen(aString);
-   recordFields[index] = new char[len+1];
-   strcpy(recordFields[index], aString);
+   char* newfield = copyString(aString);
+   freeString(recordFields[index]);
+   recordFields[index] = newfield;
    modifiedQ = 1;
+   markOwnerDirty();
 }
    
 
@@ -2248,33 +2374,38 @@ void HumdrumRecord::setToken(int index, const string& aString) {
 
 //////////////////////////////
 //
-// HumdrumRecord::setLine -- sets the record to a (new) string
+// HumdrumRecord::setLine -- sets the record to a (new) string.  If a
+//     length is given, then aLine does not need to be null-terminated
+//     (such as a line in a memory-mapped file).
 //
 
 void HumdrumRecord::setLine(const char* aLine) {
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
+   setLine(aLine, strlen(aLine));
+}
+
+
+void HumdrumRecord::setLine(const char* aLine, int length) {
+   // copy the line before clearing, since aLine may be a field of this record
+   if ((length > 0) && 
+         (aLine[length-1] == 0x0d || aLine[length-1] == 0x0a)) {
+      length--;
    }
-   int length = strlen(aLine);
-   recordString = new char[length+1];
-   strcpy(recordString, aLine);
-   if (recordString[length-1] == 0x0d || recordString[length-1] == 0x0a) {
-      recordString[length-1] = '\0';
+   char* newstring;
+   if (arena != NULL) {
+      // The line and a copy of it with its tabs replaced by nulls are
+      // stored in one arena block, and the fields point into the copy.
+      newstring = arena->allocate(2 * (length + 1));
+   } else {
+      newstring = new char[length+1];
    }
+   memcpy(newstring, aLine, length);
+   newstring[length] = '\0';
+   clearFields();
+   recordString = newstring;
    modifiedQ = 0;
+   markOwnerDirty();
    int i;
 
-   if (recordFields.getSize() != 0) {
-      for (i=0; i<recordFields.getSize(); i++) {
-         if (recordFields[i] != NULL) {
-            delete recordFields[i];
-            recordFields[i] = NULL;
-         }
-      }
-      recordFields.setSize(0);
-   }
-
    spineids.clear();
 
    type = determineType(recordString);
@@ -2297,7 +2428,23 @@ void HumdrumRecord::setLine(const char* aLine) {
    i = 0;
    char* temp;
    int index;
-   if (fieldCount == 1) {
+   if (arena != NULL) {
+      temp = recordString + length + 1;
+      memcpy(temp, recordString, length + 1);
+      index = recordFields.getSize();
+      recordFields[index] = temp;
+      spineids.push_back("");
+      if (fieldCount > 1) {
+         for (i=0; i<length; i++) {
+            if (temp[i] == '\t') {
+               temp[i] = '\0';
+               index = recordFields.getSize();
+               recordFields[index] = temp + i + 1;
+               spineids.push_back("");
+            }
+         }
+      }
+   } else if (fieldCount == 1) {
       temp = new char[strlen(recordString)+1];
       strcpy(temp, recordString);
       index = recordFields.getSize(); 
@@ -4273,6 +4420,21 @@ const char* HumdrumRecord::getBibLangIso639_2(const char* string) {
 //
 
 
+//////////////////////////////
+//
+// HumdrumRecord::markOwnerDirty -- Tell the file containing the record
+//     that its contents have changed, so that incremental analyses of
+//     the file will include the line.
+//
+
+void HumdrumRecord::markOwnerDirty(void) {
+   if (owner != NULL) {
+      owner->markDirty(ownerindex);
+   }
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumRecord::makeRecordString --
@@ -4286,17 +4448,76 @@ void HumdrumRecord::makeRecordString(void) {
    }
    temp << recordFields[recordFields.getSize()-1] << ends;
 
-   if (recordString != NULL) {
-      delete [] recordString;
-      recordString = NULL;
-   }
-   recordString = new char[strlen(temp.str().c_str()) + 1];
-   strcpy(recordString, temp.str().c_str());
+   freeString(recordString);
+   recordString = copyString(temp.str().c_str());
    modifiedQ = 0;
 }
 
 
 
+//////////////////////////////
+//
+// HumdrumRecord::allocateString -- Return storage for a string of the
+//     given length (plus its null terminator), either from the arena
+//     or from the heap.
+//
+
+char* HumdrumRecord::allocateString(int length) {
+   if (arena != NULL) {
+      return arena->allocate(length+1);
+   }
+   return new char[length+1];
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::copyString --
+//
+
+char* HumdrumRecord::copyString(const char* aString) {
+   if (arena != NULL) {
+      return arena->copy(aString);
+   }
+   char* output = new char[strlen(aString)+1];
+   strcpy(output, aString);
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::freeString -- Arena strings are released when the 
+//     arena is cleared, so only heap strings are deleted here.
+//
+
+void HumdrumRecord::freeString(char* aString) {
+   if ((arena == NULL) && (aString != NULL)) {
+      delete [] aString;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::clearFields -- Release the record string and fields.
+//
+
+void HumdrumRecord::clearFields(void) {
+   freeString(recordString);
+   recordString = NULL;
+   for (int i=0; i<recordFields.getSize(); i++) {
+      freeString(recordFields[i]);
+      recordFields[i] = NULL;
+   }
+   recordFields.setSize(0);
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////
 //
 // generic functions
@@ -4385,6 +4606,10 @@ int HumdrumRecord::determineFieldCount(const char* aLine) const {
 
 void HumdrumRecord::setSize(int asize) {
 
+   for (int k=0; k<recordFields.getSize(); k++) {
+      freeString(recordFields[k]);
+      recordFields[k] = NULL;
+   }
    recordFields.allowGrowth(1);
    recordFields.setSize(asize*4);   
    recordFields.setGrowth(132);   
@@ -4409,8 +4634,7 @@ void HumdrumRecord::setSize(int asize) {
    char buffer[32] = {0};
    int i;
    for (i=0; i<recordFields.getSize(); i++) {
-      recordFields[i] = new char[2];
-      strcpy(recordFields[i], ".");
+      recordFields[i] = copyString(".");
       sprintf(buffer, "%d", i+1);
       spineids[i] = buffer;
    }
@@ -4418,6 +4642,7 @@ void HumdrumRecord::setSize(int asize) {
    dotline.setAll(-1);
    dotspine.setAll(-1);
    interpretation.setAll(-1); // or 0?
+   markOwnerDirty();
 }
 
 
@@ -4436,6 +4661,55 @@ void HumdrumRecord::setAllFields(const char* astring) {
 
 
 
+//////////////////////////////
+//
+// HumdrumRecord::setArena -- Store the text of the record in the given
+//     arena rather than in individual heap allocations.  The arena must
+//     outlive the record (HumdrumFileBasic sets this on its own lines).
+//     Any current contents are moved into the new storage.  A NULL
+//     arena returns the record to heap storage.
+//
+
+void HumdrumRecord::setArena(HumdrumArena* anArena) {
+   if (anArena == arena) {
+      return;
+   }
+   HumdrumArena* oldarena = arena;
+   char* oldstring;
+   int i;
+
+   for (i=0; i<recordFields.getSize(); i++) {
+      oldstring = recordFields[i];
+      arena = anArena;
+      recordFields[i] = (oldstring == NULL) ? NULL : copyString(oldstring);
+      arena = oldarena;
+      freeString(oldstring);
+   }
+
+   oldstring = recordString;
+   arena = anArena;
+   recordString = (oldstring == NULL) ? NULL : copyString(oldstring);
+   arena = oldarena;
+   freeString(oldstring);
+
+   arena = anArena;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumRecord::rebindArena -- Point the record to a different arena
+//     without copying any text.  Used after HumdrumArena::swap() when
+//     the storage of the record has moved into the new arena object.
+//
+
+void HumdrumRecord::rebindArena(HumdrumArena* anArena) {
+   arena = anArena;
+}
+
+
+
 //////////////////////////////
 //
 // operator<< --
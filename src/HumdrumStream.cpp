@@ -3,6 +3,8 @@
 // Creation Date: Tue Dec 11 16:09:32 PST 2012
 // Last Modified: Tue Dec 11 16:09:38 PST 2012
 // Last Modified: Fri Mar 11 21:26:18 PST 2016 Changed to STL
+// Last Modified: Sat Oct 17 18:15:17 PDT 2026 Added worker thread prefetching
+// Last Modified: Sat Oct 17 19:41:20 PDT 2026 Added .humc cache files
 // Filename:      ...sig/src/sigInfo/HumdrumStream.cpp
 // Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumStream.cpp
 // Syntax:        C++ 
@@ -11,8 +13,21 @@
 //                Inherits HumdrumStreamBasic and adds rhythmic and other
 //                types of analyses to the HumdrumStream class.
 //
+//                In parallel mode (see setThreadCount()), each file in
+//                the file list is read by a worker thread with its own
+//                HumdrumStream, so universal comments are not carried
+//                over from one file to the next, and filenames listed
+//                inside of a file are read immediately after that file
+//                rather than at the end of the list.
+//
+//                A file in the file list is loaded from its .humc cache
+//                (see HumdrumCache) when the cache is newer than the
+//                file, and no universal comments or !!!!SEGMENT names
+//                from the previous files need to be applied to it.
+//
 
 #include "HumdrumStream.h"
+#include "HumdrumCache.h"
 #include "PerlRegularExpression.h"
 
 #include <vector>
@@ -38,21 +53,21 @@ using namespace std;
 //
 
 HumdrumStream::HumdrumStream(void) {
-   curfile = -1;
+   initialize();
 }
 
 HumdrumStream::HumdrumStream(char** list) {
-   curfile = -1;
+   initialize();
    setFileList(list);
 }
 
 HumdrumStream::HumdrumStream(const vector<string>& list) {
-   curfile = -1;
+   initialize();
    setFileList(list);
 }
 
 HumdrumStream::HumdrumStream(Options& options) {
-   curfile = -1;
+   initialize();
    vector<string> list;
    options.getArgList(list);
    setFileList(list);
@@ -60,12 +75,55 @@ HumdrumStream::HumdrumStream(Options& options) {
 
 
 
+//////////////////////////////
+//
+// HumdrumStream::~HumdrumStream --
+//
+
+HumdrumStream::~HumdrumStream() {
+   stopThreads();
+   for (int i=0; i<(int)pending.size(); i++) {
+      delete pending[i];
+      pending[i] = NULL;
+   }
+   pending.clear();
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::initialize -- set the default values for the
+//     constructors.
+//
+
+void HumdrumStream::initialize(void) {
+   curfile       = -1;
+   cacheQ        = 1;
+   threadcount   = 1;
+   prefetchlimit = 0;
+   rhythmQ       = 0;
+   nextjob       = 0;
+   nextresult    = 0;
+   stopQ         = 0;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumStream::clear -- reset the contents of the class.
 //
 
 void HumdrumStream::clear(void) {
+   stopThreads();
+   for (int i=0; i<(int)pending.size(); i++) {
+      delete pending[i];
+      pending[i] = NULL;
+   }
+   pending.clear();
+   nextjob = 0;
+   nextresult = 0;
    curfile = 0;
    filelist.resize(0);
    universals.resize(0);
@@ -80,6 +138,7 @@ void HumdrumStream::clear(void) {
 //
 
 int HumdrumStream::setFileList(char** list) {
+   stopThreads();
    filelist.reserve(1000);
    filelist.resize(0);
    int i = 0;
@@ -92,12 +151,117 @@ int HumdrumStream::setFileList(char** list) {
 
 
 int HumdrumStream::setFileList(const vector<string>& list) {
+   stopThreads();
    filelist = list;
    return (int)list.size();
 }
 
 
 
+//////////////////////////////
+//
+// HumdrumStream::setThreadCount -- Parse the files in the file list with
+//     the given number of worker threads.  At most prefetch files will be
+//     parsed ahead of the file most recently returned by getFile(); the
+//     default is two files per thread.  A count of 1 (the default) reads
+//     the files sequentially in the calling thread.  Should be called
+//     before the first file is read.
+//     default value: prefetch = 0
+//
+
+void HumdrumStream::setThreadCount(int count, int prefetch) {
+   stopThreads();
+   if (count < 1) {
+      count = 1;
+   }
+   threadcount = count;
+   prefetchlimit = prefetch > 0 ? prefetch : 2 * count;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::setRhythmAnalysis -- Have worker threads also run
+//     analyzeRhythm() with the given base on each file.  When the program
+//     then calls analyzeRhythm() with the same base, the analysis done in
+//     the worker thread is kept.  A NULL base turns off the analysis.
+//     default value: base = "4"
+//
+
+void HumdrumStream::setRhythmAnalysis(const char* base) {
+   stopThreads();
+   if (base == NULL) {
+      rhythmQ = 0;
+      rhythmbase = "";
+   } else {
+      rhythmQ = 1;
+      rhythmbase = base;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::setCacheUse -- Turn on/off loading files from their
+//     .humc caches (on by default).
+//     default value: state = 1
+//
+
+void HumdrumStream::setCacheUse(int state) {
+   stopThreads();
+   cacheQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::writeCache -- Parse a file and store its segments in
+//     the file's .humc cache.  If base is not NULL, the rhythm of each
+//     segment is analyzed with that base before it is stored, and
+//     programs calling analyzeRhythm() with the same base will use the
+//     stored analysis.  Files which contain universal comments or lists
+//     of other files are not cached, since reading them changes how the
+//     files which follow them in a stream are read.  Returns 1 if the
+//     cache was written.
+//     default value: base = "4"
+//
+
+int HumdrumStream::writeCache(const string& filename, const char* base) {
+   if (strstr(filename.c_str(), "://") != NULL) {
+      return 0;
+   }
+   HumdrumStream single(vector<string>(1, filename));
+   single.setCacheUse(0);
+
+   vector<HumdrumFile*> segments;
+   HumdrumFile* file = new HumdrumFile;
+   while (single.getFile(*file)) {
+      if (base != NULL) {
+         file->analyzeRhythm(base);
+      }
+      segments.push_back(file);
+      file = new HumdrumFile;
+   }
+   delete file;
+
+   int status = 0;
+   if (single.universals.empty() && single.newfilebuffer.empty() &&
+         (single.filelist.size() == 1)) {
+      status = HumdrumCache::write(HumdrumCache::getCacheName(filename),
+            filename, segments);
+   }
+
+   for (int i=0; i<(int)segments.size(); i++) {
+      delete segments[i];
+   }
+   return status;
+}
+
+
+
 //////////////////////////////
 //
 // HumdrumStream::read -- alias for getFile.
@@ -116,6 +280,16 @@ int HumdrumStream::read(HumdrumFile& infile) {
 //
 
 int HumdrumStream::eof(void) {
+   if ((threadcount > 1) && (filelist.size() > 0)) {
+      lock_guard<mutex> lock(prefetchmutex);
+      return pending.empty() && (nextresult >= (int)filelist.size());
+   }
+
+   if (!pending.empty()) {
+      // more segments loaded from a cache
+      return 0;
+   }
+
    istream* newinput = NULL;
 
    // Read HumdrumFile contents from:
@@ -163,11 +337,24 @@ int HumdrumStream::eof(void) {
 //
 
 int HumdrumStream::getFile(HumdrumFile& infile) {
+   if ((threadcount > 1) && (filelist.size() > 0)) {
+      return getPrefetchedFile(infile);
+   }
+
    infile.clear();
    istream* newinput;
 
 restarting:
 
+   if (!pending.empty()) {
+      // return the next segment loaded from a cache
+      HumdrumFile* file = pending.front();
+      pending.pop_front();
+      infile.swap(*file);
+      delete file;
+      return 1;
+   }
+
    newinput = NULL;
 
    if (urlbuffer.eof()) {
@@ -206,6 +393,10 @@ restarting:
          infile.setFilename(filelist[curfile].c_str());
          goto restarting;
       }
+      if (cacheQ && universals.empty() && newfilebuffer.empty() &&
+            readCache(filelist[curfile])) {
+         goto restarting;
+      }
       instream.open(filelist[curfile].c_str());
       infile.setFilename(filelist[curfile].c_str());
       if (!instream.is_open()) {
@@ -440,6 +631,173 @@ restarting:
 }
 
 
+
+//////////////////////////////
+//
+// HumdrumStream::getPrefetchedFile -- getFile() for parallel mode: wait
+//     for the worker threads to finish parsing the next file in the list,
+//     then move its first remaining segment into infile.
+//
+
+int HumdrumStream::getPrefetchedFile(HumdrumFile& infile) {
+   if (workers.empty()) {
+      startThreads();
+   }
+
+   HumdrumFile* file = NULL;
+   {
+      unique_lock<mutex> lock(prefetchmutex);
+      while (pending.empty()) {
+         if (nextresult >= (int)filelist.size()) {
+            infile.clear();
+            return 0;
+         }
+         resultready.wait(lock, [this] {
+            return prefetched.find(nextresult) != prefetched.end();
+         });
+         map<int, vector<HumdrumFile*> >::iterator it;
+         it = prefetched.find(nextresult);
+         pending.assign(it->second.begin(), it->second.end());
+         prefetched.erase(it);
+         curfile = nextresult;
+         nextresult++;
+         jobready.notify_all();
+      }
+      file = pending.front();
+      pending.pop_front();
+   }
+
+   infile.swap(*file);
+   delete file;
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::readCache -- Load the segments of a file from its
+//     .humc cache into the list of pending segments.  Returns 0 if the
+//     file does not have an up-to-date cache.
+//
+
+int HumdrumStream::readCache(const string& filename) {
+   string cachename = HumdrumCache::getCacheName(filename);
+   if (!HumdrumCache::isCurrent(cachename, filename)) {
+      return 0;
+   }
+   vector<HumdrumFile*> segments;
+   if (!HumdrumCache::read(cachename, filename, segments)) {
+      return 0;
+   }
+   pending.insert(pending.end(), segments.begin(), segments.end());
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::startThreads -- start the worker threads which parse
+//     the files in filelist.
+//
+
+void HumdrumStream::startThreads(void) {
+   stopQ = 0;
+   nextjob = nextresult;
+   int count = threadcount;
+   if (count > (int)filelist.size() - nextjob) {
+      count = (int)filelist.size() - nextjob;
+   }
+   for (int i=0; i<count; i++) {
+      workers.push_back(thread(&HumdrumStream::prefetchWorker, this));
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::stopThreads -- stop and remove the worker threads, and
+//     throw away any files which they have parsed but which have not
+//     been read yet.
+//
+
+void HumdrumStream::stopThreads(void) {
+   if (workers.empty()) {
+      return;
+   }
+   {
+      lock_guard<mutex> lock(prefetchmutex);
+      stopQ = 1;
+   }
+   jobready.notify_all();
+   for (int i=0; i<(int)workers.size(); i++) {
+      workers[i].join();
+   }
+   workers.clear();
+   stopQ = 0;
+
+   map<int, vector<HumdrumFile*> >::iterator it;
+   for (it = prefetched.begin(); it != prefetched.end(); it++) {
+      for (int i=0; i<(int)it->second.size(); i++) {
+         delete it->second[i];
+      }
+   }
+   prefetched.clear();
+   nextjob = nextresult;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumStream::prefetchWorker -- main loop of a worker thread: claim
+//     the next unparsed file in the list, read all of its segments (and
+//     optionally analyze their rhythms), then hand them back to the
+//     reading thread.
+//
+
+void HumdrumStream::prefetchWorker(void) {
+   int index;
+   string filename;
+   while (1) {
+      {
+         unique_lock<mutex> lock(prefetchmutex);
+         jobready.wait(lock, [this] {
+            return stopQ || (nextjob >= (int)filelist.size()) ||
+                  (nextjob < nextresult + prefetchlimit);
+         });
+         if (stopQ || (nextjob >= (int)filelist.size())) {
+            return;
+         }
+         index = nextjob++;
+         filename = filelist[index];
+      }
+
+      vector<HumdrumFile*> segments;
+      HumdrumStream single(vector<string>(1, filename));
+      single.setCacheUse(cacheQ);
+      HumdrumFile* file = new HumdrumFile;
+      while (single.getFile(*file)) {
+         if (rhythmQ) {
+            file->analyzeRhythm(rhythmbase.c_str());
+            file->keepRhythmAnalysis();
+         }
+         segments.push_back(file);
+         file = new HumdrumFile;
+      }
+      delete file;
+
+      {
+         lock_guard<mutex> lock(prefetchmutex);
+         prefetched[index] = segments;
+      }
+      resultready.notify_all();
+   }
+}
+
+
 //////////////////////////////
 //
 // HumdrumStream::fillUrlBuffer --
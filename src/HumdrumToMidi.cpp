@@ -0,0 +1,1339 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 22:09:46 PDT 2026
+// Last Modified: Sat Oct 17 22:09:46 PDT 2026
+// Last Modified: Sun Oct 18 01:05:40 PDT 2026 event times and order as in hum2mid
+// Filename:      ...sig/src/sigInfo/HumdrumToMidi.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/HumdrumToMidi.cpp
+// Syntax:        C++
+//
+// Description:   Converts the **kern spines of a HumdrumFile into a
+//                Standard MIDI File, writing the events of each track
+//                directly into a byte buffer in time order.
+//
+
+#include "HumdrumToMidi.h"
+#include "HumdrumNoteTable.h"
+#include "Convert.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include <algorithm>
+#include <fstream>
+
+// extra ticks after the last line, so that players do not cut off
+// the last notes (same as hum2mid):
+#define ENDING_TICKS 120
+
+// duration in ticks for notes on lines without duration (grace notes):
+#define GRACE_TICKS 12
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::HumdrumToMidi --
+//
+
+HumdrumToMidi::HumdrumToMidi(void) {
+   tpq            = 120;
+   velocity       = 64;
+   fixedvelocityQ = 0;
+   transpose      = 0;
+   channel        = -1;
+   type0Q         = 0;
+   padQ           = 1;
+   commentQ       = 1;
+   textQ          = 0;
+   instrumentQ    = 1;
+   ktrackcount    = 0;
+   serial         = 0;
+   currenttranspose = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::~HumdrumToMidi --
+//
+
+HumdrumToMidi::~HumdrumToMidi() {
+   // do nothing
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::clear -- Remove the data of the last conversion.  The
+//     track buffers keep their storage for the next conversion.
+//
+
+void HumdrumToMidi::clear(void) {
+   int i;
+   for (i=0; i<(int)trackdata.size(); i++) {
+      trackdata[i].clear();
+      noteoffs[i].clear();
+   }
+   ktrackcount = 0;
+   serial = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setTicksPerQuarterNote -- default 120.
+//
+
+void HumdrumToMidi::setTicksPerQuarterNote(int ticks) {
+   if (ticks < 1) {
+      ticks = 1;
+   } else if (ticks > 0x7fff) {
+      ticks = 0x7fff;
+   }
+   tpq = ticks;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setVelocity -- Set the attack velocity of notes
+//     (default 64).  Accents and sforzandos increase the velocity.
+//
+
+void HumdrumToMidi::setVelocity(int aVelocity) {
+   if (aVelocity < 1) {
+      aVelocity = 1;
+   } else if (aVelocity > 127) {
+      aVelocity = 127;
+   }
+   velocity = aVelocity;
+   fixedvelocityQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setFixedVelocity -- Set the attack velocity of all
+//     notes, regardless of accents (hum2mid -v option).
+//
+
+void HumdrumToMidi::setFixedVelocity(int aVelocity) {
+   setVelocity(aVelocity);
+   fixedvelocityQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setTranspose -- Transpose notes by the given number of
+//     semitones.  A "!!midi-transpose:" line in the file replaces this
+//     value from that point in the file.
+//
+
+void HumdrumToMidi::setTranspose(int semitones) {
+   transpose = semitones;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setChannel -- Store all notes in the given channel
+//     (offset from 0).  Use -1 to assign channels by instrument (default).
+//
+
+void HumdrumToMidi::setChannel(int aChannel) {
+   if (aChannel > 15) {
+      aChannel = 15;
+   }
+   if (aChannel < 0) {
+      aChannel = -1;
+   }
+   channel = aChannel;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setType0 -- Store all events in a single track.
+//
+
+void HumdrumToMidi::setType0(int state) {
+   type0Q = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setPadding -- Add a silent note just before the end
+//     of each track (default on).
+//
+
+void HumdrumToMidi::setPadding(int state) {
+   padQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setComments -- Store global comments as text meta
+//     messages (default on).
+//
+
+void HumdrumToMidi::setComments(int state) {
+   commentQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setText -- Store the title and copyright of the work
+//     (and other reference records if comments are stored) as meta
+//     messages (default off).
+//
+
+void HumdrumToMidi::setText(int state) {
+   textQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::setInstruments -- Store program changes for *I
+//     instrument codes (default on).
+//
+
+void HumdrumToMidi::setInstruments(int state) {
+   instrumentQ = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::convert -- Convert a Humdrum file into MIDI data.
+//     Track 0 contains the tempo, meter, key and text meta messages,
+//     and there is one more track for each **kern spine (the last
+//     spine is stored in track 1).  The lines of the file are processed
+//     in order, and all events on a line have the tick time of the line,
+//     so events are always stored in time order.  Note-offs are kept
+//     in a heap until an event at or after their time is stored.  The
+//     track names (at the first data line) and the program changes and
+//     pan controllers of the interpretation lines before a data line are
+//     stored after the meta messages of track 0 at that time, which is
+//     where they are when hum2mid joins and sorts the tracks of a type-0
+//     file.  A file without **kern spines gives a type-0 file with only
+//     track 0 (as in hum2mid).
+//
+
+void HumdrumToMidi::convert(HumdrumFile& infile) {
+   clear();
+   if (!infile.rhythmQ()) {
+      infile.analyzeRhythm("4");
+   }
+   vector<int> ktracks;
+   infile.getKernTracks(ktracks);
+   ktrackcount = (int)ktracks.size();
+   trackindex.resize(infile.getMaxTracks() + 1);
+   fill(trackindex.begin(), trackindex.end(), -1);
+   int i;
+   for (i=0; i<ktrackcount; i++) {
+      trackindex[ktracks[i]] = ktrackcount - i;
+   }
+
+   int tcount = type0Q ? 1 : ktrackcount + 1;
+   if ((int)trackdata.size() < tcount) {
+      trackdata.resize(tcount);
+      noteoffs.resize(tcount);
+   }
+   tracktick.resize(tcount);
+   fill(tracktick.begin(), tracktick.end(), 0);
+
+   assignChannels(infile);
+   storeGraceCounts(infile);
+   if (textQ) {
+      storeTitle(infile);
+   }
+
+   currenttranspose = transpose;
+   int index = 0;
+   int lastdata = -1;
+   int tick;
+   int k;
+   const char* ptr;
+   for (i=0; i<infile.getNumLines(); i++) {
+      tick = int(infile[i].getAbsBeat() * tpq);
+      switch (infile[i].getType()) {
+         case E_humrec_global_comment:
+            ptr = strstr(infile[i][0], "midi-transpose");
+            if (ptr != NULL) {
+               ptr += strlen("midi-transpose");
+               while (isspace(*ptr)) {
+                  ptr++;
+               }
+               if (*ptr == ':') {
+                  ptr++;
+                  while (isspace(*ptr)) {
+                     ptr++;
+                  }
+                  if (isdigit(*ptr) || ((*ptr == '-') && isdigit(ptr[1]))) {
+                     currenttranspose = atoi(ptr);
+                  }
+               }
+            }
+            if (commentQ) {
+               storeMetaEvent(0, tick, 0x01, infile[i][0],
+                     strlen(infile[i][0]));
+            }
+            break;
+
+         case E_humrec_bibliography:
+            if (!textQ) {
+               break;
+            }
+            if (strncmp(infile[i][0] + 3, "YEC", 3) == 0) {
+               storeMetaEvent(0, tick, 0x02, infile[i][0],
+                     strlen(infile[i][0]));
+            } else if (commentQ) {
+               storeMetaEvent(0, tick, 0x01, infile[i][0],
+                     strlen(infile[i][0]));
+            }
+            break;
+
+         case E_humrec_interpretation:
+            storeTempo(infile, i, tick);
+            break;
+
+         case E_humrec_data:
+            storeTimeSignature(infile, i, tick);
+            storeKeySignature(infile, i, tick);
+            if (lastdata < 0) {
+               storeTrackNames(infile);
+            }
+            for (k=lastdata+1; k<i; k++) {
+               if (infile[k].isInterpretation()) {
+                  storeInterpretations(infile, k,
+                        int(infile[k].getAbsBeat() * tpq));
+               }
+            }
+            storeNotes(infile, i, tick, index);
+            lastdata = i;
+            break;
+
+         default:
+            break;
+      }
+   }
+   if (lastdata < 0) {
+      storeTrackNames(infile);
+   }
+   for (k=lastdata+1; k<infile.getNumLines(); k++) {
+      if (infile[k].isInterpretation()) {
+         storeInterpretations(infile, k, int(infile[k].getAbsBeat() * tpq));
+      }
+   }
+
+   storeEnding(infile);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::getTrackCount -- return the number of tracks in the
+//     converted MIDI data.  There is always at least track 0, and a file
+//     with one track is written as a type-0 file.
+//
+
+int HumdrumToMidi::getTrackCount(void) const {
+   return type0Q ? 1 : ktrackcount + 1;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::getSize -- return the number of bytes in the Standard
+//     MIDI File.
+//
+
+int HumdrumToMidi::getSize(void) const {
+   int tcount = getTrackCount();
+   int sum = 14;
+   int i;
+   for (i=0; i<tcount; i++) {
+      sum += 8 + (int)trackdata[i].size();
+   }
+   return sum;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::getData -- Store the Standard MIDI File in a byte array.
+//
+
+void HumdrumToMidi::getData(vector<unsigned char>& data) {
+   int tcount = getTrackCount();
+   data.resize(getSize());
+   unsigned char* ptr = data.data();
+   memcpy(ptr, "MThd", 4);
+   ptr[4] = 0;
+   ptr[5] = 0;
+   ptr[6] = 0;
+   ptr[7] = 6;
+   ptr[8] = 0;
+   ptr[9] = (tcount == 1) ? 0 : 1;
+   ptr[10] = (tcount >> 8) & 0xff;
+   ptr[11] = tcount & 0xff;
+   ptr[12] = (tpq >> 8) & 0xff;
+   ptr[13] = tpq & 0xff;
+   ptr += 14;
+
+   int i;
+   int size;
+   for (i=0; i<tcount; i++) {
+      size = (int)trackdata[i].size();
+      memcpy(ptr, "MTrk", 4);
+      ptr[4] = (size >> 24) & 0xff;
+      ptr[5] = (size >> 16) & 0xff;
+      ptr[6] = (size >>  8) & 0xff;
+      ptr[7] = size & 0xff;
+      if (size > 0) {
+         memcpy(ptr + 8, trackdata[i].data(), size);
+      }
+      ptr += 8 + size;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::write -- Write the Standard MIDI File to a stream or
+//     file.  The filename version returns 0 if the file could not be
+//     written.
+//
+
+ostream& HumdrumToMidi::write(ostream& out) {
+   int tcount = getTrackCount();
+   char header[14] = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 0, 0, 0};
+   header[9]  = (tcount == 1) ? 0 : 1;
+   header[10] = (tcount >> 8) & 0xff;
+   header[11] = tcount & 0xff;
+   header[12] = (tpq >> 8) & 0xff;
+   header[13] = tpq & 0xff;
+   out.write(header, 14);
+
+   int i;
+   int size;
+   char trackheader[8] = {'M', 'T', 'r', 'k', 0, 0, 0, 0};
+   for (i=0; i<tcount; i++) {
+      size = (int)trackdata[i].size();
+      trackheader[4] = (size >> 24) & 0xff;
+      trackheader[5] = (size >> 16) & 0xff;
+      trackheader[6] = (size >>  8) & 0xff;
+      trackheader[7] = size & 0xff;
+      out.write(trackheader, 8);
+      out.write((const char*)trackdata[i].data(), size);
+   }
+   return out;
+}
+
+
+int HumdrumToMidi::write(const char* filename) {
+   ofstream outfile(filename, ios::out | ios::binary);
+   if (!outfile.is_open()) {
+      return 0;
+   }
+   write(outfile);
+   outfile.close();
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::assignChannels -- Assign a channel to each track, in
+//     the same way as hum2mid.  Tracks with a General MIDI instrument
+//     are given their own channel, avoiding the percussion channel.
+//
+
+void HumdrumToMidi::assignChannels(HumdrumFile& infile) {
+   int i, j;
+   trackchannel.resize(ktrackcount + 1);
+   if (channel >= 0) {
+      fill(trackchannel.begin(), trackchannel.end(), channel);
+      return;
+   }
+   fill(trackchannel.begin(), trackchannel.end(), 0);
+
+   vector<int> trackinst(ktrackcount + 1, -1);
+   int instcount = 0;
+   int track;
+   int inst;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (infile[i].isData()) {
+         break;
+      }
+      if (!infile[i].isInterpretation()) {
+         continue;
+      }
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         if (strncmp(infile[i][j], "*I", 2) != 0) {
+            continue;
+         }
+         track = trackindex[infile[i].getPrimaryTrack(j)];
+         if (track < 0) {
+            continue;
+         }
+         inst = instruments.getGM(infile[i][j]);
+         if ((inst != -1) && (trackinst[track] == -1)) {
+            trackinst[track] = inst;
+            instcount++;
+         }
+      }
+   }
+
+   int nextchannel = 1;   // channel 0 is for undefined instrument spines
+   int dup;
+   if (instcount < 14) {
+      for (i=0; i<(int)trackinst.size(); i++) {
+         if (trackinst[i] != -1) {
+            if (nextchannel == 9) {
+               nextchannel++;
+            }
+            trackchannel[i] = nextchannel++;
+         }
+         if (nextchannel == 9) {
+            nextchannel++;
+         }
+      }
+   } else {
+      // place duplicate instruments on the same channel
+      for (i=0; i<(int)trackinst.size(); i++) {
+         dup = -1;
+         for (j=0; j<i; j++) {
+            if (trackinst[j] == trackinst[i]) {
+               dup = j;
+            }
+         }
+         if (trackinst[i] == -1) {
+            trackchannel[i] = 0;
+         } else if (dup != -1) {
+            trackchannel[i] = trackchannel[dup];
+         } else {
+            if (nextchannel == 10) {
+               nextchannel++;
+            }
+            trackchannel[i] = nextchannel++;
+         }
+         if (nextchannel == 10) {
+            nextchannel++;
+         }
+      }
+      if (nextchannel > 16) {
+         for (i=0; i<(int)trackchannel.size(); i++) {
+            if (trackchannel[i] > 15) {
+               trackchannel[i] = 0;
+            }
+         }
+      }
+   }
+
+   // don't conserve channels if there are enough to go around
+   if (ktrackcount < 13) {
+      for (i=1; i<ktrackcount; i++) {
+         trackchannel[i] = (i >= 10) ? i : i - 1;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeGraceCounts -- Store for each line without
+//     duration the number of lines without duration from it up to the
+//     next line with a duration (the grace-note state in hum2mid).
+//
+
+void HumdrumToMidi::storeGraceCounts(HumdrumFile& infile) {
+   int lines = infile.getNumLines();
+   gracecount.resize(lines);
+   int i;
+   for (i=lines-1; i>=0; i--) {
+      if (infile[i].getDuration() != 0.0) {
+         gracecount[i] = 0;
+      } else if (i < lines - 1) {
+         gracecount[i] = 1 + gracecount[i+1];
+      } else {
+         gracecount[i] = 1;
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeTrackNames -- Name each track which contains an
+//     instrument code, using the first *I" instrument name before the
+//     data.
+//
+
+void HumdrumToMidi::storeTrackNames(HumdrumFile& infile) {
+   vector<const char*> names(ktrackcount + 1, (const char*)NULL);
+   vector<char> named(ktrackcount + 1, 0);
+   int i, j;
+   int track;
+   int dataQ = 0;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (infile[i].isData()) {
+         dataQ = 1;
+         continue;
+      }
+      if (!infile[i].isInterpretation()) {
+         continue;
+      }
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         if (strncmp(infile[i][j], "*I", 2) != 0) {
+            continue;
+         }
+         if (!infile[i].isExInterp(j, "**kern")) {
+            continue;
+         }
+         track = trackindex[infile[i].getPrimaryTrack(j)];
+         if (track < 0) {
+            continue;
+         }
+         named[track] = 1;
+         if (!dataQ && (names[track] == NULL) && (infile[i][j][2] == '"')) {
+            names[track] = infile[i][j] + 3;
+         }
+      }
+   }
+
+   for (i=1; i<(int)named.size(); i++) {
+      if (!named[i]) {
+         continue;
+      }
+      if (names[i] == NULL) {
+         storeMetaEvent(i, 0, 0x03, "", 0);
+      } else {
+         storeMetaEvent(i, 0, 0x03, names[i], strlen(names[i]));
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeTitle -- Store the !!!OPR and !!!OTL records as
+//     the name of track 0.
+//
+
+void HumdrumToMidi::storeTitle(HumdrumFile& infile) {
+   int opr = -1;
+   int otl = -1;
+   int i;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (!infile[i].isBibliographic()) {
+         continue;
+      }
+      if ((opr < 0) && (strncmp(infile[i][0], "!!!OPR", 6) == 0)) {
+         opr = i;
+      }
+      if ((otl < 0) && (strncmp(infile[i][0], "!!!OTL", 6) == 0)) {
+         otl = i;
+      }
+   }
+
+   string title;
+   string value;
+   if (opr >= 0) {
+      title = infile[opr].getBibValue(value);
+   }
+   if (otl >= 0) {
+      if (opr >= 0) {
+         title += "  ";
+      }
+      title += infile[otl].getBibValue(value);
+   }
+   if (!title.empty()) {
+      storeMetaEvent(0, 0, 0x03, title.c_str(), (int)title.size());
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeTempo -- Store a tempo meta message for the first
+//     *MM tempo marking on an interpretation line.
+//
+
+void HumdrumToMidi::storeTempo(HumdrumFile& infile, int line, int tick) {
+   int j;
+   float tempo = 60.0;
+   for (j=0; j<infile[line].getFieldCount(); j++) {
+      if (strncmp(infile[line][j], "*MM", 3) == 0) {
+         break;
+      }
+   }
+   if (j >= infile[line].getFieldCount()) {
+      return;
+   }
+   sscanf(infile[line][j] + 3, "%f", &tempo);
+   int itempo = (int)tempo;
+   if (itempo <= 0) {
+      return;
+   }
+   int usec = (int)(60000000.0 / itempo + 0.5);
+   char data[3];
+   data[0] = (usec >> 16) & 0xff;
+   data[1] = (usec >>  8) & 0xff;
+   data[2] = usec & 0xff;
+   storeMetaEvent(0, tick, 0x51, data, 3);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeInterpretations -- Store program changes for
+//     instrument codes and pan controllers for *pan= in the **kern spines.
+//
+
+void HumdrumToMidi::storeInterpretations(HumdrumFile& infile, int line,
+      int tick) {
+   int j;
+   int track;
+   int chan;
+   for (j=infile[line].getFieldCount()-1; j>=0; j--) {
+      if (infile[line][j][1] != 'I' && infile[line][j][1] != 'p') {
+         continue;
+      }
+      if (!infile[line].isExInterp(j, "**kern")) {
+         continue;
+      }
+      track = trackindex[infile[line].getPrimaryTrack(j)];
+      chan  = 0x0f & trackchannel[track];
+      if (strncmp(infile[line][j], "*I", 2) == 0) {
+         if (!instrumentQ) {
+            continue;
+         }
+         int pc = instruments.getGM(infile[line][j]);
+         if (pc >= 0) {
+            storeEvent(getTrack(track), tick, 0xc0 | chan, pc);
+         }
+      } else if (strncmp(infile[line][j], "*pan=", 5) == 0) {
+         double value = 0.5;
+         int mvalue;
+         sscanf(infile[line][j], "*pan=%lf", &value);
+         if (value <= 1.0) {
+            mvalue = int(value * 128.0);
+         } else {
+            mvalue = int(value + 0.5);
+         }
+         if (mvalue > 127) {
+            mvalue = 127;
+         } else if (mvalue < 0) {
+            mvalue = 0;
+         }
+         storeEvent(getTrack(track), tick, 0xb0 | chan, 10, mvalue);
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeTimeSignature -- Store a time signature if there
+//     is one in the **kern spines between the previous data line and
+//     the given data line.  The time signature must be the same in all
+//     **kern spines; otherwise a global comment such as
+//        !!primary-mensuration: met(C|)
+//     is used to select a time signature.
+//
+
+void HumdrumToMidi::storeTimeSignature(HumdrumFile& infile, int line,
+      int tick) {
+   int i, j;
+   int top = 4;
+   int bottom = 1;
+   int bottom2 = 0;
+   int ttop, tbottom, tbottom2;
+   int foundsig = -1;
+   string primary;
+   const char* ptr;
+   const char* ptr2;
+   int firstkern;
+
+   for (i=line-1; i>0; i--) {
+      if (infile[i].isData()) {
+         break;
+      }
+      if (infile[i].isGlobalComment()) {
+         ptr = infile[i][0];
+         if (strncmp(ptr, "!!primary-mensuration:", 22) != 0) {
+            continue;
+         }
+         ptr += 22;
+         while (isspace(*ptr)) {
+            ptr++;
+         }
+         if (strncmp(ptr, "met(", 4) != 0) {
+            continue;
+         }
+         ptr += 4;
+         ptr2 = strchr(ptr, ')');
+         if ((ptr2 == NULL) || (ptr2 == ptr)) {
+            continue;
+         }
+         primary.assign(ptr, ptr2 - ptr);
+         ptr2++;
+         while (isspace(*ptr2)) {
+            ptr2++;
+         }
+         if (*ptr2 != '\0') {
+            continue;
+         }
+         if ((primary == "C|") || (primary == "C.") || (primary == "C") ||
+               (primary == "C2")) {
+            top = 2;
+            bottom = 1;
+         }
+         if ((primary == "3") || (primary == "3/2") || (primary == "C|3") ||
+               (primary == "C3") || (primary == "O|") || (primary == "O") ||
+               (primary == "O2") || (primary == "O/3") ||
+               (primary == "O3/2")) {
+            top = 3;
+            bottom = 1;
+         }
+         foundsig = i;
+         break;
+      } else if (strncmp(infile[i][0], "**", 2) == 0) {
+         break;
+      } else if (infile[i].isInterpretation()) {
+         firstkern = -1;
+         for (j=0; j<infile[i].getFieldCount(); j++) {
+            if (!infile[i].isExInterp(j, "**kern")) {
+               continue;
+            }
+            if (firstkern == -1) {
+               if (!getTimeSignature(infile[i][j], ttop, tbottom,
+                     tbottom2)) {
+                  break;
+               }
+               top = ttop;
+               bottom = tbottom;
+               bottom2 = tbottom2;
+               firstkern = j;
+            } else if (strcmp(infile[i][firstkern], infile[i][j]) != 0) {
+               firstkern = -1;
+            }
+         }
+         if (firstkern >= 0) {
+            foundsig = i;
+            break;
+         }
+      }
+   }
+
+   if (foundsig < 0) {
+      return;
+   }
+
+   int cticks = 24;
+   int ispow2 = ((bottom & (bottom - 1)) == 0);
+   if (bottom2 > 0) {
+      if ((top == 3) && (bottom == 3) && (bottom2 == 2)) {
+         // 2/1 with coloration
+         top = 2;
+         bottom = 1;
+         cticks = 64;
+      } else {
+         return;
+      }
+   } else if (ispow2) {
+      if (bottom == 0) {
+         // breve is not possible in MIDI, so use semibreve
+         bottom = 1;
+         top *= 2;
+      } else {
+         cticks = cticks * 4 / bottom;
+      }
+      if ((top != 3) && (top % 3 == 0)) {
+         cticks *= 3;
+      }
+   } else {
+      // cannot represent denominators which are not a power of 2
+      return;
+   }
+
+   int base2 = 0;
+   while (bottom >>= 1) {
+      base2++;
+   }
+   char data[4];
+   data[0] = top & 0xff;
+   data[1] = base2 & 0xff;
+   data[2] = cticks & 0xff;
+   data[3] = 8;
+   storeMetaEvent(0, tick, 0x58, data, 4);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeKeySignature -- Store a key signature if there is
+//     both a key and key signature in the first **kern spine between
+//     the previous data line and the given data line.
+//
+
+void HumdrumToMidi::storeKeySignature(HumdrumFile& infile, int line,
+      int tick) {
+   int i, j;
+   int firstkern;
+   int minorQ = -1;
+   const char* keysig = NULL;
+   const char* ptr;
+   for (i=line-1; i>0; i--) {
+      if (infile[i].isData()) {
+         break;
+      }
+      if (strncmp(infile[i][0], "**", 2) == 0) {
+         break;
+      }
+      if (!infile[i].isInterpretation()) {
+         continue;
+      }
+      firstkern = -1;
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         if (!infile[i].isExInterp(j, "**kern")) {
+            continue;
+         }
+         if (firstkern == -1) {
+            ptr = infile[i][j];
+            if ((ptr[0] == '*') && (toupper(ptr[1]) >= 'A') &&
+                  (toupper(ptr[1]) <= 'G')) {
+               ptr += 2;
+               while ((*ptr == '#') || (*ptr == '-')) {
+                  ptr++;
+               }
+               if (*ptr == ':') {
+                  minorQ = islower(infile[i][j][1]) ? 1 : 0;
+               }
+            } else if (strncmp(ptr, "*k[", 3) == 0) {
+               ptr += 3;
+               while ((toupper(*ptr) >= 'A' && toupper(*ptr) <= 'G') ||
+                     (*ptr == '#') || (*ptr == '-')) {
+                  ptr++;
+               }
+               if (*ptr == ']') {
+                  keysig = infile[i][j];
+               }
+            }
+            firstkern = j;
+         } else if (strcmp(infile[i][firstkern], infile[i][j]) != 0) {
+            firstkern = -1;
+         }
+      }
+   }
+
+   if ((minorQ < 0) || (keysig == NULL)) {
+      return;
+   }
+
+   int keynum = Convert::kernKeyToNumber(keysig);
+   char data[2];
+   data[0] = (keynum >= 0) ? keynum : 0x100 + keynum;
+   data[1] = minorQ;
+   storeMetaEvent(0, tick, 0x59, data, 2);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeNotes -- Store the note-ons for the notes which
+//     are attacked on a data line, and queue their note-offs.  Spines
+//     are processed from right to left (as in hum2mid).  The index is
+//     the position of the first note on the line in the note table,
+//     and is updated to the first note of the next line.
+//
+//     hum2mid moves notes on lines without duration by the number of
+//     lines without duration which follow (times tempo * tpq / 600).
+//     Its tempo is always -1 for the options handled here (it is reset
+//     on each interpretation line), so such notes are delayed by a
+//     tick for about each 600/tpq lines.  Delayed note-ons are kept in
+//     the note-off heap until their time.
+//
+
+void HumdrumToMidi::storeNotes(HumdrumFile& infile, int line, int tick,
+      int& index) {
+   const HumdrumNoteTable& notes = infile.getNoteTable();
+   int start = index;
+   while ((start < notes.getSize()) && (notes.line[start] < line)) {
+      start++;
+   }
+   int stop = start;
+   while ((stop < notes.getSize()) && (notes.line[stop] == line)) {
+      stop++;
+   }
+   index = stop;
+
+   int linegrace = int(infile[line].getDuration() * tpq + 0.5);
+   int delay = -int(gracecount[line] * (-tpq / 600.0) + 0.5);
+   int ontick = tick + delay;
+   char buffer[1024] = {0};
+   int first;
+   int last = stop;
+   int n;
+   int track;
+   int mtrack;
+   int chan;
+   int key;
+   int vel;
+   int offtick;
+   int accentQ;
+   int sforzandoQ;
+   int staccatoQ;
+   double duration;
+   const char* token;
+
+   while (last > start) {
+      // notes of a spine are contiguous, with chord notes in order
+      first = last - 1;
+      while ((first > start) && (notes.field[first-1] == notes.field[last-1])) {
+         first--;
+      }
+      token  = infile[line][notes.field[first]];
+      track  = trackindex[notes.track[first]];
+      mtrack = getTrack(track);
+      chan   = 0x0f & trackchannel[track];
+      vel    = velocity;
+      for (n=first; n<last; n++) {
+         if (!notes.isAttack(n)) {
+            continue;
+         }
+         accentQ    = 0;
+         sforzandoQ = 0;
+         staccatoQ  = 0;
+         if (strpbrk(token, "^z'`\"s") != NULL) {
+            infile[line].getToken(buffer, notes.field[n], notes.subtoken[n],
+                  1000);
+            accentQ    = strchr(buffer, '^') != NULL;
+            sforzandoQ = strchr(buffer, 'z') != NULL;
+            // attacas, staccatissimos, pizzicatos and spiccatos are
+            // played as staccatos
+            staccatoQ  = strpbrk(buffer, "'`\"s") != NULL;
+         }
+
+         if (notes.tienext[n] >= 0) {
+            duration = notes.tiedduration[n].getFloat();
+         } else {
+            duration = notes.duration[n].getFloat();
+         }
+         if (staccatoQ) {
+            duration *= 0.5;
+         }
+         if (accentQ) {
+            vel = (int)(vel * 1.3 + 0.5);
+         }
+         if (sforzandoQ) {
+            vel = (int)(vel * 1.5 + 0.5);
+         }
+         if (vel > 127) {
+            vel = 127;
+         }
+         if (vel < 1) {
+            vel = 1;
+         }
+
+         key = notes.midi[n] + currenttranspose;
+         if (key > 127) {
+            key = 127;
+         } else if (key < 0) {
+            key = 0;
+         }
+
+         offtick = int(duration * tpq) + ontick;
+         if (offtick <= ontick) {
+            offtick = ontick + linegrace;
+         }
+         if (offtick <= ontick) {
+            offtick = ontick + GRACE_TICKS;
+         }
+
+         if (delay > 0) {
+            storeNoteOff(mtrack, ontick, 0x90 | chan, key,
+                  fixedvelocityQ ? velocity : vel);
+         } else {
+            storeEvent(mtrack, tick, 0x90 | chan, key,
+                  fixedvelocityQ ? velocity : vel);
+         }
+         storeNoteOff(mtrack, offtick, 0x80 | chan, key,
+               fixedvelocityQ ? velocity : vel);
+      }
+      last = first;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeEnding -- Store the remaining note-offs, the
+//     padding notes and the end-of-track messages.
+//
+
+void HumdrumToMidi::storeEnding(HumdrumFile& infile) {
+   int endtick = ENDING_TICKS;
+   if (infile.getNumLines() > 0) {
+      endtick += int(infile[infile.getNumLines()-1].getAbsBeat() * tpq);
+   }
+   int tcount = getTrackCount();
+   int i;
+   for (i=0; i<tcount; i++) {
+      flushNoteOffs(i, 0x7fffffff);
+      // Don't pad the first track of type-1 files, because Windows
+      // Media Player won't play the MIDI file otherwise.
+      if (padQ && (type0Q || (i > 0))) {
+         storeEvent(i, endtick - 1, 0x90, 0x00, 0x00);
+      }
+      storeTick(i, tracktick[i]);
+      trackdata[i].push_back(0xff);
+      trackdata[i].push_back(0x2f);
+      trackdata[i].push_back(0x00);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::getTrack -- return the MIDI track in which to store
+//     the events for a **kern spine track number.
+//
+
+int HumdrumToMidi::getTrack(int track) const {
+   return type0Q ? 0 : track;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeEvent -- Store a channel message (with two or
+//     three bytes).  Note-offs waiting in the track at an earlier time are
+//     stored first.  Note-offs at the same time are also stored first if
+//     the message is a note-on.
+//
+
+void HumdrumToMidi::storeEvent(int track, int tick, int p0, int p1,
+      int p2) {
+   if ((p0 & 0xf0) == 0x90) {
+      flushNoteOffs(track, tick + 1);
+   } else {
+      flushNoteOffs(track, tick);
+   }
+   storeTick(track, tick);
+   vector<unsigned char>& data = trackdata[track];
+   data.push_back((unsigned char)p0);
+   data.push_back((unsigned char)p1);
+   if (p2 >= 0) {
+      data.push_back((unsigned char)p2);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeMetaEvent -- Store a meta message.
+//
+
+void HumdrumToMidi::storeMetaEvent(int track, int tick, int type,
+      const char* text, int size) {
+   track = getTrack(track);
+   flushNoteOffs(track, tick);
+   storeTick(track, tick);
+   vector<unsigned char>& data = trackdata[track];
+   data.push_back(0xff);
+   data.push_back((unsigned char)(type & 0x7f));
+   storeVLV(data, size);
+   data.insert(data.end(), (const unsigned char*)text,
+         (const unsigned char*)text + size);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeNoteOff -- Add a note-off (or a delayed note-on)
+//     to the heap of waiting note-offs in a track.
+//
+
+void HumdrumToMidi::storeNoteOff(int track, int tick, int command, int key,
+      int aVelocity) {
+   _HumdrumToMidiNoteOff noteoff;
+   noteoff.tick     = tick;
+   noteoff.serial   = serial++;
+   noteoff.command  = (unsigned char)command;
+   noteoff.key      = (unsigned char)key;
+   noteoff.velocity = (unsigned char)aVelocity;
+   noteoffs[track].push_back(noteoff);
+   push_heap(noteoffs[track].begin(), noteoffs[track].end(), noteOffCompare);
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::flushNoteOffs -- Store the waiting note-offs in a track
+//     which occur before the given tick time.  Note-offs at the same time
+//     are stored in the order that they were added, before any delayed
+//     note-ons at that time.
+//
+
+void HumdrumToMidi::flushNoteOffs(int track, int tick) {
+   vector<_HumdrumToMidiNoteOff>& heap = noteoffs[track];
+   vector<unsigned char>& data = trackdata[track];
+   while (!heap.empty() && (heap.front().tick < tick)) {
+      _HumdrumToMidiNoteOff& noteoff = heap.front();
+      storeTick(track, noteoff.tick);
+      data.push_back(noteoff.command);
+      data.push_back(noteoff.key);
+      data.push_back(noteoff.velocity);
+      pop_heap(heap.begin(), heap.end(), noteOffCompare);
+      heap.pop_back();
+   }
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeTick -- Store the delta time of the next event in
+//     a track.  Events are stored in time order, so a time earlier than
+//     the previous event in the track is stored at the previous time.
+//
+
+void HumdrumToMidi::storeTick(int track, int tick) {
+   if (tick < tracktick[track]) {
+      tick = tracktick[track];
+   }
+   storeVLV(trackdata[track], tick - tracktick[track]);
+   tracktick[track] = tick;
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::storeVLV -- Append a MIDI variable-length value.
+//
+
+void HumdrumToMidi::storeVLV(vector<unsigned char>& data, int value) {
+   unsigned long uvalue = (unsigned long)value & 0x0fffffff;
+   if (uvalue >= (1 << 21)) {
+      data.push_back((unsigned char)(0x80 | ((uvalue >> 21) & 0x7f)));
+   }
+   if (uvalue >= (1 << 14)) {
+      data.push_back((unsigned char)(0x80 | ((uvalue >> 14) & 0x7f)));
+   }
+   if (uvalue >= (1 << 7)) {
+      data.push_back((unsigned char)(0x80 | ((uvalue >> 7) & 0x7f)));
+   }
+   data.push_back((unsigned char)(uvalue & 0x7f));
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::getTimeSignature -- Read a time signature such as
+//     "*M3/4" or "*M3/3%2".  Returns 0 if the token is not a time
+//     signature.
+//
+
+int HumdrumToMidi::getTimeSignature(const char* token, int& top,
+      int& bottom, int& bottom2) {
+   if (strncmp(token, "*M", 2) != 0) {
+      return 0;
+   }
+   const char* ptr = token + 2;
+   if (!isdigit(*ptr)) {
+      return 0;
+   }
+   top = atoi(ptr);
+   while (isdigit(*ptr)) {
+      ptr++;
+   }
+   if ((*ptr != '/') || !isdigit(ptr[1])) {
+      return 0;
+   }
+   ptr++;
+   bottom = atoi(ptr);
+   while (isdigit(*ptr)) {
+      ptr++;
+   }
+   if (*ptr == '%') {
+      ptr++;
+   }
+   bottom2 = atoi(ptr);
+   while (isdigit(*ptr)) {
+      ptr++;
+   }
+   return *ptr == '\0';
+}
+
+
+
+//////////////////////////////
+//
+// HumdrumToMidi::noteOffCompare -- Ordering for the note-off heap: the
+//     earliest note-off (and the first stored at that time) is at the
+//     front of the heap.  Delayed note-ons follow the note-offs at the
+//     same time.
+//
+
+bool HumdrumToMidi::noteOffCompare(const _HumdrumToMidiNoteOff& a,
+      const _HumdrumToMidiNoteOff& b) {
+   if (a.tick != b.tick) {
+      return a.tick > b.tick;
+   }
+   if ((a.command & 0xf0) != (b.command & 0xf0)) {
+      return (a.command & 0xf0) > (b.command & 0xf0);
+   }
+   return a.serial > b.serial;
+}
+
+
+
@@ -0,0 +1,277 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 19:12:08 PDT 2026
+// Last Modified: Sat Oct 17 19:12:08 PDT 2026
+// Filename:      ...sig/src/sigInfo/KeyFinder.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/KeyFinder.cpp
+// Syntax:        C++
+//
+// Description:   Krumhansl-Schmuckler style key finding with precomputed
+//                key profiles and running-sum window histograms.
+//
+
+#include "KeyFinder.h"
+
+#include <math.h>
+
+
+//////////////////////////////
+//
+// KeyFinder::KeyFinder -- The default profiles are the Krumhansl-Kessler
+//     major and minor key profiles.
+//
+
+KeyFinder::KeyFinder(void) {
+   double majorKey[12] = {6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52,
+         5.19, 2.39, 3.66, 2.29, 2.88};
+   double minorKey[12] = {6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54,
+         4.75, 3.98, 2.69, 3.34, 3.17};
+   setProfiles(majorKey, minorKey);
+   segmentcount = 0;
+}
+
+
+KeyFinder::KeyFinder(const double* majorKey, const double* minorKey) {
+   setProfiles(majorKey, minorKey);
+   segmentcount = 0;
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::~KeyFinder --
+//
+
+KeyFinder::~KeyFinder() {
+   clearSegments();
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::setProfiles -- Store the mean-centered major and minor
+//     key profiles (12 values each, starting on C).
+//
+
+void KeyFinder::setProfiles(const double* majorKey, const double* minorKey) {
+   int i;
+   double summaj = 0.0;
+   double summin = 0.0;
+   for (i=0; i<12; i++) {
+      summaj += majorKey[i];
+      summin += minorKey[i];
+   }
+   double major_mean = summaj / 12.0;
+   double minor_mean = summin / 12.0;
+
+   majorsquares = 0.0;
+   minorsquares = 0.0;
+   for (i=0; i<12; i++) {
+      major[i] = majorKey[i] - major_mean;
+      minor[i] = minorKey[i] - minor_mean;
+      majorsquares += major[i] * major[i];
+      minorsquares += minor[i] * minor[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::correlate -- Calculate the Pearson correlation of the
+//     pitch-class histogram with each key profile.  scores 0-11 are the
+//     major keys starting on C major, and 12-23 are the minor keys
+//     starting on C minor (scores must have a size of 24 or greater).
+//     Correlations which cannot be calculated (such as for a histogram
+//     with all values equal) are set to 0.0.  Returns the key with
+//     the highest score (the lowest key number in case of a tie).
+//
+//     The inner loops run across the 12 transpositions with no
+//     dependency between iterations so that they can be vectorized
+//     by the compiler, while the summation order for each key is the
+//     same as the direct calculation in ::analyzeKeyKS().
+//
+
+int KeyFinder::correlate(double* scores, const double* histogram) const {
+   int i, j;
+   double sum = 0.0;
+   for (i=0; i<12; i++) {
+      sum += histogram[i];
+   }
+   double mean = sum / 12.0;
+
+   // centered histogram, doubled so that rotations are contiguous:
+   double centered[24];
+   for (i=0; i<12; i++) {
+      centered[i] = histogram[i] - mean;
+      centered[i+12] = centered[i];
+   }
+
+   double majnum[12] = {0.0};
+   double minnum[12] = {0.0};
+   double squares[12] = {0.0};
+   const double* rotation;
+   for (j=0; j<12; j++) {
+      rotation = centered + j;
+      for (i=0; i<12; i++) {
+         majnum[i]  += major[j] * rotation[i];
+         minnum[i]  += minor[j] * rotation[i];
+         squares[i] += rotation[i] * rotation[i];
+      }
+   }
+
+   double denominator;
+   for (i=0; i<12; i++) {
+      denominator = sqrt(majorsquares * squares[i]);
+      scores[i] = denominator <= 0.0 ? 0.0 : majnum[i] / denominator;
+      denominator = sqrt(minorsquares * squares[i]);
+      scores[i+12] = denominator <= 0.0 ? 0.0 : minnum[i] / denominator;
+   }
+
+   int bestkey = 0;
+   for (i=1; i<24; i++) {
+      if (scores[i] > scores[bestkey]) {
+         bestkey = i;
+      }
+   }
+
+   return bestkey;
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::loadSegments -- Divide the duration of the music into
+//     equal-length segments and store the running sums of the
+//     duration-weighted pitch-class histograms of the segments.  Notes
+//     which cross segment boundaries are divided proportionally between
+//     the segments.  The durations are measured in segments (a note
+//     filling a complete segment adds 1.0 to its pitch class).  Grace
+//     notes are ignored.  The onsets in the note table should be in
+//     quarter-note units (HumdrumFile::analyzeRhythm("4")).
+//
+
+void KeyFinder::loadSegments(const HumdrumNoteTable& notes,
+      double totalduration, int segments) {
+   clearSegments();
+   if (segments <= 0) {
+      return;
+   }
+
+   vector<double> histograms(segments * 12, 0.0);
+
+   int i, j;
+   int pitch;
+   double duration;
+   double start;
+   for (i=0; i<notes.getSize(); i++) {
+      pitch = notes.midi[i];
+      if (pitch < 0) {
+         continue;  // ignore strange objects
+      }
+      duration = notes.duration[i].getFloat();
+      if (duration <= 0.0) {
+         continue;  // ignore grace notes and strange objects
+      }
+      start = notes.onset[i].getFloat();
+      addToSegments(histograms, pitch % 12, start, duration,
+            totalduration, segments);
+   }
+
+   segmentcount = segments;
+   runningsum.resize((segments + 1) * 12);
+   for (j=0; j<12; j++) {
+      runningsum[j] = 0.0;
+   }
+   for (i=0; i<segments; i++) {
+      for (j=0; j<12; j++) {
+         runningsum[(i+1)*12+j] = runningsum[i*12+j] + histograms[i*12+j];
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::clearSegments --
+//
+
+void KeyFinder::clearSegments(void) {
+   segmentcount = 0;
+   runningsum.clear();
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::getHistogram -- Fill in the 12 pitch-class histogram for
+//     count segments starting at the given segment.
+//
+
+void KeyFinder::getHistogram(double* histogram, int start, int count) const {
+   int i;
+   if (start < 0) {
+      count += start;
+      start = 0;
+   }
+   if (start + count > segmentcount) {
+      count = segmentcount - start;
+   }
+   if (count <= 0) {
+      for (i=0; i<12; i++) {
+         histogram[i] = 0.0;
+      }
+      return;
+   }
+
+   const double* first = runningsum.data() + start * 12;
+   const double* last  = runningsum.data() + (start + count) * 12;
+   for (i=0; i<12; i++) {
+      histogram[i] = last[i] - first[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// KeyFinder::addToSegments -- Add a note to the segment histograms
+//     (count segments of 12 values each) which the note overlaps.
+//
+
+void KeyFinder::addToSegments(vector<double>& segments, int pc,
+      double start, double dur, double tdur, int count) {
+
+   double startseg = start / tdur * count;
+   double startfrac = startseg - (int)startseg;
+
+   double segdur = dur / tdur * count;
+
+   if (segdur <= 1.0 - startfrac) {
+      segments[(int)startseg * 12 + pc] += segdur;
+      return;
+   } else if (1.0 - startfrac > 0.0) {
+      segments[(int)startseg * 12 + pc] += (1.0 - startfrac);
+      segdur -= (1.0 - startfrac);
+   }
+
+   int i = (int)(startseg + 1);
+   while (segdur > 0.0 && i < count) {
+      if (segdur < 1.0) {
+         segments[i * 12 + pc] += segdur;
+         segdur = 0.0;
+      } else {
+         segments[i * 12 + pc] += 1.0;
+         segdur -= 1.0;
+      }
+      i++;
+   }
+}
+
+
+
@@ -0,0 +1,505 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 22:24:23 PDT 2026
+// Last Modified: Sat Oct 17 22:24:23 PDT 2026
+// Filename:      ...sig/src/sigInfo/MidiFileReader.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/MidiFileReader.cpp
+// Syntax:        C++
+//
+// Description:   Read-only access to the events of a memory-mapped
+//                Standard MIDI File, decoded while iterating.
+//
+
+#include "MidiFileReader.h"
+
+#include <string.h>
+#include <ctype.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#ifndef VISUAL
+   #define USING_MMAP
+#endif
+
+#ifdef USING_MMAP
+   #include <sys/types.h>   /* off_t           */
+   #include <sys/stat.h>    /* fstat           */
+   #include <sys/mman.h>    /* mmap, munmap    */
+   #include <fcntl.h>       /* open            */
+   #include <unistd.h>      /* close           */
+#endif
+
+
+//////////////////////////////
+//
+// _MidiFileTrackCursor::next -- Decode the next event in the track.
+//     Returns false at the end of the track (after the end-of-track
+//     message), or if the track data is invalid.
+//
+
+int _MidiFileTrackCursor::next(MidiFileEvent& event) {
+   if (ptr >= end) {
+      return 0;
+   }
+
+   // delta time (at most four bytes):
+   int delta = 0;
+   int i;
+   for (i=0; i<4; i++) {
+      if (ptr >= end) {
+         return 0;
+      }
+      delta = (delta << 7) | (*ptr & 0x7f);
+      if (*ptr++ < 0x80) {
+         break;
+      }
+   }
+   if ((i == 4) || (ptr >= end)) {
+      ptr = end;
+      return 0;
+   }
+   tick += delta;
+
+   if (*ptr < 0x80) {
+      // running status is not allowed after meta and system exclusive
+      // messages (which also set the running status as in smf::MidiFile).
+      if ((running == 0) || (running >= 0xf0)) {
+         ptr = end;
+         return 0;
+      }
+   } else {
+      running = *ptr++;
+   }
+
+   event.tick    = tick;
+   event.track   = track;
+   event.command = running;
+   event.data    = ptr;
+   event.size    = 0;
+
+   int length;
+   switch (running & 0xf0) {
+      case 0x80:   // note-off
+      case 0x90:   // note-on
+      case 0xa0:   // aftertouch
+      case 0xb0:   // continuous controller
+      case 0xe0:   // pitch bend
+         event.size = 2;
+         break;
+      case 0xc0:   // patch change
+      case 0xd0:   // channel pressure
+         event.size = 1;
+         break;
+      default:
+         if (running == 0xff) {
+            // meta message: type, length (VLV) and data bytes:
+            length = 0;
+            for (i=1; i<5; i++) {
+               if (ptr + i >= end) {
+                  ptr = end;
+                  return 0;
+               }
+               length = (length << 7) | (ptr[i] & 0x7f);
+               if (ptr[i] < 0x80) {
+                  break;
+               }
+            }
+            if (i == 5) {
+               ptr = end;
+               return 0;
+            }
+            event.size = i + 1 + length;
+         } else if ((running == 0xf0) || (running == 0xf7)) {
+            // system exclusive: length (VLV), which is not part of the
+            // message, and data bytes:
+            length = 0;
+            for (i=0; i<4; i++) {
+               if (ptr >= end) {
+                  ptr = end;
+                  return 0;
+               }
+               length = (length << 7) | (*ptr & 0x7f);
+               if (*ptr++ < 0x80) {
+                  break;
+               }
+            }
+            if (i == 4) {
+               ptr = end;
+               return 0;
+            }
+            event.data = ptr;
+            event.size = length;
+         }
+   }
+
+   if ((event.size < 0) || (end - ptr < event.size)) {
+      ptr = end;
+      return 0;
+   }
+   if (running < 0xf0) {
+      for (i=0; i<event.size; i++) {
+         if (ptr[i] > 0x7f) {
+            ptr = end;
+            return 0;
+         }
+      }
+   }
+   ptr += event.size;
+
+   if ((running == 0xff) && (event.data[0] == 0x2f)) {
+      // end-of-track message: ignore anything after it.
+      end = ptr;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::MidiFileReader --
+//
+
+MidiFileReader::MidiFileReader(void) {
+   mapping     = NULL;
+   mappingsize = 0;
+   mappedQ     = 0;
+   validQ      = 0;
+   format      = 0;
+   tpq         = 120;
+   mergeQ      = 0;
+}
+
+
+MidiFileReader::MidiFileReader(const char* filename) {
+   mapping     = NULL;
+   mappingsize = 0;
+   mappedQ     = 0;
+   validQ      = 0;
+   format      = 0;
+   tpq         = 120;
+   mergeQ      = 0;
+   open(filename);
+}
+
+
+MidiFileReader::MidiFileReader(const string& filename) {
+   mapping     = NULL;
+   mappingsize = 0;
+   mappedQ     = 0;
+   validQ      = 0;
+   format      = 0;
+   tpq         = 120;
+   mergeQ      = 0;
+   open(filename.c_str());
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::~MidiFileReader --
+//
+
+MidiFileReader::~MidiFileReader() {
+   close();
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::open -- Map a MIDI file into memory and locate its
+//     tracks.  Returns true if the file is a Standard MIDI File.
+//
+
+int MidiFileReader::open(const string& filename) {
+   return open(filename.c_str());
+}
+
+
+int MidiFileReader::open(const char* filename) {
+   close();
+
+#ifdef USING_MMAP
+   int fd = ::open(filename, O_RDONLY);
+   if (fd < 0) {
+      return 0;
+   }
+   struct stat info;
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode) ||
+         (info.st_size < 14)) {
+      ::close(fd);
+      return 0;
+   }
+   void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE,
+         fd, 0);
+   ::close(fd);
+   if (data == MAP_FAILED) {
+      return 0;
+   }
+   mapping = (const unsigned char*)data;
+   mappingsize = (long)info.st_size;
+   mappedQ = 1;
+   return indexTracks();
+#else
+   ifstream infile(filename, ios::binary | ios::in);
+   if (!infile.is_open()) {
+      return 0;
+   }
+   return read(infile);
+#endif
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::read -- Read a MIDI file from a stream (into memory
+//     owned by the reader).  Returns true if the data is a Standard
+//     MIDI File.
+//
+
+int MidiFileReader::read(istream& input) {
+   close();
+   string contents((istreambuf_iterator<char>(input)),
+         istreambuf_iterator<char>());
+   if (contents.size() < 14) {
+      return 0;
+   }
+   unsigned char* buffer = new unsigned char[contents.size()];
+   memcpy(buffer, contents.data(), contents.size());
+   mapping = buffer;
+   mappingsize = (long)contents.size();
+   mappedQ = 0;
+   return indexTracks();
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::close --
+//
+
+void MidiFileReader::close(void) {
+   releaseMapping();
+   trackstart.clear();
+   trackend.clear();
+   cursors.clear();
+   pending.clear();
+   heap.clear();
+   format = 0;
+   tpq    = 120;
+   mergeQ = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::rewind -- Start iterating through the events of the
+//     given track.  If the track is -1, then iterate through the events
+//     of all tracks in time order.
+//     default value: track = -1
+//
+
+void MidiFileReader::rewind(int track) {
+   cursors.clear();
+   pending.clear();
+   heap.clear();
+   mergeQ = (track < 0);
+
+   int first = mergeQ ? 0 : track;
+   int last  = mergeQ ? getTrackCount() - 1 : track;
+   if (last >= getTrackCount()) {
+      return;
+   }
+   _MidiFileTrackCursor cursor;
+   int i;
+   for (i=first; i<=last; i++) {
+      cursor.ptr     = trackstart[i];
+      cursor.end     = trackend[i];
+      cursor.tick    = 0;
+      cursor.track   = i;
+      cursor.running = 0;
+      cursors.push_back(cursor);
+   }
+   if (!mergeQ) {
+      return;
+   }
+
+   pending.resize(cursors.size());
+   for (i=0; i<(int)cursors.size(); i++) {
+      if (cursors[i].next(pending[i])) {
+         heap.push_back(i);
+      }
+   }
+   make_heap(heap.begin(), heap.end(),
+         [this](int a, int b) { return heapCompare(a, b); });
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::next -- Decode the next event.  Returns false when
+//     there are no more events.
+//
+
+int MidiFileReader::next(MidiFileEvent& event) {
+   if (!mergeQ) {
+      if (cursors.empty()) {
+         return 0;
+      }
+      return cursors[0].next(event);
+   }
+
+   if (heap.empty()) {
+      return 0;
+   }
+   auto compare = [this](int a, int b) { return heapCompare(a, b); };
+   pop_heap(heap.begin(), heap.end(), compare);
+   int index = heap.back();
+   event = pending[index];
+   if (cursors[index].next(pending[index])) {
+      push_heap(heap.begin(), heap.end(), compare);
+   } else {
+      heap.pop_back();
+   }
+   return 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// protected functions
+//
+
+//////////////////////////////
+//
+// MidiFileReader::indexTracks -- Read the header and find the data of
+//     each track chunk.  If the length of a track chunk is wrong (which
+//     is common), the end of the track is found from its end-of-track
+//     message, as smf::MidiFile does.  Returns true if the header is valid.
+//
+
+int MidiFileReader::indexTracks(void) {
+   const unsigned char* p = mapping;
+   long size = mappingsize;
+   if ((size < 14) || (memcmp(p, "MThd", 4) != 0)) {
+      releaseMapping();
+      return 0;
+   }
+   long headersize = ((long)p[4] << 24) | (p[5] << 16) | (p[6] << 8) | p[7];
+   if ((headersize < 6) || (8 + headersize > size)) {
+      releaseMapping();
+      return 0;
+   }
+   format = (p[8] << 8) | p[9];
+   int tracks = (p[10] << 8) | p[11];
+   int division = (p[12] << 8) | p[13];
+   if (division >= 0x8000) {
+      // SMPTE ticks: frames per second * subframes
+      int framespersecond = 255 - ((division >> 8) & 0x00ff) + 1;
+      tpq = framespersecond * (division & 0x00ff);
+   } else {
+      tpq = division;
+   }
+
+   long position = 8 + headersize;
+   long length;
+   long start;
+   long stop;
+   _MidiFileTrackCursor cursor;
+   MidiFileEvent event;
+   int i;
+   for (i=0; i<tracks; i++) {
+      // skip any non-track chunks:
+      while ((position + 8 <= size) && (memcmp(p + position, "MTrk", 4) != 0)
+            && isalpha(p[position]) && isalpha(p[position+1])
+            && isalpha(p[position+2]) && isalpha(p[position+3])) {
+         length = ((long)p[position+4] << 24) | (p[position+5] << 16) |
+               (p[position+6] << 8) | p[position+7];
+         position += 8 + length;
+      }
+      if ((position + 8 > size) || (memcmp(p + position, "MTrk", 4) != 0)) {
+         break;
+      }
+      length = ((long)p[position+4] << 24) | (p[position+5] << 16) |
+            (p[position+6] << 8) | p[position+7];
+      start = position + 8;
+      stop = start + length;
+      if (stop > size) {
+         stop = size;
+      }
+      if ((i < tracks - 1) && ((stop + 4 > size) ||
+            (memcmp(p + stop, "MTrk", 4) != 0))) {
+         // chunk length is wrong, so find the end-of-track message:
+         cursor.ptr     = p + start;
+         cursor.end     = p + size;
+         cursor.tick    = 0;
+         cursor.track   = i;
+         cursor.running = 0;
+         while (cursor.next(event)) {
+            if ((event.command == 0xff) && (event.data[0] == 0x2f)) {
+               break;
+            }
+         }
+         stop = cursor.ptr - p;
+      }
+      trackstart.push_back(p + start);
+      trackend.push_back(p + stop);
+      position = stop;
+   }
+
+   validQ = 1;
+   return validQ;
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::heapCompare -- Order of the pending events of two track
+//     cursors in the (max) heap, so that the earliest event (and then the
+//     lowest track) is at the top.
+//
+
+bool MidiFileReader::heapCompare(int a, int b) const {
+   if (pending[a].tick != pending[b].tick) {
+      return pending[a].tick > pending[b].tick;
+   }
+   return a > b;
+}
+
+
+
+//////////////////////////////
+//
+// MidiFileReader::releaseMapping -- free the contents of the file.
+//
+
+void MidiFileReader::releaseMapping(void) {
+   if (mapping != NULL) {
+      #ifdef USING_MMAP
+         if (mappedQ) {
+            munmap((void*)mapping, (size_t)mappingsize);
+         } else {
+            delete [] mapping;
+         }
+      #else
+         delete [] mapping;
+      #endif
+   }
+   mapping     = NULL;
+   mappingsize = 0;
+   mappedQ     = 0;
+   validQ      = 0;
+}
+
+
+
@@ -0,0 +1,768 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 20:14:50 PDT 2026
+// Last Modified: Sat Oct 17 20:24:34 PDT 2026 added JIT compiling
+// Filename:      ...sig/src/sigInfo/MultiPatternMatcher.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/MultiPatternMatcher.cpp
+// Syntax:        C++
+//
+// Description:   Search a string for several regular expressions at once,
+//                using an Aho-Corasick automaton of the literal text in
+//                the patterns to avoid running the regular expressions
+//                which cannot match.
+//
+
+#include "MultiPatternMatcher.h"
+#include "PerlRegularExpression.h"
+
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#include <algorithm>
+
+// pattern kinds:
+#define MPM_REGEX   0     /* check with the regular expression library */
+#define MPM_TEXT    1     /* plain text anywhere in the string */
+#define MPM_PREFIX  2     /* plain text at the start of the string */
+#define MPM_SUFFIX  3     /* plain text at the end of the string */
+#define MPM_EXACT   4     /* plain text which is the entire string */
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::MultiPatternMatcher --
+//
+
+MultiPatternMatcher::MultiPatternMatcher(void) {
+   syntax = MPM_SYNTAX_PCRE;
+   icaseQ = 0;
+   jitQ   = PerlRegularExpression::getJitDefault();
+   builtQ = 0;
+   stamp  = 0;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::~MultiPatternMatcher --
+//
+
+MultiPatternMatcher::~MultiPatternMatcher() {
+   clear();
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::clear -- Remove all patterns.  The syntax and
+//     case settings are not changed.
+//
+
+void MultiPatternMatcher::clear(void) {
+   int i;
+   for (i=0; i<(int)pcres.size(); i++) {
+      if (studies[i] != NULL) {
+         pcre_free_study(studies[i]);
+      }
+      if (pcres[i] != NULL) {
+         pcre_free(pcres[i]);
+      }
+      if (posixes[i] != NULL) {
+         regfree(posixes[i]);
+         delete posixes[i];
+      }
+   }
+   patterns.clear();
+   kinds.clear();
+   texts.clear();
+   required.clear();
+   pcres.clear();
+   studies.clear();
+   posixes.clear();
+   matches.clear();
+
+   literals.clear();
+   transitions.clear();
+   outputs.clear();
+   found.clear();
+   stamp = 0;
+   builtQ = 0;
+   error.clear();
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::setSyntax -- MPM_SYNTAX_PCRE (default),
+//     MPM_SYNTAX_EXTENDED or MPM_SYNTAX_BASIC.  Should be set before
+//     adding patterns.
+//
+
+void MultiPatternMatcher::setSyntax(int aSyntax) {
+   syntax = aSyntax;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::setIgnoreCase -- Should be set before adding
+//     patterns, since it applies to all of the literal text in the
+//     automaton.  Case is ignored for ASCII letters.
+//     default value: state = 1
+//
+
+void MultiPatternMatcher::setIgnoreCase(int state) {
+   icaseQ = state;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::setJit -- JIT compile PCRE patterns which are 
+//     added afterwards (see PerlRegularExpression::setJit()).  The 
+//     initial state is PerlRegularExpression::getJitDefault().
+//     default value: state = 1
+//
+
+void MultiPatternMatcher::setJit(int state) {
+   jitQ = state;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::addPattern -- Returns the index of the pattern,
+//     or -1 if the pattern is not a valid regular expression (the reason
+//     is given by getError()).
+//
+
+int MultiPatternMatcher::addPattern(const string& pattern) {
+   error.clear();
+   int index = (int)patterns.size();
+   patterns.push_back(pattern);
+   kinds.push_back(MPM_REGEX);
+   texts.push_back("");
+   required.resize(index+1);
+   pcres.push_back(NULL);
+   studies.push_back(NULL);
+   posixes.push_back(NULL);
+   matches.push_back(0);
+   builtQ = 0;
+
+   int i;
+   if (isPlainText(pattern, syntax)) {
+      string text = pattern;
+      int kind = MPM_TEXT;
+      if ((text.size() > 0) && (text[0] == '^')) {
+         text.erase(0, 1);
+         kind = MPM_PREFIX;
+      }
+      if ((text.size() > 0) && (text[text.size()-1] == '$')) {
+         text.resize(text.size()-1);
+         kind = kind == MPM_PREFIX ? MPM_EXACT : MPM_SUFFIX;
+      }
+      kinds[index] = kind;
+      texts[index] = text;
+      if ((kind == MPM_TEXT) && (text.size() > 0)) {
+         required[index].push_back(addLiteral(text));
+      }
+      return index;
+   }
+
+   if (!compilePattern(pattern)) {
+      patterns.pop_back();
+      kinds.pop_back();
+      texts.pop_back();
+      required.pop_back();
+      pcres.pop_back();
+      studies.pop_back();
+      posixes.pop_back();
+      matches.pop_back();
+      return -1;
+   }
+
+   vector<string> strings;
+   getRegexLiterals(strings, pattern, syntax);
+   for (i=0; i<(int)strings.size(); i++) {
+      required[index].push_back(addLiteral(strings[i]));
+   }
+   return index;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::getPatternCount --
+//
+
+int MultiPatternMatcher::getPatternCount(void) const {
+   return (int)patterns.size();
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::getPattern --
+//
+
+const string& MultiPatternMatcher::getPattern(int index) const {
+   return patterns[index];
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::search -- Check all patterns against the text.
+//     Returns the number of patterns which match.  The results for each
+//     pattern are given by isMatch() until the next search.
+//
+
+int MultiPatternMatcher::search(const string& text) {
+   return search(text.c_str());
+}
+
+
+int MultiPatternMatcher::search(const char* text) {
+   if (!builtQ) {
+      build();
+   }
+   int length = (int)strlen(text);
+   int i, j;
+
+   if (!literals.empty()) {
+      stamp++;
+      if (stamp == 0) {
+         std::fill(found.begin(), found.end(), 0);
+         stamp = 1;
+      }
+      const int* next = transitions.data();
+      const unsigned char* ptr = (const unsigned char*)text;
+      int state = 0;
+      for (i=0; i<length; i++) {
+         state = next[(state << 8) | ptr[i]];
+         if (!outputs[state].empty()) {
+            for (j=0; j<(int)outputs[state].size(); j++) {
+               found[outputs[state][j]] = stamp;
+            }
+         }
+      }
+   }
+
+   int count = 0;
+   int candidateQ;
+   for (i=0; i<(int)patterns.size(); i++) {
+      candidateQ = 1;
+      for (j=0; j<(int)required[i].size(); j++) {
+         if (found[required[i][j]] != stamp) {
+            candidateQ = 0;
+            break;
+         }
+      }
+      if (!candidateQ) {
+         matches[i] = 0;
+      } else if (kinds[i] == MPM_TEXT) {
+         matches[i] = 1;
+      } else if (kinds[i] == MPM_REGEX) {
+         matches[i] = checkRegex(i, text, length);
+      } else {
+         matches[i] = checkText(i, text, length);
+      }
+      count += matches[i];
+   }
+
+   return count;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::isMatch -- Returns true if the given pattern
+//     matched the text of the last search.
+//
+
+int MultiPatternMatcher::isMatch(int index) const {
+   return matches[index];
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::getRegexLiterals -- extract strings of characters
+//    which must occur (in order and without anything between them) in
+//    any match of a regular expression.  If the expression contains
+//    alternation or other constructs which are not understood, no
+//    literals are given.  The literals are a necessary but not sufficient
+//    condition for a match.
+//    default value: syntax = MPM_SYNTAX_PCRE
+//
+
+void MultiPatternMatcher::getRegexLiterals(vector<string>& literals,
+      const string& regex, int syntax) {
+   literals.clear();
+   if (regex.find('|') != string::npos) {
+      return;
+   }
+   if (regex.find("(*") != string::npos) {
+      // PCRE start-of-pattern options such as (*UTF8)
+      return;
+   }
+   if ((syntax == MPM_SYNTAX_BASIC) &&
+         (regex.find_first_of("\\()") != string::npos)) {
+      // Parentheses are literal characters, and escaped characters are
+      // the operators in basic syntax.
+      return;
+   }
+
+   string current;
+   int literalQ;
+   char ch;
+   int next;
+   int i = 0;
+   while (i < (int)regex.size()) {
+      ch = regex[i];
+      if (ch == '(') {
+         int end = findRegexGroupEnd(regex, i, syntax);
+         if (end < 0) {
+            literals.clear();
+            return;
+         }
+         next = skipRegexQuantifier(regex, end+1);
+         if (next == end+1) {
+            // A group which is not repeated matches its contents in sequence.
+            if ((i+1 < (int)regex.size()) && (regex[i+1] == '?')) {
+               if ((i+2 < (int)regex.size()) && (regex[i+2] == ':')) {
+                  i += 3;
+                  continue;
+               }
+               literals.clear();
+               return;
+            }
+            i++;
+            continue;
+         }
+         i = next;
+      } else if (ch == ')') {
+         i++;
+         continue;
+      } else if (ch == '[') {
+         i = skipRegexQuantifier(regex, skipRegexClass(regex, i, syntax));
+      } else {
+         if (ch == '\\') {
+            if (i+1 >= (int)regex.size()) {
+               break;
+            }
+            ch = regex[i+1];
+            if (strchr("xcpPgkoNQ0123456789", ch) != NULL) {
+               // escapes with arguments (character codes, properties,
+               // back-references or quoted text)
+               literals.clear();
+               return;
+            }
+            literalQ = !isalnum((unsigned char)ch);
+            if ((syntax != MPM_SYNTAX_PCRE) && (strchr("<>`'", ch) != NULL)) {
+               // GNU word and buffer boundaries
+               literalQ = 0;
+            }
+            i += 2;
+         } else {
+            literalQ = (strchr(".^$?*+{", ch) == NULL);
+            i++;
+         }
+         next = skipRegexQuantifier(regex, i);
+         if ((next == i) && literalQ) {
+            current += ch;
+            continue;
+         }
+         // A repeated character is not adjacent to the following text,
+         // and it is optional if the quantifier can be zero.
+         if (literalQ && (regex[i] != '?') && (regex[i] != '*') &&
+               ((regex[i] != '{') || (regex[i+1] != '0'))) {
+            current += ch;
+         }
+         i = next;
+      }
+      if (!current.empty()) {
+         literals.push_back(current);
+         current.clear();
+      }
+   }
+   if (!current.empty()) {
+      literals.push_back(current);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::build -- Create the automaton for the literals
+//     of the patterns.  Each state has a transition for every byte value,
+//     including the transitions of the failure links, so that searching
+//     only needs one table lookup per character.
+//
+
+void MultiPatternMatcher::build(void) {
+   transitions.assign(256, 0);
+   outputs.assign(1, vector<int>());
+   found.assign(literals.size(), 0);
+   stamp = 0;
+
+   int i, j;
+   int state;
+   int target;
+   unsigned char ch;
+   for (i=0; i<(int)literals.size(); i++) {
+      state = 0;
+      for (j=0; j<(int)literals[i].size(); j++) {
+         ch = (unsigned char)literals[i][j];
+         target = transitions[(state << 8) | ch];
+         if (target == 0) {
+            target = (int)outputs.size();
+            outputs.resize(target + 1);
+            transitions.resize((target + 1) * 256, 0);
+            transitions[(state << 8) | ch] = target;
+         }
+         state = target;
+      }
+      outputs[state].push_back(i);
+   }
+
+   // breadth-first calculation of failure links:
+   vector<int> fail(outputs.size(), 0);
+   vector<int> queue;
+   queue.reserve(outputs.size());
+   int c;
+   for (c=0; c<256; c++) {
+      if (transitions[c] != 0) {
+         queue.push_back(transitions[c]);
+      }
+   }
+   for (i=0; i<(int)queue.size(); i++) {
+      state = queue[i];
+      for (c=0; c<256; c++) {
+         target = transitions[(state << 8) | c];
+         if (target != 0) {
+            fail[target] = transitions[(fail[state] << 8) | c];
+            outputs[target].insert(outputs[target].end(),
+                  outputs[fail[target]].begin(), outputs[fail[target]].end());
+            queue.push_back(target);
+         } else {
+            transitions[(state << 8) | c] = transitions[(fail[state] << 8) | c];
+         }
+      }
+   }
+
+   if (icaseQ) {
+      // the literals are stored in lower case
+      for (state=0; state<(int)outputs.size(); state++) {
+         for (c='A'; c<='Z'; c++) {
+            transitions[(state << 8) | c] =
+                  transitions[(state << 8) | tolower(c)];
+         }
+      }
+   }
+
+   builtQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::addLiteral -- Returns the index of the literal in
+//     the automaton list.
+//
+
+int MultiPatternMatcher::addLiteral(const string& literal) {
+   string text = literal;
+   if (icaseQ) {
+      foldCase(text);
+   }
+   int i;
+   for (i=0; i<(int)literals.size(); i++) {
+      if (literals[i] == text) {
+         return i;
+      }
+   }
+   literals.push_back(text);
+   builtQ = 0;
+   return (int)literals.size() - 1;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::compilePattern -- Compile the last pattern in the
+//     list.  Returns 0 if there is an error.
+//
+
+int MultiPatternMatcher::compilePattern(const string& pattern) {
+   int index = (int)patterns.size() - 1;
+   if (syntax == MPM_SYNTAX_PCRE) {
+      const char* message = NULL;
+      int offset = 0;
+      pcres[index] = pcre_compile(pattern.c_str(),
+            icaseQ ? PCRE_CASELESS : 0, &message, &offset, NULL);
+      if (pcres[index] == NULL) {
+         error = message == NULL ? "invalid regular expression" : message;
+         return 0;
+      }
+      studies[index] = PerlRegularExpression::studyPattern(pcres[index],
+            jitQ, &message);
+      return 1;
+   }
+
+   int flags = REG_NOSUB;
+   if (syntax == MPM_SYNTAX_EXTENDED) {
+      flags |= REG_EXTENDED;
+   }
+   if (icaseQ) {
+      flags |= REG_ICASE;
+   }
+   posixes[index] = new regex_t;
+   int status = regcomp(posixes[index], pattern.c_str(), flags);
+   if (status != 0) {
+      char buffer[1024] = {0};
+      regerror(status, posixes[index], buffer, 1000);
+      error = buffer;
+      delete posixes[index];
+      posixes[index] = NULL;
+      return 0;
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::checkText -- Match an anchored plain text pattern.
+//
+
+int MultiPatternMatcher::checkText(int index, const char* text,
+      int length) const {
+   const string& pattern = texts[index];
+   int size = (int)pattern.size();
+   int count = 1;
+   if ((syntax == MPM_SYNTAX_PCRE) && (kinds[index] != MPM_PREFIX) &&
+         (length > 0) && (text[length-1] == '\n')) {
+      // PCRE's $ also matches before a newline at the end of the text.
+      count = 2;
+   }
+   const char* start;
+   int i;
+   for (i=0; i<count; i++, length--) {
+      if (length < size) {
+         return 0;
+      }
+      if ((kinds[index] == MPM_EXACT) && (length != size)) {
+         continue;
+      }
+      start = kinds[index] == MPM_SUFFIX ? text + length - size : text;
+      if (icaseQ) {
+         if (strncasecmp(start, pattern.c_str(), size) == 0) {
+            return 1;
+         }
+      } else if (strncmp(start, pattern.c_str(), size) == 0) {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::checkRegex -- Match a regular expression pattern.
+//
+
+int MultiPatternMatcher::checkRegex(int index, const char* text,
+      int length) const {
+   if (pcres[index] != NULL) {
+      int ovector[30];
+      return pcre_exec(pcres[index], studies[index], text, length, 0, 0,
+            ovector, 30) >= 0;
+   }
+   return regexec(posixes[index], text, 0, NULL, 0) == 0;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::foldCase -- convert ASCII letters to lower case.
+//
+
+void MultiPatternMatcher::foldCase(string& text) {
+   int i;
+   for (i=0; i<(int)text.size(); i++) {
+      text[i] = (char)tolower((unsigned char)text[i]);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::isPlainText -- Returns true if the pattern only
+//     contains literal characters, other than a ^ at the start or a $ at
+//     the end.
+//
+
+int MultiPatternMatcher::isPlainText(const string& text, int syntax) {
+   const char* special = syntax == MPM_SYNTAX_BASIC ? "\\^$.[*" :
+         "\\^$.[]|()?*+{}";
+   int start = 0;
+   int end = (int)text.size();
+   if ((end > 0) && (text[0] == '^')) {
+      start++;
+   }
+   if ((end > start) && (text[end-1] == '$')) {
+      end--;
+   }
+   int i;
+   for (i=start; i<end; i++) {
+      if (strchr(special, text[i]) != NULL) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::findRegexGroupEnd -- return the index of the
+//    parenthesis which closes the group starting at the given index, or
+//    -1 if not closed.
+//
+
+int MultiPatternMatcher::findRegexGroupEnd(const string& regex, int index,
+      int syntax) {
+   int depth = 0;
+   int i = index;
+   while (i < (int)regex.size()) {
+      switch (regex[i]) {
+         case '\\':
+            i += 2;
+            continue;
+         case '[':
+            i = skipRegexClass(regex, i, syntax);
+            continue;
+         case '(':
+            depth++;
+            break;
+         case ')':
+            depth--;
+            if (depth == 0) {
+               return i;
+            }
+            break;
+      }
+      i++;
+   }
+   return -1;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::skipRegexClass -- return the index after the
+//    character class which starts at the given index.  Backslashes only
+//    escape characters inside of PCRE classes.
+//
+
+int MultiPatternMatcher::skipRegexClass(const string& regex, int index,
+      int syntax) {
+   int size = (int)regex.size();
+   int i = index + 1;
+   if ((i < size) && (regex[i] == '^')) {
+      i++;
+   }
+   if ((i < size) && (regex[i] == ']')) {
+      i++;
+   }
+   size_t end;
+   while ((i < size) && (regex[i] != ']')) {
+      if ((regex[i] == '[') && (i+1 < size) &&
+            (strchr(":=.", regex[i+1]) != NULL)) {
+         // [:alpha:], [=a=] or [.a.]
+         end = regex.find(string(1, regex[i+1]) + "]", i+2);
+         if (end == string::npos) {
+            return size;
+         }
+         i = (int)end + 2;
+         continue;
+      }
+      if ((regex[i] == '\\') && (syntax == MPM_SYNTAX_PCRE)) {
+         i++;
+      }
+      i++;
+   }
+   return i + 1;
+}
+
+
+
+//////////////////////////////
+//
+// MultiPatternMatcher::skipRegexQuantifier -- return the index after a
+//    quantifier starting at the given index in a regular expression, or
+//    the given index if there is no quantifier there.
+//
+
+int MultiPatternMatcher::skipRegexQuantifier(const string& regex, int index) {
+   int size = (int)regex.size();
+   if (index >= size) {
+      return index;
+   }
+   int i = index;
+   if ((regex[i] == '?') || (regex[i] == '*') || (regex[i] == '+')) {
+      i++;
+   } else if (regex[i] == '{') {
+      // {n}, {n,} or {n,m}; otherwise "{" is a literal character.
+      int j = i + 1;
+      while ((j < size) && isdigit((unsigned char)regex[j])) {
+         j++;
+      }
+      if (j == i + 1) {
+         return index;
+      }
+      if ((j < size) && (regex[j] == ',')) {
+         j++;
+         while ((j < size) && isdigit((unsigned char)regex[j])) {
+            j++;
+         }
+      }
+      if ((j >= size) || (regex[j] != '}')) {
+         return index;
+      }
+      i = j + 1;
+   } else {
+      return index;
+   }
+   // lazy or possessive quantifier
+   if ((i < size) && ((regex[i] == '?') || (regex[i] == '+'))) {
+      i++;
+   }
+   return i;
+}
+
+
+
@@ -21,6 +21,8 @@
 // Last Modified: Tue Jun 19 14:03:03 PDT 2012 added printing of text
 // Last Modified: Wed Jun 20 15:43:34 PDT 2012 various updates/enhancements
 // Last Modified: Mon Aug 19 20:30:28 PDT 2013 handle multi-syllable lyric
+// Last Modified: Sat Oct 17 23:26:16 PDT 2026 read input with expat (SAX)
+// Last Modified: Sat Oct 17 23:26:16 PDT 2026 read() returns 0 on errors
 //
 // Filename:      ...sig/include/sigInfo/MusicXmlFile.h
 // Web Address:   http://sig.sapp.org/include/sigInfo/MusicXmlFile.h
@@ -73,6 +75,7 @@
 #include <cctype>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 using namespace CSL::XML;
 
@@ -120,6 +123,13 @@ MusicXmlFile::MusicXmlFile(void) {
    setOption("lyric",   1);
    setOption("renumber",1);
    lastchordhead = NULL;
+   parsecontainer  = NULL;
+   parsecdataQ     = 0;
+   parseretain     = 0;
+   parsepartcount  = 0;
+   parsepartnum    = -1;
+   parsepartstartQ = 0;
+   parseticktime   = 0;
 }
 
 
@@ -150,6 +160,13 @@ MusicXmlFile::MusicXmlFile(const char* aFile) {
    setOption("lyric",   1);
    setOption("renumber",1);
    lastchordhead = NULL;
+   parsecontainer  = NULL;
+   parsecdataQ     = 0;
+   parseretain     = 0;
+   parsepartcount  = 0;
+   parsepartnum    = -1;
+   parsepartstartQ = 0;
+   parseticktime   = 0;
 
    read(aFile);
 }
@@ -493,8 +510,15 @@ char* MusicXmlFile::getPartId(char* buffer, int partnum) {
 //
 
 ostream& MusicXmlFile::print(ostream& out) {
-   CXMLObject* entry = xmldocument;
-   printTraverse(out, entry);
+   // Only the elements needed for conversion to Humdrum data are kept
+   // when reading, so re-read the complete file for printing.
+   if (filename.getSize() > 0) {
+      CXMLFactory         factory;
+      CXMLDocumentBuilder builder;
+      CXMLDocument* document = factory.CreateDocument("MusicXML Document");
+      builder.BuildDocument(filename.getBase(), document, &factory);
+      printTraverse(out, document);
+   }
    out << "\n";
    return out;
 }
@@ -720,17 +744,64 @@ ostream& MusicXmlFile::printCharacterData(ostream& out,
 
 //////////////////////////////
 //
-// MusicXmlFile::read --
+// MusicXmlFile::read -- read a MusicXML file with the expat parser.
+//    Each <measure> is converted into part data as soon as its end
+//    tag is read (see MusicXmlFile::endElement()).  The measure elements
+//    are kept, since the part data refers to them, so the memory used
+//    still grows with the length of the score; only the elements outside
+//    of the part list and the measures are discarded while reading.
+//    Returns 0 (after printing a message) if the file cannot be opened
+//    or is not well-formed XML, otherwise returns 1.
 //
 
-void MusicXmlFile::read(const char* aFile) {
-   CXMLFactory         factory;
-   CXMLDocumentBuilder builder;
-
-   xmldocument = factory.CreateDocument("MusicXML Document");
-   builder.BuildDocument(aFile, xmldocument, &factory);
+int MusicXmlFile::read(const char* aFile) {
+   FILE* input = fopen(aFile, "rb");
+   if (input == NULL) {
+      cerr << "Error: cannot open file: " << aFile << endl;
+      return 0;
+   }
+   filename.setSize(strlen(aFile)+1);
+   strcpy(filename.getBase(), aFile);
+
+   xmldocument     = xmlfactory.CreateDocument("MusicXML Document");
+   parsecontainer  = xmldocument;
+   parsecdataQ     = 0;
+   parseretain     = 0;
+   parsepartcount  = 0;
+   parsepartnum    = -1;
+   parsepartstartQ = 0;
+   parseticktime   = 0;
+   parseserialnum  = 1;
+   lastchordhead   = NULL;
+   parsetext.clear();
+
+   XML_Parser parser = XML_ParserCreate(NULL);
+   XML_SetUserData(parser, this);
+   XML_SetElementHandler(parser, startElementHandler, endElementHandler);
+   XML_SetCharacterDataHandler(parser, characterDataHandler);
+   XML_SetCdataSectionHandler(parser, startCdataHandler, endCdataHandler);
+
+   char buffer[32768];
+   int length;
+   int doneQ = 0;
+   while (!doneQ) {
+      length = fread(buffer, 1, sizeof(buffer), input);
+      doneQ = length < (int)sizeof(buffer);
+      if (!XML_Parse(parser, buffer, length, doneQ)) {
+         cerr << "Error: " << XML_ErrorString(XML_GetErrorCode(parser))
+              << " on line " << XML_GetCurrentLineNumber(parser)
+              << " of file: " << aFile << endl;
+         XML_ParserFree(parser);
+         fclose(input);
+         parsecontainer = NULL;
+         return 0;
+      }
+   }
+   XML_ParserFree(parser);
+   fclose(input);
+   parsecontainer = NULL;
 
-   parse();
+   fixPickupBarline();
 
    int i;
    for (i=0; i<getStaffCount(); i++) {
@@ -747,38 +818,205 @@ void MusicXmlFile::read(const char* aFile) {
          }
       }
    }
+
+   return 1;
 }
 
 
 
 //////////////////////////////
 //
-// operator<< -- directions for printing a MusicXmlFile object.
+// MusicXmlFile::startElementHandler -- expat callback for a start tag.
 //
 
-ostream& operator<<(ostream& out, MusicXmlFile& aMusicXmlFile) {
-   aMusicXmlFile.print(out);
-   return out;
+void MusicXmlFile::startElementHandler(void* userdata, const XML_Char* name,
+      const XML_Char** atts) {
+   ((MusicXmlFile*)userdata)->startElement(name, atts);
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::endElementHandler -- expat callback for an end tag.
+//
+
+void MusicXmlFile::endElementHandler(void* userdata, const XML_Char* name) {
+   ((MusicXmlFile*)userdata)->endElement(name);
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::characterDataHandler -- expat callback for text.  The
+//    text may arrive in several pieces, so it is collected until the
+//    next tag.
+//
+
+void MusicXmlFile::characterDataHandler(void* userdata,
+      const XML_Char* text, int length) {
+   ((MusicXmlFile*)userdata)->parsetext.append(text, length);
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::startCdataHandler -- expat callback for the start of
+//     a CDATA section.
+//
+
+void MusicXmlFile::startCdataHandler(void* userdata) {
+   MusicXmlFile& xmlfile = *((MusicXmlFile*)userdata);
+   xmlfile.storeCharacterData(0);
+   xmlfile.parsecdataQ = 1;
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::endCdataHandler -- expat callback for the end of
+//     a CDATA section.
+//
+
+void MusicXmlFile::endCdataHandler(void* userdata) {
+   MusicXmlFile& xmlfile = *((MusicXmlFile*)userdata);
+   xmlfile.storeCharacterData(0);
+   xmlfile.parsecdataQ = 0;
 }
 
 
 
 //////////////////////////////
 //
-// MusicXmlFile::parse --
+// MusicXmlFile::startElement -- add a new element to the currently
+//     open element.
 //
 
-void MusicXmlFile::parse(void) {
-   if (xmldocument == NULL) {
-      cout << "XMLDocument is null" << endl;
+void MusicXmlFile::startElement(const char* name, const char** atts) {
+   storeCharacterData(1);
+
+   CXMLElement* element = xmlfactory.CreateElement(name);
+   int i;
+   for (i=0; atts[i] != NULL; i+=2) {
+      element->GetAttributes().SetAttribute(
+            xmlfactory.CreateAttribute(atts[i], "CDATA", atts[i+1]));
+   }
+   parsecontainer->InsertChild(element);
+   parsecontainer = element;
+
+   if ((strcmp(name, "part-list") == 0) || (strcmp(name, "score-part") == 0)
+         || (strcmp(name, "measure") == 0)) {
+      parseretain++;
+   } else if (strcmp(name, "part") == 0) {
+      parsepartstartQ = 0;
+      parsepartnum    = -1;
+      parseticktime   = 0;
+      lastchordhead   = NULL;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::endElement -- close the current element.  A completed
+//     <measure> in a <part> is converted into part data.  Elements
+//     outside of the part list and the measures are not needed for
+//     the conversion, so they are deleted.
+//
+
+void MusicXmlFile::endElement(const char* name) {
+   storeCharacterData(0);
+
+   CXMLElement* element = (CXMLElement*)parsecontainer;
+   parsecontainer = (CXMLContainer*)element->GetParent();
+
+   if (strcmp(name, "score-part") == 0) {
+      parseScorePart(element);
+   } else if (strcmp(name, "measure") == 0) {
+      if ((parsecontainer->GetType() == xmlElement) &&
+            (((CXMLElement*)parsecontainer)->GetName() == "part")) {
+         if (!parsepartstartQ) {
+            // the staff count of a part is given in its first measure
+            parsepartnum = parsePart(parsecontainer);
+            parsepartstartQ = 1;
+         }
+         if (parsepartnum >= 0) {
+            parsePartMeasure(element, parsepartnum);
+         }
+      }
+   } else if (strcmp(name, "part") == 0) {
+      if (!parsepartstartQ) {
+         parsePart(element);
+      }
+      parsepartstartQ = 0;
+   }
+
+   if ((strcmp(name, "part-list") == 0) || (strcmp(name, "score-part") == 0)
+         || (strcmp(name, "measure") == 0)) {
+      parseretain--;
+   } else if ((parseretain == 0) && (strcmp(name, "part") != 0) &&
+         (parsecontainer != xmldocument)) {
+      parsecontainer->RemoveChild(element);
+      delete element;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::storeCharacterData -- add the text read since the last
+//     tag to the currently open element.  Whitespace between elements
+//     is not stored.
+//        elementQ: true if the text is followed by the start of an element.
+//
+
+void MusicXmlFile::storeCharacterData(int elementQ) {
+   if (parsetext.empty()) {
+      return;
+   }
+   if (parseretain <= 0) {
+      parsetext.clear();
       return;
    }
 
-   parseserialnum = 1;
-   lastchordhead  = NULL;
+   if (parsecdataQ) {
+      parsecontainer->InsertChild(xmlfactory.CreateCDATASection(parsetext));
+      parsetext.clear();
+      return;
+   }
 
-   traverse(xmldocument);
-   fixPickupBarline();
+   if (elementQ || (parsecontainer->Zoom() != NULL)) {
+      int i;
+      for (i=0; i<(int)parsetext.size(); i++) {
+         if (!std::isspace(parsetext[i])) {
+            break;
+         }
+      }
+      if (i >= (int)parsetext.size()) {
+         parsetext.clear();
+         return;
+      }
+   }
+
+   parsecontainer->InsertChild(xmlfactory.CreateCharacterData(parsetext));
+   parsetext.clear();
+}
+
+
+
+//////////////////////////////
+//
+// operator<< -- directions for printing a MusicXmlFile object.
+//
+
+ostream& operator<<(ostream& out, MusicXmlFile& aMusicXmlFile) {
+   aMusicXmlFile.print(out);
+   return out;
 }
 
 
@@ -981,64 +1219,6 @@ int MusicXmlFile::getTimeSignatureTicks(CXMLObject* obj, int tickinfo) {
 
 
 
-//////////////////////////////
-//
-// MusicXmlFile::traverse --
-//
-
-void MusicXmlFile::traverse(CXMLObject* entry) {
-   while (entry != NULL) {
-      lastchordhead = NULL;
-      process(entry);
-      entry = entry->GetNext();
-   }
-}
-
-
-//////////////////////////////
-//
-// MusicXmlFile::process --
-//
-
-void MusicXmlFile::process(CXMLObject* entry) {
-   int zoomQ = 1;
-   switch (entry->GetType()) {
-      case xmlObject:
-         break;
-      case xmlContainer:
-         break;
-      case xmlAttribute:
-         break;
-      case xmlElement:
-         zoomQ = parseElement(entry);
-         break;
-      case xmlCharacterData:
-         break;
-      case xmlCDATASection:
-         break;
-      case xmlComment:
-         break;
-      case xmlGenericData:
-         break;
-      case xmlProcessingInstruction:
-         break;
-      case xmlExternalEntity:
-         break;
-      case xmlNotationDeclaration:
-         break;
-      case xmlUnparsedEntityDeclaration:
-         break;
-      case xmlDocument:
-         break;
-   }
-
-   if (zoomQ) {
-      traverse(entry->Zoom());
-   }
-}
-
-
-
 //////////////////////////////
 //
 // MusicXmlFile::addStaffData --
@@ -1127,69 +1307,74 @@ int MusicXmlFile::getStaffCountFromPart(CXMLObject* object) {
 
 //////////////////////////////
 //
-// parseElement --
+// MusicXmlFile::parseScorePart -- add a <score-part> from the
+//     <part-list> to the list of parts.
+//
+
+void MusicXmlFile::parseScorePart(CXMLObject* entry) {
+   int tval = 1;
+
+   parts.append(entry);
+   partstaves.append(tval);
+
+   if (partstaves.getSize() <= 1) {
+      tval = partstaves.getSize()-1;
+      partoffset.append(tval);
+   } else {
+      tval = partstaves[partstaves.getSize()-1-1] +
+             partoffset[partoffset.getSize()-1];
+      partoffset.append(tval);
+   }
+   addStaffData();
+}
+
+
+
+//////////////////////////////
+//
+// MusicXmlFile::parsePart -- set up the staves and instrument name
+//     of a <part> before its measures are parsed.  Returns the part
+//     number of the part, or -1 if the part is not listed in the
+//     <part-list>.
 //
 
-int MusicXmlFile::parseElement(CXMLObject* entry) {
+int MusicXmlFile::parsePart(CXMLObject* entry) {
    CXMLElement* element = (CXMLElement*)entry;
    char buffer[1024] = {0};
    int i;
    int ii;
+   int jj;
    XMLString idname;
    int partnum = -1;
-   int tval = 1;
-   int staves = 0;
-   int static partcount = 0;
-   int jj;
-
-   if (element->GetName() == "score-part") {
-      parts.append(entry);
-      tval = 1;
-      partstaves.append(tval);
-
-      if (partstaves.getSize() <= 1) {
-         tval = partstaves.getSize()-1;
-         partoffset.append(tval);
-      } else {
-         tval = partstaves[partstaves.getSize()-1-1] +
-                partoffset[partoffset.getSize()-1];
-         partoffset.append(tval);
-      }
-      addStaffData();
-   } else if (element->GetName() == "part") {
-      staves = getStaffCountFromPart(element);
-      if (staves > 1) {
-         for (ii=0; ii<staves-1; ii++) {
-            addStaffData();
-            partstaves[partcount]++;
-            for (jj=partcount+1; jj<partoffset.getSize(); jj++) {
-               partoffset[jj]++;
-            }
-            // printArray("partstaves contents: ", partstaves);
-            // printArray("partoffset contents: ", partoffset);
-
+   int staves = getStaffCountFromPart(element);
+
+   if (staves > 1) {
+      for (ii=0; ii<staves-1; ii++) {
+         addStaffData();
+         partstaves[parsepartcount]++;
+         for (jj=parsepartcount+1; jj<partoffset.getSize(); jj++) {
+            partoffset[jj]++;
          }
+         // printArray("partstaves contents: ", partstaves);
+         // printArray("partoffset contents: ", partoffset);
       }
-      partcount++;
+   }
+   parsepartcount++;
 
-      for (i=0; i<element->GetAttributes().GetLength(); i++) {
-         if (element->GetAttributes().GetName(i) == "id") {
-            idname = element->GetAttributes().GetValue(i);
-            strncpy(buffer, idname.c_str(), 512);
-            partnum = getPartNumberFromId(buffer);
-            if (partnum < 0) {
-               return 1;
-            }
-            getInstrumentName(element, partnum, idname);
-            parsePart(element->Zoom(), partnum);
-            return 0;
-            break;
+   for (i=0; i<element->GetAttributes().GetLength(); i++) {
+      if (element->GetAttributes().GetName(i) == "id") {
+         idname = element->GetAttributes().GetValue(i);
+         strncpy(buffer, idname.c_str(), 512);
+         partnum = getPartNumberFromId(buffer);
+         if (partnum < 0) {
+            return -1;
          }
-
+         getInstrumentName(element, partnum, idname);
+         return partnum;
       }
    }
 
-   return 1;
+   return -1;
 }
 
 
@@ -1282,28 +1467,13 @@ void MusicXmlFile::getInstrumentName(CXMLObject* object, int partnum,
 
 //////////////////////////////
 //
-// MusicXmlFile::parsePart(CXMLObject* entry, int partnum) {
+// MusicXmlFile::parsePartMeasure -- parse the next measure in a part.
 //
 
-void MusicXmlFile::parsePart(CXMLObject* entry, int partnum) {
-   // cout << "Parsing of Part " << partnum + 1 << endl;
-   CXMLObject* current = entry;
-   CXMLElement* element;
-   long ticktime = 0;
-   long oldticktime = 0;
-   while (current != NULL) {
-      if (current->GetType() == xmlElement) {
-         element = (CXMLElement*)current;
-         if (element->GetName() == "measure") {
-            oldticktime = ticktime;
-            parseMeasure(element, partnum, ticktime);
-            ticktime = oldticktime + getMeasureTickDuration(element);
-         }
-         // cout << "Part " << partnum + 1 << " Element name = "
-         //      << element->GetName() << endl;
-      }
-      current = current->GetNext();
-   }
+void MusicXmlFile::parsePartMeasure(CXMLObject* entry, int partnum) {
+   long oldticktime = parseticktime;
+   parseMeasure(entry, partnum, parseticktime);
+   parseticktime = oldticktime + getMeasureTickDuration(entry);
 }
 
 
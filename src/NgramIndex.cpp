@@ -0,0 +1,741 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 18:26:56 PDT 2026
+// Last Modified: Sat Oct 17 18:26:56 PDT 2026
+// Filename:      ...sig/src/sigInfo/NgramIndex.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/NgramIndex.cpp
+// Syntax:        C++
+//
+// Description:   Binary inverted index of the character n-grams found
+//                in the feature fields of a themefinder index file.
+//
+// File layout:   All integers are stored in native byte order:
+//                   char[8]              magic string "HUMTIX01"
+//                   long long            n-gram size
+//                   long long            size of the indexed text file
+//                   long long            number of lines in the text
+//                   long long            number of n-gram keys
+//                   long long            number of postings
+//                   long long            number of control lines
+//                   char[32]             marker characters (NUL padded)
+//                   long long[lines+1]   byte offset of each line
+//                   long long[keys+1]    first posting of each key
+//                   unsigned[keys]       sorted n-gram keys
+//                   int[controls]        lines starting with '#'
+//                   unsigned[postings]   line of each posting
+//                   unsigned[postings]   character offset of each posting
+//
+
+#include "NgramIndex.h"
+
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#ifndef VISUAL
+   #define USING_MMAP
+#endif
+
+#ifdef USING_MMAP
+   #include <sys/types.h>   /* off_t           */
+   #include <sys/stat.h>    /* fstat           */
+   #include <sys/mman.h>    /* mmap, munmap    */
+   #include <fcntl.h>       /* open            */
+   #include <unistd.h>      /* close           */
+#endif
+
+#define NGRAM_MAGIC       "HUMTIX01"
+#define NGRAM_MAGICSIZE   8
+#define NGRAM_MARKERSIZE  32
+#define NGRAM_HEADERSIZE  (NGRAM_MAGICSIZE + 6 * 8 + NGRAM_MARKERSIZE)
+
+
+//////////////////////////////
+//
+// NgramIndex::NgramIndex --
+//
+
+NgramIndex::NgramIndex(void) {
+   mapping = NULL;
+   mappingsize = 0;
+   mappedQ = 0;
+   clear();
+}
+
+
+NgramIndex::NgramIndex(const string& markers) {
+   mapping = NULL;
+   mappingsize = 0;
+   mappedQ = 0;
+   clear();
+   setMarkers(markers);
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::~NgramIndex --
+//
+
+NgramIndex::~NgramIndex() {
+   releaseMapping();
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::clear -- remove any index data being built or read.
+//
+
+void NgramIndex::clear(void) {
+   releaseMapping();
+   markers.clear();
+   partial.clear();
+   textsize = 0;
+   lineoffsets.clear();
+   controllines.clear();
+   postings.clear();
+   validQ        = 0;
+   rlineoffsets  = NULL;
+   rkeystarts    = NULL;
+   rkeys         = NULL;
+   rcontrollines = NULL;
+   rpostlines    = NULL;
+   rpostoffsets  = NULL;
+   rlinecount    = 0;
+   rkeycount     = 0;
+   rcontrolcount = 0;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::setMarkers -- set the characters which start features
+//    in the fields of the text.  Only text following a marker is indexed.
+//
+
+void NgramIndex::setMarkers(const string& markerlist) {
+   markers.clear();
+   for (int i=0; i<(int)markerlist.size(); i++) {
+      if ((markerlist[i] == '\t') || (markerlist[i] == '\n') ||
+            (markerlist[i] == '\0')) {
+         continue;
+      }
+      if (markers.find(markerlist[i]) != string::npos) {
+         continue;
+      }
+      if ((int)markers.size() >= NGRAM_MARKERSIZE - 1) {
+         break;
+      }
+      markers += markerlist[i];
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::addText -- add text which may contain several lines, or
+//    only part of a line.  Unterminated text is stored until the rest
+//    of the line is given (or until write() is called).
+//
+
+void NgramIndex::addText(const char* text, long length) {
+   long start = 0;
+   for (long i=0; i<length; i++) {
+      if (text[i] != '\n') {
+         continue;
+      }
+      if (partial.empty()) {
+         addLine(text + start, i - start);
+      } else {
+         partial.append(text + start, i - start);
+         addLine(partial.c_str(), (long)partial.size());
+         partial.clear();
+      }
+      start = i + 1;
+   }
+   if (start < length) {
+      partial.append(text + start, length - start);
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::addLine -- index a single line of text (not including
+//    its newline, which is counted in the size of the text).
+//
+
+void NgramIndex::addLine(const char* line, long length) {
+   unsigned linenum = (unsigned)lineoffsets.size();
+   lineoffsets.push_back(textsize);
+   textsize += length + 1;
+
+   if ((length > 0) && (line[0] == '#')) {
+      controllines.push_back((int)linenum);
+      return;
+   }
+
+   Posting posting;
+   posting.line = linenum;
+   long start = 0;
+   for (long i=0; i<=length; i++) {
+      if ((i < length) && (line[i] != '\t')) {
+         continue;
+      }
+      const char* field = line + start;
+      long fieldlength = i - start;
+      start = i + 1;
+      for (int m=0; m<(int)markers.size(); m++) {
+         const char* found = (const char*)memchr(field, markers[m],
+               fieldlength);
+         if (found == NULL) {
+            continue;
+         }
+         // Index the text after the first marker in the field, which also
+         // covers any matches which begin at a later copy of the marker.
+         const char* segment = found + 1;
+         long segmentlength = fieldlength - (segment - field);
+         for (long k=0; k+NGRAM<=segmentlength; k++) {
+            posting.key    = makeKey(markers[m], segment + k);
+            posting.offset = (unsigned)k;
+            postings.push_back(posting);
+         }
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::write -- sort the postings and store the index in a file.
+//    Returns 0 if the file could not be written.
+//
+
+int NgramIndex::write(const string& filename) {
+   if (!partial.empty()) {
+      addLine(partial.c_str(), (long)partial.size());
+      partial.clear();
+      textsize--;   // the last line was not terminated
+   }
+
+   sort(postings.begin(), postings.end(), comparePostings);
+
+   // remove duplicate postings (from identical feature fields):
+   long count = 0;
+   for (long i=0; i<(long)postings.size(); i++) {
+      if ((count > 0) && (postings[count-1].key == postings[i].key) &&
+            (postings[count-1].line == postings[i].line) &&
+            (postings[count-1].offset == postings[i].offset)) {
+         continue;
+      }
+      postings[count++] = postings[i];
+   }
+   postings.resize(count);
+
+   vector<unsigned> keys;
+   vector<long long> keystarts;
+   for (long i=0; i<(long)postings.size(); i++) {
+      if (keys.empty() || (keys.back() != postings[i].key)) {
+         keys.push_back(postings[i].key);
+         keystarts.push_back(i);
+      }
+   }
+   keystarts.push_back((long long)postings.size());
+
+   vector<long long> offsets(lineoffsets.begin(), lineoffsets.end());
+   offsets.push_back(textsize);
+
+   ofstream outfile(filename.c_str(), ios::binary | ios::out | ios::trunc);
+   if (!outfile.is_open()) {
+      return 0;
+   }
+
+   long long header[6];
+   header[0] = NGRAM;
+   header[1] = textsize;
+   header[2] = (long long)lineoffsets.size();
+   header[3] = (long long)keys.size();
+   header[4] = (long long)postings.size();
+   header[5] = (long long)controllines.size();
+   char markerbuffer[NGRAM_MARKERSIZE] = {0};
+   memcpy(markerbuffer, markers.c_str(), markers.size());
+
+   outfile.write(NGRAM_MAGIC, NGRAM_MAGICSIZE);
+   outfile.write((const char*)header, sizeof(header));
+   outfile.write(markerbuffer, NGRAM_MARKERSIZE);
+   outfile.write((const char*)offsets.data(),
+         offsets.size() * sizeof(long long));
+   outfile.write((const char*)keystarts.data(),
+         keystarts.size() * sizeof(long long));
+   outfile.write((const char*)keys.data(), keys.size() * sizeof(unsigned));
+   outfile.write((const char*)controllines.data(),
+         controllines.size() * sizeof(int));
+
+   vector<unsigned> buffer(postings.size());
+   for (long i=0; i<(long)postings.size(); i++) {
+      buffer[i] = postings[i].line;
+   }
+   outfile.write((const char*)buffer.data(), buffer.size() * sizeof(unsigned));
+   for (long i=0; i<(long)postings.size(); i++) {
+      buffer[i] = postings[i].offset;
+   }
+   outfile.write((const char*)buffer.data(), buffer.size() * sizeof(unsigned));
+
+   outfile.close();
+   return !outfile.fail();
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::comparePostings -- sort postings by key, then line,
+//    then offset.
+//
+
+bool NgramIndex::comparePostings(const Posting& a, const Posting& b) {
+   if (a.key != b.key) {
+      return a.key < b.key;
+   }
+   if (a.line != b.line) {
+      return a.line < b.line;
+   }
+   return a.offset < b.offset;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::read -- load an index file for searching.  If textsize
+//    is not negative, then the index is rejected if it was created from
+//    text of a different size.  Returns true if the index can be used.
+//    default value: textsize = -1
+//
+
+int NgramIndex::read(const string& filename, long textsize) {
+   clear();
+
+#ifdef USING_MMAP
+   int fd = open(filename.c_str(), O_RDONLY);
+   if (fd < 0) {
+      return 0;
+   }
+   struct stat info;
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode) ||
+         (info.st_size < NGRAM_HEADERSIZE)) {
+      close(fd);
+      return 0;
+   }
+   void* data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE,
+         fd, 0);
+   close(fd);
+   if (data == MAP_FAILED) {
+      return 0;
+   }
+   mapping = (char*)data;
+   mappingsize = (long)info.st_size;
+   mappedQ = 1;
+#else
+   ifstream infile(filename.c_str(), ios::binary | ios::in);
+   if (!infile.is_open()) {
+      return 0;
+   }
+   infile.seekg(0, ios::end);
+   long filesize = (long)infile.tellg();
+   infile.seekg(0, ios::beg);
+   if (filesize < NGRAM_HEADERSIZE) {
+      return 0;
+   }
+   mapping = new char[filesize];
+   mappingsize = filesize;
+   mappedQ = 0;
+   infile.read(mapping, filesize);
+   if (infile.fail()) {
+      releaseMapping();
+      return 0;
+   }
+#endif
+
+   if (strncmp(mapping, NGRAM_MAGIC, NGRAM_MAGICSIZE) != 0) {
+      releaseMapping();
+      return 0;
+   }
+   long long header[6];
+   memcpy(header, mapping + NGRAM_MAGICSIZE, sizeof(header));
+   long long postingcount = header[4];
+   if ((header[0] != NGRAM) || (header[2] < 0) || (header[3] < 0) ||
+         (postingcount < 0) || (header[5] < 0)) {
+      releaseMapping();
+      return 0;
+   }
+   long long expected = NGRAM_HEADERSIZE
+         + (header[2] + 1) * (long long)sizeof(long long)
+         + (header[3] + 1) * (long long)sizeof(long long)
+         + header[3] * (long long)sizeof(unsigned)
+         + header[5] * (long long)sizeof(int)
+         + postingcount * 2 * (long long)sizeof(unsigned);
+   if (expected != mappingsize) {
+      releaseMapping();
+      return 0;
+   }
+   if ((textsize >= 0) && (header[1] != textsize)) {
+      releaseMapping();
+      return 0;
+   }
+
+   char markerbuffer[NGRAM_MARKERSIZE+1] = {0};
+   memcpy(markerbuffer, mapping + NGRAM_MAGICSIZE + sizeof(header),
+         NGRAM_MARKERSIZE);
+   markers = markerbuffer;
+
+   this->textsize = (long)header[1];
+   rlinecount    = (long)header[2];
+   rkeycount     = (long)header[3];
+   rcontrolcount = (long)header[5];
+
+   char* ptr = mapping + NGRAM_HEADERSIZE;
+   rlineoffsets  = (const long long*)ptr;
+   ptr += (rlinecount + 1) * sizeof(long long);
+   rkeystarts    = (const long long*)ptr;
+   ptr += (rkeycount + 1) * sizeof(long long);
+   rkeys         = (const unsigned*)ptr;
+   ptr += rkeycount * sizeof(unsigned);
+   rcontrollines = (const int*)ptr;
+   ptr += rcontrolcount * sizeof(int);
+   rpostlines    = (const unsigned*)ptr;
+   ptr += postingcount * sizeof(unsigned);
+   rpostoffsets  = (const unsigned*)ptr;
+
+   validQ = 1;
+   return validQ;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::releaseMapping -- free the contents of a read index file.
+//
+
+void NgramIndex::releaseMapping(void) {
+   if (mapping != NULL) {
+      #ifdef USING_MMAP
+         if (mappedQ) {
+            munmap(mapping, (size_t)mappingsize);
+         } else {
+            delete [] mapping;
+         }
+      #else
+         delete [] mapping;
+      #endif
+   }
+   mapping     = NULL;
+   mappingsize = 0;
+   mappedQ     = 0;
+   validQ      = 0;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::isValid -- true if an index file was read successfully.
+//
+
+int NgramIndex::isValid(void) const {
+   return validQ;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::hasMarker -- true if features with the given marker
+//    are indexed.
+//
+
+int NgramIndex::hasMarker(char marker) const {
+   return markers.find(marker) != string::npos;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::getTextSize -- return the size in bytes of the text
+//    which was indexed.
+//
+
+long NgramIndex::getTextSize(void) const {
+   return textsize;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::getLineCount -- return the number of lines in the text
+//    which was indexed.
+//
+
+int NgramIndex::getLineCount(void) const {
+   if (validQ) {
+      return (int)rlinecount;
+   }
+   return (int)lineoffsets.size();
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::getLineOffset -- return the byte offset of the start of
+//    a line in the text which was indexed.
+//
+
+long NgramIndex::getLineOffset(int line) const {
+   if (validQ) {
+      if ((line < 0) || (line > rlinecount)) {
+         return -1;
+      }
+      return (long)rlineoffsets[line];
+   }
+   if ((line < 0) || (line >= (int)lineoffsets.size())) {
+      return -1;
+   }
+   return lineoffsets[line];
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::getControlLines -- return the list of lines which start
+//    with '#' (which are not indexed).
+//
+
+void NgramIndex::getControlLines(vector<int>& lines) const {
+   if (validQ) {
+      lines.assign(rcontrollines, rcontrollines + rcontrolcount);
+   } else {
+      lines = controllines;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::searchLiteral -- find the lines which contain the literal
+//    string somewhere after the given marker character in one of their
+//    fields.  The lines are returned in ascending order.  Returns -1 if
+//    the index cannot be used to search for the literal (the literal is
+//    shorter than an n-gram, or the marker is not indexed), in which case
+//    all lines must be considered as candidates.
+//
+
+int NgramIndex::searchLiteral(vector<int>& lines, char marker,
+      const string& literal) const {
+   lines.clear();
+   if (!validQ || !hasMarker(marker) || ((int)literal.size() < NGRAM)) {
+      return -1;
+   }
+   if (literal.find_first_of("\t\n") != string::npos) {
+      return -1;
+   }
+
+   int count = (int)literal.size() - NGRAM + 1;
+   vector<long> starts(count);
+   vector<long> ends(count);
+   int pivot = 0;
+   for (int i=0; i<count; i++) {
+      if (!findKey(makeKey(marker, literal.c_str() + i), starts[i], ends[i])) {
+         return 0;
+      }
+      if (ends[i] - starts[i] < ends[pivot] - starts[pivot]) {
+         pivot = i;
+      }
+   }
+
+   // Start with the postings for the least common n-gram, and check that
+   // the other n-grams of the literal occur next to it:
+   for (long p=starts[pivot]; p<ends[pivot]; p++) {
+      unsigned line = rpostlines[p];
+      if (!lines.empty() && (lines.back() == (int)line)) {
+         continue;
+      }
+      if (rpostoffsets[p] < (unsigned)pivot) {
+         continue;
+      }
+      unsigned base = rpostoffsets[p] - pivot;
+      int i;
+      for (i=0; i<count; i++) {
+         if (i == pivot) {
+            continue;
+         }
+         if (!hasPosting(starts[i], ends[i], line, base + i)) {
+            break;
+         }
+      }
+      if (i == count) {
+         lines.push_back((int)line);
+      }
+   }
+
+   return (int)lines.size();
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::intersect -- keep only the lines which are also in the
+//    other list.  Both lists must be sorted.
+//
+
+void NgramIndex::intersect(vector<int>& lines, const vector<int>& other) {
+   vector<int> output;
+   output.reserve(lines.size() < other.size() ? lines.size() : other.size());
+   set_intersection(lines.begin(), lines.end(), other.begin(), other.end(),
+         back_inserter(output));
+   lines.swap(output);
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::makeKey -- combine a marker and the characters of an
+//    n-gram into a single key.
+//
+
+unsigned NgramIndex::makeKey(char marker, const char* ngram) {
+   return ((unsigned)(unsigned char)marker << 24) |
+          ((unsigned)(unsigned char)ngram[0] << 16) |
+          ((unsigned)(unsigned char)ngram[1] << 8) |
+          ((unsigned)(unsigned char)ngram[2]);
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::findKey -- find the range of postings for a key in a
+//    read index.  Returns false if the key does not occur.
+//
+
+int NgramIndex::findKey(unsigned key, long& start, long& end) const {
+   const unsigned* found = lower_bound(rkeys, rkeys + rkeycount, key);
+   if ((found == rkeys + rkeycount) || (*found != key)) {
+      start = end = 0;
+      return 0;
+   }
+   long index = (long)(found - rkeys);
+   start = (long)rkeystarts[index];
+   end   = (long)rkeystarts[index+1];
+   return 1;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndex::hasPosting -- binary search for a line/offset pair in a
+//    range of postings (which are sorted by line, then by offset).
+//
+
+int NgramIndex::hasPosting(long start, long end, unsigned line,
+      unsigned offset) const {
+   long last = end;
+   while (start < end) {
+      long middle = start + (end - start) / 2;
+      if ((rpostlines[middle] < line) || ((rpostlines[middle] == line) &&
+            (rpostoffsets[middle] < offset))) {
+         start = middle + 1;
+      } else {
+         end = middle;
+      }
+   }
+   return (start < last) && (rpostlines[start] == line) &&
+         (rpostoffsets[start] == offset);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// NgramIndexBuffer class functions --
+//
+
+
+//////////////////////////////
+//
+// NgramIndexBuffer::NgramIndexBuffer --
+//
+
+NgramIndexBuffer::NgramIndexBuffer(streambuf* aTarget, NgramIndex& anIndex)
+      : target(aTarget), index(anIndex) {
+   // unbuffered: all output is passed through overflow() and xsputn()
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndexBuffer::~NgramIndexBuffer --
+//
+
+NgramIndexBuffer::~NgramIndexBuffer() {
+   target = NULL;
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndexBuffer::overflow -- pass a single character through.
+//
+
+int NgramIndexBuffer::overflow(int ch) {
+   if (ch == traits_type::eof()) {
+      return traits_type::not_eof(ch);
+   }
+   char c = (char)ch;
+   index.addText(&c, 1);
+   return target->sputc(c);
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndexBuffer::xsputn -- pass a string of characters through.
+//
+
+streamsize NgramIndexBuffer::xsputn(const char* text, streamsize count) {
+   index.addText(text, (long)count);
+   return target->sputn(text, count);
+}
+
+
+
+//////////////////////////////
+//
+// NgramIndexBuffer::sync -- flush the target stream buffer.
+//
+
+int NgramIndexBuffer::sync(void) {
+   return target->pubsync();
+}
+
+
+
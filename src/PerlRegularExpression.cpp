@@ -1,6 +1,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Mon Jun 29 14:25:53 PDT 2009
 // Last Modified: Mon Jun 29 14:26:01 PDT 2009
+// Last Modified: Sat Oct 17 17:55:33 PDT 2026 added compiled pattern cache
+// Last Modified: Sat Oct 17 20:24:34 PDT 2026 added JIT compilation
 // Filename:      ...sig/src/sig/PerlRegularExpression.cpp
 // Web Address:   http://sig.sapp.org/src/sig/PerlRegularExpression.cpp
 // Syntax:        C++; Perl Compatible Regular Expressions (http://www.pcre.org)
@@ -159,15 +161,112 @@
 
 
 #include <string.h>
+#include <strings.h>
+#include <stdlib.h>
 
 #include <iostream>
 #include <sstream>
 #include <vector>
 #include <string>
+#include <map>
+#include <mutex>
 
 #include "PerlRegularExpression.h"
 #include "Array.h"
 
+
+///////////////////////////////////////////////////////////////////////////
+//
+// Process-wide cache of compiled and studied patterns.  Many functions
+// in the library (such as HumdrumRecord::isKey()) create a temporary
+// PerlRegularExpression for a constant pattern on every call, so the
+// compiled patterns are shared between all objects, keyed by the
+// compile flags and the pattern string.  Entries are never freed, so
+// the number of cached patterns is limited; patterns past the limit
+// are compiled by each object as before.
+//
+
+#define PRE_CACHE_LIMIT 4096
+
+class _PreCacheEntry {
+   public:
+      pcre*       pre;
+      pcre_extra* pe;
+};
+
+class _PreCache {
+   public:
+      _PreCache(void) { hits = 0; misses = 0; }
+      map<string, _PreCacheEntry> entries;
+      mutex                       lock;
+      long                        hits;
+      long                        misses;
+};
+
+static _PreCache& getPreCache(void) {
+   static _PreCache cache;
+   return cache;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// JIT stacks.  The machine stack which a JIT-compiled pattern uses by
+// default is only 32K, so each thread is given its own JIT stack which
+// can grow up to PRE_JIT_STACK_MAX.  A match which needs more stack than
+// that fails with PCRE_ERROR_JIT_STACKLIMIT (the interpreter would run
+// out of machine stack long before).  The stack is attached to studied
+// patterns with a callback, so patterns in the cache can be shared
+// between threads.  The stack is freed when the thread exits.
+//
+
+#define PRE_JIT_STACK_START  (32 * 1024)
+#define PRE_JIT_STACK_MAX    (8 * 1024 * 1024)
+
+class _PreJitStack {
+   public:
+      _PreJitStack(void) { stack = NULL; }
+     ~_PreJitStack() { 
+         if (stack != NULL) {
+            pcre_jit_stack_free(stack);
+         }
+      }
+      pcre_jit_stack* stack;
+};
+
+static pcre_jit_stack* getThreadJitStack(void* userdata) {
+   static thread_local _PreJitStack jitstack;
+   if (jitstack.stack == NULL) {
+      jitstack.stack = pcre_jit_stack_alloc(PRE_JIT_STACK_START, 
+            PRE_JIT_STACK_MAX);
+   }
+   // If the allocation failed, NULL will use the machine stack.
+   return jitstack.stack;
+}
+
+
+//
+// The default for new objects is set by the HUMEXTRA_PCRE_JIT environment
+// variable: JIT compiling is used if it is set to anything other than
+// "0", "no" or "off".
+//
+
+static int& getJitDefaultStorage(void) {
+   static int state = [](void) {
+      const char* value = getenv("HUMEXTRA_PCRE_JIT");
+      if ((value == NULL) || (value[0] == '\0')) {
+         return 0;
+      }
+      if ((strcmp(value, "0") == 0) || (strcasecmp(value, "no") == 0) ||
+            (strcasecmp(value, "off") == 0)) {
+         return 0;
+      }
+      return 1;
+   }();
+   return state;
+}
+
+
 using namespace std;
 
 
@@ -182,7 +281,9 @@ PerlRegularExpression::PerlRegularExpression(void) {
    extendedQ   = 1;  // always extended for PCRE
    ignorecaseQ = 0;
    studyQ      = 0;
+   cachedQ     = 0;
    anchorQ     = 0;
+   jitQ        = getJitDefault();
 
    output_substrings.setSize(3 * 100);  // has to be a multiple of 3
    output_substrings.setAll(0);
@@ -211,11 +312,7 @@ PerlRegularExpression::PerlRegularExpression(void) {
 //
 
 PerlRegularExpression::~PerlRegularExpression() {
-   if (pre != NULL) {
-      pcre_free(pre);
-      pre = NULL;
-   }
-	 
+   releasePattern();
 }
 
 
@@ -453,9 +550,9 @@ void PerlRegularExpression::initializeSearch(void) {
       compflags |= PCRE_ANCHORED;
    }
 
-   if (pre != NULL) {
-      pcre_free(pre);
-      pre = NULL;
+   releasePattern();
+   if (getCachedPattern(compflags)) {
+      return;
    }
 
    pre = pcre_compile(search_string.getBase(), compflags, &compile_error,
@@ -539,7 +636,7 @@ void PerlRegularExpression::studySearch() {
       const char* statusMessage = "";
       studyQ = 1;
       // how should any old structure that pe points to be disposed?
-      pe = pcre_study(pre, 0, &statusMessage);
+      pe = studyPattern(pre, jitQ, &statusMessage);
       if (statusMessage != NULL) {
          cerr << "WARNING: problem studying regular expression: " << endl;
          cerr << statusMessage << endl;
@@ -551,6 +648,212 @@ void PerlRegularExpression::studySearch() {
 
 
 
+//////////////////////////////
+//
+// PerlRegularExpression::getCacheHits -- Number of times that a
+//     compiled pattern was found in the process-wide cache.
+//
+
+long PerlRegularExpression::getCacheHits(void) {
+   _PreCache& cache = getPreCache();
+   lock_guard<mutex> guard(cache.lock);
+   return cache.hits;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::getCacheMisses -- Number of times that a
+//     pattern had to be compiled because it was not in the cache.
+//
+
+long PerlRegularExpression::getCacheMisses(void) {
+   _PreCache& cache = getPreCache();
+   lock_guard<mutex> guard(cache.lock);
+   return cache.misses;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::getCacheSize -- Number of compiled patterns
+//     stored in the cache.
+//
+
+int PerlRegularExpression::getCacheSize(void) {
+   _PreCache& cache = getPreCache();
+   lock_guard<mutex> guard(cache.lock);
+   return (int)cache.entries.size();
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::setJit -- Turn JIT compiling of the pattern on
+//     or off.  JIT compiling is done when the pattern is studied, and 
+//     is ignored if the PCRE library was built without JIT support.
+//     default value: state = 1
+//
+
+void PerlRegularExpression::setJit(int state) {
+   state = state ? 1 : 0;
+   if (state == jitQ) {
+      return;
+   }
+   jitQ = state;
+   releasePattern();
+   valid = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::isJitAvailable -- Returns true if the PCRE
+//     library was built with JIT support (configure --enable-jit).
+//
+
+int PerlRegularExpression::isJitAvailable(void) {
+   int value = 0;
+   if (pcre_config(PCRE_CONFIG_JIT, &value) != 0) {
+      return 0;
+   }
+   return value;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::setJitDefault -- Set the JIT state of objects
+//     created afterwards.  Should be called before any threads are
+//     started.
+//
+
+void PerlRegularExpression::setJitDefault(int state) {
+   getJitDefaultStorage() = state ? 1 : 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::getJitDefault -- Returns the JIT state for new
+//     objects.  This is initially set from the HUMEXTRA_PCRE_JIT
+//     environment variable.
+//
+
+int PerlRegularExpression::getJitDefault(void) {
+   return getJitDefaultStorage();
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::studyPattern -- Study a compiled pattern, JIT
+//     compiling it if requested, and attach the per-thread JIT stack 
+//     if the JIT compile succeeded.  The error message is set to NULL 
+//     on success.  The result may be NULL if there is nothing to store.
+//
+
+pcre_extra* PerlRegularExpression::studyPattern(pcre* code, int jit,
+      const char** error) {
+   pcre_extra* extra = pcre_study(code, jit ? PCRE_STUDY_JIT_COMPILE : 0,
+         error);
+   if ((extra != NULL) && (extra->flags & PCRE_EXTRA_EXECUTABLE_JIT)) {
+      pcre_assign_jit_stack(extra, getThreadJitStack, NULL);
+   }
+   return extra;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+//
+// private functions
+//
+
+//////////////////////////////
+//
+// PerlRegularExpression::releasePattern -- Free the compiled pattern
+//     unless it belongs to the cache.
+//
+
+void PerlRegularExpression::releasePattern(void) {
+   if (!cachedQ) {
+      if (pe != NULL) {
+         pcre_free_study(pe);
+      }
+      if (pre != NULL) {
+         pcre_free(pre);
+      }
+   }
+   pre = NULL;
+   pe  = NULL;
+   cachedQ = 0;
+   studyQ  = 0;
+}
+
+
+
+//////////////////////////////
+//
+// PerlRegularExpression::getCachedPattern -- Get the compiled and studied
+//     form of the current search string from the process-wide cache,
+//     compiling and storing it if necessary.  Returns 0 if the pattern
+//     has to be compiled by the object (cache is full or the pattern
+//     has a syntax error which will be reported by the caller).
+//
+
+int PerlRegularExpression::getCachedPattern(int compflags) {
+   string key;
+   key.reserve(search_string.getSize() + 16);
+   key += to_string(compflags);
+   key += jitQ ? "j:" : ":";
+   key += search_string.getBase();
+
+   _PreCache& cache = getPreCache();
+   lock_guard<mutex> guard(cache.lock);
+
+   map<string, _PreCacheEntry>::iterator it = cache.entries.find(key);
+   if (it != cache.entries.end()) {
+      cache.hits++;
+      pre = it->second.pre;
+      pe  = it->second.pe;
+   } else {
+      cache.misses++;
+      if ((int)cache.entries.size() >= PRE_CACHE_LIMIT) {
+         return 0;
+      }
+      pcre* newpre = pcre_compile(search_string.getBase(), compflags, 
+            &compile_error, &error_offset, NULL);
+      if (newpre == NULL) {
+         return 0;
+      }
+      const char* statusMessage = NULL;
+      pcre_extra* newpe = studyPattern(newpre, jitQ, &statusMessage);
+      if (statusMessage != NULL) {
+         newpe = NULL;
+      }
+      _PreCacheEntry& entry = cache.entries[key];
+      entry.pre = newpre;
+      entry.pe  = newpe;
+      pre = newpre;
+      pe  = newpe;
+   }
+
+   cachedQ = 1;
+   studyQ  = 1;
+   valid   = 1;
+   return 1;
+}
+
+
+
 //////////////////////////////
 //
 // PerlRegularExpression::sar -- search and replace, destructively.
@@ -941,9 +1244,6 @@ int PerlRegularExpression::search(const char* input, const char* searchstring,
       const char* optionstring) {
 
    setSearchString(searchstring);
-   if (valid == 0) {
-      initializeSearch();
-   }
 
    int i;
    if (optionstring != NULL) {
@@ -966,6 +1266,9 @@ int PerlRegularExpression::search(const char* input, const char* searchstring,
       }
    }
 
+   if (valid == 0) {
+      initializeSearch();
+   }
    return search(input);
 }
 
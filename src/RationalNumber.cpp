@@ -2,6 +2,9 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Wed May 19 21:10:47 PDT 2010
 // Last Modified: Wed May 19 21:10:51 PDT 2010
+// Last Modified: Sat Oct 17 18:56:50 PDT 2026 binary gcd
+// Last Modified: Sat Oct 17 22:53:35 PDT 2026 invalid values (den 0)
+// Last Modified: Sun Oct 18 00:43:53 PDT 2026 INT_MIN in simplify()
 // Filename:      ...sig/maint/code/base/RationalNumber/RationalNumber.cpp
 // Web Address:   http://sig.sapp.org/src/sigBase/RationalNumber.cpp
 // Syntax:        C++ 
@@ -14,6 +17,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 //////////////////////////////
 //
@@ -76,6 +80,11 @@ RationalNumber RationalNumber::operator-(void) const {
 //
 
 RationalNumber RationalNumber::operator+(const RationalNumber &r) const {
+   if (!isValid() || !r.isValid()) {
+      RationalNumber invalid;
+      invalid.setInvalid();
+      return invalid;
+   }
    if (r.getNumerator() == 0) {
       return *this;
    }
@@ -117,6 +126,10 @@ RationalNumber RationalNumber::operator-(const RationalNumber &r) const {
 RationalNumber RationalNumber::operator*(const RationalNumber &r) const {
    RationalNumber temp;
 
+   if (!isValid() || !r.isValid()) {
+      temp.setInvalid();
+      return temp;
+   }
    if (r.getNumerator() == 0) {
       temp.setValue(0,1);
       return temp;
@@ -280,6 +293,9 @@ RationalNumber RationalNumber::operator--(int n) {
 //
 
 int RationalNumber::operator ==(const RationalNumber &r) const {
+   if (!isValid() || !r.isValid()) {
+      return 0;
+   }
    if ((this->getNumerator() == 0) && (r.getNumerator() == 0)) {
       return 1;
    } else {
@@ -377,22 +393,39 @@ void RationalNumber::setValue(int num, int den) {
 //////////////////////////////
 //
 // RationalNumber::gcd -- Greatest common denominator. (static function)
+//     Uses the binary gcd algorithm.  If one number is zero, returns
+//     the absolute value of the other if it is negative, otherwise 1
+//     (the behavior of the previous implementation).  The absolute
+//     values are calculated as unsigned ints, so INT_MIN is allowed, but
+//     a gcd of 2^31 (when both numbers are 0 or INT_MIN) is returned as
+//     INT_MIN.
 //
 
 int RationalNumber::gcd(int _x, int _y) {
-   int x = _x;
-   int y = _y;
-   if (x < 0) x = -x;
-   if (y < 0) y = -y;
-   if (_x > _y) swap(x, y);
-   int i;
-   for (i=x; i>1; i--) {
-      if (!(x%i) && !(y%i)) break;
-   }
-   if (i==0) {
-      i++;
-   }
-   return i;
+   unsigned int x = _x < 0 ? 0u - (unsigned int)_x : (unsigned int)_x;
+   unsigned int y = _y < 0 ? 0u - (unsigned int)_y : (unsigned int)_y;
+   if ((x == 0) || (y == 0)) {
+      return ((_x < 0) || (_y < 0)) ? (int)(x | y) : 1;
+   }
+   int shift = 0;
+   while (((x | y) & 1) == 0) {
+      x >>= 1;
+      y >>= 1;
+      shift++;
+   }
+   while ((x & 1) == 0) {
+      x >>= 1;
+   }
+   do {
+      while ((y & 1) == 0) {
+         y >>= 1;
+      }
+      if (x > y) {
+         swap(x, y);
+      }
+      y -= x;
+   } while (y != 0);
+   return (int)(x << shift);
 }
 
 
@@ -404,11 +437,11 @@ int RationalNumber::gcd(int _x, int _y) {
 
 int RationalNumber::lcm(int _x, int _y) {
    int gcd_val = gcd(_x, _y);
-   int prod = _x * _y;
+   int prod = (_x / gcd_val) * _y;
    if (prod < 0) {
       prod = -prod;
    }
-   return (prod / gcd_val);
+   return prod;
 }
 
 
@@ -416,17 +449,25 @@ int RationalNumber::lcm(int _x, int _y) {
 //////////////////////////////
 //
 // RationalNumber::simplify -- Removed redundant factors between
-//     numerator and denominator. (static function)
+//     numerator and denominator. (static function)  The common factor
+//     is divided out before the sign of a negative denominator is moved
+//     to the numerator, so INT_MIN only has to be negated if it has no
+//     common factor; in that case the value cannot be stored with a
+//     positive denominator, and it is marked as invalid.
 //
 
 void RationalNumber::simplify(RationalNumber &r) {
    int gcd_val = gcd(r._num, r._den);
+   r._num /= gcd_val;
+   r._den /= gcd_val;
    if (r._den < 0) {
+      if ((r._num == INT_MIN) || (r._den == INT_MIN)) {
+         r.setInvalid();
+         return;
+      }
       r._num = -r._num;
       r._den = -r._den;
    }
-   r._num /= gcd_val;
-   r._den /= gcd_val;
 }
 
 
@@ -679,6 +720,10 @@ double RationalNumber::Pow(const RationalNumber &p, const RationalNumber &q) {
 //
 
 ostream& operator<<(ostream& out, RationalNumber p) {
+   if (!p.isValid()) {
+      out << "nan";
+      return out;
+   }
    out << p.getNumerator();
    if (p.getNumerator() != 0) {
       if (p.getDenominator() != 1) {
@@ -0,0 +1,580 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 18:56:50 PDT 2026
+// Last Modified: Sat Oct 17 18:56:50 PDT 2026
+// Last Modified: Sat Oct 17 22:53:35 PDT 2026 invalid result on int overflow
+// Filename:      ...sig/src/sigInfo/RationalNumber64.cpp
+// Web Address:   http://sig.sapp.org/src/sigInfo/RationalNumber64.cpp
+// Syntax:        C++
+//
+// Description:   Rational number class with 64-bit numerator and
+//                denominator.
+//
+
+#include "RationalNumber64.h"
+
+#include <climits>
+#include <cmath>
+
+using namespace std;
+
+
+//////////////////////////////
+//
+// trailingZeros -- return the number of zero bits at the bottom of a
+//     non-zero number.
+//
+
+static int trailingZeros(unsigned long long value) {
+   #ifdef __GNUC__
+      return __builtin_ctzll(value);
+   #else
+      int output = 0;
+      while ((value & 1) == 0) {
+         value >>= 1;
+         output++;
+      }
+      return output;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// unsignedAbs -- absolute value of a number, which also works for the
+//     most negative number.
+//
+
+static unsigned long long unsignedAbs(long long value) {
+   if (value < 0) {
+      return 0ull - (unsigned long long)value;
+   }
+   return (unsigned long long)value;
+}
+
+
+
+//////////////////////////////
+//
+// powerOfTwoGcd -- greatest common divisor of a non-zero number and
+//     a power of two.
+//
+
+static long long powerOfTwoGcd(long long value, long long poweroftwo) {
+   int shift = trailingZeros(unsignedAbs(value));
+   int pshift = trailingZeros((unsigned long long)poweroftwo);
+   return 1ll << (shift < pshift ? shift : pshift);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::RationalNumber64 --
+//
+
+RationalNumber64::RationalNumber64(long long aNumerator,
+      long long aDenominator) {
+   setValue(aNumerator, aDenominator);
+}
+
+
+RationalNumber64::RationalNumber64(const RationalNumber& aNumber) {
+   if (!aNumber.isValid()) {
+      setInvalid();
+      return;
+   }
+   num = aNumber.getNumerator();
+   den = aNumber.getDenominator();
+   simplify(*this);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::setValue -- the denominator cannot be zero.
+//
+
+void RationalNumber64::setValue(long long aNumerator, long long aDenominator) {
+   num = aNumerator;
+   den = aDenominator;
+   if (den == 0) {
+      _error_msg("denominator can't be zero.");
+   }
+   simplify(*this);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator+ --
+//
+
+RationalNumber64 RationalNumber64::operator+(const RationalNumber64& r) const {
+   RationalNumber64 output;
+   if (!isValid() || !r.isValid()) {
+      output.setInvalid();
+      return output;
+   }
+   if (r.num == 0) {
+      return *this;
+   }
+   if (num == 0) {
+      return r;
+   }
+
+   long long a;   // numerator of *this with the common denominator
+   long long c;   // numerator of r with the common denominator
+   long long d;   // common denominator
+   int overflowQ = 0;
+   if (den == r.den) {
+      a = num;
+      c = r.num;
+      d = den;
+   } else if (isPowerOfTwo(den) && isPowerOfTwo(r.den)) {
+      // the larger denominator is a multiple of the smaller one
+      if (den > r.den) {
+         a = num;
+         overflowQ = multiplyOverflow(r.num, den / r.den, c);
+         d = den;
+      } else {
+         overflowQ = multiplyOverflow(num, r.den / den, a);
+         c = r.num;
+         d = r.den;
+      }
+   } else {
+      long long g = gcd(den, r.den);
+      overflowQ = multiplyOverflow(den / g, r.den, d) ||
+                  multiplyOverflow(num, r.den / g, a) ||
+                  multiplyOverflow(r.num, den / g, c);
+   }
+   if (overflowQ || addOverflow(a, c, output.num)) {
+      output.setInvalid();
+      return output;
+   }
+   output.den = d;
+   simplify(output);
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator- --
+//
+
+RationalNumber64 RationalNumber64::operator-(const RationalNumber64& r) const {
+   return *this + (-r);
+}
+
+
+RationalNumber64 RationalNumber64::operator-(void) const {
+   RationalNumber64 output = *this;
+   if (num == LLONG_MIN) {
+      output.setInvalid();
+   } else {
+      output.num = -num;
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator* -- Common factors are removed before
+//     multiplying, so the result is already in lowest terms.
+//
+
+RationalNumber64 RationalNumber64::operator*(const RationalNumber64& r) const {
+   RationalNumber64 output;
+   if (!isValid() || !r.isValid()) {
+      output.setInvalid();
+      return output;
+   }
+   if ((num == 0) || (r.num == 0)) {
+      return output;
+   }
+
+   long long g1;  // common factor of num and r.den
+   long long g2;  // common factor of r.num and den
+   if (isPowerOfTwo(den) && isPowerOfTwo(r.den)) {
+      g1 = powerOfTwoGcd(num, r.den);
+      g2 = powerOfTwoGcd(r.num, den);
+   } else {
+      g1 = gcd(num, r.den);
+      g2 = gcd(r.num, den);
+   }
+   if (multiplyOverflow(num / g1, r.num / g2, output.num) ||
+       multiplyOverflow(den / g2, r.den / g1, output.den)) {
+      output.setInvalid();
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator/ -- Dividing by zero gives an invalid number.
+//
+
+RationalNumber64 RationalNumber64::operator/(const RationalNumber64& r) const {
+   RationalNumber64 inverse;
+   if (!r.isValid() || (r.num == 0) || (r.num == LLONG_MIN)) {
+      inverse.setInvalid();
+      return inverse;
+   }
+   if (r.num < 0) {
+      inverse.num = -r.den;
+      inverse.den = -r.num;
+   } else {
+      inverse.num = r.den;
+      inverse.den = r.num;
+   }
+   return *this * inverse;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator+= --
+//
+
+RationalNumber64& RationalNumber64::operator+=(const RationalNumber64& r) {
+   *this = *this + r;
+   return *this;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator-= --
+//
+
+RationalNumber64& RationalNumber64::operator-=(const RationalNumber64& r) {
+   *this = *this - r;
+   return *this;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator*= --
+//
+
+RationalNumber64& RationalNumber64::operator*=(const RationalNumber64& r) {
+   *this = *this * r;
+   return *this;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator/= --
+//
+
+RationalNumber64& RationalNumber64::operator/=(const RationalNumber64& r) {
+   *this = *this / r;
+   return *this;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator== -- Invalid numbers are not equal to
+//     anything (including themselves).
+//
+
+int RationalNumber64::operator==(const RationalNumber64& r) const {
+   return isValid() && (num == r.num) && (den == r.den);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator!= --
+//
+
+int RationalNumber64::operator!=(const RationalNumber64& r) const {
+   return !(*this == r);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator< --
+//
+
+int RationalNumber64::operator<(const RationalNumber64& r) const {
+   return isValid() && r.isValid() && (compare(*this, r) < 0);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator> --
+//
+
+int RationalNumber64::operator>(const RationalNumber64& r) const {
+   return isValid() && r.isValid() && (compare(*this, r) > 0);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator<= --
+//
+
+int RationalNumber64::operator<=(const RationalNumber64& r) const {
+   return isValid() && r.isValid() && (compare(*this, r) <= 0);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::operator>= --
+//
+
+int RationalNumber64::operator>=(const RationalNumber64& r) const {
+   return isValid() && r.isValid() && (compare(*this, r) >= 0);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::getFloat -- returns NaN if the number is invalid.
+//
+
+double RationalNumber64::getFloat(void) const {
+   if (den == 0) {
+      return NAN;
+   }
+   return (double)num / den;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::isRationalNumber -- returns true if the number
+//     fits into the int terms of a RationalNumber.
+//
+
+int RationalNumber64::isRationalNumber(void) const {
+   return isValid() && (num >= INT_MIN) && (num <= INT_MAX) &&
+         (den <= INT_MAX);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::getRationalNumber -- convert to a RationalNumber.
+//     If the number is invalid or does not fit into int terms, an
+//     invalid RationalNumber is returned (see RationalNumber::isValid()).
+//
+
+RationalNumber RationalNumber64::getRationalNumber(void) const {
+   RationalNumber output;
+   if (isRationalNumber()) {
+      output.setNumerator((int)num);
+      output.setDenominator((int)den);
+   } else {
+      output.setInvalid();
+   }
+   return output;
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::gcd -- Greatest common divisor, calculated with the
+//     binary gcd algorithm.  gcd(0, y) is |y|. (static function)
+//
+
+long long RationalNumber64::gcd(long long x, long long y) {
+   unsigned long long a = unsignedAbs(x);
+   unsigned long long b = unsignedAbs(y);
+   if (a == 0) {
+      return (long long)b;
+   }
+   if (b == 0) {
+      return (long long)a;
+   }
+   int shift = trailingZeros(a | b);
+   a >>= trailingZeros(a);
+   do {
+      b >>= trailingZeros(b);
+      if (a > b) {
+         unsigned long long temp = a;
+         a = b;
+         b = temp;
+      }
+      b -= a;
+   } while (b != 0);
+   return (long long)(a << shift);
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::addOverflow -- stores a+b in result and returns
+//     true if the sum overflowed. (static function)
+//
+
+int RationalNumber64::addOverflow(long long a, long long b,
+      long long& result) {
+   #ifdef __GNUC__
+      return __builtin_add_overflow(a, b, &result);
+   #else
+      if (((b > 0) && (a > LLONG_MAX - b)) ||
+          ((b < 0) && (a < LLONG_MIN - b))) {
+         return 1;
+      }
+      result = a + b;
+      return 0;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::multiplyOverflow -- stores a*b in result and returns
+//     true if the product overflowed. (static function)
+//
+
+int RationalNumber64::multiplyOverflow(long long a, long long b,
+      long long& result) {
+   #ifdef __GNUC__
+      return __builtin_mul_overflow(a, b, &result);
+   #else
+      if ((a == 0) || (b == 0)) {
+         result = 0;
+         return 0;
+      }
+      if (((a == -1) && (b == LLONG_MIN)) || ((b == -1) && (a == LLONG_MIN))) {
+         return 1;
+      }
+      long long product = (long long)((unsigned long long)a *
+            (unsigned long long)b);
+      if (product / b != a) {
+         return 1;
+      }
+      result = product;
+      return 0;
+   #endif
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::simplify -- put the number into lowest terms with a
+//     positive denominator.  Numbers with power-of-two denominators are
+//     reduced by shifting out common factors of two. (static function)
+//
+
+void RationalNumber64::simplify(RationalNumber64& r) {
+   if (r.den == 0) {
+      return;
+   }
+   if (r.den < 0) {
+      if ((r.num == LLONG_MIN) || (r.den == LLONG_MIN)) {
+         r.setInvalid();
+         return;
+      }
+      r.num = -r.num;
+      r.den = -r.den;
+   }
+   if (r.num == 0) {
+      r.den = 1;
+      return;
+   }
+   if (r.den == 1) {
+      return;
+   }
+   long long g;
+   if (isPowerOfTwo(r.den)) {
+      g = powerOfTwoGcd(r.num, r.den);
+   } else {
+      g = gcd(r.num, r.den);
+   }
+   if (g > 1) {
+      r.num /= g;
+      r.den /= g;
+   }
+}
+
+
+
+//////////////////////////////
+//
+// RationalNumber64::compare -- returns -1 if a < b, 0 if a == b, and
+//     +1 if a > b.  Both numbers must be valid. (static function)
+//
+
+int RationalNumber64::compare(const RationalNumber64& a,
+      const RationalNumber64& b) {
+   if (a.den == b.den) {
+      return (a.num < b.num) ? -1 : ((a.num > b.num) ? 1 : 0);
+   }
+   long long left;
+   long long right;
+   if (!multiplyOverflow(a.num, b.den, left) &&
+       !multiplyOverflow(b.num, a.den, right)) {
+      return (left < right) ? -1 : ((left > right) ? 1 : 0);
+   }
+   #ifdef __SIZEOF_INT128__
+      __int128 bigleft  = (__int128)a.num * b.den;
+      __int128 bigright = (__int128)b.num * a.den;
+      return (bigleft < bigright) ? -1 : ((bigleft > bigright) ? 1 : 0);
+   #else
+      long double fleft  = (long double)a.num / a.den;
+      long double fright = (long double)b.num / b.den;
+      return (fleft < fright) ? -1 : ((fleft > fright) ? 1 : 0);
+   #endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// operator<< -- invalid numbers are printed as "nan".
+//
+
+ostream& operator<<(ostream& out, const RationalNumber64& aNumber) {
+   if (!aNumber.isValid()) {
+      out << "nan";
+      return out;
+   }
+   out << aNumber.getNumerator();
+   if ((aNumber.getNumerator() != 0) && (aNumber.getDenominator() != 1)) {
+      out << "/" << aNumber.getDenominator();
+   }
+   return out;
+}
+
+
+
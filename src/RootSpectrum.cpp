@@ -3,6 +3,8 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Tue Dec 24 18:25:42 PST 2002
 // Last Modified: Tue Dec 24 18:25:44 PST 2002
+// Last Modified: Sat Oct 17 23:27:44 PDT 2026 (table-driven scoring)
+// Last Modified: Sun Oct 18 00:24:20 PDT 2026 (restored calculateBatch)
 // Filename:      ...sig/include/sigInfo/RootSpectrum.cpp
 // Web Address:   http://sig.sapp.org/include/sigInfo/RootSpectrum.cpp
 // Syntax:        C++ 
@@ -801,23 +803,42 @@ int RootSpectrum::calculate(IntervalWeight& distances, HumdrumFile& infile,
       return -1;
    }
 
+   if (!melodyQ) {
+      // score the notes as a batch of one sonority:
+      Array<int> offsets(2);
+      offsets[0] = 0;
+      offsets[1] = pitches.getSize();
+      Array<int> roots;
+      calculateBatch(rootscores, roots, distances, pitches, durations, 
+            levels, offsets);
+      return bestIndex();
+   }
+
    rootscores.setSize(40);
    rootscores.setAll(0.0);
-   double melodyscaling;
 
-   for (i=0; i<rootscores.getSize(); i++) {
-      for (j=0; j<pitches.getSize(); j++) {
-         if (melodyQ) {
-            melodyscaling = getMelodicScaling(i, pitches[j], 
-               lastpitches[j], nextpitches[j], distances, 
-               absbeat[j], chordstartbeat, chordendbeat, durations[j]);
-         } else {
-            melodyscaling = 1.0;
-         }
-         rootscores[i] += distances[(pitches[j]-i+400)%40] *
-            durationscaling(durations[j]) * 
-            metricscaling(levels[j]) *
-            melodyscaling;
+   // the rhythmic scalings only depend on the note, not the root:
+   int count = pitches.getSize();
+   Array<double> durscales(count);
+   Array<double> metscales(count);
+   for (j=0; j<count; j++) {
+      durscales[j] = durationscaling(durations[j]);
+      metscales[j] = metricscaling(levels[j]);
+   }
+
+   Array<double> table;
+   fillWeightTable(table, distances);
+
+   double melodyscaling;
+   double* weights;
+   for (j=0; j<count; j++) {
+      weights = table.getBase() + ((pitches[j] % 40 + 40) % 40) * 40;
+      for (i=0; i<40; i++) {
+         melodyscaling = getMelodicScaling(i, pitches[j], 
+            lastpitches[j], nextpitches[j], distances, 
+            absbeat[j], chordstartbeat, chordendbeat, durations[j]);
+         rootscores[i] += weights[i] * durscales[j] * metscales[j] *
+               melodyscaling;
       }
    }
 
@@ -825,6 +846,77 @@ int RootSpectrum::calculate(IntervalWeight& distances, HumdrumFile& infile,
 }
 
 
+
+//////////////////////////////
+//
+// RootSpectrum::calculateBatch -- calculate the root scores for a
+//     sequence of sonorities at once.  The notes of all sonorities are
+//     given in pitches (base-40), durations (in quarter notes) and
+//     levels (metric level of the note on a linear scale), with the
+//     notes of sonority i being at indexes offsets[i] to offsets[i+1]-1
+//     (so offsets has one more entry than the number of sonorities).
+//     The scores for sonority i are stored in scores[i*40] to
+//     scores[i*40+39], and roots[i] is set to the best root (the lowest
+//     score), or -1 if the sonority has no notes (in which case all of
+//     its scores are 100000.0).  The duration and metric level settings
+//     of the object are used, but not the melodic (non-harmonic tone)
+//     scaling, since it requires the neighboring pitches of each note;
+//     the results are the same as calculate() with melodyOff().
+//
+
+void RootSpectrum::calculateBatch(Array<double>& scores, Array<int>& roots,
+      IntervalWeight& distances, Array<int>& pitches, 
+      Array<double>& durations, Array<double>& levels, Array<int>& offsets) {
+
+   int sonorities = offsets.getSize() - 1;
+   if (sonorities < 0) {
+      sonorities = 0;
+   }
+   scores.setSize(sonorities * 40);
+   roots.setSize(sonorities);
+
+   int i, j;
+   int count = pitches.getSize();
+   Array<double> durscales(count);
+   Array<double> metscales(count);
+   for (j=0; j<count; j++) {
+      durscales[j] = durationscaling(durations[j]);
+      metscales[j] = metricscaling(levels[j]);
+   }
+
+   Array<double> table;
+   fillWeightTable(table, distances);
+
+   int start;
+   int best;
+   double* rootscores;
+   for (i=0; i<sonorities; i++) {
+      rootscores = scores.getBase() + i * 40;
+      start = offsets[i];
+      count = offsets[i+1] - start;
+      if (count <= 0) {
+         for (j=0; j<40; j++) {
+            rootscores[j] = 100000.0;
+         }
+         roots[i] = -1;
+         continue;
+      }
+      for (j=0; j<40; j++) {
+         rootscores[j] = 0.0;
+      }
+      scoreNotes(rootscores, table.getBase(), pitches.getBase() + start,
+            durscales.getBase() + start, metscales.getBase() + start, count);
+      best = 0;
+      for (j=1; j<40; j++) {
+         if (rootscores[j] < rootscores[best]) {
+            best = j;
+         }
+      }
+      roots[i] = best;
+   }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Private Functions
@@ -1158,6 +1250,55 @@ double RootSpectrum::getMeterBias(void) {
 
 
 
+//////////////////////////////
+//
+// RootSpectrum::fillWeightTable -- arrange the interval weights so that
+//     the weights of a pitch class against all 40 roots are contiguous:
+//     table[pc*40 + root] is the weight of the interval from the root
+//     to the pitch class.
+//
+
+void RootSpectrum::fillWeightTable(Array<double>& table, 
+      IntervalWeight& distances) {
+   table.setSize(40 * 40);
+   int pc, root;
+   for (pc=0; pc<40; pc++) {
+      for (root=0; root<40; root++) {
+         table[pc * 40 + root] = distances[(pc - root + 40) % 40];
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// RootSpectrum::scoreNotes -- add the scores of a list of notes to the
+//     scores of each root.  The loop over the roots is the inner loop and
+//     has no dependencies between roots, so it can be vectorized by the
+//     compiler, while the notes are still added to each root in the same
+//     order as the original root-by-root calculation.
+//
+
+void RootSpectrum::scoreNotes(double* scores, const double* table,
+      const int* pitches, const double* durscales, const double* metscales,
+      int count) {
+   int i, j;
+   const double* weights;
+   double durscale;
+   double metscale;
+   for (j=0; j<count; j++) {
+      weights  = table + ((pitches[j] % 40 + 40) % 40) * 40;
+      durscale = durscales[j];
+      metscale = metscales[j];
+      for (i=0; i<40; i++) {
+         scores[i] += weights[i] * durscale * metscale;
+      }
+   }
+}
+
+
+
 //////////////////////////////
 //
 // RootSpectrum::durationscaling -- scaling factor for duration of note.
@@ -2,6 +2,7 @@
 // Programmer:    Craig Stuart Sapp <craig@ccrma.stanford.edu>
 // Creation Date: Sun May 13 14:00:43 PDT 2001
 // Last Modified: Sun May 13 14:00:40 PDT 2001
+// Last Modified: Sat Oct 17 19:12:08 PDT 2026 Correlate with KeyFinder
 // Filename:      ...sig/src/museinfo/humdrumfileextras.cpp
 // Web Address:   http://sig.sapp.org/src/museinfo/humdrumfileextras.cpp
 // Syntax:        C++ 
@@ -10,6 +11,8 @@
 //		  but not necessarily using HumdrumFile class.
 //
 
+#include "KeyFinder.h"
+
 #include <math.h>
 
 #ifndef OLDCPP
@@ -38,7 +41,7 @@
 
 int analyzeKeyKS(double* scores, double* distribution, int* pitch, 
       double* durations, int size, int rhythmQ, int binaryQ) {
-   int i, j;
+   int i;
    int histogram[12] = {0};
 
    double majorKey[12] = {6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 
@@ -72,33 +75,6 @@ int analyzeKeyKS(double* scores, double* distribution, int* pitch,
       }
    }
 
-   double sum = 0.0;
-   double summaj = 0.0;
-   double summin = 0.0;
-   for (i=0; i<12; i++) {
-      sum += distribution[i];
-      summaj += majorKey[i];
-      summin += minorKey[i];
-   }
-
-   double mean = sum/12.0;
-   double major_mean = summaj / 12.0;
-   double minor_mean = summin / 12.0;
-
-   // Krumhansl-Kessler mean values:
-   // double major_mean = 3.4825;
-   // double minor_mean = 3.709167;
-
-   double maj_numerator;
-   double min_numerator;
-   double maj_denominator;
-   double min_denominator;
-   double maj_temp;
-   double min_temp;
-   double temp;
-
-   int subscript;
-     
 /*
    if (binaryQ) {
       double binaryDistribution[12] = {0};
@@ -158,58 +134,11 @@ int analyzeKeyKS(double* scores, double* distribution, int* pitch,
          }
       }
 
-   } else {
-*/
-      double* r_major = scores;
-      double* r_minor = scores + 12;
-
-      for (i=0; i<12; i++) {
-         maj_numerator = min_numerator = 0;
-         maj_denominator = min_denominator = 0;
-         maj_temp = min_temp = temp = 0;
-   
-         // Examine all pitches for each key,
-         for (j=0; j<12; j++) {
-            subscript = (i+j)%12;
-            temp += pow(distribution[subscript] - mean, 2.0);
-   
-            // for the major keys:
-            maj_numerator += (majorKey[j] - major_mean) *
-                             (distribution[subscript] - mean);
-            maj_temp += pow(majorKey[j] - major_mean, 2.0);
-   
-            // for the minor keys:
-            min_numerator += (minorKey[j] - minor_mean) *
-                             (distribution[subscript] - mean);
-            min_temp += pow(minorKey[j] - minor_mean, 2.0);
-         }
-         
-         maj_denominator = sqrt(maj_temp * temp);
-         min_denominator = sqrt(min_temp * temp);
-   
-         if (maj_denominator <= 0.0) {
-            r_major[i] = 0.0;
-         } else {
-            r_major[i] = maj_numerator / maj_denominator;
-         }
-   
-         if (min_denominator <= 0.0) {
-            r_minor[i] = 0.0;
-         } else {
-            r_minor[i] = min_numerator / min_denominator;
-         }
-      }
- //  }
-
-   // now figure out which key is the largest.
-   int bestkey = 0;
-   for (i=1; i<24; i++) {
-      if (scores[i] > scores[bestkey]) {
-         bestkey = i;
-      }
    }
+*/
 
-   return bestkey;
+   KeyFinder finder(majorKey, minorKey);
+   return finder.correlate(scores, distribution);
 }
 
 
@@ -226,7 +155,7 @@ int analyzeKeyKS(double* scores, double* distribution, int* pitch,
 int analyzeKeyKS2(double* scores, double* distribution, int* pitch, 
       double* durations, int size, int rhythmQ, double* majorKey,
       double* minorKey) {
-   int i, j;
+   int i;
    int histogram[12] = {0};
 
    // double majorKey[12] = {6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 
@@ -261,83 +190,8 @@ int analyzeKeyKS2(double* scores, double* distribution, int* pitch,
 //}
 //cout << "\n\n\n";
 
-   double sum = 0.0;
-   double summaj = 0.0;
-   double summin = 0.0;
-   for (i=0; i<12; i++) {
-      sum    += distribution[i];
-      summaj += majorKey[i];
-      summin += minorKey[i];
-   }
-
-   double mean = sum/12.0;
-   double major_mean = summaj/12.0;
-   double minor_mean = summin/12.0;
-
-
-   // Krumhansl-Kessler weight means
-   // double major_mean = 3.4825;
-   // double minor_mean = 3.709167;
-
-   double maj_numerator;
-   double min_numerator;
-   double maj_denominator;
-   double min_denominator;
-   double maj_temp;
-   double min_temp;
-   double temp;
-
-   int subscript;
-     
-   double* r_major = scores;
-   double* r_minor = scores + 12;
-
-   for (i=0; i<12; i++) {
-      maj_numerator = min_numerator = 0;
-      maj_denominator = min_denominator = 0;
-      maj_temp = min_temp = temp = 0;
-   
-      // Examine all pitches for each key,
-      for (j=0; j<12; j++) {
-         subscript = (i+j)%12;
-         temp += pow(distribution[subscript] - mean, 2.0);
-  
-         // for the major keys:
-         maj_numerator += (majorKey[j] - major_mean) *
-                          (distribution[subscript] - mean);
-         maj_temp += pow(majorKey[j] - major_mean, 2.0);
- 
-         // for the minor keys:
-         min_numerator += (minorKey[j] - minor_mean) *
-                          (distribution[subscript] - mean);
-         min_temp += pow(minorKey[j] - minor_mean, 2.0);
-      }
-      
-      maj_denominator = sqrt(maj_temp * temp);
-      min_denominator = sqrt(min_temp * temp);
-
-      if (maj_denominator <= 0.0) {
-         r_major[i] = 0.0;
-      } else {
-         r_major[i] = maj_numerator / maj_denominator;
-      }
-
-      if (min_denominator <= 0.0) {
-         r_minor[i] = 0.0;
-      } else {
-         r_minor[i] = min_numerator / min_denominator;
-      }
-   }
-
-   // now figure out which key is the largest.
-   int bestkey = 0;
-   for (i=1; i<24; i++) {
-      if (scores[i] > scores[bestkey]) {
-         bestkey = i;
-      }
-   }
-
-   return bestkey;
+   KeyFinder finder(majorKey, minorKey);
+   return finder.correlate(scores, distribution);
 }
 
 
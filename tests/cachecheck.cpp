@@ -0,0 +1,192 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 01:14:13 PDT 2026
+// Last Modified: Sun Oct 18 01:14:13 PDT 2026
+// Filename:      ...humextra/tests/cachecheck.cpp
+// Syntax:        C++11; humextra
+//
+// Description:   Check that HumdrumCache::read() loads the null-token
+//                (dot) analysis of a file from its .humc cache, and that
+//                it rejects a cache in which a null token refers to a line
+//                or field outside of the file (so that the source is
+//                parsed instead).  The dot table is found in the cache by
+//                searching for the dotline/dotspine pairs of the file.
+//
+// Usage:         cachecheck
+//
+
+#include "humdrum.h"
+
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+// function declarations:
+int      findDots        (const string& data, vector<int>& dots);
+int      readCorrupted   (const string& cachename, const string& sourcename,
+                          const string& data, int position, int line,
+                          int spine);
+void     report          (int ok, const char* label);
+
+int checks   = 0;
+int failures = 0;
+
+const char* Contents =
+   "**kern\t**kern\n"
+   "4c\t4e\n"
+   ".\t4f\n"
+   "4d\t.\n"
+   ".\t.\n"
+   "*-\t*-\n";
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   string sourcename = "/tmp/cachecheck-" + to_string((long long)getpid());
+   sourcename += ".krn";
+   string cachename = HumdrumCache::getCacheName(sourcename);
+   ofstream source(sourcename.c_str());
+   source << Contents;
+   source.close();
+
+   HumdrumFile infile;
+   infile.read(sourcename.c_str());
+   vector<HumdrumFile*> segments(1, &infile);
+   report(HumdrumCache::write(cachename, sourcename, segments), "write");
+
+   // the dotline/dotspine pairs of the file, in the order of the cache,
+   // and the position of the pair for the first null token (line 2,
+   // field 0, which refers to line 1, field 0):
+   vector<int> dots;
+   int nullpair = -1;
+   int i, j;
+   for (i=0; i<infile.getNumLines(); i++) {
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         if ((i == 2) && (j == 0)) {
+            nullpair = (int)dots.size() * sizeof(int);
+         }
+         dots.push_back(infile[i].getDotLine(j));
+         dots.push_back(infile[i].getDotSpine(j));
+      }
+   }
+
+   ifstream cache(cachename.c_str(), ios::in | ios::binary);
+   stringstream buffer;
+   buffer << cache.rdbuf();
+   string data = buffer.str();
+   cache.close();
+   int position = findDots(data, dots);
+   report(position >= 0, "dot table in cache");
+   report((infile[2].getDotLine(0) == 1) && (infile[2].getDotSpine(0) == 0),
+         "dot analysis of the file");
+   position += nullpair;
+
+   vector<HumdrumFile*> loaded;
+   int status = HumdrumCache::read(cachename, sourcename, loaded);
+   report(status && (loaded.size() == 1), "read");
+   if (status && (loaded.size() == 1)) {
+      HumdrumFile& cached = *loaded[0];
+      int ok = 1;
+      for (i=0; i<infile.getNumLines(); i++) {
+         if (!infile[i].isData()) {
+            continue;
+         }
+         for (j=0; j<infile[i].getFieldCount(); j++) {
+            if ((cached[i].getDotLine(j) != infile[i].getDotLine(j)) ||
+                  (cached[i].getDotSpine(j) != infile[i].getDotSpine(j))) {
+               ok = 0;
+            }
+         }
+      }
+      report(ok, "dots read from cache");
+   }
+   for (i=0; i<(int)loaded.size(); i++) {
+      delete loaded[i];
+   }
+
+   if (position >= nullpair) {
+      int lines = infile.getNumLines();
+      report(readCorrupted(cachename, sourcename, data, position,
+            lines, 0), "dotline past the last line");
+      report(readCorrupted(cachename, sourcename, data, position,
+            -2, 0), "negative dotline");
+      report(readCorrupted(cachename, sourcename, data, position,
+            1, 2), "dotspine past the last field");
+      report(readCorrupted(cachename, sourcename, data, position,
+            1, -1), "dotspine of -1 with a dotline");
+      report(!readCorrupted(cachename, sourcename, data, position,
+            1, 1), "dot in range");
+   }
+
+   unlink(cachename.c_str());
+   unlink(sourcename.c_str());
+
+   cout << checks << " checks, " << failures << " failures" << endl;
+   return failures == 0 ? 0 : 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// findDots -- Return the byte position of the dot table in the cache
+//     data, or -1 if it is not found.
+//
+
+int findDots(const string& data, vector<int>& dots) {
+   string pattern((const char*)dots.data(), dots.size() * sizeof(int));
+   size_t position = data.find(pattern);
+   if (position == string::npos) {
+      return -1;
+   }
+   return (int)position;
+}
+
+
+
+//////////////////////////////
+//
+// readCorrupted -- Write the cache with the dotline and dotspine at the
+//     given position changed, and return true if the cache is rejected.
+//
+
+int readCorrupted(const string& cachename, const string& sourcename,
+      const string& data, int position, int line, int spine) {
+   string changed = data;
+   memcpy(&changed[position], &line, sizeof(int));
+   memcpy(&changed[position + sizeof(int)], &spine, sizeof(int));
+   // keep the cache newer than the source:
+   ofstream cache(cachename.c_str(), ios::out | ios::binary | ios::trunc);
+   cache.write(changed.data(), changed.size());
+   cache.close();
+
+   vector<HumdrumFile*> loaded;
+   int status = HumdrumCache::read(cachename, sourcename, loaded);
+   for (int i=0; i<(int)loaded.size(); i++) {
+      delete loaded[i];
+   }
+   return !status;
+}
+
+
+
+//////////////////////////////
+//
+// report -- Count a check and print a message if it failed.
+//
+
+void report(int ok, const char* label) {
+   checks++;
+   if (!ok) {
+      failures++;
+      cout << "FAILED " << label << endl;
+   }
+}
+
+
+
@@ -0,0 +1,70 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 00:32:01 PDT 2026
+// Last Modified: Sun Oct 18 00:32:01 PDT 2026
+// Filename:      ...humextra/tests/kerncheck.cpp
+// Syntax:        C++11; humextra
+//
+// Description:   Check of the durations which Convert::kernToDurationR()
+//                (based on Convert::scanKernToken()) gives for **kern
+//                tokens, including tokens with rhythm numbers which are
+//                too large for an int, such as the "-2147483648" rhythm
+//                which durationToKernRhythm() writes for a duration of 0.
+//
+// Usage:         kerncheck
+//
+
+#include "humdrum.h"
+
+using namespace std;
+
+class KernCheck {
+   public:
+      const char* token;
+      int         top;     // expected duration in quarter notes
+      int         bottom;
+};
+
+KernCheck Checks[] = {
+   { "4c",                          1,  1 },
+   { "8.c]",                        3,  4 },
+   { "16..G#L",                     7, 16 },
+   { "3%2e-",                       8,  3 },
+   { "0r",                          8,  1 },
+   { "000F",                       32,  1 },
+   { "4c 8e 8g",                    1,  1 },
+   { "qq8c",                        0,  1 },
+   { ".",                           0,  1 },
+   { "2147483647c",                 4, 2147483647 },
+   { "2147483648c",                 0,  1 },
+   { "-2147483648c",                0,  1 },
+   { "-2147483648.c]",              0,  1 },
+   { "99999999999999999999c",       0,  1 },
+   { "3%99999999999c",              0,  1 },
+   { "99999999999%2c",              0,  1 },
+   { NULL,                          0,  1 }
+};
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   int checks   = 0;
+   int failures = 0;
+   RationalNumber duration;
+   for (int i=0; Checks[i].token != NULL; i++) {
+      checks++;
+      duration = Convert::kernToDurationR(Checks[i].token);
+      if (duration != RationalNumber(Checks[i].top, Checks[i].bottom)) {
+         failures++;
+         cout << "FAILED kernToDurationR(\"" << Checks[i].token << "\") = "
+              << duration << endl;
+      }
+   }
+
+   cout << checks << " checks, " << failures << " failures" << endl;
+   return failures == 0 ? 0 : 1;
+}
+
+
+
@@ -0,0 +1,109 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 00:43:53 PDT 2026
+// Last Modified: Sun Oct 18 00:43:53 PDT 2026
+// Filename:      ...humextra/tests/rationalcheck.cpp
+// Syntax:        C++11; humextra
+//
+// Description:   Check of RationalNumber::setValue() (which simplifies
+//                the value with RationalNumber::simplify() and the binary
+//                RationalNumber::gcd()), in particular for numerators and
+//                denominators of INT_MIN, which cannot be negated.  A
+//                valid value must always have a positive denominator.
+//
+// Usage:         rationalcheck
+//
+
+#include "humdrum.h"
+
+#include <limits.h>
+
+using namespace std;
+
+class RationalCheck {
+   public:
+      int num;            // value given to setValue()
+      int den;
+      int valid;          // expected value (if valid)
+      int top;
+      int bottom;
+};
+
+RationalCheck Checks[] = {
+   { 6,        4,        1,  3,          2         },
+   { 6,        -4,       1,  -3,         2         },
+   { -6,       -4,       1,  3,          2         },
+   { 0,        -4,       1,  0,          1         },
+   { 4,        INT_MIN,  1,  -1,         536870912 },
+   { -4,       INT_MIN,  1,  1,          536870912 },
+   { 0,        INT_MIN,  1,  0,          1         },
+   { INT_MIN,  INT_MIN,  1,  1,          1         },
+   { INT_MIN,  1,        1,  INT_MIN,    1         },
+   { INT_MIN,  2,        1,  -1073741824, 1         },
+   { INT_MIN,  -2,       1,  1073741824, 1         },
+   { INT_MAX,  INT_MIN,  0,  0,          0         },
+   { 1,        INT_MIN,  0,  0,          0         },
+   { INT_MIN,  -1,       0,  0,          0         },
+   { 0,        0,        0,  0,          0         }
+};
+
+class GcdCheck {
+   public:
+      int x;
+      int y;
+      int gcd;
+};
+
+GcdCheck GcdChecks[] = {
+   { 12,       18,       6       },
+   { -12,      18,       6       },
+   { 0,        -5,       5       },
+   { INT_MIN,  6,        2       },
+   { INT_MIN,  INT_MAX,  1       },
+   { 4,        INT_MIN,  4       },
+   { 0,        0,        0       }
+};
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   int checks   = 0;
+   int failures = 0;
+   RationalNumber value;
+   int i;
+   for (i=0; (Checks[i].num != 0) || (Checks[i].den != 0); i++) {
+      checks++;
+      value.setValue(Checks[i].num, Checks[i].den);
+      int ok;
+      if (Checks[i].valid) {
+         ok = value.isValid() && (value.getDenominator() > 0) &&
+               (value.getNumerator() == Checks[i].top) &&
+               (value.getDenominator() == Checks[i].bottom);
+      } else {
+         ok = !value.isValid();
+      }
+      if (!ok) {
+         failures++;
+         cout << "FAILED setValue(" << Checks[i].num << ", " << Checks[i].den
+              << ") = " << value.getNumerator() << "/"
+              << value.getDenominator() << endl;
+      }
+   }
+
+   for (i=0; GcdChecks[i].gcd != 0; i++) {
+      checks++;
+      int gcd = RationalNumber::gcd(GcdChecks[i].x, GcdChecks[i].y);
+      if (gcd != GcdChecks[i].gcd) {
+         failures++;
+         cout << "FAILED gcd(" << GcdChecks[i].x << ", " << GcdChecks[i].y
+              << ") = " << gcd << endl;
+      }
+   }
+
+   cout << checks << " checks, " << failures << " failures" << endl;
+   return failures == 0 ? 0 : 1;
+}
+
+
+
@@ -0,0 +1,165 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 00:24:20 PDT 2026
+// Last Modified: Sun Oct 18 00:24:20 PDT 2026
+// Filename:      ...humextra/tests/rootcheck.cpp
+// Syntax:        C++11; humextra
+//
+// Description:   Check that the root scores of each sonority calculated
+//                by RootSpectrum::calculateBatch() are the same as the
+//                ones calculated by RootSpectrum::calculate() for the
+//                sonority alone, and (without rhythm scaling) the same as
+//                adding the interval weights root by root.  The scores
+//                must match exactly, since the notes are added in the
+//                same order.
+//
+// Usage:         rootcheck
+//
+
+#include "humdrum.h"
+
+#include <sstream>
+
+using namespace std;
+
+// function declarations:
+void     checkSettings   (HumdrumFile& infile, IntervalWeight& distances,
+                          RootSpectrum& spectrum, const char* label,
+                          int plainQ);
+
+int checks   = 0;
+int failures = 0;
+
+const char* Contents =
+   "**kern\t**kern\t**kern\n"
+   "*M3/4\t*M3/4\t*M3/4\n"
+   "4C\t4e\t4g\n"
+   "8G\t4d\t4b\n"
+   "8B\t.\t.\n"
+   "4C\t4c\t4ee\n"
+   "=1\t=1\t=1\n"
+   "2.A\t4c\t4a\n"
+   ".\t4e\t8cc#\n"
+   ".\t.\t8dd\n"
+   ".\t4r\t4ee-\n"
+   "=2\t=2\t=2\n"
+   "4r\t4r\t4r\n"
+   "2F\t2f\t2a\n"
+   "*-\t*-\t*-\n";
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   stringstream contents;
+   contents << Contents;
+   HumdrumFile infile;
+   infile.read(contents);
+   infile.analyzeRhythm("4");
+
+   IntervalWeight distances;
+   distances.setChromatic2(-45.0, 75.0);
+
+   RootSpectrum spectrum;
+   spectrum.melodyOff();
+   spectrum.rhythmOff();
+   checkSettings(infile, distances, spectrum, "no rhythm", 1);
+
+   spectrum.rhythmOn();
+   spectrum.rhythmLinear();
+   checkSettings(infile, distances, spectrum, "linear rhythm", 0);
+
+   spectrum.rhythmLog();
+   checkSettings(infile, distances, spectrum, "log rhythm", 0);
+
+   spectrum.durationOff();
+   spectrum.meterLinear();
+   checkSettings(infile, distances, spectrum, "linear meter", 0);
+
+   cout << checks << " checks, " << failures << " failures" << endl;
+   return failures == 0 ? 0 : 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// checkSettings -- Calculate the root scores of each data line of the
+//     file with calculateBatch(), and compare them to calculate() for
+//     the line.  If plainQ is true, also compare them to the interval
+//     weights added root by root.
+//
+
+void checkSettings(HumdrumFile& infile, IntervalWeight& distances,
+      RootSpectrum& spectrum, const char* label, int plainQ) {
+   Array<int>    lines;
+   Array<int>    pitches;
+   Array<double> durations;
+   Array<double> levels;
+   Array<int>    offsets;
+   Array<double> absbeat;
+   Array<int>    p;
+   Array<double> d;
+   Array<double> l;
+   pitches.setSize(0);
+   durations.setSize(0);
+   levels.setSize(0);
+   offsets.setSize(0);
+   lines.setSize(0);
+
+   int i, j;
+   int count = 0;
+   for (i=0; i<infile.getNumLines(); i++) {
+      if (!infile[i].isData()) {
+         continue;
+      }
+      lines.append(i);
+      offsets.append(count);
+      infile.getNoteArray(absbeat, p, d, l, i, i);
+      for (j=0; j<p.getSize(); j++) {
+         pitches.append(p[j]);
+         durations.append(d[j]);
+         levels.append(l[j]);
+         count++;
+      }
+   }
+   offsets.append(count);
+
+   Array<double> scores;
+   Array<int>    roots;
+   spectrum.calculateBatch(scores, roots, distances, pitches, durations,
+         levels, offsets);
+
+   int root;
+   double sum;
+   for (i=0; i<lines.getSize(); i++) {
+      checks++;
+      root = spectrum.calculate(distances, infile, lines[i], lines[i]);
+      int ok = (root == roots[i]);
+      for (j=0; j<40; j++) {
+         if (spectrum[j] != scores[i*40+j]) {
+            ok = 0;
+         }
+      }
+      if (plainQ) {
+         for (j=0; (j<40) && (offsets[i+1] > offsets[i]); j++) {
+            sum = 0.0;
+            for (int k=offsets[i]; k<offsets[i+1]; k++) {
+               sum += distances[(pitches[k] - j + 400) % 40];
+            }
+            if (sum != scores[i*40+j]) {
+               ok = 0;
+            }
+         }
+      }
+      if (!ok) {
+         failures++;
+         cout << "FAILED " << label << ": line " << lines[i] + 1 << endl;
+      }
+   }
+}
+
+
+
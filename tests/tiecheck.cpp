@@ -0,0 +1,174 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sun Oct 18 00:16:12 PDT 2026
+// Last Modified: Sun Oct 18 00:16:12 PDT 2026
+// Filename:      ...humextra/tests/tiecheck.cpp
+// Syntax:        C++11; humextra
+//
+// Description:   Check of the getTied*() functions of HumdrumFile.  The
+//                ties are looked up before the rhythm is analyzed (when
+//                they are found by searching through the tokens), after
+//                the analysis (when they are read from the note table),
+//                and after tokens are changed with setToken() and
+//                changeField() (when the note table is out of date).
+//
+// Usage:         tiecheck
+//
+
+#include "humdrum.h"
+
+#include <sstream>
+
+using namespace std;
+
+// function declarations:
+void     checkDuration   (HumdrumFile& infile, int line, int field,
+                          int top, int bottom, const char* label);
+void     checkTotal      (HumdrumFile& infile, int line, int field,
+                          int top, int bottom, const char* label);
+void     checkStart      (HumdrumFile& infile, int line, int field,
+                          int sline, int sfield, const char* label);
+void     checkAll        (HumdrumFile& infile, const char* label);
+void     report          (int ok, const char* label, const char* function,
+                          int line, int field);
+
+int checks   = 0;
+int failures = 0;
+
+const char* Contents =
+   "**kern\t**kern\n"     // line 0
+   "*M4/4\t*M4/4\n"       // line 1
+   "4c[\t4e\n"            // line 2
+   "4c]\t4f\n"            // line 3
+   "=1\t=1\n"             // line 4
+   "2d[\t2g[\n"           // line 5
+   "4d_\t4g]\n"           // line 6
+   "4d]\t4a\n"            // line 7
+   "*-\t*-\n";            // line 8
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   stringstream contents;
+   contents << Contents;
+   HumdrumFile infile;
+   infile.read(contents);
+
+   checkAll(infile, "before analyzeRhythm()");
+
+   infile.analyzeRhythm("4");
+   checkAll(infile, "after analyzeRhythm()");
+   if (infile.getTiedStartBeatR(7, 0) != 2) {
+      report(0, "after analyzeRhythm()", "getTiedStartBeatR", 7, 0);
+   }
+   checks++;
+
+   // break the first tie in the first spine:
+   infile[3].setToken(0, "4c");
+   checkDuration(infile, 2, 0, 1, 1, "after setToken()");
+   checkStart(infile, 3, 0, 3, 0, "after setToken()");
+
+   // break the tie in the second spine:
+   infile[5].changeField(1, "2g");
+   checkDuration(infile, 5, 1, 2, 1, "after changeField()");
+   checkTotal(infile, 6, 1, 1, 1, "after changeField()");
+
+   // the note table is current again after the next analysis:
+   infile.analyzeRhythm("4");
+   checkDuration(infile, 2, 0, 1, 1, "after analyzing again");
+   checkDuration(infile, 5, 1, 2, 1, "after analyzing again");
+   checkDuration(infile, 5, 0, 4, 1, "after analyzing again");
+
+   cout << checks << " checks, " << failures << " failures" << endl;
+   return failures == 0 ? 0 : 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// checkAll -- Check the ties of the unchanged file.
+//
+
+void checkAll(HumdrumFile& infile, const char* label) {
+   checkDuration(infile, 2, 0, 2, 1, label);
+   checkDuration(infile, 2, 1, 1, 1, label);
+   checkDuration(infile, 5, 0, 4, 1, label);
+   checkDuration(infile, 5, 1, 3, 1, label);
+   checkTotal(infile, 3, 0, 2, 1, label);
+   checkTotal(infile, 7, 0, 4, 1, label);
+   checkTotal(infile, 6, 1, 3, 1, label);
+   checkTotal(infile, 7, 1, 1, 1, label);
+   checkStart(infile, 3, 0, 2, 0, label);
+   checkStart(infile, 7, 0, 5, 0, label);
+   checkStart(infile, 6, 1, 5, 1, label);
+   checkStart(infile, 7, 1, 7, 1, label);
+}
+
+
+
+//////////////////////////////
+//
+// checkDuration -- Check the result of getTiedDurationR().
+//
+
+void checkDuration(HumdrumFile& infile, int line, int field, int top,
+      int bottom, const char* label) {
+   RationalNumber expected(top, bottom);
+   report(infile.getTiedDurationR(line, field) == expected, label,
+         "getTiedDurationR", line, field);
+}
+
+
+
+//////////////////////////////
+//
+// checkTotal -- Check the result of getTotalTiedDurationR().
+//
+
+void checkTotal(HumdrumFile& infile, int line, int field, int top,
+      int bottom, const char* label) {
+   RationalNumber expected(top, bottom);
+   report(infile.getTotalTiedDurationR(line, field, 0) == expected, label,
+         "getTotalTiedDurationR", line, field);
+}
+
+
+
+//////////////////////////////
+//
+// checkStart -- Check the result of getTiedStartLocation().
+//
+
+void checkStart(HumdrumFile& infile, int line, int field, int sline,
+      int sfield, const char* label) {
+   int tline = -1;
+   int tcol  = -1;
+   int ttok  = -1;
+   infile.getTiedStartLocation(line, field, 0, tline, tcol, ttok);
+   report((tline == sline) && (tcol == sfield) && (ttok == 0), label,
+         "getTiedStartLocation", line, field);
+}
+
+
+
+//////////////////////////////
+//
+// report -- Count a check and print a message if it failed.
+//
+
+void report(int ok, const char* label, const char* function, int line,
+      int field) {
+   checks++;
+   if (!ok) {
+      failures++;
+      cout << "FAILED " << label << ": " << function << "(" << line
+           << ", " << field << ")" << endl;
+   }
+}
+
+
+
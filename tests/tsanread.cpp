@@ -0,0 +1,217 @@
+//
+// Programmer:    agent <agent@local>
+// Creation Date: Sat Oct 17 23:19:37 PDT 2026
+// Last Modified: Sat Oct 17 23:19:37 PDT 2026
+// Filename:      ...humextra/tests/tsanread.cpp
+// Syntax:        C++11; humextra
+//
+// Description:   ThreadSanitizer check of reading HumdrumFiles from many
+//                threads at once (see the "Threads" notes in HumdrumFile.h).
+//                The files are read and analyzed in the main thread, then
+//                several reader threads calculate a checksum of everything
+//                that the reading functions return for each file, while
+//                another thread reads new files containing unknown
+//                exclusive interpretations (which are added to
+//                Convert::exint).  The checksums must match the ones
+//                calculated before the threads were started.  Compile with
+//                -fsanitize=thread against a library also compiled with it
+//                (type "make tsan" in the base directory).
+//
+// Usage:         tsanread file.krn [file2.krn ...]
+//
+
+#include "humdrum.h"
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <sstream>
+
+using namespace std;
+
+#define READERS 4
+#define ROUNDS  3
+
+// function declarations:
+unsigned long long checksum      (HumdrumFile& infile);
+void               readFiles     (vector<HumdrumFile*>& files,
+                                  vector<unsigned long long>& sums,
+                                  atomic<int>& errors);
+void               addInterps    (atomic<int>& done);
+unsigned long long hashString    (unsigned long long sum, const char* string);
+unsigned long long hashNumber    (unsigned long long sum, double number);
+
+
+///////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+   if (argc < 2) {
+      cerr << "Usage: " << argv[0] << " file.krn [file2.krn ...]" << endl;
+      exit(1);
+   }
+
+   vector<HumdrumFile*> files;
+   vector<unsigned long long> sums;
+   int i;
+   for (i=1; i<argc; i++) {
+      HumdrumFile* infile = new HumdrumFile;
+      infile->read(argv[i]);
+      infile->analyzeRhythm("4");
+      files.push_back(infile);
+      sums.push_back(checksum(*infile));
+   }
+
+   atomic<int> errors(0);
+   atomic<int> done(0);
+   thread writer(addInterps, std::ref(done));
+   vector<thread> readers;
+   for (i=0; i<READERS; i++) {
+      readers.push_back(thread(readFiles, std::ref(files), std::ref(sums),
+            std::ref(errors)));
+   }
+   for (i=0; i<(int)readers.size(); i++) {
+      readers[i].join();
+   }
+   done = 1;
+   writer.join();
+
+   for (i=0; i<(int)files.size(); i++) {
+      delete files[i];
+   }
+
+   cout << files.size() << " files, " << READERS << " readers, "
+        << errors << " checksum errors" << endl;
+   return errors == 0 ? 0 : 1;
+}
+
+
+///////////////////////////////////////////////////////////////////////////
+
+
+//////////////////////////////
+//
+// readFiles -- Calculate the checksum of each file again.
+//
+
+void readFiles(vector<HumdrumFile*>& files, vector<unsigned long long>& sums,
+      atomic<int>& errors) {
+   int i, r;
+   for (r=0; r<ROUNDS; r++) {
+      for (i=0; i<(int)files.size(); i++) {
+         if (checksum(*files[i]) != sums[i]) {
+            errors++;
+         }
+      }
+   }
+}
+
+
+
+//////////////////////////////
+//
+// addInterps -- Read files with new exclusive interpretations until the
+//    readers are finished.
+//
+
+void addInterps(atomic<int>& done) {
+   int count = 0;
+   while (!done) {
+      stringstream contents;
+      contents << "**kern\t**tsan" << count++ << "\n"
+               << "*M4/4\t*\n"
+               << "4c\tx\n"
+               << "*-\t*-\n";
+      HumdrumFile infile;
+      infile.read(contents);
+      infile.analyzeRhythm("4");
+   }
+}
+
+
+
+//////////////////////////////
+//
+// checksum -- Combine the results of the reading functions of a file.
+//
+
+unsigned long long checksum(HumdrumFile& infile) {
+   unsigned long long sum = 0;
+   char key[1024] = {0};
+   char buffer[1024] = {0};
+   const char* value;
+   Array<int> notes;
+   int i, j;
+   for (i=0; i<infile.getNumLines(); i++) {
+      sum = hashString(sum, infile[i].getLine());
+      sum = hashNumber(sum, infile[i].getBeat());
+      sum = hashNumber(sum, infile[i].getAbsBeat());
+      sum = hashNumber(sum, infile[i].getDuration());
+      sum = hashNumber(sum, infile[i].isMeasure());
+      if (infile[i].isBibliographic()) {
+         infile[i].getBibKey(key, 1000);
+         value = infile.getBibValue(buffer, key);
+         if (value != NULL) {
+            sum = hashString(sum, value);
+         }
+      }
+      if (!infile[i].isData()) {
+         continue;
+      }
+      infile.getNoteList(notes, i, NL_NOPC | NL_FILL | NL_NOSORT |
+            NL_NOUNIQ | NL_NORESTS);
+      sum = hashNumber(sum, notes.getSize());
+      for (j=0; j<infile[i].getFieldCount(); j++) {
+         sum = hashString(sum, infile[i].getExInterp(j));
+         if (!infile[i].isExInterp(j, "**kern")) {
+            continue;
+         }
+         sum = hashNumber(sum, infile.getTiedDurationR(i, j).getFloat());
+         sum = hashNumber(sum, infile.getTiedStartBeatR(i, j).getFloat());
+      }
+   }
+
+   Array<int> metlev;
+   infile.analyzeMetricLevel(metlev);
+   for (i=0; i<metlev.getSize(); i++) {
+      sum = hashNumber(sum, metlev[i]);
+   }
+
+   const HumdrumNoteTable& table = infile.getNoteTable();
+   for (i=0; i<table.getSize(); i++) {
+      sum = hashNumber(sum, table.midi[i]);
+      sum = hashNumber(sum, table.tie[i]);
+   }
+
+   return sum;
+}
+
+
+
+//////////////////////////////
+//
+// hashString -- FNV-1a hash of a string added to a checksum.
+//
+
+unsigned long long hashString(unsigned long long sum, const char* string) {
+   while (*string != '\0') {
+      sum ^= (unsigned char)*string++;
+      sum *= 1099511628211ULL;
+   }
+   return sum;
+}
+
+
+
+//////////////////////////////
+//
+// hashNumber -- Add a number to a checksum.
+//
+
+unsigned long long hashNumber(unsigned long long sum, double number) {
+   char buffer[64];
+   snprintf(buffer, 64, "%.9g;", number);
+   return hashString(sum, buffer);
+}
+
+
+